@@ -50,6 +50,12 @@ const ::std::map<int, open_func> open_funcs = {
 	{ chip::OPEN_BY_NUMBER,	open_by_number,	},
 };
 
+const ::std::map<int, int> line_info_policy_mapping = {
+	{ chip::LINE_INFO_REFRESH_ALWAYS,	GPIOD_LINE_INFO_REFRESH_ALWAYS, },
+	{ chip::LINE_INFO_REFRESH_IF_STALE,	GPIOD_LINE_INFO_REFRESH_IF_STALE, },
+	{ chip::LINE_INFO_REFRESH_NEVER,	GPIOD_LINE_INFO_REFRESH_NEVER, },
+};
+
 void chip_deleter(::gpiod_chip* chip)
 {
 	::gpiod_chip_close(chip);
@@ -172,6 +178,59 @@ line_bulk chip::find_lines(const ::std::vector<::std::string>& names) const
 	return ::std::move(lines);
 }
 
+void chip::set_line_info_policy(int policy) const
+{
+	this->throw_if_noref();
+
+	::gpiod_chip_set_line_info_policy(this->_m_chip.get(),
+					  line_info_policy_mapping.at(policy));
+}
+
+int chip::line_info_policy(void) const
+{
+	this->throw_if_noref();
+
+	int policy = ::gpiod_chip_get_line_info_policy(this->_m_chip.get());
+
+	for (auto& it: line_info_policy_mapping) {
+		if (it.second == policy)
+			return it.first;
+	}
+
+	throw ::std::logic_error("invalid line info refresh policy");
+}
+
+void chip::invalidate_line_info(void) const
+{
+	this->throw_if_noref();
+
+	::gpiod_chip_invalidate_line_info(this->_m_chip.get());
+}
+
+int chip::uapi_version(void) const
+{
+	this->throw_if_noref();
+
+	return ::gpiod_chip_uapi_version(this->_m_chip.get());
+}
+
+void chip::set_event_buffer_size(unsigned int size) const
+{
+	this->throw_if_noref();
+
+	int rv = ::gpiod_chip_set_event_buffer_size(this->_m_chip.get(), size);
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "unable to set the event buffer size");
+}
+
+unsigned int chip::event_buffer_size(void) const
+{
+	this->throw_if_noref();
+
+	return ::gpiod_chip_get_event_buffer_size(this->_m_chip.get());
+}
+
 bool chip::operator==(const chip& rhs) const noexcept
 {
 	return this->_m_chip.get() == rhs._m_chip.get();
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+#include <gpiod.hpp>
+#include <system_error>
+#include <utility>
+
+namespace gpiod {
+
+namespace {
+
+void event_source_deleter(::gpiod_event_source* source)
+{
+	::gpiod_event_source_free(source);
+}
+
+::std::shared_ptr<::gpiod_event_source> make_event_source(void)
+{
+	::gpiod_event_source *source = ::gpiod_event_source_new();
+
+	if (!source)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error allocating the event source");
+
+	return ::std::shared_ptr<::gpiod_event_source>(source,
+						       event_source_deleter);
+}
+
+} /* namespace */
+
+event_source::event_source(void)
+	: _m_source(make_event_source()),
+	  _m_handlers(),
+	  _m_error()
+{
+
+}
+
+void event_source::add(const line& line_obj, const callback& cb)
+{
+	line_obj.throw_if_null();
+
+	auto it = this->_m_handlers.find(line_obj._m_line);
+	bool added = it == this->_m_handlers.end();
+
+	/*
+	 * The C library keeps a pointer to the handler of every line in the
+	 * source, so the handler of a line which is already there must stay
+	 * in place even if re-adding it fails.
+	 */
+	if (added) {
+		it = this->_m_handlers.emplace(line_obj._m_line, handler()).first;
+		it->second.owner = this;
+		it->second.source = line_obj;
+	}
+
+	int rv = ::gpiod_event_source_add_line(this->_m_source.get(),
+					       line_obj._m_line,
+					       event_source::handle_event,
+					       ::std::addressof(it->second));
+	if (rv) {
+		if (added)
+			this->_m_handlers.erase(it);
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error adding line to the event source");
+	}
+
+	it->second.cb = cb;
+}
+
+void event_source::add(const line_bulk& bulk, const callback& cb)
+{
+	::std::vector<callback> prev(bulk.size());
+	::std::vector<bool> added(bulk.size());
+
+	for (unsigned int i = 0; i < bulk.size(); i++) {
+		const line& line_obj = bulk._m_bulk[i];
+		auto hnd = this->_m_handlers.find(line_obj._m_line);
+
+		added[i] = hnd == this->_m_handlers.end();
+		if (!added[i])
+			prev[i] = hnd->second.cb;
+
+		try {
+			this->add(line_obj, cb);
+		} catch (...) {
+			/* Undo only what this call did. */
+			while (i--) {
+				const line& undo = bulk._m_bulk[i];
+
+				if (added[i])
+					this->remove(undo);
+				else
+					this->_m_handlers[undo._m_line].cb = prev[i];
+			}
+			throw;
+		}
+	}
+}
+
+void event_source::remove(const line& line_obj)
+{
+	line_obj.throw_if_null();
+
+	int rv = ::gpiod_event_source_remove_line(this->_m_source.get(),
+						  line_obj._m_line);
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error removing line from the event source");
+
+	this->_m_handlers.erase(line_obj._m_line);
+}
+
+int event_source::fd(void) const
+{
+	return ::gpiod_event_source_get_fd(this->_m_source.get());
+}
+
+int event_source::dispatch(void)
+{
+	int rv = ::gpiod_event_source_dispatch(this->_m_source.get());
+
+	if (this->_m_error) {
+		::std::exception_ptr error = this->_m_error;
+
+		this->_m_error = nullptr;
+		::std::rethrow_exception(error);
+	}
+
+	if (rv < 0)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error dispatching line events");
+
+	return rv;
+}
+
+void event_source::handle_event(::gpiod_line* line_ptr GPIOD_UNUSED,
+				const ::gpiod_line_event* event_buf,
+				void* data)
+{
+	handler* hnd = static_cast<handler*>(data);
+	line_event event;
+
+	/* Don't let exceptions unwind through the C library. */
+	if (hnd->owner->_m_error)
+		return;
+
+	if (event_buf->event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+		event.event_type = line_event::RISING_EDGE;
+	else if (event_buf->event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
+		event.event_type = line_event::FALLING_EDGE;
+
+	event.timestamp = ::std::chrono::nanoseconds(
+				event_buf->ts.tv_nsec + (event_buf->ts.tv_sec * 1000000000));
+	event.source = hnd->source;
+	event.seqno = event_buf->seqno;
+	event.line_seqno = event_buf->line_seqno;
+
+	try {
+		hnd->cb(event);
+	} catch (...) {
+		hnd->owner->_m_error = ::std::current_exception();
+	}
+}
+
+} /* namespace gpiod */
@@ -22,6 +22,7 @@
 #include <cstring>
 #include <cerrno>
 #include <functional>
+#include <thread>
 
 #include <poll.h>
 
@@ -333,6 +334,72 @@ void multiple_lines_test(void)
 }
 TEST_CASE(multiple_lines_test);
 
+void multiple_lines_mask_test(void)
+{
+	::gpiod::chip chip("gpiochip0");
+
+	auto lines = chip.get_lines({ 0, 2, 3, 4, 6 });
+
+	::gpiod::line_request config;
+	config.consumer = "gpiod_cxx_tests";
+	config.request_type = ::gpiod::line_request::DIRECTION_OUTPUT;
+
+	lines.request(config);
+
+	::std::cerr << "Setting values using a bitset" << ::std::endl;
+
+	lines.set_values_mask(::std::bitset<64>("10110"));
+
+	::std::cerr << "Changing a subset of lines" << ::std::endl;
+
+	lines.set_values_mask(::std::bitset<64>("00001"),
+			      ::std::bitset<64>("00011"));
+
+	auto vals = lines.get_values_mask();
+
+	::std::cerr << "Values: " << vals.to_string().substr(59) << ::std::endl;
+
+	if (vals != ::std::bitset<64>("10101"))
+		throw ::std::logic_error("unexpected line values");
+}
+TEST_CASE(multiple_lines_mask_test);
+
+void software_pwm(void)
+{
+	::gpiod::chip chip("gpiochip0");
+
+	auto lines = chip.get_lines({ 0, 2, 3 });
+
+	::gpiod::line_request config;
+	config.consumer = "gpiod_cxx_tests";
+	config.request_type = ::gpiod::line_request::DIRECTION_OUTPUT;
+
+	lines.request(config);
+
+	::gpiod::pwm pwm(lines, ::std::chrono::milliseconds(10));
+	pwm.set_channel(0, ::std::chrono::milliseconds(10),
+			::std::chrono::milliseconds(5));
+	pwm.set_channel(1, ::std::chrono::milliseconds(5),
+			::std::chrono::milliseconds(1));
+	pwm.set_channel(2, ::std::chrono::milliseconds(10),
+			::std::chrono::milliseconds(10));
+
+	::std::cerr << "generating pulses for 100ms" << ::std::endl;
+	pwm.start();
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(100));
+
+	auto stats = pwm.get_stats();
+	pwm.stop();
+
+	::std::cerr << "edges: " << stats.edges
+		    << ", max latency: " << stats.max_latency.count() << "ns"
+		    << ::std::endl;
+
+	if (!stats.edges)
+		throw ::std::logic_error("no edges generated");
+}
+TEST_CASE(software_pwm);
+
 void chip_get_all_lines(void)
 {
 	::gpiod::chip chip("gpiochip0");
@@ -453,6 +520,104 @@ void line_event_poll_fd(void)
 }
 TEST_CASE(line_event_poll_fd);
 
+void line_event_source(void)
+{
+	::gpiod::chip chip("gpiochip0");
+	auto lines = chip.get_lines({ 1, 2, 3, 4 });
+
+	::gpiod::line_request config;
+	config.consumer = "gpiod_cxx_tests";
+	config.request_type = ::gpiod::line_request::EVENT_BOTH_EDGES;
+
+	::std::cerr << "requesting lines for events" << ::std::endl;
+	lines.request(config);
+
+	::std::vector<::gpiod::line_event> events;
+	::gpiod::event_source source;
+	source.add(lines, [&events](const ::gpiod::line_event& event) {
+		events.push_back(event);
+	});
+
+	::std::cerr << "generating two line events" << ::std::endl;
+	fire_line_event("gpiochip0", 2, true);
+	fire_line_event("gpiochip0", 4, false);
+
+	pollfd fd;
+	fd.fd = source.fd();
+	fd.events = POLLIN;
+
+	while (events.size() < 2) {
+		int rv = poll(&fd, 1, 1000);
+		if (rv < 0)
+			throw ::std::runtime_error("error polling for events: "
+						+ ::std::string(::strerror(errno)));
+		else if (rv == 0)
+			throw ::std::runtime_error("poll() timed out while waiting for events");
+
+		source.dispatch();
+	}
+
+	::std::cerr << "events received:" << ::std::endl;
+	for (auto& event: events)
+		print_event(event);
+}
+TEST_CASE(line_event_source);
+
+void line_event_source_add_bulk_rollback(void)
+{
+	::gpiod::chip chip("gpiochip0");
+	auto lines = chip.get_lines({ 1, 2 });
+	auto input = chip.get_line(6);
+
+	::gpiod::line_request config;
+	config.consumer = "gpiod_cxx_tests";
+	config.request_type = ::gpiod::line_request::EVENT_BOTH_EDGES;
+	lines.request(config);
+
+	config.request_type = ::gpiod::line_request::DIRECTION_INPUT;
+	input.request(config);
+
+	unsigned int first = 0, second = 0;
+	::gpiod::event_source source;
+	source.add(lines[0], [&first](const ::gpiod::line_event&) { first++; });
+
+	::std::cerr << "adding a bulk with a line not requested for events"
+		    << ::std::endl;
+	try {
+		source.add(::gpiod::line_bulk({ lines[0], lines[1], input }),
+			   [&second](const ::gpiod::line_event&) { second++; });
+		throw ::std::logic_error("adding the bulk should have failed");
+	} catch (const ::std::system_error&) {
+
+	}
+
+	try {
+		source.remove(lines[1]);
+		throw ::std::logic_error("line 2 should have been removed");
+	} catch (const ::std::system_error&) {
+
+	}
+
+	/* Toggle both ways, the line may have been left high. */
+	fire_line_event("gpiochip0", 1, false);
+	fire_line_event("gpiochip0", 1, true);
+
+	pollfd fd;
+	fd.fd = source.fd();
+	fd.events = POLLIN;
+
+	int rv = poll(&fd, 1, 1000);
+	if (rv <= 0)
+		throw ::std::runtime_error("no event on line 1");
+
+	source.dispatch();
+	if (first == 0 || second != 0)
+		throw ::std::logic_error("line 1 lost its original callback");
+
+	::std::cerr << "the source was left intact" << ::std::endl;
+}
+TEST_CASE(line_event_source_add_bulk_rollback);
+
 void chip_iterator(void)
 {
 	::std::cerr << "iterating over all GPIO chips in the system:" << ::std::endl;
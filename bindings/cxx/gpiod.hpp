@@ -10,7 +10,10 @@
 
 #include <bitset>
 #include <chrono>
+#include <exception>
+#include <functional>
 #include <gpiod.h>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -20,6 +23,8 @@ namespace gpiod {
 class line;
 class line_bulk;
 class line_event;
+class event_source;
+class pwm;
 class line_iter;
 class chip_iter;
 
@@ -149,6 +154,44 @@ public:
 	 */
 	GPIOD_API line_bulk find_lines(const ::std::vector<::std::string>& names) const;
 
+	/**
+	 * @brief Set the policy deciding when the info of lines exposed by
+	 *        this chip is re-read from the kernel.
+	 * @param policy One of the LINE_INFO_REFRESH_* values.
+	 */
+	GPIOD_API void set_line_info_policy(int policy) const;
+
+	/**
+	 * @brief Get the current line info refresh policy of this chip.
+	 * @return One of the LINE_INFO_REFRESH_* values.
+	 */
+	GPIOD_API int line_info_policy(void) const;
+
+	/**
+	 * @brief Make the info of all lines exposed by this chip be re-read
+	 *        from the kernel the next time it's accessed.
+	 */
+	GPIOD_API void invalidate_line_info(void) const;
+
+	/**
+	 * @brief Get the version of the kernel uAPI used to access this chip.
+	 * @return 2 if the kernel supports the v2 uAPI, 1 otherwise.
+	 */
+	GPIOD_API int uapi_version(void) const;
+
+	/**
+	 * @brief Set the number of events the kernel can queue for event
+	 *        requests of lines exposed by this chip.
+	 * @param size Number of events or 0 to use the kernel default.
+	 */
+	GPIOD_API void set_event_buffer_size(unsigned int size) const;
+
+	/**
+	 * @brief Get the size of the kernel event buffer of event requests.
+	 * @return Number of events or 0 if the kernel default is used.
+	 */
+	GPIOD_API unsigned int event_buffer_size(void) const;
+
 	/**
 	 * @brief Equality operator.
 	 * @param rhs Right-hand side of the equation.
@@ -192,6 +235,19 @@ public:
 		/**< Assume the string is the number of the GPIO chip. */
 	};
 
+	/**
+	 * @brief Policies deciding when the line info is re-read from the
+	 *        kernel.
+	 */
+	enum : int {
+		LINE_INFO_REFRESH_ALWAYS = 1,
+		/**< Every time a line is retrieved and after requests. */
+		LINE_INFO_REFRESH_IF_STALE,
+		/**< On first access after a line was retrieved or requested. */
+		LINE_INFO_REFRESH_NEVER,
+		/**< Only after chip::invalidate_line_info or line::update. */
+	};
+
 private:
 
 	chip(::gpiod_chip* chip);
@@ -204,6 +260,22 @@ private:
 	friend line_iter;
 };
 
+/**
+ * @brief Overrides the request configuration of a single line.
+ */
+struct line_config
+{
+	unsigned int offset;
+	/**< Hardware offset of the line this config applies to. */
+	int request_type;
+	/**< Type of the request for this line or 0 to use the one of the
+	 *   whole request. */
+	::std::bitset<32> flags;
+	/**< Request flags replacing the ones of the whole request. */
+	::std::chrono::microseconds debounce_period;
+	/**< Debounce period, used if line_request::FLAG_DEBOUNCE is set. */
+};
+
 /**
  * @brief Stores the configuration for line requests.
  */
@@ -233,6 +305,16 @@ struct line_request
 	/**< The line is an open-source port. */
 	GPIOD_API static const ::std::bitset<32> FLAG_OPEN_DRAIN;
 	/**< The line is an open-drain port. */
+	GPIOD_API static const ::std::bitset<32> FLAG_SHARED_EVENT_FD;
+	/**< Request all lines for events with a single file descriptor. */
+	GPIOD_API static const ::std::bitset<32> FLAG_BIAS_DISABLE;
+	/**< Disable the internal bias of the line. */
+	GPIOD_API static const ::std::bitset<32> FLAG_BIAS_PULL_DOWN;
+	/**< Enable the internal pull-down of the line. */
+	GPIOD_API static const ::std::bitset<32> FLAG_BIAS_PULL_UP;
+	/**< Enable the internal pull-up of the line. */
+	GPIOD_API static const ::std::bitset<32> FLAG_DEBOUNCE;
+	/**< Debounce the line using the debounce period. */
 
 	::std::string consumer;
 	/**< Consumer name to pass to the request. */
@@ -240,6 +322,10 @@ struct line_request
 	/**< Type of the request. */
 	::std::bitset<32> flags;
 	/**< Additional request flags. */
+	::std::chrono::microseconds debounce_period;
+	/**< Debounce period, used if FLAG_DEBOUNCE is set. */
+	::std::vector<line_config> line_configs;
+	/**< Per-line overrides of the request configuration. */
 };
 
 /**
@@ -369,6 +455,16 @@ public:
 	 */
 	GPIOD_API void set_value(int val) const;
 
+	/**
+	 * @brief Change the configuration of this line without releasing it.
+	 * @param direction New direction: one of the line_request::DIRECTION_*
+	 *        request types.
+	 * @param flags New request flags.
+	 * @param value New value - only relevant if the direction is output.
+	 */
+	GPIOD_API void set_config(int direction, const ::std::bitset<32>& flags,
+				  int value = 0) const;
+
 	/**
 	 * @brief Wait for an event on this line.
 	 * @param timeout Time to wait before returning if no event occurred.
@@ -463,6 +559,7 @@ private:
 	friend chip;
 	friend line_bulk;
 	friend line_iter;
+	friend event_source;
 };
 
 /**
@@ -494,6 +591,10 @@ struct line_event
 	/**< Type of the event that occurred. */
 	line source;
 	/**< Line object referencing the GPIO line on which the event occurred. */
+	unsigned int seqno;
+	/**< Sequence number of the event among all events of the request. */
+	unsigned int line_seqno;
+	/**< Sequence number of the event among the events of this line. */
 };
 
 /**
@@ -617,6 +718,43 @@ public:
 	 */
 	GPIOD_API void set_values(const ::std::vector<int>& values) const;
 
+	/**
+	 * @brief Read values from all lines held by this object into a bitset.
+	 * @return Bitset in which bit N holds the value of the N-th line in
+	 *         the internal array.
+	 */
+	GPIOD_API ::std::bitset<64> get_values_mask(void) const;
+
+	/**
+	 * @brief Set values of all lines held by this object from a bitset.
+	 * @param values Bitset in which bit N holds the value to set on the
+	 *        N-th line in the internal array.
+	 */
+	GPIOD_API void set_values_mask(const ::std::bitset<64>& values) const;
+
+	/**
+	 * @brief Set values of a subset of lines held by this object.
+	 * @param values Bitset in which bit N holds the value to set on the
+	 *        N-th line in the internal array.
+	 * @param mask Bitset of lines to change. Values of the remaining
+	 *        lines are preserved.
+	 */
+	GPIOD_API void set_values_mask(const ::std::bitset<64>& values,
+				       const ::std::bitset<64>& mask) const;
+
+	/**
+	 * @brief Change the configuration of all lines held by this object
+	 *        without releasing them.
+	 * @param direction New direction: one of the line_request::DIRECTION_*
+	 *        request types.
+	 * @param flags New request flags.
+	 * @param values New values - only relevant if the direction is output.
+	 *        Must be empty or the same size as the number of lines held
+	 *        by this line_bulk.
+	 */
+	GPIOD_API void set_config(int direction, const ::std::bitset<32>& flags,
+				  const ::std::vector<int>& values = ::std::vector<int>()) const;
+
 	/**
 	 * @brief Poll the set of lines for line events.
 	 * @param timeout Number of nanoseconds to wait before returning an
@@ -639,7 +777,10 @@ public:
 	GPIOD_API bool operator!(void) const noexcept;
 
 	/**
-	 * @brief Max number of lines that this object can hold.
+	 * @brief Max number of lines that can be requested with a single kernel
+	 *        line handle. Larger sets of lines are split into several
+	 *        handles internally. The bitmask-based value accessors are
+	 *        limited to this number of lines.
 	 */
 	GPIOD_API static const unsigned int MAX_LINES;
 
@@ -745,8 +886,203 @@ private:
 
 	void throw_if_empty(void) const;
 	void to_line_bulk(::gpiod_line_bulk* bulk) const;
+	::std::shared_ptr<::gpiod_line_array> to_line_array(void) const;
 
 	::std::vector<line> _m_bulk;
+
+	friend event_source;
+	friend pwm;
+};
+
+/**
+ * @brief Aggregates the events of any number of lines behind a single file
+ *        descriptor.
+ *
+ * Lines from any number of chips can be added to an event source together
+ * with callbacks. Whenever the file descriptor of the source becomes readable,
+ * the user calls event_source::dispatch which reads the pending events and
+ * calls the callbacks of the lines on which they occurred. Event sources can
+ * be neither copied nor moved.
+ */
+class event_source
+{
+public:
+
+	/**
+	 * @brief Type of the callbacks called for line events.
+	 */
+	using callback = ::std::function<void (const line_event&)>;
+
+	/**
+	 * @brief Constructor. Creates an empty event source.
+	 */
+	GPIOD_API event_source(void);
+
+	event_source(const event_source& other) = delete;
+	event_source(event_source&& other) = delete;
+	event_source& operator=(const event_source& other) = delete;
+	event_source& operator=(event_source&& other) = delete;
+
+	/**
+	 * @brief Destructor.
+	 */
+	GPIOD_API ~event_source(void) = default;
+
+	/**
+	 * @brief Add a line to this event source.
+	 * @param line_obj Line to add. Must be requested for events.
+	 * @param cb Callback called for every event occurring on the line.
+	 *
+	 * Adding a line which is already in the source replaces its callback.
+	 */
+	GPIOD_API void add(const line& line_obj, const callback& cb);
+
+	/**
+	 * @brief Add a set of lines to this event source.
+	 * @param bulk Lines to add. Must be requested for events.
+	 * @param cb Callback called for every event occurring on the lines.
+	 *
+	 * If adding any of the lines fails, the source is left as it was
+	 * before the call.
+	 */
+	GPIOD_API void add(const line_bulk& bulk, const callback& cb);
+
+	/**
+	 * @brief Remove a line from this event source.
+	 * @param line_obj Line to remove.
+	 *
+	 * Lines must be removed from the source before they are released.
+	 */
+	GPIOD_API void remove(const line& line_obj);
+
+	/**
+	 * @brief Get the file descriptor of this event source.
+	 * @return File descriptor which becomes readable when events are
+	 *         pending on any of the lines.
+	 */
+	GPIOD_API int fd(void) const;
+
+	/**
+	 * @brief Read pending events and pass them to the line callbacks.
+	 * @return Number of events read.
+	 *
+	 * This method never blocks. Exceptions thrown by the callbacks are
+	 * rethrown once all events read in this call have been dispatched.
+	 */
+	GPIOD_API int dispatch(void);
+
+private:
+
+	struct handler
+	{
+		event_source* owner;
+		line source;
+		callback cb;
+	};
+
+	static void handle_event(::gpiod_line* line_ptr,
+				 const ::gpiod_line_event* event_buf,
+				 void* data);
+
+	::std::shared_ptr<::gpiod_event_source> _m_source;
+	::std::map<::gpiod_line*, handler> _m_handlers;
+	::std::exception_ptr _m_error;
+};
+
+/**
+ * @brief Generates pulses on a set of output lines from a dedicated thread.
+ *
+ * Every line of the bulk is a PWM channel, numbered by its index in the bulk.
+ * The edges of all channels are merged into a single schedule so that every
+ * instant at which any channel changes costs a single ioctl. PWM objects can
+ * be neither copied nor moved.
+ */
+class pwm
+{
+public:
+
+	/**
+	 * @brief Timing statistics of a software PWM.
+	 *
+	 * The latency of an edge is the time between its scheduled and its
+	 * actual occurrence.
+	 */
+	struct stats
+	{
+		unsigned long long edges;
+		/**< Number of times the line values were changed. */
+		::std::chrono::nanoseconds min_latency;
+		/**< Lowest latency. */
+		::std::chrono::nanoseconds max_latency;
+		/**< Highest latency. */
+		::std::chrono::nanoseconds total_latency;
+		/**< Sum of the latencies of all edges. */
+	};
+
+	/**
+	 * @brief Constructor. Creates a PWM on the lines of a bulk.
+	 * @param bulk Lines requested together as outputs.
+	 * @param period Initial period of all channels.
+	 *
+	 * The duty cycle of all channels is initially 0.
+	 */
+	GPIOD_API pwm(const line_bulk& bulk, ::std::chrono::nanoseconds period);
+
+	pwm(const pwm& other) = delete;
+	pwm(pwm&& other) = delete;
+	pwm& operator=(const pwm& other) = delete;
+	pwm& operator=(pwm&& other) = delete;
+
+	/**
+	 * @brief Destructor. Stops the PWM.
+	 */
+	GPIOD_API ~pwm(void) = default;
+
+	/**
+	 * @brief Set the scheduling policy and priority of the PWM thread.
+	 * @param policy Scheduling policy.
+	 * @param priority Scheduling priority.
+	 */
+	GPIOD_API void set_sched(int policy, int priority);
+
+	/**
+	 * @brief Pin the PWM thread to a single CPU.
+	 * @param cpu CPU number or -1 to let the thread run on any CPU.
+	 */
+	GPIOD_API void set_cpu(int cpu);
+
+	/**
+	 * @brief Set the period and duty cycle of a channel.
+	 * @param channel Index of the channel.
+	 * @param period Period of the channel.
+	 * @param duty Length of the pulse. Must not exceed the period.
+	 *
+	 * Can be called while the PWM is running. The update takes effect at
+	 * the start of the next period of the channel.
+	 */
+	GPIOD_API void set_channel(unsigned int channel,
+				   ::std::chrono::nanoseconds period,
+				   ::std::chrono::nanoseconds duty);
+
+	/**
+	 * @brief Start generating pulses.
+	 */
+	GPIOD_API void start(void);
+
+	/**
+	 * @brief Stop generating pulses and set all lines to inactive.
+	 */
+	GPIOD_API void stop(void);
+
+	/**
+	 * @brief Get the timing statistics of this PWM.
+	 * @return Statistics since the PWM was last started.
+	 */
+	GPIOD_API stats get_stats(void) const;
+
+private:
+
+	::std::shared_ptr<::gpiod_pwm> _m_pwm;
 };
 
 /**
@@ -817,6 +1153,8 @@ public:
 	/**
 	 * @brief Advance the iterator by one element.
 	 * @return Reference to this iterator.
+	 * @note Chips are opened lazily, so this throws std::system_error if
+	 *       opening the next chip fails.
 	 */
 	GPIOD_API chip_iter& operator++(void);
 
@@ -34,6 +34,20 @@ void line_iter_deleter(::gpiod_line_iter* iter)
 	return iter;
 }
 
+::gpiod_chip* next_chip(::gpiod_chip_iter* iter)
+{
+	::gpiod_chip* chip;
+
+	/* NULL with errno left at 0 means there are no more chips. */
+	errno = 0;
+	chip = ::gpiod_chip_iter_next_noclose(iter);
+	if (!chip && errno)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error opening the next GPIO chip");
+
+	return chip;
+}
+
 } /* namespace */
 
 chip_iter make_chip_iter(void)
@@ -59,7 +73,7 @@ bool chip_iter::operator!=(const chip_iter& rhs) const noexcept
 chip_iter::chip_iter(::gpiod_chip_iter *iter)
 	: _m_iter(iter, chip_iter_deleter)
 {
-	::gpiod_chip* first = ::gpiod_chip_iter_next_noclose(this->_m_iter.get());
+	::gpiod_chip* first = next_chip(this->_m_iter.get());
 
 	if (first != nullptr)
 		this->_m_current = ::std::move(chip(first));
@@ -67,7 +81,7 @@ chip_iter::chip_iter(::gpiod_chip_iter *iter)
 
 chip_iter& chip_iter::operator++(void)
 {
-	::gpiod_chip* next = ::gpiod_chip_iter_next_noclose(this->_m_iter.get());
+	::gpiod_chip* next = next_chip(this->_m_iter.get());
 
 	this->_m_current = next ? chip(next) : chip();
 
@@ -139,6 +139,16 @@ void line::set_value(int val) const
 	bulk.set_values({ val });
 }
 
+void line::set_config(int direction, const ::std::bitset<32>& flags,
+		      int value) const
+{
+	this->throw_if_null();
+
+	line_bulk bulk({ *this });
+
+	bulk.set_config(direction, flags, { value });
+}
+
 bool line::event_wait(const ::std::chrono::nanoseconds& timeout) const
 {
 	this->throw_if_null();
@@ -171,7 +181,14 @@ line_event line::event_read(void) const
 	event.timestamp = ::std::chrono::nanoseconds(
 				event_buf.ts.tv_nsec + (event_buf.ts.tv_sec * 1000000000));
 
-	event.source = *this;
+	/* Lines sharing an event fd receive the events of all of them. */
+	if (event_buf.offset == this->offset())
+		event.source = *this;
+	else
+		event.source = this->_m_chip.get_line(event_buf.offset);
+
+	event.seqno = event_buf.seqno;
+	event.line_seqno = event_buf.line_seqno;
 
 	return ::std::move(event);
 }
@@ -14,6 +14,11 @@ namespace gpiod {
 const ::std::bitset<32> line_request::FLAG_ACTIVE_LOW("001");
 const ::std::bitset<32> line_request::FLAG_OPEN_SOURCE("010");
 const ::std::bitset<32> line_request::FLAG_OPEN_DRAIN("100");
+const ::std::bitset<32> line_request::FLAG_SHARED_EVENT_FD("1000");
+const ::std::bitset<32> line_request::FLAG_BIAS_DISABLE("10000");
+const ::std::bitset<32> line_request::FLAG_BIAS_PULL_DOWN("100000");
+const ::std::bitset<32> line_request::FLAG_BIAS_PULL_UP("1000000");
+const ::std::bitset<32> line_request::FLAG_DEBOUNCE("10000000");
 
 namespace {
 
@@ -38,8 +43,41 @@ const ::std::map<::std::bitset<32>, int, bitset_cmp> reqflag_mapping = {
 	{ line_request::FLAG_ACTIVE_LOW,	GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW, },
 	{ line_request::FLAG_OPEN_DRAIN,	GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN, },
 	{ line_request::FLAG_OPEN_SOURCE,	GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE, },
+	{ line_request::FLAG_SHARED_EVENT_FD,	GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD, },
+	{ line_request::FLAG_BIAS_DISABLE,	GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE, },
+	{ line_request::FLAG_BIAS_PULL_DOWN,	GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN, },
+	{ line_request::FLAG_BIAS_PULL_UP,	GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP, },
+	{ line_request::FLAG_DEBOUNCE,		GPIOD_LINE_REQUEST_FLAG_DEBOUNCE, },
 };
 
+int map_request_flags(const ::std::bitset<32>& flags)
+{
+	int ret = 0;
+
+	for (auto& it: reqflag_mapping) {
+		if ((it.first & flags).to_ulong())
+			ret |= it.second;
+	}
+
+	return ret;
+}
+
+void line_array_deleter(::gpiod_line_array* array)
+{
+	::gpiod_line_array_free(array);
+}
+
+::std::shared_ptr<::gpiod_line_array> make_line_array(void)
+{
+	::gpiod_line_array *array = ::gpiod_line_array_new();
+
+	if (!array)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error allocating the line array");
+
+	return ::std::shared_ptr<::gpiod_line_array>(array, line_array_deleter);
+}
+
 } /* namespace */
 
 const unsigned int line_bulk::MAX_LINES = GPIOD_LINE_BULK_MAX_LINES;
@@ -58,9 +96,6 @@ void line_bulk::append(const line& new_line)
 	if (!new_line)
 		throw ::std::logic_error("line_bulk cannot hold empty line objects");
 
-	if (this->_m_bulk.size() >= MAX_LINES)
-		throw ::std::logic_error("maximum number of lines reached");
-
 	if (this->_m_bulk.size() >= 1 && this->_m_bulk.begin()->get_chip() != new_line.get_chip())
 		throw std::logic_error("line_bulk cannot hold GPIO lines from different chips");
 
@@ -99,24 +134,49 @@ void line_bulk::request(const line_request& config, const std::vector<int> defau
 	if (!default_vals.empty() && this->size() != default_vals.size())
 		throw ::std::invalid_argument("the number of default values must correspond with the number of lines");
 
+	::std::vector<::gpiod_line_config> line_configs;
 	::gpiod_line_request_config conf;
-	::gpiod_line_bulk bulk;
 	int rv;
 
-	this->to_line_bulk(::std::addressof(bulk));
-
 	conf.consumer = config.consumer.c_str();
 	conf.request_type = reqtype_mapping.at(config.request_type);
-	conf.flags = 0;
+	conf.flags = map_request_flags(config.flags);
+	conf.debounce_period_us = (config.flags & line_request::FLAG_DEBOUNCE).any() ?
+				  config.debounce_period.count() : 0;
 
-	for (auto& it: reqflag_mapping) {
-		if ((it.first & config.flags).to_ulong())
-			conf.flags |= it.second;
+	for (auto& it: config.line_configs) {
+		::gpiod_line_config line_conf;
+
+		line_conf.offset = it.offset;
+		line_conf.request_type = it.request_type ?
+				reqtype_mapping.at(it.request_type) : 0;
+		line_conf.flags = map_request_flags(it.flags);
+		line_conf.debounce_period_us = (it.flags & line_request::FLAG_DEBOUNCE).any() ?
+					       it.debounce_period.count() : 0;
+
+		line_configs.push_back(line_conf);
 	}
 
-	rv = ::gpiod_line_request_bulk(::std::addressof(bulk),
-				       ::std::addressof(conf),
-				       default_vals.empty() ? NULL : default_vals.data());
+	conf.line_configs = line_configs.data();
+	conf.num_line_configs = line_configs.size();
+	if (!line_configs.empty())
+		conf.flags |= GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+
+	if (this->_m_bulk.size() <= MAX_LINES) {
+		::gpiod_line_bulk bulk;
+
+		this->to_line_bulk(::std::addressof(bulk));
+
+		rv = ::gpiod_line_request_bulk(::std::addressof(bulk),
+					       ::std::addressof(conf),
+					       default_vals.empty() ? NULL : default_vals.data());
+	} else {
+		auto array = this->to_line_array();
+
+		rv = ::gpiod_line_array_request(array.get(),
+						::std::addressof(conf),
+						default_vals.empty() ? NULL : default_vals.data());
+	}
 	if (rv)
 		throw ::std::system_error(errno, ::std::system_category(),
 					  "error requesting GPIO lines");
@@ -126,11 +186,17 @@ void line_bulk::release(void) const
 {
 	this->throw_if_empty();
 
-	::gpiod_line_bulk bulk;
+	if (this->_m_bulk.size() <= MAX_LINES) {
+		::gpiod_line_bulk bulk;
 
-	this->to_line_bulk(::std::addressof(bulk));
+		this->to_line_bulk(::std::addressof(bulk));
+
+		::gpiod_line_release_bulk(::std::addressof(bulk));
+	} else {
+		auto array = this->to_line_array();
 
-	::gpiod_line_release_bulk(::std::addressof(bulk));
+		::gpiod_line_array_release(array.get());
+	}
 }
 
 ::std::vector<int> line_bulk::get_values(void) const
@@ -138,13 +204,22 @@ void line_bulk::release(void) const
 	this->throw_if_empty();
 
 	::std::vector<int> values;
-	::gpiod_line_bulk bulk;
 	int rv;
 
-	this->to_line_bulk(::std::addressof(bulk));
 	values.resize(this->_m_bulk.size());
 
-	rv = ::gpiod_line_get_value_bulk(::std::addressof(bulk), values.data());
+	if (this->_m_bulk.size() <= MAX_LINES) {
+		::gpiod_line_bulk bulk;
+
+		this->to_line_bulk(::std::addressof(bulk));
+
+		rv = ::gpiod_line_get_value_bulk(::std::addressof(bulk),
+						 values.data());
+	} else {
+		auto array = this->to_line_array();
+
+		rv = ::gpiod_line_array_get_values(array.get(), values.data());
+	}
 	if (rv)
 		throw ::std::system_error(errno, ::std::system_category(),
 					  "error reading GPIO line values");
@@ -159,43 +234,141 @@ void line_bulk::set_values(const ::std::vector<int>& values) const
 	if (values.size() != this->_m_bulk.size())
 		throw ::std::invalid_argument("the size of values array must correspond with the number of lines");
 
+	int rv;
+
+	if (this->_m_bulk.size() <= MAX_LINES) {
+		::gpiod_line_bulk bulk;
+
+		this->to_line_bulk(::std::addressof(bulk));
+
+		rv = ::gpiod_line_set_value_bulk(::std::addressof(bulk),
+						 values.data());
+	} else {
+		auto array = this->to_line_array();
+
+		rv = ::gpiod_line_array_set_values(array.get(), values.data());
+	}
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting GPIO line values");
+}
+
+::std::bitset<64> line_bulk::get_values_mask(void) const
+{
+	this->throw_if_empty();
+
+	::gpiod_line_bulk bulk;
+	uint64_t values;
+	int rv;
+
+	this->to_line_bulk(::std::addressof(bulk));
+
+	rv = ::gpiod_line_get_value_bulk_mask(::std::addressof(bulk),
+					      ::std::addressof(values));
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error reading GPIO line values");
+
+	return ::std::bitset<64>(values);
+}
+
+void line_bulk::set_values_mask(const ::std::bitset<64>& values) const
+{
+	this->throw_if_empty();
+
 	::gpiod_line_bulk bulk;
 	int rv;
 
 	this->to_line_bulk(::std::addressof(bulk));
 
-	rv = ::gpiod_line_set_value_bulk(::std::addressof(bulk), values.data());
+	rv = ::gpiod_line_set_value_bulk_mask(::std::addressof(bulk),
+					      values.to_ullong());
 	if (rv)
 		throw ::std::system_error(errno, ::std::system_category(),
 					  "error setting GPIO line values");
 }
 
-line_bulk line_bulk::event_wait(const ::std::chrono::nanoseconds& timeout) const
+void line_bulk::set_values_mask(const ::std::bitset<64>& values,
+				const ::std::bitset<64>& mask) const
 {
 	this->throw_if_empty();
 
-	::gpiod_line_bulk bulk, event_bulk;
-	::timespec ts;
-	line_bulk ret;
+	::gpiod_line_bulk bulk;
 	int rv;
 
 	this->to_line_bulk(::std::addressof(bulk));
 
-	::gpiod_line_bulk_init(::std::addressof(event_bulk));
+	rv = ::gpiod_line_set_value_bulk_masked(::std::addressof(bulk),
+						mask.to_ullong(),
+						values.to_ullong());
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting GPIO line values");
+}
+
+void line_bulk::set_config(int direction, const ::std::bitset<32>& flags,
+			   const ::std::vector<int>& values) const
+{
+	this->throw_if_empty();
+
+	if (!values.empty() && this->_m_bulk.size() != values.size())
+		throw ::std::invalid_argument("the size of values array must correspond with the number of lines");
+
+	::gpiod_line_bulk bulk;
+	int rv;
+
+	this->to_line_bulk(::std::addressof(bulk));
+
+	rv = ::gpiod_line_set_config_bulk(::std::addressof(bulk),
+					  reqtype_mapping.at(direction),
+					  map_request_flags(flags),
+					  values.empty() ? NULL : values.data());
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting GPIO line config");
+}
+
+line_bulk line_bulk::event_wait(const ::std::chrono::nanoseconds& timeout) const
+{
+	this->throw_if_empty();
+
+	::timespec ts;
+	line_bulk ret;
+	int rv;
 
 	ts.tv_sec = timeout.count() / 1000000000ULL;
 	ts.tv_nsec = timeout.count() % 1000000000ULL;
 
-	rv = ::gpiod_line_event_wait_bulk(::std::addressof(bulk),
-					  ::std::addressof(ts),
-					  ::std::addressof(event_bulk));
-	if (rv < 0) {
+	if (this->_m_bulk.size() <= MAX_LINES) {
+		::gpiod_line_bulk bulk, event_bulk;
+
+		this->to_line_bulk(::std::addressof(bulk));
+		::gpiod_line_bulk_init(::std::addressof(event_bulk));
+
+		rv = ::gpiod_line_event_wait_bulk(::std::addressof(bulk),
+						  ::std::addressof(ts),
+						  ::std::addressof(event_bulk));
+		if (rv > 0) {
+			for (unsigned int i = 0; i < event_bulk.num_lines; i++)
+				ret.append(line(event_bulk.lines[i],
+						this->_m_bulk[0].get_chip()));
+		}
+	} else {
+		auto array = this->to_line_array();
+		auto event_array = make_line_array();
+
+		rv = ::gpiod_line_array_event_wait(array.get(),
+						   ::std::addressof(ts),
+						   event_array.get());
+		if (rv > 0) {
+			for (unsigned int i = 0; i < ::gpiod_line_array_num_lines(event_array.get()); i++)
+				ret.append(line(::gpiod_line_array_get_line(event_array.get(), i),
+						this->_m_bulk[0].get_chip()));
+		}
+	}
+	if (rv < 0)
 		throw ::std::system_error(errno, ::std::system_category(),
 					  "error polling for events");
-	} else if (rv > 0) {
-		for (unsigned int i = 0; i < event_bulk.num_lines; i++)
-			ret.append(line(event_bulk.lines[i], this->_m_bulk[i].get_chip()));
-	}
 
 	return ::std::move(ret);
 }
@@ -261,9 +434,27 @@ void line_bulk::throw_if_empty(void) const
 
 void line_bulk::to_line_bulk(::gpiod_line_bulk *bulk) const
 {
+	if (this->_m_bulk.size() > MAX_LINES)
+		throw ::std::logic_error("too many lines for a single line handle");
+
 	::gpiod_line_bulk_init(bulk);
 	for (auto& it: this->_m_bulk)
 		::gpiod_line_bulk_add(bulk, it._m_line);
 }
 
+::std::shared_ptr<::gpiod_line_array> line_bulk::to_line_array(void) const
+{
+	auto array = make_line_array();
+	int rv;
+
+	for (auto& it: this->_m_bulk) {
+		rv = ::gpiod_line_array_add(array.get(), it._m_line);
+		if (rv)
+			throw ::std::system_error(errno, ::std::system_category(),
+						  "error adding line to the line array");
+	}
+
+	return array;
+}
+
 } /* namespace gpiod */
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+#include <cstdint>
+#include <gpiod.hpp>
+#include <stdexcept>
+#include <system_error>
+
+namespace gpiod {
+
+namespace {
+
+void pwm_deleter(::gpiod_pwm* pwm)
+{
+	::gpiod_pwm_free(pwm);
+}
+
+::std::uint32_t duration_to_ns(::std::chrono::nanoseconds duration)
+{
+	if (duration.count() < 0 || duration.count() > UINT32_MAX)
+		throw ::std::out_of_range("PWM period and duty cycle must fit in 32 bits");
+
+	return duration.count();
+}
+
+::std::shared_ptr<::gpiod_pwm> make_pwm(::gpiod_line_bulk* bulk,
+					::std::chrono::nanoseconds period)
+{
+	::gpiod_pwm *pwm = ::gpiod_pwm_new(bulk, duration_to_ns(period));
+
+	if (!pwm)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error creating the PWM");
+
+	return ::std::shared_ptr<::gpiod_pwm>(pwm, pwm_deleter);
+}
+
+} /* namespace */
+
+pwm::pwm(const line_bulk& bulk, ::std::chrono::nanoseconds period)
+	: _m_pwm()
+{
+	::gpiod_line_bulk bulk_buf;
+
+	bulk.throw_if_empty();
+	bulk.to_line_bulk(::std::addressof(bulk_buf));
+
+	this->_m_pwm = make_pwm(::std::addressof(bulk_buf), period);
+}
+
+void pwm::set_sched(int policy, int priority)
+{
+	int rv = ::gpiod_pwm_set_sched(this->_m_pwm.get(), policy, priority);
+
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting the PWM scheduling policy");
+}
+
+void pwm::set_cpu(int cpu)
+{
+	int rv = ::gpiod_pwm_set_cpu(this->_m_pwm.get(), cpu);
+
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting the PWM CPU");
+}
+
+void pwm::set_channel(unsigned int channel, ::std::chrono::nanoseconds period,
+		      ::std::chrono::nanoseconds duty)
+{
+	int rv = ::gpiod_pwm_set_channel(this->_m_pwm.get(), channel,
+					 duration_to_ns(period),
+					 duration_to_ns(duty));
+
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error setting the PWM channel");
+}
+
+void pwm::start(void)
+{
+	int rv = ::gpiod_pwm_start(this->_m_pwm.get());
+
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error starting the PWM");
+}
+
+void pwm::stop(void)
+{
+	::gpiod_pwm_stop(this->_m_pwm.get());
+}
+
+pwm::stats pwm::get_stats(void) const
+{
+	::gpiod_pwm_stats stats_buf;
+	stats ret;
+
+	int rv = ::gpiod_pwm_get_stats(this->_m_pwm.get(),
+				       ::std::addressof(stats_buf));
+	if (rv)
+		throw ::std::system_error(errno, ::std::system_category(),
+					  "error generating PWM pulses");
+
+	ret.edges = stats_buf.edges;
+	ret.min_latency = ::std::chrono::nanoseconds(stats_buf.min_latency);
+	ret.max_latency = ::std::chrono::nanoseconds(stats_buf.max_latency);
+	ret.total_latency = ::std::chrono::nanoseconds(stats_buf.total_latency);
+
+	return ret;
+}
+
+} /* namespace gpiod */
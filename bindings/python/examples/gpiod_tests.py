@@ -15,6 +15,7 @@ system and that it's detected as gpiochip0.
 
 import gpiod
 import select
+import time
 
 test_cases = []
 
@@ -323,6 +324,48 @@ def request_multiple_lines_with_default_values():
 
 add_test('Request multiple lines with default values', request_multiple_lines_with_default_values)
 
+def set_get_values_mask():
+    with gpiod.Chip('gpiochip0') as chip:
+        lines = chip.get_lines(( 1, 2, 3, 4, 5 ))
+        lines.request(consumer='gpiod_test.py', type=gpiod.LINE_REQ_DIR_OUT)
+
+        print('setting line values using a bitmask')
+        lines.set_values_mask(0b10101)
+        vals = lines.get_values_mask()
+        print('line values after setting: {}'.format(bin(vals)))
+        assert vals == 0b10101
+
+        print('changing a subset of lines using a bitmask')
+        lines.set_values_mask(0b00010, 0b00011)
+        vals = lines.get_values_mask()
+        print('line values after setting: {}'.format(bin(vals)))
+        assert vals == 0b10110
+
+add_test('Set and get values using bitmasks', set_get_values_mask)
+
+def software_pwm():
+    with gpiod.Chip('gpiochip0') as chip:
+        lines = chip.get_lines(( 1, 2, 3 ))
+        lines.request(consumer='gpiod_test.py', type=gpiod.LINE_REQ_DIR_OUT)
+
+        pwm = gpiod.PWM(lines, 10000000)
+        pwm.set_channel(0, 10000000, 5000000)
+        pwm.set_channel(1, 5000000, 1000000)
+        pwm.set_channel(2, 10000000, 10000000)
+
+        print('generating pulses for 100ms')
+        pwm.start()
+        time.sleep(0.1)
+
+        edges, min_latency, max_latency, total_latency = pwm.stats()
+        pwm.stop()
+
+        print('edges: {}, max latency: {}ns'.format(edges, max_latency))
+        assert edges > 0, 'Expected the PWM to generate edges'
+        assert lines.get_values_mask() == 0
+
+add_test('Generate pulses using a software PWM', software_pwm)
+
 def request_line_incorrect_number_of_def_vals():
     with gpiod.Chip('gpiochip0') as chip:
         lines = chip.get_lines(( 1, 2, 3, 4, 5 ))
@@ -413,6 +456,76 @@ def line_event_poll_fd():
 
 add_test('Monitor multiple lines using their file descriptors', line_event_poll_fd)
 
+def line_event_source():
+    chip = gpiod.Chip('gpiochip0')
+    lines = chip.get_lines((1, 2, 3, 4))
+    print('requesting lines for events')
+    lines.request(consumer="gpiod_test.py", type=gpiod.LINE_REQ_EV_BOTH_EDGES)
+
+    events = []
+    source = gpiod.EventSource()
+    source.add(lines, lambda event: events.append(event))
+
+    print('generating two line events')
+    fire_line_event('gpiochip0', 2, True)
+    fire_line_event('gpiochip0', 4, False)
+
+    while len(events) < 2:
+        readable, writable, exceptional = select.select([source], [], [], 1.0)
+        assert len(readable) == 1, 'Expected the event source to be readable'
+        source.dispatch()
+
+    print('events received:')
+    for event in events:
+        print_event(event)
+
+    chip.close()
+
+add_test('Monitor multiple lines using an event source', line_event_source)
+
+def line_event_source_add_bulk_rollback():
+    with gpiod.Chip('gpiochip0') as chip:
+        lines = chip.get_lines((1, 2))
+        lines.request(consumer="gpiod_test.py",
+                      type=gpiod.LINE_REQ_EV_BOTH_EDGES)
+        line_in = chip.get_line(6)
+        line_in.request(consumer="gpiod_test.py", type=gpiod.LINE_REQ_DIR_IN)
+        line1, line2 = lines.to_list()
+
+        first = []
+        second = []
+        source = gpiod.EventSource()
+        source.add(line1, lambda event: first.append(event))
+
+        print('adding a bulk with a line not requested for events')
+        bulk = gpiod.LineBulk([line1, line2, line_in])
+        try:
+            source.add(bulk, lambda event: second.append(event))
+            assert False, 'OSError expected'
+        except OSError:
+            pass
+
+        try:
+            source.remove(line2)
+            assert False, 'line 2 should have been removed'
+        except OSError:
+            pass
+
+        # Toggle both ways, the line may have been left high.
+        fire_line_event('gpiochip0', 1, False)
+        fire_line_event('gpiochip0', 1, True)
+
+        readable, writable, exceptional = select.select([source], [], [], 1.0)
+        assert len(readable) == 1, 'Expected the event source to be readable'
+        source.dispatch()
+
+        assert len(first) > 0 and len(second) == 0, \
+            'line 1 lost its original callback'
+        print('the source was left intact')
+
+add_test('Failed event source bulk add leaves the source intact',
+         line_event_source_add_bulk_rollback)
+
 def line_event_repr():
     with gpiod.Chip('gpiochip0') as chip:
         line = chip.get_line(1)
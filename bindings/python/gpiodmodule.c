@@ -43,6 +43,18 @@ typedef struct {
 	gpiod_ChipObject *owner;
 } gpiod_LineIterObject;
 
+typedef struct {
+	PyObject_HEAD
+	struct gpiod_event_source *source;
+	PyObject *handlers;
+} gpiod_EventSourceObject;
+
+typedef struct {
+	PyObject_HEAD
+	struct gpiod_pwm *pwm;
+	PyObject *bulk;
+} gpiod_PWMObject;
+
 static gpiod_LineBulkObject *gpiod_LineToLineBulk(gpiod_LineObject *line);
 static gpiod_LineObject *gpiod_MakeLineObject(gpiod_ChipObject *owner,
 					      struct gpiod_line *line);
@@ -60,6 +72,10 @@ enum {
 	gpiod_LINE_REQ_FLAG_OPEN_DRAIN		= GPIOD_BIT(0),
 	gpiod_LINE_REQ_FLAG_OPEN_SOURCE		= GPIOD_BIT(1),
 	gpiod_LINE_REQ_FLAG_ACTIVE_LOW		= GPIOD_BIT(2),
+	gpiod_LINE_REQ_FLAG_SHARED_EVENT_FD	= GPIOD_BIT(3),
+	gpiod_LINE_REQ_FLAG_BIAS_DISABLE	= GPIOD_BIT(4),
+	gpiod_LINE_REQ_FLAG_BIAS_PULL_DOWN	= GPIOD_BIT(5),
+	gpiod_LINE_REQ_FLAG_BIAS_PULL_UP	= GPIOD_BIT(6),
 };
 
 enum {
@@ -159,6 +175,24 @@ gpiod_LineObject *gpiod_LineEvent_get_source(gpiod_LineEventObject *self)
 	return self->source;
 }
 
+PyDoc_STRVAR(gpiod_LineEvent_get_seqno_doc,
+"Sequence number of this event among all events of the line request or 0\n"
+"if the kernel doesn't report it (integer).");
+
+PyObject *gpiod_LineEvent_get_seqno(gpiod_LineEventObject *self)
+{
+	return Py_BuildValue("I", self->event.seqno);
+}
+
+PyDoc_STRVAR(gpiod_LineEvent_get_line_seqno_doc,
+"Sequence number of this event among the events of its line or 0 if the\n"
+"kernel doesn't report it (integer).");
+
+PyObject *gpiod_LineEvent_get_line_seqno(gpiod_LineEventObject *self)
+{
+	return Py_BuildValue("I", self->event.line_seqno);
+}
+
 static PyGetSetDef gpiod_LineEvent_getset[] = {
 	{
 		.name = "type",
@@ -180,6 +214,16 @@ static PyGetSetDef gpiod_LineEvent_getset[] = {
 		.get = (getter)gpiod_LineEvent_get_source,
 		.doc = gpiod_LineEvent_get_source_doc,
 	},
+	{
+		.name = "seqno",
+		.get = (getter)gpiod_LineEvent_get_seqno,
+		.doc = gpiod_LineEvent_get_seqno_doc,
+	},
+	{
+		.name = "line_seqno",
+		.get = (getter)gpiod_LineEvent_get_line_seqno,
+		.doc = gpiod_LineEvent_get_line_seqno_doc,
+	},
 	{ }
 };
 
@@ -404,7 +448,9 @@ PyDoc_STRVAR(gpiod_Line_request_doc,
 "  flags\n"
 "    Other configuration flags.\n"
 "  default_val\n"
-"    Default value of this line."
+"    Default value of this line.\n"
+"  debounce_period_us\n"
+"    Debounce period of this line in microseconds.\n"
 "\n"
 "Note: default_vals argument (sequence of default values passed down to\n"
 "LineBulk.request()) is still supported for backward compatibility but is\n"
@@ -542,6 +588,43 @@ static PyObject *gpiod_Line_set_value(gpiod_LineObject *self, PyObject *args)
 	return ret;
 }
 
+PyDoc_STRVAR(gpiod_Line_set_config_doc,
+"set_config(direction[, flags[, value]]) -> None\n"
+"\n"
+"Change the configuration of this GPIO line without releasing it.\n"
+"\n"
+"  direction\n"
+"    New direction: one of the LINE_REQ_DIR_* request types.\n"
+"  flags\n"
+"    New request flags.\n"
+"  value\n"
+"    New value - only relevant if the direction is output.");
+
+static PyObject *gpiod_Line_set_config(gpiod_LineObject *self,
+				       PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "direction", "flags", "value", NULL };
+
+	int rv, direction, flags = 0, value = 0;
+	gpiod_LineBulkObject *bulk_obj;
+	PyObject *ret;
+
+	rv = PyArg_ParseTupleAndKeywords(args, kwds, "i|ii", kwlist,
+					 &direction, &flags, &value);
+	if (!rv)
+		return NULL;
+
+	bulk_obj = gpiod_LineToLineBulk(self);
+	if (!bulk_obj)
+		return NULL;
+
+	ret = PyObject_CallMethod((PyObject *)bulk_obj, "set_config",
+				  "ii(i)", direction, flags, value);
+	Py_DECREF(bulk_obj);
+
+	return ret;
+}
+
 PyDoc_STRVAR(gpiod_Line_release_doc,
 "release() -> None\n"
 "\n"
@@ -608,6 +691,7 @@ PyDoc_STRVAR(gpiod_Line_event_read_doc,
 static gpiod_LineEventObject *gpiod_Line_event_read(gpiod_LineObject *self)
 {
 	gpiod_LineEventObject *ret;
+	struct gpiod_line *line;
 	int rv;
 
 	if (gpiod_ChipIsClosed(self->owner))
@@ -628,6 +712,25 @@ static gpiod_LineEventObject *gpiod_Line_event_read(gpiod_LineObject *self)
 		return NULL;
 	}
 
+	/* Lines sharing an event fd receive the events of all of them. */
+	if (ret->event.offset != gpiod_line_offset(self->line)) {
+		line = gpiod_chip_get_line(self->owner->chip,
+					   ret->event.offset);
+		if (!line) {
+			PyErr_SetFromErrno(PyExc_OSError);
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		ret->source = gpiod_MakeLineObject(self->owner, line);
+		if (!ret->source) {
+			Py_DECREF(ret);
+			return NULL;
+		}
+
+		return ret;
+	}
+
 	Py_INCREF(self);
 	ret->source = self;
 
@@ -755,6 +858,12 @@ static PyMethodDef gpiod_Line_methods[] = {
 		.ml_flags = METH_VARARGS,
 		.ml_doc = gpiod_Line_set_value_doc,
 	},
+	{
+		.ml_name = "set_config",
+		.ml_meth = (PyCFunction)gpiod_Line_set_config,
+		.ml_flags = METH_VARARGS | METH_KEYWORDS,
+		.ml_doc = gpiod_Line_set_config_doc,
+	},
 	{
 		.ml_name = "release",
 		.ml_meth = (PyCFunction)gpiod_Line_release,
@@ -827,11 +936,6 @@ static int gpiod_LineBulk_init(gpiod_LineBulkObject *self, PyObject *args)
 				"Argument must be a non-empty sequence");
 		return -1;
 	}
-	if (self->num_lines > GPIOD_LINE_BULK_MAX_LINES) {
-		PyErr_SetString(PyExc_TypeError,
-				"Too many objects in the sequence");
-		return -1;
-	}
 
 	self->lines = PyMem_Calloc(self->num_lines, sizeof(PyObject *));
 	if (!self->lines) {
@@ -933,60 +1037,202 @@ static PyObject *gpiod_LineBulk_to_list(gpiod_LineBulkObject *self)
 	return list;
 }
 
-static void gpiod_LineBulkObjToCLineBulk(gpiod_LineBulkObject *bulk_obj,
-					 struct gpiod_line_bulk *bulk)
+static int gpiod_LineBulkObjToCLineBulk(gpiod_LineBulkObject *bulk_obj,
+					struct gpiod_line_bulk *bulk)
 {
 	gpiod_LineObject *line_obj;
 	Py_ssize_t i;
 
+	if (bulk_obj->num_lines > GPIOD_LINE_BULK_MAX_LINES) {
+		PyErr_SetString(PyExc_ValueError,
+				"Too many lines for this operation");
+		return -1;
+	}
+
 	gpiod_line_bulk_init(bulk);
 
 	for (i = 0; i < bulk_obj->num_lines; i++) {
 		line_obj = (gpiod_LineObject *)bulk_obj->lines[i];
 		gpiod_line_bulk_add(bulk, line_obj->line);
 	}
+
+	return 0;
+}
+
+/*
+ * Lines that fit in a single line handle are passed to the bulk routines in a
+ * bulk object on the stack. A line array is only allocated for more lines.
+ */
+struct gpiod_CLines {
+	struct gpiod_line_bulk bulk;
+	struct gpiod_line_array *array;
+};
+
+static int gpiod_LineBulkObjToCLines(gpiod_LineBulkObject *bulk_obj,
+				     struct gpiod_CLines *lines)
+{
+	gpiod_LineObject *line_obj;
+	Py_ssize_t i;
+	int rv;
+
+	lines->array = NULL;
+
+	if (bulk_obj->num_lines <= GPIOD_LINE_BULK_MAX_LINES)
+		return gpiod_LineBulkObjToCLineBulk(bulk_obj, &lines->bulk);
+
+	lines->array = gpiod_line_array_new();
+	if (!lines->array) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+
+	for (i = 0; i < bulk_obj->num_lines; i++) {
+		line_obj = (gpiod_LineObject *)bulk_obj->lines[i];
+
+		rv = gpiod_line_array_add(lines->array, line_obj->line);
+		if (rv) {
+			PyErr_SetFromErrno(PyExc_OSError);
+			gpiod_line_array_free(lines->array);
+			return -1;
+		}
+	}
+
+	return 0;
 }
 
-static void gpiod_MakeRequestConfig(struct gpiod_line_request_config *conf,
-				    const char *consumer,
-				    int request_type, int flags)
+static void gpiod_CLinesFree(struct gpiod_CLines *lines)
 {
-	memset(conf, 0, sizeof(*conf));
+	if (lines->array)
+		gpiod_line_array_free(lines->array);
+}
 
-	conf->consumer = consumer;
+static unsigned int gpiod_CLinesNumLines(struct gpiod_CLines *lines)
+{
+	return lines->array ? gpiod_line_array_num_lines(lines->array)
+			    : gpiod_line_bulk_num_lines(&lines->bulk);
+}
+
+static struct gpiod_line *gpiod_CLinesGetLine(struct gpiod_CLines *lines,
+					      unsigned int index)
+{
+	return lines->array ? gpiod_line_array_get_line(lines->array, index)
+			    : gpiod_line_bulk_get_line(&lines->bulk, index);
+}
 
+static int gpiod_MapRequestType(int request_type)
+{
 	switch (request_type) {
 	case gpiod_LINE_REQ_DIR_IN:
-		conf->request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
-		break;
+		return GPIOD_LINE_REQUEST_DIRECTION_INPUT;
 	case gpiod_LINE_REQ_DIR_OUT:
-		conf->request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
-		break;
+		return GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
 	case gpiod_LINE_REQ_EV_FALLING_EDGE:
-		conf->request_type = GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE;
-		break;
+		return GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE;
 	case gpiod_LINE_REQ_EV_RISING_EDGE:
-		conf->request_type = GPIOD_LINE_REQUEST_EVENT_RISING_EDGE;
-		break;
+		return GPIOD_LINE_REQUEST_EVENT_RISING_EDGE;
 	case gpiod_LINE_REQ_EV_BOTH_EDGES:
-		conf->request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
-		break;
+		return GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
 	case gpiod_LINE_REQ_DIR_AS_IS:
 	default:
-		conf->request_type = GPIOD_LINE_REQUEST_DIRECTION_AS_IS;
-		break;
+		return GPIOD_LINE_REQUEST_DIRECTION_AS_IS;
 	}
+}
+
+static int gpiod_MapRequestFlags(int flags)
+{
+	int ret = 0;
 
 	if (flags & gpiod_LINE_REQ_FLAG_OPEN_DRAIN)
-		conf->flags |= GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN;
+		ret |= GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN;
 	if (flags & gpiod_LINE_REQ_FLAG_OPEN_SOURCE)
-		conf->flags |= GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE;
+		ret |= GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE;
 	if (flags & gpiod_LINE_REQ_FLAG_ACTIVE_LOW)
-		conf->flags |= GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW;
+		ret |= GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW;
+	if (flags & gpiod_LINE_REQ_FLAG_SHARED_EVENT_FD)
+		ret |= GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD;
+	if (flags & gpiod_LINE_REQ_FLAG_BIAS_DISABLE)
+		ret |= GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE;
+	if (flags & gpiod_LINE_REQ_FLAG_BIAS_PULL_DOWN)
+		ret |= GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN;
+	if (flags & gpiod_LINE_REQ_FLAG_BIAS_PULL_UP)
+		ret |= GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP;
+
+	return ret;
+}
+
+static void gpiod_MakeRequestConfig(struct gpiod_line_request_config *conf,
+				    const char *consumer,
+				    int request_type, int flags)
+{
+	memset(conf, 0, sizeof(*conf));
+
+	conf->consumer = consumer;
+	conf->request_type = gpiod_MapRequestType(request_type);
+	conf->flags = gpiod_MapRequestFlags(flags);
+}
+
+/*
+ * Converts the line_configs dictionary passed to request() - mapping line
+ * offsets to (type, flags[, debounce_period_us]) tuples - to an array of
+ * per-line configs. Type 0 means: use the type of the whole request.
+ */
+static struct gpiod_line_config *
+gpiod_MakeLineConfigs(PyObject *line_configs_obj, unsigned int *num_configs)
+{
+	struct gpiod_line_config *line_configs, *line_conf;
+	PyObject *key, *value;
+	Py_ssize_t pos = 0;
+	int rv, type, flags;
+
+	if (!PyDict_Check(line_configs_obj)) {
+		PyErr_SetString(PyExc_TypeError,
+				"line_configs must be a dictionary");
+		return NULL;
+	}
+
+	*num_configs = PyDict_Size(line_configs_obj);
+	line_configs = PyMem_Calloc(*num_configs + 1, sizeof(*line_configs));
+	if (!line_configs) {
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	line_conf = line_configs;
+	while (PyDict_Next(line_configs_obj, &pos, &key, &value)) {
+		line_conf->offset = PyLong_AsUnsignedLong(key);
+		if (PyErr_Occurred())
+			goto err_out;
+
+		if (!PyTuple_Check(value)) {
+			PyErr_SetString(PyExc_TypeError,
+					"line config must be a tuple");
+			goto err_out;
+		}
+
+		type = flags = 0;
+		rv = PyArg_ParseTuple(value, "ii|I", &type, &flags,
+				      &line_conf->debounce_period_us);
+		if (!rv)
+			goto err_out;
+
+		if (type)
+			line_conf->request_type = gpiod_MapRequestType(type);
+		line_conf->flags = gpiod_MapRequestFlags(flags);
+		if (line_conf->debounce_period_us)
+			line_conf->flags |= GPIOD_LINE_REQUEST_FLAG_DEBOUNCE;
+
+		line_conf++;
+	}
+
+	return line_configs;
+
+err_out:
+	PyMem_Free(line_configs);
+	return NULL;
 }
 
 PyDoc_STRVAR(gpiod_LineBulk_request_doc,
-"request(consumer[, type[, flags[, default_vals]]]) -> None\n"
+"request(consumer[, type[, flags[, default_vals[, debounce_period_us[, line_configs]]]]]) -> None\n"
 "\n"
 "Request all lines held by this LineBulk object.\n"
 "\n"
@@ -997,7 +1243,13 @@ PyDoc_STRVAR(gpiod_LineBulk_request_doc,
 "  flags\n"
 "    Other configuration flags.\n"
 "  default_vals\n"
-"    List of default values.\n");
+"    List of default values.\n"
+"  debounce_period_us\n"
+"    Debounce period of the lines in microseconds.\n"
+"  line_configs\n"
+"    Dictionary mapping line offsets to (type, flags[, debounce_period_us])\n"
+"    tuples overriding the config of the request for single lines. Type 0\n"
+"    keeps the type of the request.\n");
 
 static PyObject *gpiod_LineBulk_request(gpiod_LineBulkObject *self,
 					PyObject *args, PyObject *kwds)
@@ -1006,13 +1258,17 @@ static PyObject *gpiod_LineBulk_request(gpiod_LineBulkObject *self,
 				  "type",
 				  "flags",
 				  "default_vals",
+				  "debounce_period_us",
+				  "line_configs",
 				  NULL };
 
 	int rv, type = gpiod_LINE_REQ_DIR_AS_IS, flags = 0,
-	    default_vals[GPIOD_LINE_BULK_MAX_LINES], val;
-	PyObject *def_vals_obj = NULL, *iter, *next;
+	    *default_vals = NULL, val;
+	PyObject *def_vals_obj = NULL, *line_configs_obj = NULL, *iter, *next;
+	struct gpiod_line_config *line_configs = NULL;
 	struct gpiod_line_request_config conf;
-	struct gpiod_line_bulk bulk;
+	unsigned int debounce_period_us = 0;
+	struct gpiod_CLines lines;
 	Py_ssize_t num_def_vals;
 	char *consumer = NULL;
 	Py_ssize_t i;
@@ -1020,28 +1276,52 @@ static PyObject *gpiod_LineBulk_request(gpiod_LineBulkObject *self,
 	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	rv = PyArg_ParseTupleAndKeywords(args, kwds, "s|iiO", kwlist,
+	rv = PyArg_ParseTupleAndKeywords(args, kwds, "s|iiOIO", kwlist,
 					 &consumer, &type,
-					 &flags, &def_vals_obj);
+					 &flags, &def_vals_obj,
+					 &debounce_period_us,
+					 &line_configs_obj);
 	if (!rv)
 		return NULL;
 
-	gpiod_LineBulkObjToCLineBulk(self, &bulk);
 	gpiod_MakeRequestConfig(&conf, consumer, type, flags);
 
-	if (def_vals_obj) {
-		memset(default_vals, 0, sizeof(default_vals));
+	if (debounce_period_us) {
+		conf.flags |= GPIOD_LINE_REQUEST_FLAG_DEBOUNCE;
+		conf.debounce_period_us = debounce_period_us;
+	}
+
+	if (line_configs_obj && line_configs_obj != Py_None) {
+		line_configs = gpiod_MakeLineConfigs(line_configs_obj,
+						     &conf.num_line_configs);
+		if (!line_configs)
+			return NULL;
+
+		conf.line_configs = line_configs;
+		conf.flags |= GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+	}
 
+	if (def_vals_obj) {
 		num_def_vals = PyObject_Size(def_vals_obj);
 		if (num_def_vals != self->num_lines) {
 			PyErr_SetString(PyExc_TypeError,
 					"Number of default values is not the same as the number of lines");
+			PyMem_Free(line_configs);
 			return NULL;
 		}
 
+		default_vals = PyMem_Calloc(self->num_lines, sizeof(int));
+		if (!default_vals) {
+			PyMem_Free(line_configs);
+			return PyErr_NoMemory();
+		}
+
 		iter = PyObject_GetIter(def_vals_obj);
-		if (!iter)
+		if (!iter) {
+			PyMem_Free(default_vals);
+			PyMem_Free(line_configs);
 			return NULL;
+		}
 
 		for (i = 0;; i++) {
 			next = PyIter_Next(iter);
@@ -1054,6 +1334,8 @@ static PyObject *gpiod_LineBulk_request(gpiod_LineBulkObject *self,
 			Py_DECREF(next);
 			if (PyErr_Occurred()) {
 				Py_DECREF(iter);
+				PyMem_Free(default_vals);
+				PyMem_Free(line_configs);
 				return NULL;
 			}
 
@@ -1061,9 +1343,22 @@ static PyObject *gpiod_LineBulk_request(gpiod_LineBulkObject *self,
 		}
 	}
 
+	if (gpiod_LineBulkObjToCLines(self, &lines)) {
+		PyMem_Free(default_vals);
+		PyMem_Free(line_configs);
+		return NULL;
+	}
+
 	Py_BEGIN_ALLOW_THREADS;
-	rv = gpiod_line_request_bulk(&bulk, &conf, default_vals);
+	if (lines.array)
+		rv = gpiod_line_array_request(lines.array, &conf,
+					      default_vals);
+	else
+		rv = gpiod_line_request_bulk(&lines.bulk, &conf, default_vals);
 	Py_END_ALLOW_THREADS;
+	gpiod_CLinesFree(&lines);
+	PyMem_Free(default_vals);
+	PyMem_Free(line_configs);
 	if (rv) {
 		PyErr_SetFromErrno(PyExc_OSError);
 		return NULL;
@@ -1081,33 +1376,47 @@ PyDoc_STRVAR(gpiod_LineBulk_get_values_doc,
 
 static PyObject *gpiod_LineBulk_get_values(gpiod_LineBulkObject *self)
 {
-	int rv, vals[GPIOD_LINE_BULK_MAX_LINES];
-	struct gpiod_line_bulk bulk;
+	struct gpiod_CLines lines;
 	PyObject *val_list, *val;
 	Py_ssize_t i;
+	int rv, *vals;
 
 	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	gpiod_LineBulkObjToCLineBulk(self, &bulk);
+	vals = PyMem_Calloc(self->num_lines, sizeof(int));
+	if (!vals)
+		return PyErr_NoMemory();
+
+	if (gpiod_LineBulkObjToCLines(self, &lines)) {
+		PyMem_Free(vals);
+		return NULL;
+	}
 
-	memset(vals, 0, sizeof(vals));
 	Py_BEGIN_ALLOW_THREADS;
-	rv = gpiod_line_get_value_bulk(&bulk, vals);
+	if (lines.array)
+		rv = gpiod_line_array_get_values(lines.array, vals);
+	else
+		rv = gpiod_line_get_value_bulk(&lines.bulk, vals);
 	Py_END_ALLOW_THREADS;
+	gpiod_CLinesFree(&lines);
 	if (rv) {
+		PyMem_Free(vals);
 		PyErr_SetFromErrno(PyExc_OSError);
 		return NULL;
 	}
 
 	val_list = PyList_New(self->num_lines);
-	if (!val_list)
+	if (!val_list) {
+		PyMem_Free(vals);
 		return NULL;
+	}
 
 	for (i = 0; i < self->num_lines; i++) {
 		val = Py_BuildValue("i", vals[i]);
 		if (!val) {
 			Py_DECREF(val_list);
+			PyMem_Free(vals);
 			return NULL;
 		}
 
@@ -1115,10 +1424,13 @@ static PyObject *gpiod_LineBulk_get_values(gpiod_LineBulkObject *self)
 		if (rv < 0) {
 			Py_DECREF(val);
 			Py_DECREF(val_list);
+			PyMem_Free(vals);
 			return NULL;
 		}
 	}
 
+	PyMem_Free(vals);
+
 	return val_list;
 }
 
@@ -1137,17 +1449,14 @@ PyDoc_STRVAR(gpiod_LineBulk_set_values_doc,
 static PyObject *gpiod_LineBulk_set_values(gpiod_LineBulkObject *self,
 					   PyObject *args)
 {
-	int rv, vals[GPIOD_LINE_BULK_MAX_LINES], val;
 	PyObject *val_list, *iter, *next;
-	struct gpiod_line_bulk bulk;
+	struct gpiod_CLines lines;
 	Py_ssize_t num_vals, i;
+	int rv, *vals, val;
 
 	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	gpiod_LineBulkObjToCLineBulk(self, &bulk);
-	memset(vals, 0, sizeof(vals));
-
 	rv = PyArg_ParseTuple(args, "O", &val_list);
 	if (!rv)
 		return NULL;
@@ -1159,9 +1468,15 @@ static PyObject *gpiod_LineBulk_set_values(gpiod_LineBulkObject *self,
 		return NULL;
 	}
 
+	vals = PyMem_Calloc(self->num_lines, sizeof(int));
+	if (!vals)
+		return PyErr_NoMemory();
+
 	iter = PyObject_GetIter(val_list);
-	if (!iter)
+	if (!iter) {
+		PyMem_Free(vals);
 		return NULL;
+	}
 
 	for (i = 0;; i++) {
 		next = PyIter_Next(iter);
@@ -1174,15 +1489,26 @@ static PyObject *gpiod_LineBulk_set_values(gpiod_LineBulkObject *self,
 		Py_DECREF(next);
 		if (PyErr_Occurred()) {
 			Py_DECREF(iter);
+			PyMem_Free(vals);
 			return NULL;
 		}
 
 		vals[i] = (int)val;
 	}
 
+	if (gpiod_LineBulkObjToCLines(self, &lines)) {
+		PyMem_Free(vals);
+		return NULL;
+	}
+
 	Py_BEGIN_ALLOW_THREADS;
-	rv = gpiod_line_set_value_bulk(&bulk, vals);
+	if (lines.array)
+		rv = gpiod_line_array_set_values(lines.array, vals);
+	else
+		rv = gpiod_line_set_value_bulk(&lines.bulk, vals);
 	Py_END_ALLOW_THREADS;
+	gpiod_CLinesFree(&lines);
+	PyMem_Free(vals);
 	if (rv) {
 		PyErr_SetFromErrno(PyExc_OSError);
 		return NULL;
@@ -1191,99 +1517,293 @@ static PyObject *gpiod_LineBulk_set_values(gpiod_LineBulkObject *self,
 	Py_RETURN_NONE;
 }
 
-PyDoc_STRVAR(gpiod_LineBulk_release_doc,
-"release() -> None\n"
+PyDoc_STRVAR(gpiod_LineBulk_get_values_mask_doc,
+"get_values_mask() -> integer\n"
 "\n"
-"Release all lines held by this LineBulk object.");
+"Read the values of all the lines held by this LineBulk object into a\n"
+"bitmask. Bit N of the returned integer holds the value of the line at\n"
+"index N in this gpiod.LineBulk object.");
 
-static PyObject *gpiod_LineBulk_release(gpiod_LineBulkObject *self)
+static PyObject *gpiod_LineBulk_get_values_mask(gpiod_LineBulkObject *self)
 {
 	struct gpiod_line_bulk bulk;
+	uint64_t vals;
+	int rv;
 
 	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	gpiod_LineBulkObjToCLineBulk(self, &bulk);
-	gpiod_line_release_bulk(&bulk);
+	if (gpiod_LineBulkObjToCLineBulk(self, &bulk))
+		return NULL;
 
-	Py_RETURN_NONE;
+	Py_BEGIN_ALLOW_THREADS;
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &vals);
+	Py_END_ALLOW_THREADS;
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	return PyLong_FromUnsignedLongLong(vals);
 }
 
-PyDoc_STRVAR(gpiod_LineBulk_event_wait_doc,
-"event_wait([sec[ ,nsec]]) -> gpiod.LineBulk object or None\n"
-"\n"
-"Poll the lines held by this LineBulk Object for line events.\n"
+PyDoc_STRVAR(gpiod_LineBulk_set_values_mask_doc,
+"set_values_mask(values[, mask]) -> None\n"
 "\n"
-"  sec\n"
-"    Number of seconds to wait before timeout.\n"
-"  nsec\n"
-"    Number of nanoseconds to wait before timeout.\n"
+"Set the values of the lines held by this LineBulk object from a bitmask.\n"
 "\n"
-"Returns a gpiod.LineBulk object containing references to lines on which\n"
-"events occurred or None if we reached the timeout without any event\n"
-"occurring.");
+"  values\n"
+"    Integer in which bit N holds the value to set on the line at index N.\n"
+"  mask\n"
+"    Integer in which bit N is set if the line at index N is to be changed.\n"
+"    The values of the remaining lines are preserved. If not specified, all\n"
+"    lines are changed.");
 
-static PyObject *gpiod_LineBulk_event_wait(gpiod_LineBulkObject *self,
-					   PyObject *args, PyObject *kwds)
+static PyObject *gpiod_LineBulk_set_values_mask(gpiod_LineBulkObject *self,
+						PyObject *args,
+						PyObject *kwds)
 {
-	static char *kwlist[] = { "sec", "nsec", NULL };
+	static char *kwlist[] = { "values", "mask", NULL };
 
-	struct gpiod_line_bulk bulk, ev_bulk;
-	struct gpiod_line *line, **line_ptr;
-	gpiod_LineObject *line_obj;
-	gpiod_ChipObject *owner;
-	long sec = 0, nsec = 0;
-	struct timespec ts;
-	PyObject *ret;
-	Py_ssize_t i;
+	unsigned long long vals, mask = UINT64_MAX;
+	struct gpiod_line_bulk bulk;
 	int rv;
 
 	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	rv = PyArg_ParseTupleAndKeywords(args, kwds,
-					 "|ll", kwlist, &sec, &nsec);
+	rv = PyArg_ParseTupleAndKeywords(args, kwds, "K|K", kwlist,
+					 &vals, &mask);
 	if (!rv)
 		return NULL;
 
-	ts.tv_sec = sec;
-	ts.tv_nsec = nsec;
-
-	gpiod_LineBulkObjToCLineBulk(self, &bulk);
+	if (gpiod_LineBulkObjToCLineBulk(self, &bulk))
+		return NULL;
 
 	Py_BEGIN_ALLOW_THREADS;
-	rv = gpiod_line_event_wait_bulk(&bulk, &ts, &ev_bulk);
+	rv = gpiod_line_set_value_bulk_masked(&bulk, mask, vals);
 	Py_END_ALLOW_THREADS;
-	if (rv < 0) {
+	if (rv) {
 		PyErr_SetFromErrno(PyExc_OSError);
 		return NULL;
-	} else if (rv == 0) {
-		Py_RETURN_NONE;
 	}
 
-	ret = PyList_New(gpiod_line_bulk_num_lines(&ev_bulk));
-	if (!ret)
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_LineBulk_set_config_doc,
+"set_config(direction[, flags[, values]]) -> None\n"
+"\n"
+"Change the configuration of all lines held by this LineBulk object without\n"
+"releasing them.\n"
+"\n"
+"  direction\n"
+"    New direction: one of the LINE_REQ_DIR_* request types.\n"
+"  flags\n"
+"    New request flags.\n"
+"  values\n"
+"    List of values - only relevant if the direction is output.\n"
+"\n"
+"The lines must have been requested together, in a single request.");
+
+static PyObject *gpiod_LineBulk_set_config(gpiod_LineBulkObject *self,
+					   PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "direction", "flags", "values", NULL };
+
+	int rv, direction, flags = 0, *vals = NULL;
+	PyObject *val_list = NULL, *iter, *next;
+	struct gpiod_line_bulk bulk;
+	Py_ssize_t num_vals, i;
+	long val;
+
+	if (gpiod_LineBulkOwnerIsClosed(self))
 		return NULL;
 
-	owner = ((gpiod_LineObject *)(self->lines[0]))->owner;
+	rv = PyArg_ParseTupleAndKeywords(args, kwds, "i|iO", kwlist,
+					 &direction, &flags, &val_list);
+	if (!rv)
+		return NULL;
 
-	i = 0;
-	gpiod_line_bulk_foreach_line(&ev_bulk, line, line_ptr) {
-		line_obj = gpiod_MakeLineObject(owner, line);
-		if (!line_obj) {
-			Py_DECREF(ret);
+	if (gpiod_LineBulkObjToCLineBulk(self, &bulk))
+		return NULL;
+
+	if (val_list && val_list != Py_None) {
+		num_vals = PyObject_Size(val_list);
+		if (self->num_lines != num_vals) {
+			PyErr_SetString(PyExc_TypeError,
+					"Number of values must correspond with the number of lines");
 			return NULL;
 		}
 
-		rv = PyList_SetItem(ret, i++, (PyObject *)line_obj);
-		if (rv < 0) {
-			Py_DECREF(ret);
+		vals = PyMem_Calloc(self->num_lines, sizeof(int));
+		if (!vals)
+			return PyErr_NoMemory();
+
+		iter = PyObject_GetIter(val_list);
+		if (!iter) {
+			PyMem_Free(vals);
 			return NULL;
 		}
-	}
 
-	return ret;
-}
+		for (i = 0;; i++) {
+			next = PyIter_Next(iter);
+			if (!next) {
+				Py_DECREF(iter);
+				break;
+			}
+
+			val = PyLong_AsLong(next);
+			Py_DECREF(next);
+			if (PyErr_Occurred()) {
+				Py_DECREF(iter);
+				PyMem_Free(vals);
+				return NULL;
+			}
+
+			vals[i] = (int)val;
+		}
+	}
+
+	Py_BEGIN_ALLOW_THREADS;
+	rv = gpiod_line_set_config_bulk(&bulk,
+					gpiod_MapRequestType(direction),
+					gpiod_MapRequestFlags(flags), vals);
+	Py_END_ALLOW_THREADS;
+	PyMem_Free(vals);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_LineBulk_release_doc,
+"release() -> None\n"
+"\n"
+"Release all lines held by this LineBulk object.");
+
+static PyObject *gpiod_LineBulk_release(gpiod_LineBulkObject *self)
+{
+	struct gpiod_CLines lines;
+
+	if (gpiod_LineBulkOwnerIsClosed(self))
+		return NULL;
+
+	if (gpiod_LineBulkObjToCLines(self, &lines))
+		return NULL;
+
+	if (lines.array)
+		gpiod_line_array_release(lines.array);
+	else
+		gpiod_line_release_bulk(&lines.bulk);
+	gpiod_CLinesFree(&lines);
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_LineBulk_event_wait_doc,
+"event_wait([sec[ ,nsec]]) -> gpiod.LineBulk object or None\n"
+"\n"
+"Poll the lines held by this LineBulk Object for line events.\n"
+"\n"
+"  sec\n"
+"    Number of seconds to wait before timeout.\n"
+"  nsec\n"
+"    Number of nanoseconds to wait before timeout.\n"
+"\n"
+"Returns a gpiod.LineBulk object containing references to lines on which\n"
+"events occurred or None if we reached the timeout without any event\n"
+"occurring.");
+
+static PyObject *gpiod_LineBulk_event_wait(gpiod_LineBulkObject *self,
+					   PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "sec", "nsec", NULL };
+
+	struct gpiod_CLines lines, ev_lines;
+	gpiod_LineObject *line_obj;
+	gpiod_ChipObject *owner;
+	long sec = 0, nsec = 0;
+	struct timespec ts;
+	PyObject *ret;
+	unsigned int i;
+	int rv;
+
+	if (gpiod_LineBulkOwnerIsClosed(self))
+		return NULL;
+
+	rv = PyArg_ParseTupleAndKeywords(args, kwds,
+					 "|ll", kwlist, &sec, &nsec);
+	if (!rv)
+		return NULL;
+
+	ts.tv_sec = sec;
+	ts.tv_nsec = nsec;
+
+	if (gpiod_LineBulkObjToCLines(self, &lines))
+		return NULL;
+
+	ev_lines.array = NULL;
+	if (lines.array) {
+		ev_lines.array = gpiod_line_array_new();
+		if (!ev_lines.array) {
+			gpiod_CLinesFree(&lines);
+			PyErr_SetFromErrno(PyExc_OSError);
+			return NULL;
+		}
+	} else {
+		gpiod_line_bulk_init(&ev_lines.bulk);
+	}
+
+	Py_BEGIN_ALLOW_THREADS;
+	if (lines.array)
+		rv = gpiod_line_array_event_wait(lines.array, &ts,
+						 ev_lines.array);
+	else
+		rv = gpiod_line_event_wait_bulk(&lines.bulk, &ts,
+						&ev_lines.bulk);
+	Py_END_ALLOW_THREADS;
+	gpiod_CLinesFree(&lines);
+	if (rv < 0) {
+		gpiod_CLinesFree(&ev_lines);
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	} else if (rv == 0) {
+		gpiod_CLinesFree(&ev_lines);
+		Py_RETURN_NONE;
+	}
+
+	ret = PyList_New(gpiod_CLinesNumLines(&ev_lines));
+	if (!ret) {
+		gpiod_CLinesFree(&ev_lines);
+		return NULL;
+	}
+
+	owner = ((gpiod_LineObject *)(self->lines[0]))->owner;
+
+	for (i = 0; i < gpiod_CLinesNumLines(&ev_lines); i++) {
+		line_obj = gpiod_MakeLineObject(owner,
+				gpiod_CLinesGetLine(&ev_lines, i));
+		if (!line_obj) {
+			Py_DECREF(ret);
+			gpiod_CLinesFree(&ev_lines);
+			return NULL;
+		}
+
+		rv = PyList_SetItem(ret, i, (PyObject *)line_obj);
+		if (rv < 0) {
+			Py_DECREF(ret);
+			gpiod_CLinesFree(&ev_lines);
+			return NULL;
+		}
+	}
+
+	gpiod_CLinesFree(&ev_lines);
+
+	return ret;
+}
 
 static PyObject *gpiod_LineBulk_repr(gpiod_LineBulkObject *self)
 {
@@ -1340,6 +1860,24 @@ static PyMethodDef gpiod_LineBulk_methods[] = {
 		.ml_doc = gpiod_LineBulk_set_values_doc,
 		.ml_flags = METH_VARARGS,
 	},
+	{
+		.ml_name = "get_values_mask",
+		.ml_meth = (PyCFunction)gpiod_LineBulk_get_values_mask,
+		.ml_doc = gpiod_LineBulk_get_values_mask_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{
+		.ml_name = "set_values_mask",
+		.ml_meth = (PyCFunction)gpiod_LineBulk_set_values_mask,
+		.ml_doc = gpiod_LineBulk_set_values_mask_doc,
+		.ml_flags = METH_VARARGS | METH_KEYWORDS,
+	},
+	{
+		.ml_name = "set_config",
+		.ml_meth = (PyCFunction)gpiod_LineBulk_set_config,
+		.ml_doc = gpiod_LineBulk_set_config_doc,
+		.ml_flags = METH_VARARGS | METH_KEYWORDS,
+	},
 	{
 		.ml_name = "release",
 		.ml_meth = (PyCFunction)gpiod_LineBulk_release,
@@ -1402,6 +1940,12 @@ enum {
 	gpiod_OPEN_BY_NUMBER,
 };
 
+enum {
+	gpiod_LINE_INFO_REFRESH_ALWAYS = 1,
+	gpiod_LINE_INFO_REFRESH_IF_STALE,
+	gpiod_LINE_INFO_REFRESH_NEVER,
+};
+
 static int gpiod_Chip_init(gpiod_ChipObject *self, PyObject *args)
 {
 	int rv, how = gpiod_OPEN_LOOKUP;
@@ -1535,6 +2079,159 @@ static PyObject *gpiod_Chip_num_lines(gpiod_ChipObject *self)
 	return Py_BuildValue("I", gpiod_chip_num_lines(self->chip));
 }
 
+PyDoc_STRVAR(gpiod_Chip_set_line_info_policy_doc,
+"set_line_info_policy(policy) -> None\n"
+"\n"
+"Set the policy deciding when the info of lines exposed by this chip is\n"
+"re-read from the kernel.\n"
+"\n"
+"  policy\n"
+"    One of the gpiod.Chip.LINE_INFO_REFRESH_* constants.\n"
+"\n"
+"With LINE_INFO_REFRESH_ALWAYS (the default) the line info is refreshed\n"
+"every time a line is retrieved. With LINE_INFO_REFRESH_IF_STALE it's only\n"
+"read on first access after the line was retrieved or requested and with\n"
+"LINE_INFO_REFRESH_NEVER only after calling invalidate_line_info() or\n"
+"Line.update().");
+
+static PyObject *gpiod_Chip_set_line_info_policy(gpiod_ChipObject *self,
+						 PyObject *args)
+{
+	int rv, policy;
+
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	rv = PyArg_ParseTuple(args, "i", &policy);
+	if (!rv)
+		return NULL;
+
+	switch (policy) {
+	case gpiod_LINE_INFO_REFRESH_ALWAYS:
+		policy = GPIOD_LINE_INFO_REFRESH_ALWAYS;
+		break;
+	case gpiod_LINE_INFO_REFRESH_IF_STALE:
+		policy = GPIOD_LINE_INFO_REFRESH_IF_STALE;
+		break;
+	case gpiod_LINE_INFO_REFRESH_NEVER:
+		policy = GPIOD_LINE_INFO_REFRESH_NEVER;
+		break;
+	default:
+		PyErr_SetString(PyExc_ValueError,
+				"Invalid line info refresh policy");
+		return NULL;
+	}
+
+	gpiod_chip_set_line_info_policy(self->chip, policy);
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_Chip_line_info_policy_doc,
+"line_info_policy() -> integer\n"
+"\n"
+"Get the current line info refresh policy of this chip.");
+
+static PyObject *gpiod_Chip_line_info_policy(gpiod_ChipObject *self)
+{
+	int policy;
+
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	switch (gpiod_chip_get_line_info_policy(self->chip)) {
+	case GPIOD_LINE_INFO_REFRESH_IF_STALE:
+		policy = gpiod_LINE_INFO_REFRESH_IF_STALE;
+		break;
+	case GPIOD_LINE_INFO_REFRESH_NEVER:
+		policy = gpiod_LINE_INFO_REFRESH_NEVER;
+		break;
+	default:
+		policy = gpiod_LINE_INFO_REFRESH_ALWAYS;
+		break;
+	}
+
+	return Py_BuildValue("i", policy);
+}
+
+PyDoc_STRVAR(gpiod_Chip_invalidate_line_info_doc,
+"invalidate_line_info() -> None\n"
+"\n"
+"Make the info of all lines exposed by this chip be re-read from the kernel\n"
+"the next time it's accessed.");
+
+static PyObject *gpiod_Chip_invalidate_line_info(gpiod_ChipObject *self)
+{
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	gpiod_chip_invalidate_line_info(self->chip);
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_Chip_uapi_version_doc,
+"uapi_version() -> integer\n"
+"\n"
+"Get the version of the kernel uAPI used to access this chip: 2 if the\n"
+"kernel supports it, 1 otherwise.");
+
+static PyObject *gpiod_Chip_uapi_version(gpiod_ChipObject *self)
+{
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	return Py_BuildValue("i", gpiod_chip_uapi_version(self->chip));
+}
+
+PyDoc_STRVAR(gpiod_Chip_set_event_buffer_size_doc,
+"set_event_buffer_size(size) -> None\n"
+"\n"
+"Set the number of events the kernel can queue for lines of this chip\n"
+"requested for events afterwards.\n"
+"\n"
+"  size\n"
+"    Number of events or 0 to use the kernel default.\n"
+"\n"
+"Only supported if the chip is accessed using the v2 kernel uAPI.");
+
+static PyObject *gpiod_Chip_set_event_buffer_size(gpiod_ChipObject *self,
+						  PyObject *args)
+{
+	unsigned int size;
+	int rv;
+
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	rv = PyArg_ParseTuple(args, "I", &size);
+	if (!rv)
+		return NULL;
+
+	rv = gpiod_chip_set_event_buffer_size(self->chip, size);
+	if (rv < 0) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_Chip_event_buffer_size_doc,
+"event_buffer_size() -> integer\n"
+"\n"
+"Get the size of the kernel event buffer of event requests (0 if the\n"
+"kernel default is used).");
+
+static PyObject *gpiod_Chip_event_buffer_size(gpiod_ChipObject *self)
+{
+	if (gpiod_ChipIsClosed(self))
+		return NULL;
+
+	return Py_BuildValue("I",
+			     gpiod_chip_get_event_buffer_size(self->chip));
+}
+
 static gpiod_LineObject *
 gpiod_MakeLineObject(gpiod_ChipObject *owner, struct gpiod_line *line)
 {
@@ -1728,28 +2425,30 @@ PyDoc_STRVAR(gpiod_Chip_get_all_lines_doc,
 static gpiod_LineBulkObject *
 gpiod_Chip_get_all_lines(gpiod_ChipObject *self)
 {
+	unsigned int offset, num_lines;
 	gpiod_LineBulkObject *bulk_obj;
-	struct gpiod_line_bulk bulk;
 	gpiod_LineObject *line_obj;
 	struct gpiod_line *line;
-	unsigned int offset;
 	PyObject *list;
 	int rv;
 
 	if (gpiod_ChipIsClosed(self))
 		return NULL;
 
-	rv = gpiod_chip_get_all_lines(self->chip, &bulk);
-	if (rv) {
-		PyErr_SetFromErrno(PyExc_OSError);
-		return NULL;
-	}
+	num_lines = gpiod_chip_num_lines(self->chip);
 
-	list = PyList_New(gpiod_line_bulk_num_lines(&bulk));
+	list = PyList_New(num_lines);
 	if (!list)
 		return NULL;
 
-	gpiod_line_bulk_foreach_line_off(&bulk, line, offset) {
+	for (offset = 0; offset < num_lines; offset++) {
+		line = gpiod_chip_get_line(self->chip, offset);
+		if (!line) {
+			Py_DECREF(list);
+			PyErr_SetFromErrno(PyExc_OSError);
+			return NULL;
+		}
+
 		line_obj = gpiod_MakeLineObject(self, line);
 		if (!line_obj) {
 			Py_DECREF(list);
@@ -1889,6 +2588,42 @@ static PyMethodDef gpiod_Chip_methods[] = {
 		.ml_flags = METH_NOARGS,
 		.ml_doc = gpiod_Chip_num_lines_doc,
 	},
+	{
+		.ml_name = "set_line_info_policy",
+		.ml_meth = (PyCFunction)gpiod_Chip_set_line_info_policy,
+		.ml_flags = METH_VARARGS,
+		.ml_doc = gpiod_Chip_set_line_info_policy_doc,
+	},
+	{
+		.ml_name = "line_info_policy",
+		.ml_meth = (PyCFunction)gpiod_Chip_line_info_policy,
+		.ml_flags = METH_NOARGS,
+		.ml_doc = gpiod_Chip_line_info_policy_doc,
+	},
+	{
+		.ml_name = "invalidate_line_info",
+		.ml_meth = (PyCFunction)gpiod_Chip_invalidate_line_info,
+		.ml_flags = METH_NOARGS,
+		.ml_doc = gpiod_Chip_invalidate_line_info_doc,
+	},
+	{
+		.ml_name = "uapi_version",
+		.ml_meth = (PyCFunction)gpiod_Chip_uapi_version,
+		.ml_flags = METH_NOARGS,
+		.ml_doc = gpiod_Chip_uapi_version_doc,
+	},
+	{
+		.ml_name = "set_event_buffer_size",
+		.ml_meth = (PyCFunction)gpiod_Chip_set_event_buffer_size,
+		.ml_flags = METH_VARARGS,
+		.ml_doc = gpiod_Chip_set_event_buffer_size_doc,
+	},
+	{
+		.ml_name = "event_buffer_size",
+		.ml_meth = (PyCFunction)gpiod_Chip_event_buffer_size,
+		.ml_flags = METH_NOARGS,
+		.ml_doc = gpiod_Chip_event_buffer_size_doc,
+	},
 	{
 		.ml_name = "get_line",
 		.ml_meth = (PyCFunction)gpiod_Chip_get_line,
@@ -1990,11 +2725,18 @@ static gpiod_ChipObject *gpiod_ChipIter_next(gpiod_ChipIterObject *self)
 	gpiod_ChipObject *chip_obj;
 	struct gpiod_chip *chip;
 
+	errno = 0;
+
 	Py_BEGIN_ALLOW_THREADS;
 	chip = gpiod_chip_iter_next_noclose(self->iter);
 	Py_END_ALLOW_THREADS;
-	if (!chip)
+	if (!chip) {
+		/* Chips are opened lazily - this may be an error. */
+		if (errno)
+			PyErr_SetFromErrno(PyExc_OSError);
+
 		return NULL; /* Last element. */
+	}
 
 	chip_obj = PyObject_New(gpiod_ChipObject, &gpiod_ChipType);
 	if (!chip_obj) {
@@ -2108,15 +2850,613 @@ static PyTypeObject gpiod_LineIterType = {
 	.tp_iternext = (iternextfunc)gpiod_LineIter_next,
 };
 
-PyDoc_STRVAR(gpiod_Module_find_line_doc,
-"find_line(name) -> gpiod.Line object or None\n"
-"\n"
-"Lookup a GPIO line by name. Search all gpiochips. Returns a gpiod.Line\n"
-"or None if a line with given name doesn't exist in the system.\n"
-"\n"
-"NOTE: the gpiod.Chip object owning the returned line must be closed\n"
-"by the caller.\n"
-"\n"
+static int gpiod_EventSource_init(gpiod_EventSourceObject *self)
+{
+	self->handlers = PyDict_New();
+	if (!self->handlers)
+		return -1;
+
+	self->source = gpiod_event_source_new();
+	if (!self->source) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void gpiod_EventSource_dealloc(gpiod_EventSourceObject *self)
+{
+	if (self->source)
+		gpiod_event_source_free(self->source);
+
+	Py_XDECREF(self->handlers);
+	PyObject_Del(self);
+}
+
+/*
+ * The handlers dictionary maps line pointers to (line, callback) tuples and
+ * keeps them alive while the C library holds references to them.
+ */
+static void gpiod_EventSource_handle_event(struct gpiod_line *line GPIOD_UNUSED,
+					   const struct gpiod_line_event *event,
+					   void *data)
+{
+	PyObject *handler = data, *ret;
+	gpiod_LineEventObject *ev_obj;
+
+	/* Stop calling back into Python once a callback raised. */
+	if (PyErr_Occurred())
+		return;
+
+	ev_obj = PyObject_New(gpiod_LineEventObject, &gpiod_LineEventType);
+	if (!ev_obj)
+		return;
+
+	ev_obj->event = *event;
+	ev_obj->source = (gpiod_LineObject *)PyTuple_GetItem(handler, 0);
+	Py_INCREF(ev_obj->source);
+
+	ret = PyObject_CallFunctionObjArgs(PyTuple_GetItem(handler, 1),
+					   ev_obj, NULL);
+	Py_DECREF(ev_obj);
+	Py_XDECREF(ret);
+}
+
+static int gpiod_EventSource_add_line(gpiod_EventSourceObject *self,
+				      gpiod_LineObject *line_obj,
+				      PyObject *callback)
+{
+	PyObject *key, *handler;
+	int rv;
+
+	if (gpiod_ChipIsClosed(line_obj->owner))
+		return -1;
+
+	key = PyLong_FromVoidPtr(line_obj->line);
+	if (!key)
+		return -1;
+
+	handler = PyTuple_Pack(2, line_obj, callback);
+	if (!handler) {
+		Py_DECREF(key);
+		return -1;
+	}
+
+	rv = gpiod_event_source_add_line(self->source, line_obj->line,
+					 gpiod_EventSource_handle_event,
+					 handler);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+	} else {
+		/* Drops the reference to the replaced handler if any. */
+		rv = PyDict_SetItem(self->handlers, key, handler);
+		if (rv)
+			gpiod_event_source_remove_line(self->source,
+						       line_obj->line);
+	}
+
+	Py_DECREF(handler);
+	Py_DECREF(key);
+
+	return rv ? -1 : 0;
+}
+
+/*
+ * Put a line back in the state it was in before a failed add: remove it if
+ * it wasn't in the source or reinstall its previous handler otherwise.
+ */
+static void gpiod_EventSource_restore_line(gpiod_EventSourceObject *self,
+					   gpiod_LineObject *line_obj,
+					   PyObject *prev)
+{
+	PyObject *key, *handler;
+
+	key = PyLong_FromVoidPtr(line_obj->line);
+	if (!key)
+		return;
+
+	handler = PyDict_GetItem(prev, key);
+	if (handler) {
+		if (!gpiod_event_source_add_line(self->source, line_obj->line,
+						 gpiod_EventSource_handle_event,
+						 handler))
+			PyDict_SetItem(self->handlers, key, handler);
+	} else if (PyDict_GetItem(self->handlers, key)) {
+		gpiod_event_source_remove_line(self->source, line_obj->line);
+		PyDict_DelItem(self->handlers, key);
+	}
+
+	Py_DECREF(key);
+	PyErr_Clear();
+}
+
+PyDoc_STRVAR(gpiod_EventSource_add_doc,
+"add(lines, callback) -> None\n"
+"\n"
+"Add a line or a set of lines to this event source.\n"
+"\n"
+"  lines\n"
+"    gpiod.Line or gpiod.LineBulk object. The lines must be requested for\n"
+"    events.\n"
+"  callback\n"
+"    Callable called with a gpiod.LineEvent object for every event occurring\n"
+"    on any of the lines.\n"
+"\n"
+"Adding a line which is already in the source replaces its callback. If\n"
+"adding any of the lines fails, the source is left as it was before the\n"
+"call.");
+
+static PyObject *gpiod_EventSource_add(gpiod_EventSourceObject *self,
+				       PyObject *args)
+{
+	PyObject *lines, *callback, *prev, *type, *value, *traceback;
+	gpiod_LineBulkObject *bulk;
+	Py_ssize_t i;
+	int rv;
+
+	rv = PyArg_ParseTuple(args, "OO", &lines, &callback);
+	if (!rv)
+		return NULL;
+
+	if (!PyCallable_Check(callback)) {
+		PyErr_SetString(PyExc_TypeError,
+				"callback must be callable");
+		return NULL;
+	}
+
+	if (PyObject_TypeCheck(lines, &gpiod_LineType)) {
+		rv = gpiod_EventSource_add_line(self,
+						(gpiod_LineObject *)lines,
+						callback);
+		if (rv)
+			return NULL;
+
+		Py_RETURN_NONE;
+	} else if (!PyObject_TypeCheck(lines, &gpiod_LineBulkType)) {
+		PyErr_SetString(PyExc_TypeError,
+				"lines must be a gpiod.Line or gpiod.LineBulk");
+		return NULL;
+	}
+
+	bulk = (gpiod_LineBulkObject *)lines;
+
+	/* Keep the previous handlers to undo a partial add. */
+	prev = PyDict_Copy(self->handlers);
+	if (!prev)
+		return NULL;
+
+	for (i = 0; i < bulk->num_lines; i++) {
+		rv = gpiod_EventSource_add_line(self,
+				(gpiod_LineObject *)bulk->lines[i], callback);
+		if (rv) {
+			PyErr_Fetch(&type, &value, &traceback);
+			while (i--)
+				gpiod_EventSource_restore_line(self,
+					(gpiod_LineObject *)bulk->lines[i],
+					prev);
+			PyErr_Restore(type, value, traceback);
+			Py_DECREF(prev);
+			return NULL;
+		}
+	}
+
+	Py_DECREF(prev);
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_EventSource_remove_doc,
+"remove(line) -> None\n"
+"\n"
+"Remove a line from this event source. Lines must be removed from the\n"
+"source before they are released.\n"
+"\n"
+"  line\n"
+"    gpiod.Line object.");
+
+static PyObject *gpiod_EventSource_remove(gpiod_EventSourceObject *self,
+					  PyObject *args)
+{
+	gpiod_LineObject *line_obj;
+	PyObject *key;
+	int rv;
+
+	rv = PyArg_ParseTuple(args, "O!", &gpiod_LineType, &line_obj);
+	if (!rv)
+		return NULL;
+
+	rv = gpiod_event_source_remove_line(self->source, line_obj->line);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	key = PyLong_FromVoidPtr(line_obj->line);
+	if (!key)
+		return NULL;
+
+	rv = PyDict_DelItem(self->handlers, key);
+	Py_DECREF(key);
+	if (rv)
+		return NULL;
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_EventSource_fileno_doc,
+"fileno() -> integer\n"
+"\n"
+"Get the file descriptor of this event source. It becomes readable when\n"
+"events are pending on any of the lines in the source.");
+
+static PyObject *gpiod_EventSource_fileno(gpiod_EventSourceObject *self)
+{
+	return PyLong_FromLong(gpiod_event_source_get_fd(self->source));
+}
+
+PyDoc_STRVAR(gpiod_EventSource_dispatch_doc,
+"dispatch() -> integer\n"
+"\n"
+"Read the pending events and pass them to the callbacks of the lines on\n"
+"which they occurred. Never blocks. Returns the number of events read.");
+
+static PyObject *gpiod_EventSource_dispatch(gpiod_EventSourceObject *self)
+{
+	int rv;
+
+	rv = gpiod_event_source_dispatch(self->source);
+	if (PyErr_Occurred())
+		return NULL;
+
+	if (rv < 0) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	return PyLong_FromLong(rv);
+}
+
+static PyMethodDef gpiod_EventSource_methods[] = {
+	{
+		.ml_name = "add",
+		.ml_meth = (PyCFunction)gpiod_EventSource_add,
+		.ml_doc = gpiod_EventSource_add_doc,
+		.ml_flags = METH_VARARGS,
+	},
+	{
+		.ml_name = "remove",
+		.ml_meth = (PyCFunction)gpiod_EventSource_remove,
+		.ml_doc = gpiod_EventSource_remove_doc,
+		.ml_flags = METH_VARARGS,
+	},
+	{
+		.ml_name = "fileno",
+		.ml_meth = (PyCFunction)gpiod_EventSource_fileno,
+		.ml_doc = gpiod_EventSource_fileno_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{
+		.ml_name = "dispatch",
+		.ml_meth = (PyCFunction)gpiod_EventSource_dispatch,
+		.ml_doc = gpiod_EventSource_dispatch_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{ }
+};
+
+PyDoc_STRVAR(gpiod_EventSourceType_doc,
+"Aggregates the events of any number of lines behind a single file\n"
+"descriptor.\n"
+"\n"
+"The EventSource's constructor takes no arguments. Objects of this type can\n"
+"be registered directly with the selectors module or any other event loop\n"
+"accepting objects with the fileno() method.\n"
+"\n"
+"Example:\n"
+"\n"
+"    source = gpiod.EventSource()\n"
+"    source.add(lines, lambda event: print(event))\n"
+"    sel = selectors.DefaultSelector()\n"
+"    sel.register(source, selectors.EVENT_READ)\n"
+"    while True:\n"
+"        sel.select()\n"
+"        source.dispatch()");
+
+static PyTypeObject gpiod_EventSourceType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "gpiod.EventSource",
+	.tp_basicsize = sizeof(gpiod_EventSourceObject),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = gpiod_EventSourceType_doc,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)gpiod_EventSource_init,
+	.tp_dealloc = (destructor)gpiod_EventSource_dealloc,
+	.tp_methods = gpiod_EventSource_methods,
+};
+
+static int gpiod_PWM_duration(Py_ssize_t duration, uint32_t *ns)
+{
+	if (duration < 0 || (uint64_t)duration > UINT32_MAX) {
+		PyErr_SetString(PyExc_ValueError,
+				"PWM period and duty cycle must fit in 32 bits");
+		return -1;
+	}
+
+	*ns = duration;
+
+	return 0;
+}
+
+static int gpiod_PWM_init(gpiod_PWMObject *self, PyObject *args)
+{
+	gpiod_LineBulkObject *bulk_obj;
+	struct gpiod_line_bulk bulk;
+	Py_ssize_t period;
+	uint32_t period_ns;
+	int rv;
+
+	rv = PyArg_ParseTuple(args, "O!n", &gpiod_LineBulkType,
+			      &bulk_obj, &period);
+	if (!rv)
+		return -1;
+
+	if (gpiod_LineBulkOwnerIsClosed(bulk_obj))
+		return -1;
+
+	if (gpiod_PWM_duration(period, &period_ns))
+		return -1;
+
+	if (gpiod_LineBulkObjToCLineBulk(bulk_obj, &bulk))
+		return -1;
+
+	self->pwm = gpiod_pwm_new(&bulk, period_ns);
+	if (!self->pwm) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+
+	Py_INCREF(bulk_obj);
+	self->bulk = (PyObject *)bulk_obj;
+
+	return 0;
+}
+
+static void gpiod_PWM_dealloc(gpiod_PWMObject *self)
+{
+	if (self->pwm) {
+		Py_BEGIN_ALLOW_THREADS;
+		gpiod_pwm_free(self->pwm);
+		Py_END_ALLOW_THREADS;
+	}
+
+	Py_XDECREF(self->bulk);
+	PyObject_Del(self);
+}
+
+PyDoc_STRVAR(gpiod_PWM_set_sched_doc,
+"set_sched(policy, priority) -> None\n"
+"\n"
+"Set the scheduling policy and priority of the PWM thread.\n"
+"\n"
+"  policy\n"
+"    Scheduling policy, for example os.SCHED_FIFO.\n"
+"  priority\n"
+"    Scheduling priority, only used by the realtime policies.");
+
+static PyObject *gpiod_PWM_set_sched(gpiod_PWMObject *self, PyObject *args)
+{
+	int rv, policy, priority;
+
+	rv = PyArg_ParseTuple(args, "ii", &policy, &priority);
+	if (!rv)
+		return NULL;
+
+	rv = gpiod_pwm_set_sched(self->pwm, policy, priority);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_PWM_set_cpu_doc,
+"set_cpu(cpu) -> None\n"
+"\n"
+"Pin the PWM thread to a single CPU.\n"
+"\n"
+"  cpu\n"
+"    CPU number or -1 to let the thread run on any CPU.");
+
+static PyObject *gpiod_PWM_set_cpu(gpiod_PWMObject *self, PyObject *args)
+{
+	int rv, cpu;
+
+	rv = PyArg_ParseTuple(args, "i", &cpu);
+	if (!rv)
+		return NULL;
+
+	rv = gpiod_pwm_set_cpu(self->pwm, cpu);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_PWM_set_channel_doc,
+"set_channel(channel, period, duty) -> None\n"
+"\n"
+"Set the period and duty cycle of a channel. Can be called while the PWM is\n"
+"running, the update takes effect at the start of the next period of the\n"
+"channel.\n"
+"\n"
+"  channel\n"
+"    Index of the line in the gpiod.LineBulk object.\n"
+"  period\n"
+"    Period in nanoseconds.\n"
+"  duty\n"
+"    Length of the pulse in nanoseconds. Must not exceed the period.");
+
+static PyObject *gpiod_PWM_set_channel(gpiod_PWMObject *self,
+				       PyObject *args)
+{
+	uint32_t period_ns, duty_ns;
+	Py_ssize_t period, duty;
+	unsigned int channel;
+	int rv;
+
+	rv = PyArg_ParseTuple(args, "Inn", &channel, &period, &duty);
+	if (!rv)
+		return NULL;
+
+	if (gpiod_PWM_duration(period, &period_ns) ||
+	    gpiod_PWM_duration(duty, &duty_ns))
+		return NULL;
+
+	rv = gpiod_pwm_set_channel(self->pwm, channel, period_ns, duty_ns);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_PWM_start_doc,
+"start() -> None\n"
+"\n"
+"Start generating pulses.");
+
+static PyObject *gpiod_PWM_start(gpiod_PWMObject *self)
+{
+	int rv;
+
+	rv = gpiod_pwm_start(self->pwm);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_PWM_stop_doc,
+"stop() -> None\n"
+"\n"
+"Stop generating pulses and set all lines to inactive.");
+
+static PyObject *gpiod_PWM_stop(gpiod_PWMObject *self)
+{
+	Py_BEGIN_ALLOW_THREADS;
+	gpiod_pwm_stop(self->pwm);
+	Py_END_ALLOW_THREADS;
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gpiod_PWM_stats_doc,
+"stats() -> (edges, min_latency, max_latency, total_latency)\n"
+"\n"
+"Get the timing statistics of this PWM since it was last started. Returns\n"
+"the number of times the line values were changed and the lowest, highest\n"
+"and total latency of these changes in nanoseconds.");
+
+static PyObject *gpiod_PWM_stats(gpiod_PWMObject *self)
+{
+	struct gpiod_pwm_stats stats;
+	int rv;
+
+	rv = gpiod_pwm_get_stats(self->pwm, &stats);
+	if (rv) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return NULL;
+	}
+
+	return Py_BuildValue("(KKKK)",
+			     (unsigned long long)stats.edges,
+			     (unsigned long long)stats.min_latency,
+			     (unsigned long long)stats.max_latency,
+			     (unsigned long long)stats.total_latency);
+}
+
+static PyMethodDef gpiod_PWM_methods[] = {
+	{
+		.ml_name = "set_sched",
+		.ml_meth = (PyCFunction)gpiod_PWM_set_sched,
+		.ml_doc = gpiod_PWM_set_sched_doc,
+		.ml_flags = METH_VARARGS,
+	},
+	{
+		.ml_name = "set_cpu",
+		.ml_meth = (PyCFunction)gpiod_PWM_set_cpu,
+		.ml_doc = gpiod_PWM_set_cpu_doc,
+		.ml_flags = METH_VARARGS,
+	},
+	{
+		.ml_name = "set_channel",
+		.ml_meth = (PyCFunction)gpiod_PWM_set_channel,
+		.ml_doc = gpiod_PWM_set_channel_doc,
+		.ml_flags = METH_VARARGS,
+	},
+	{
+		.ml_name = "start",
+		.ml_meth = (PyCFunction)gpiod_PWM_start,
+		.ml_doc = gpiod_PWM_start_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{
+		.ml_name = "stop",
+		.ml_meth = (PyCFunction)gpiod_PWM_stop,
+		.ml_doc = gpiod_PWM_stop_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{
+		.ml_name = "stats",
+		.ml_meth = (PyCFunction)gpiod_PWM_stats,
+		.ml_doc = gpiod_PWM_stats_doc,
+		.ml_flags = METH_NOARGS,
+	},
+	{ }
+};
+
+PyDoc_STRVAR(gpiod_PWMType_doc,
+"Generates pulses on a set of output lines from a dedicated thread.\n"
+"\n"
+"The PWM's constructor takes a gpiod.LineBulk object holding lines requested\n"
+"together as outputs and the initial period of all channels in nanoseconds.\n"
+"Every line is a channel, numbered by its index in the bulk. The edges of\n"
+"all channels are merged into a single schedule so that every instant at\n"
+"which any channel changes costs a single ioctl.\n"
+"\n"
+"Example:\n"
+"\n"
+"    pwm = gpiod.PWM(lines, 1000000)\n"
+"    pwm.set_channel(0, 1000000, 250000)\n"
+"    pwm.start()");
+
+static PyTypeObject gpiod_PWMType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "gpiod.PWM",
+	.tp_basicsize = sizeof(gpiod_PWMObject),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_doc = gpiod_PWMType_doc,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)gpiod_PWM_init,
+	.tp_dealloc = (destructor)gpiod_PWM_dealloc,
+	.tp_methods = gpiod_PWM_methods,
+};
+
+PyDoc_STRVAR(gpiod_Module_find_line_doc,
+"find_line(name) -> gpiod.Line object or None\n"
+"\n"
+"Lookup a GPIO line by name. Search all gpiochips. Returns a gpiod.Line\n"
+"or None if a line with given name doesn't exist in the system.\n"
+"\n"
+"NOTE: the gpiod.Chip object owning the returned line must be closed\n"
+"by the caller.\n"
+"\n"
 "  name\n"
 "    Name of the line to find (string).");
 
@@ -2210,7 +3550,9 @@ static gpiod_PyType gpiod_PyType_list[] = {
 	{ .name = "LineEvent",	.typeobj = &gpiod_LineEventType,	},
 	{ .name = "LineBulk",	.typeobj = &gpiod_LineBulkType,		},
 	{ .name = "LineIter",	.typeobj = &gpiod_LineIterType,		},
-	{ .name = "ChipIter",	.typeobj = &gpiod_ChipIterType		},
+	{ .name = "ChipIter",	.typeobj = &gpiod_ChipIterType,		},
+	{ .name = "EventSource", .typeobj = &gpiod_EventSourceType,	},
+	{ .name = "PWM",	.typeobj = &gpiod_PWMType,		},
 	{ }
 };
 
@@ -2246,6 +3588,21 @@ static gpiod_ConstDescr gpiod_ConstList[] = {
 		.name = "OPEN_BY_NUMBER",
 		.val = gpiod_OPEN_BY_NUMBER,
 	},
+	{
+		.typeobj = &gpiod_ChipType,
+		.name = "LINE_INFO_REFRESH_ALWAYS",
+		.val = gpiod_LINE_INFO_REFRESH_ALWAYS,
+	},
+	{
+		.typeobj = &gpiod_ChipType,
+		.name = "LINE_INFO_REFRESH_IF_STALE",
+		.val = gpiod_LINE_INFO_REFRESH_IF_STALE,
+	},
+	{
+		.typeobj = &gpiod_ChipType,
+		.name = "LINE_INFO_REFRESH_NEVER",
+		.val = gpiod_LINE_INFO_REFRESH_NEVER,
+	},
 	{
 		.typeobj = &gpiod_LineType,
 		.name = "DIRECTION_INPUT",
@@ -2334,6 +3691,22 @@ static gpiod_ModuleConst gpiod_ModuleConsts[] = {
 		.name = "LINE_REQ_FLAG_ACTIVE_LOW",
 		.value = gpiod_LINE_REQ_FLAG_ACTIVE_LOW,
 	},
+	{
+		.name = "LINE_REQ_FLAG_SHARED_EVENT_FD",
+		.value = gpiod_LINE_REQ_FLAG_SHARED_EVENT_FD,
+	},
+	{
+		.name = "LINE_REQ_FLAG_BIAS_DISABLE",
+		.value = gpiod_LINE_REQ_FLAG_BIAS_DISABLE,
+	},
+	{
+		.name = "LINE_REQ_FLAG_BIAS_PULL_DOWN",
+		.value = gpiod_LINE_REQ_FLAG_BIAS_PULL_DOWN,
+	},
+	{
+		.name = "LINE_REQ_FLAG_BIAS_PULL_UP",
+		.value = gpiod_LINE_REQ_FLAG_BIAS_PULL_UP,
+	},
 	{ }
 };
 
@@ -9,6 +9,7 @@
 #define __LIBGPIOD_GPIOD_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -37,6 +38,12 @@ extern "C" {
  * but in general a function that returns an int, returns -1 on error, while
  * a function returning a pointer bails out on error condition by returning
  * a NULL pointer.
+ *
+ * <p>General note on thread safety: lines can be retrieved from a chip and
+ * distinct requests of the same chip can be operated on concurrently from
+ * different threads. Operations on a single request, as well as opening and
+ * closing the chip and changing its line info policy, must be serialized by
+ * the caller.
  */
 
 struct gpiod_chip;
@@ -44,6 +51,15 @@ struct gpiod_line;
 struct gpiod_chip_iter;
 struct gpiod_line_iter;
 struct gpiod_line_bulk;
+struct gpiod_event_waiter;
+struct gpiod_event_drain;
+struct gpiod_event_uring;
+struct gpiod_event_source;
+struct gpiod_line_prepared;
+struct gpiod_line_array;
+struct gpiod_line_group;
+struct gpiod_waveform;
+struct gpiod_pwm;
 
 /**
  * @defgroup __common__ Common helper macros
@@ -175,6 +191,18 @@ enum {
 	/**< Rising edge event occured. */
 	GPIOD_CTXLESS_EVENT_CB_FALLING_EDGE,
 	/**< Falling edge event occured. */
+	GPIOD_CTXLESS_EVENT_CB_DROPPED_EVENT,
+	/**< An event was lost by the kernel. Only reported if
+	 *   ::GPIOD_CTXLESS_FLAG_REPORT_DROPPED was passed to the monitor. */
+};
+
+/**
+ * @brief Flags modifying the behavior of the ctxless event monitor.
+ */
+enum {
+	GPIOD_CTXLESS_FLAG_REPORT_DROPPED = GPIOD_BIT(0),
+	/**< Call the event callback with ::GPIOD_CTXLESS_EVENT_CB_DROPPED_EVENT
+	 *   once for every lost event (see ::gpiod_line_event_get_stats). */
 };
 
 /**
@@ -342,7 +370,7 @@ int gpiod_ctxless_event_monitor(const char *device, int event_type,
  * @param data User data passed to the callback.
  * @return 0 no errors were encountered, -1 if an error occurred.
  * @note The poll callback can be NULL in which case the routine will fall
- *       back to a basic, ppoll() based callback.
+ *       back to a basic, epoll() based event waiter.
  *
  * Internally this routine opens the GPIO chip, requests the set of lines for
  * the type of events specified in the event_type paramter and calls the
@@ -355,7 +383,7 @@ int gpiod_ctxless_event_monitor(const char *device, int event_type,
  * point.
  *
  * The poll_cb argument can be NULL in which case the function falls back to
- * a default, ppoll() based callback.
+ * a default, epoll() based event waiter (see ::gpiod_event_waiter_new).
  */
 int gpiod_ctxless_event_monitor_multiple(
 			const char *device, int event_type,
@@ -366,15 +394,43 @@ int gpiod_ctxless_event_monitor_multiple(
 			gpiod_ctxless_event_handle_cb event_cb,
 			void *data) GPIOD_API;
 
+/**
+ * @brief Wait for events on multiple GPIO lines with additional flags.
+ * @param device Name, path, number or label of the gpiochip.
+ * @param event_type Type of events to listen for.
+ * @param offsets Array of GPIO line offsets to monitor.
+ * @param num_lines Number of lines to monitor.
+ * @param active_low The active state of this line - true if low.
+ * @param consumer Name of the consumer.
+ * @param timeout Maximum wait time for each iteration.
+ * @param poll_cb Callback function to call when waiting for events. Can
+ *                be NULL.
+ * @param event_cb Callback function to call on event occurrence.
+ * @param data User data passed to the callback.
+ * @param flags Combination of GPIOD_CTXLESS_FLAG_* flags.
+ * @return 0 no errors were encountered, -1 if an error occurred.
+ *
+ * Works like ::gpiod_ctxless_event_monitor_multiple. Lost events are reported
+ * to the event callback before the events read after them.
+ */
+int gpiod_ctxless_event_monitor_multiple_ext(
+			const char *device, int event_type,
+			const unsigned int *offsets,
+			unsigned int num_lines, bool active_low,
+			const char *consumer, const struct timespec *timeout,
+			gpiod_ctxless_event_poll_cb poll_cb,
+			gpiod_ctxless_event_handle_cb event_cb,
+			void *data, int flags) GPIOD_API;
+
 /**
  * @brief Determine the chip name and line offset of a line with given name.
  * @param name The name of the GPIO line to lookup.
  * @param chipname Buffer in which the name of the GPIO chip will be stored.
  * @param chipname_size Size of the chip name buffer.
  * @param offset Pointer to an integer in which the line offset will be stored.
- * @return -1 on error, 0 if the line with given name doesn't exist and 1 if
- *         the line was found. In the first two cases the contents of chipname
- *         and offset remain unchanged.
+ * @return -1 on error, 0 if the line with given name is not in the cache and
+ *         1 if the line was found. In the first two cases the contents of
+ *         chipname and offset remain unchanged.
  * @note The chip name is truncated if the buffer can't hold its entire size.
  */
 int gpiod_ctxless_find_line(const char *name, char *chipname,
@@ -397,6 +453,31 @@ int gpiod_ctxless_find_line(const char *name, char *chipname,
  */
 struct gpiod_chip *gpiod_chip_open(const char *path) GPIOD_API;
 
+/**
+ * @brief Flags which can be passed to gpiod_chip_open_flags().
+ */
+enum {
+	GPIOD_CHIP_OPEN_FLAG_NO_VERIFY = GPIOD_BIT(0),
+	/**< Don't check in sysfs whether the file is a GPIO character device. */
+	GPIOD_CHIP_OPEN_FLAG_UAPI_V1 = GPIOD_BIT(1),
+	/**< Use the v1 kernel uAPI even if the kernel supports v2. */
+};
+
+/**
+ * @brief Open a gpiochip by path with additional flags.
+ * @param path Path to the gpiochip device file.
+ * @param flags Combination of GPIOD_CHIP_OPEN_FLAG_* values.
+ * @return GPIO chip handle or NULL if an error occurred.
+ *
+ * By default the opened file is checked against the dev attribute of its
+ * sysfs GPIO device entry. Callers which know the path to be a GPIO chip
+ * (for instance: ones which just got it from a udev event) can skip this
+ * check with GPIOD_CHIP_OPEN_FLAG_NO_VERIFY - a file which is not a GPIO
+ * chip will then only be rejected by the chip info ioctl().
+ */
+struct gpiod_chip *gpiod_chip_open_flags(const char *path,
+					 int flags) GPIOD_API;
+
 /**
  * @brief Open a gpiochip by name.
  * @param name Name of the gpiochip to open.
@@ -463,6 +544,89 @@ const char *gpiod_chip_label(struct gpiod_chip *chip) GPIOD_API;
  */
 unsigned int gpiod_chip_num_lines(struct gpiod_chip *chip) GPIOD_API;
 
+/**
+ * @brief Policies deciding when the info of lines exposed by a chip is
+ *        re-read from the kernel.
+ */
+enum {
+	GPIOD_LINE_INFO_REFRESH_ALWAYS = 1,
+	/**< Refresh the line info every time the line is retrieved from the
+	 *   chip and on first access after the line was requested. This is the
+	 *   default. */
+	GPIOD_LINE_INFO_REFRESH_IF_STALE,
+	/**< Retrieving a line never queries the kernel - the line info is only
+	 *   read on first access after the line was first retrieved, requested
+	 *   or invalidated. */
+	GPIOD_LINE_INFO_REFRESH_NEVER,
+	/**< Like GPIOD_LINE_INFO_REFRESH_IF_STALE but requesting lines doesn't
+	 *   make their info stale: it's only re-read after calling
+	 *   ::gpiod_chip_invalidate_line_info or ::gpiod_line_update. */
+};
+
+/**
+ * @brief Set the policy for refreshing the info of lines exposed by a chip.
+ * @param chip The GPIO chip object.
+ * @param policy One of GPIOD_LINE_INFO_REFRESH_* values.
+ * @return 0 on success, -1 on failure (errno is set to EINVAL if the policy
+ *         is not valid).
+ *
+ * Callers which only need line handles (for instance to request lines and
+ * read or set their values) can avoid a GPIO_GET_LINEINFO_IOCTL for every
+ * call to ::gpiod_chip_get_line by choosing a policy other than the default
+ * GPIOD_LINE_INFO_REFRESH_ALWAYS.
+ */
+int gpiod_chip_set_line_info_policy(struct gpiod_chip *chip,
+				    int policy) GPIOD_API;
+
+/**
+ * @brief Get the current line info refresh policy of a chip.
+ * @param chip The GPIO chip object.
+ * @return One of GPIOD_LINE_INFO_REFRESH_* values.
+ */
+int gpiod_chip_get_line_info_policy(struct gpiod_chip *chip) GPIOD_API;
+
+/**
+ * @brief Mark the info of all lines exposed by a chip as stale.
+ * @param chip The GPIO chip object.
+ *
+ * The info of every line is re-read from the kernel the next time it's
+ * accessed, regardless of the refresh policy.
+ */
+void gpiod_chip_invalidate_line_info(struct gpiod_chip *chip) GPIOD_API;
+
+/**
+ * @brief Get the version of the kernel uAPI used to access a chip.
+ * @param chip The GPIO chip object.
+ * @return 2 if the chip is accessed using the v2 uAPI, 1 otherwise.
+ *
+ * The v2 uAPI is selected when the chip is opened if the running kernel
+ * supports it, unless GPIOD_CHIP_OPEN_FLAG_UAPI_V1 was passed to
+ * ::gpiod_chip_open_flags. The v1 uAPI is used on older kernels.
+ */
+int gpiod_chip_uapi_version(struct gpiod_chip *chip) GPIOD_API;
+
+/**
+ * @brief Set the size of the kernel event buffer of event requests.
+ * @param chip The GPIO chip object.
+ * @param size Number of events the kernel can queue for a single request or
+ *             0 to use the kernel default (16 events per requested line).
+ * @return 0 on success, -1 on failure (errno is set to ENOTSUP if the chip
+ *         is accessed using the v1 uAPI).
+ *
+ * The size applies to lines requested for events after this call. The kernel
+ * may cap it.
+ */
+int gpiod_chip_set_event_buffer_size(struct gpiod_chip *chip,
+				     unsigned int size) GPIOD_API;
+
+/**
+ * @brief Get the size of the kernel event buffer of event requests.
+ * @param chip The GPIO chip object.
+ * @return Number of events or 0 if the kernel default is used.
+ */
+unsigned int
+gpiod_chip_get_event_buffer_size(struct gpiod_chip *chip) GPIOD_API;
+
 /**
  * @brief Get the handle to the GPIO line at given offset.
  * @param chip The GPIO chip object.
@@ -489,6 +653,10 @@ int gpiod_chip_get_lines(struct gpiod_chip *chip,
  * @param chip The GPIO chip object.
  * @param bulk Line bulk object in which to store the line handles.
  * @return 0 on success, -1 on error.
+ *
+ * If the chip exposes more than ::GPIOD_LINE_BULK_MAX_LINES lines, errno is
+ * set to E2BIG. Use ::gpiod_line_array_add to collect the lines of larger
+ * chips.
  */
 int gpiod_chip_get_all_lines(struct gpiod_chip *chip,
 			     struct gpiod_line_bulk *bulk) GPIOD_API;
@@ -501,6 +669,11 @@ int gpiod_chip_get_all_lines(struct gpiod_chip *chip,
  *         found or an error occurred.
  * @note In case a line with given name is not associated with given chip, the
  *       function sets errno to ENOENT.
+ *
+ * The first call builds an index of the names of all lines exposed by the
+ * chip which is then reused by subsequent lookups for as long as the chip
+ * stays open. If several lines share the same name, the one with the lowest
+ * offset is returned.
  */
 struct gpiod_line *
 gpiod_chip_find_line(struct gpiod_chip *chip, const char *name) GPIOD_API;
@@ -513,7 +686,8 @@ gpiod_chip_find_line(struct gpiod_chip *chip, const char *name) GPIOD_API;
  * @param bulk Line bulk object in which the located lines will be stored.
  * @return 0 if all lines were located, -1 on error.
  * @note If at least one line from the list could not be found among the lines
- *       exposed by this chip, the function sets errno to ENOENT.
+ *       exposed by this chip, the function sets errno to ENOENT. If there are
+ *       more than ::GPIOD_LINE_BULK_MAX_LINES names, errno is set to E2BIG.
  */
 int gpiod_chip_find_lines(struct gpiod_chip *chip, const char **names,
 			  struct gpiod_line_bulk *bulk) GPIOD_API;
@@ -740,10 +914,11 @@ int gpiod_line_update(struct gpiod_line *line) GPIOD_API;
  * @return Returns false if the line is up-to-date. True otherwise.
  *
  * The line is updated by calling gpiod_line_update() from within
- * gpiod_chip_get_line() and on every line request/release. However: an error
- * returned from gpiod_line_update() only breaks the execution of the former.
- * The request/release routines only set the internal up-to-date flag to false
- * and continue their execution. This routine allows to check if a line info
+ * gpiod_chip_get_line(). Requesting a line marks its info as outdated and it's
+ * then updated the next time any of the line info getters is called. However:
+ * an error returned from gpiod_line_update() only breaks the execution of the
+ * former. The getters only set the internal up-to-date flag to false and
+ * return the previous info. This routine allows to check if a line info
  * update failed at some point and we should call gpiod_line_update()
  * explicitly.
  */
@@ -784,10 +959,43 @@ enum {
 	/**< The line is an open-source port. */
 	GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW	= GPIOD_BIT(2),
 	/**< The active state of the line is low (high is the default). */
+	GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD	= GPIOD_BIT(3),
+	/**< Request all lines for events with a single file descriptor. Only
+	 *   supported by the v2 uAPI. */
+	GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE	= GPIOD_BIT(4),
+	/**< Disable the internal bias of the line. */
+	GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN	= GPIOD_BIT(5),
+	/**< Enable the internal pull-down of the line. */
+	GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP	= GPIOD_BIT(6),
+	/**< Enable the internal pull-up of the line. */
+	GPIOD_LINE_REQUEST_FLAG_DEBOUNCE	= GPIOD_BIT(7),
+	/**< Debounce the line using the period from the request config. Only
+	 *   supported by the v2 uAPI. */
+	GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG	= GPIOD_BIT(8),
+	/**< Apply the per-line configs from the request config. Only
+	 *   supported by the v2 uAPI for values and shared event requests. */
+};
+
+/**
+ * @brief Structure overriding the request configuration of a single line.
+ */
+struct gpiod_line_config {
+	unsigned int offset;
+	/**< Hardware offset of the line this config applies to. */
+	int request_type;
+	/**< Request type or 0 to use the one of the whole request. Lines can't
+	 *   mix direction and event request types. */
+	int flags;
+	/**< Configuration flags replacing the ones of the whole request. */
+	unsigned int debounce_period_us;
+	/**< Debounce period if GPIOD_LINE_REQUEST_FLAG_DEBOUNCE is set. */
 };
 
 /**
  * @brief Structure holding configuration of a line request.
+ *
+ * The fields following flags are only read if the corresponding request flag
+ * is set.
  */
 struct gpiod_line_request_config {
 	const char *consumer;
@@ -796,6 +1004,14 @@ struct gpiod_line_request_config {
 	/**< Request type. */
 	int flags;
 	/**< Other configuration flags. */
+	unsigned int debounce_period_us;
+	/**< Debounce period in microseconds, used if
+	 *   GPIOD_LINE_REQUEST_FLAG_DEBOUNCE is set. */
+	const struct gpiod_line_config *line_configs;
+	/**< Per-line overrides, used if GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG
+	 *   is set. Lines without an override use the config of the request. */
+	unsigned int num_line_configs;
+	/**< Number of entries in line_configs. */
 };
 
 /**
@@ -927,6 +1143,12 @@ int gpiod_line_request_both_edges_events_flags(struct gpiod_line *line,
  * If this routine succeeds, the caller takes ownership of the GPIO lines
  * until they're released. All the requested lines must be prodivided by the
  * same gpiochip.
+ *
+ * Lines requested for events get a file descriptor each unless
+ * GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD is set. In that case all lines share
+ * a single file descriptor: reading events from any of them returns the events
+ * of every line in the request, told apart by the offset field of
+ * ::gpiod_line_event.
  */
 int gpiod_line_request_bulk(struct gpiod_line_bulk *bulk,
 			    const struct gpiod_line_request_config *config,
@@ -1120,184 +1342,1452 @@ int gpiod_line_set_value_bulk(struct gpiod_line_bulk *bulk,
 			      const int *values) GPIOD_API;
 
 /**
- * @}
+ * @brief Read current values of a set of GPIO lines into a bitmask.
+ * @param bulk Set of GPIO lines to reserve.
+ * @param values Address of the variable in which to store the values. Bit N
+ *               holds the value of the N-th line in the bulk object.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
  *
- * @defgroup __line_event__ Line events handling
- * @{
+ * If the lines were not previously requested together, the behavior is
+ * undefined.
  */
+int gpiod_line_get_value_bulk_mask(struct gpiod_line_bulk *bulk,
+				   uint64_t *values) GPIOD_API;
 
 /**
- * @brief Event types.
+ * @brief Set the values of a set of GPIO lines from a bitmask.
+ * @param bulk Set of GPIO lines to reserve.
+ * @param values New values. Bit N holds the value of the N-th line in the
+ *               bulk object.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ *
+ * If the lines were not previously requested together, the behavior is
+ * undefined.
  */
-enum {
-	GPIOD_LINE_EVENT_RISING_EDGE = 1,
-	/**< Rising edge event. */
-	GPIOD_LINE_EVENT_FALLING_EDGE,
-	/**< Falling edge event. */
-};
+int gpiod_line_set_value_bulk_mask(struct gpiod_line_bulk *bulk,
+				   uint64_t values) GPIOD_API;
 
 /**
- * @brief Structure holding event info.
+ * @brief Set the values of a subset of a set of GPIO lines.
+ * @param bulk Set of GPIO lines to reserve.
+ * @param mask Bitmask of lines to change. Bit N corresponds with the N-th
+ *             line in the bulk object.
+ * @param values New values. Only bits set in mask are taken into account.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ *
+ * The values of the lines not included in the mask are preserved. With the
+ * v2 uAPI the kernel updates only the masked lines. The v1 uAPI doesn't
+ * support partial updates, so this routine then reads the current values
+ * first and the read-modify-write sequence is not atomic with regard to other
+ * users of the same line handle.
  */
-struct gpiod_line_event {
-	struct timespec ts;
-	/**< Best estimate of time of event occurrence. */
-	int event_type;
-	/**< Type of the event that occurred. */
-};
+int gpiod_line_set_value_bulk_masked(struct gpiod_line_bulk *bulk,
+				     uint64_t mask,
+				     uint64_t values) GPIOD_API;
 
 /**
- * @brief Wait for an event on a single line.
+ * @brief Change the configuration of a single requested GPIO line.
  * @param line GPIO line object.
- * @param timeout Wait time limit.
- * @return 0 if wait timed out, -1 if an error occurred, 1 if an event
- *         occurred.
+ * @param direction New direction: one of the GPIOD_LINE_REQUEST_DIRECTION_*
+ *                  request types.
+ * @param flags New request flags: a combination of the open-drain,
+ *              open-source, active-low and bias flags.
+ * @param value New value - only relevant if the direction is output.
+ * @return 0 if the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
  */
-int gpiod_line_event_wait(struct gpiod_line *line,
-			  const struct timespec *timeout) GPIOD_API;
+int gpiod_line_set_config(struct gpiod_line *line, int direction,
+			  int flags, int value) GPIOD_API;
 
 /**
- * @brief Wait for events on a set of lines.
- * @param bulk Set of GPIO lines to monitor.
- * @param timeout Wait time limit.
- * @param event_bulk Bulk object in which to store the line handles on which
- *                   events occurred. Can be NULL.
- * @return 0 if wait timed out, -1 if an error occurred, 1 if at least one
- *         event occurred.
+ * @brief Change the configuration of a set of requested GPIO lines.
+ * @param bulk Set of GPIO lines. All lines must have been requested for
+ *             values together in a single request, in the same order.
+ * @param direction New direction: one of the GPIOD_LINE_REQUEST_DIRECTION_*
+ *                  request types.
+ * @param flags New request flags: a combination of the open-drain,
+ *              open-source, active-low and bias flags.
+ * @param values Array of output values - only relevant if the direction is
+ *               output. May be NULL.
+ * @return 0 if the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ *
+ * The lines are reconfigured in place, without releasing them, so the line
+ * handle stays open and there's no window in which the lines are free. The
+ * new config replaces the one of the whole request. Requires linux v5.5 or
+ * later.
  */
-int gpiod_line_event_wait_bulk(struct gpiod_line_bulk *bulk,
-			       const struct timespec *timeout,
-			       struct gpiod_line_bulk *event_bulk) GPIOD_API;
+int gpiod_line_set_config_bulk(struct gpiod_line_bulk *bulk, int direction,
+			       int flags, const int *values) GPIOD_API;
 
 /**
- * @brief Read the last event from the GPIO line.
- * @param line GPIO line object.
- * @param event Buffer to which the event data will be copied.
- * @return 0 if the event was read correctly, -1 on error.
- * @note This function will block if no event was queued for this line.
+ * @brief Prepare a set of requested lines for fast value access.
+ * @param bulk Set of GPIO lines. All lines must have been requested together
+ *             in a single request.
+ * @return New prepared request object or NULL if an error occurred.
+ *
+ * The lines are validated once when the prepared request is created. The
+ * get and set routines operating on the returned object skip all per-call
+ * checks and go straight to the kernel. The prepared request holds a
+ * reference to the underlying line handle, so it stays valid until it is
+ * freed even if the lines are released in the meantime.
+ *
+ * @note As a consequence, the lines stay claimed in the kernel after they're
+ *       released with ::gpiod_line_release_bulk and can't be requested again
+ *       (the request fails with EBUSY) until the prepared request is freed.
+ *
+ * If the lines were not requested together, errno is set to EINVAL. If any
+ * of the lines is not requested, errno is set to EPERM.
  */
-int gpiod_line_event_read(struct gpiod_line *line,
-			  struct gpiod_line_event *event) GPIOD_API;
+struct gpiod_line_prepared *
+gpiod_line_prepared_new(struct gpiod_line_bulk *bulk) GPIOD_API;
 
 /**
- * @brief Get the event file descriptor.
- * @param line GPIO line object.
- * @return Number of the event file descriptor or -1 if the user tries to
- *         retrieve the descriptor from a line that wasn't configured for
- *         event monitoring.
- *
- * Users may want to poll the event file descriptor on their own. This routine
- * allows to access it.
+ * @brief Release all resources associated with a prepared request.
+ * @param prepared Prepared request object.
  */
-int gpiod_line_event_get_fd(struct gpiod_line *line) GPIOD_API;
+void gpiod_line_prepared_free(struct gpiod_line_prepared *prepared) GPIOD_API;
 
 /**
- * @brief Read the last GPIO event directly from a file descriptor.
- * @param fd File descriptor.
- * @param event Buffer in which the event data will be stored.
- * @return 0 if the event was read correctly, -1 on error.
- *
- * Users who directly poll the file descriptor for incoming events can also
- * directly read the event data from it using this routine. This function
- * translates the kernel representation of the event to the libgpiod format.
+ * @brief Get the number of lines in a prepared request.
+ * @param prepared Prepared request object.
+ * @return Number of lines the prepared request was created from.
  */
-int gpiod_line_event_read_fd(int fd, struct gpiod_line_event *event) GPIOD_API;
+unsigned int
+gpiod_line_prepared_num_lines(struct gpiod_line_prepared *prepared) GPIOD_API;
+
+/**
+ * @brief Read the values of the lines in a prepared request.
+ * @param prepared Prepared request object.
+ * @param values An array big enough to hold the number of values equal to
+ *               the number of lines in the prepared request.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_prepared_get_values(struct gpiod_line_prepared *prepared,
+				   int *values) GPIOD_API;
+
+/**
+ * @brief Set the values of the lines in a prepared request.
+ * @param prepared Prepared request object.
+ * @param values An array holding the number of values equal to the number
+ *               of lines in the prepared request.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_prepared_set_values(struct gpiod_line_prepared *prepared,
+				   const int *values) GPIOD_API;
+
+/**
+ * @brief Read the values of the lines in a prepared request into a bitmask.
+ * @param prepared Prepared request object.
+ * @param values Address of the variable in which to store the values. Bit N
+ *               holds the value of the N-th line in the prepared request.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_prepared_get_values_mask(struct gpiod_line_prepared *prepared,
+					uint64_t *values) GPIOD_API;
+
+/**
+ * @brief Set the values of the lines in a prepared request from a bitmask.
+ * @param prepared Prepared request object.
+ * @param values New values. Bit N holds the value of the N-th line in the
+ *               prepared request.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_prepared_set_values_mask(struct gpiod_line_prepared *prepared,
+					uint64_t values) GPIOD_API;
 
 /**
  * @}
  *
- * @defgroup __line_misc__ Misc line functions
+ * @defgroup __line_output__ Timed output generation
  * @{
  */
 
 /**
- * @brief Get a GPIO line handle by GPIO chip description and offset.
- * @param device String describing the gpiochip.
- * @param offset The offset of the GPIO line.
- * @return GPIO line handle or NULL if an error occurred.
+ * @brief Single step of a waveform.
+ */
+struct gpiod_waveform_step {
+	uint64_t time;
+	/**< Time at which the step is played, in nanoseconds since the start
+	 *   of the playback. */
+	uint64_t values;
+	/**< Values to set, bit N holds the value of the Nth line of the
+	 *   bulk. */
+};
+
+/**
+ * @brief Timing statistics of a waveform playback.
  *
- * This routine provides a shorter alternative to calling
- * ::gpiod_chip_open_lookup and ::gpiod_chip_get_line.
+ * The latency of a step is the time between its scheduled and its actual
+ * playback.
+ */
+struct gpiod_waveform_stats {
+	uint64_t steps;
+	/**< Number of steps played. */
+	uint64_t min_latency;
+	/**< Lowest latency in nanoseconds. */
+	uint64_t max_latency;
+	/**< Highest latency in nanoseconds. */
+	uint64_t total_latency;
+	/**< Sum of the latencies of all steps in nanoseconds. */
+};
+
+/**
+ * @brief Create a new waveform.
+ * @param bulk Set of GPIO lines requested together as outputs.
+ * @param steps Array of steps sorted by time.
+ * @param num_steps Number of steps in the array.
+ * @return New waveform object or NULL if an error occurred.
  *
- * If this function succeeds, the caller is responsible for closing the
- * associated GPIO chip.
+ * A waveform plays a preloaded sequence of steps from a dedicated thread. The
+ * thread sleeps until the absolute time of every step on CLOCK_MONOTONIC, so
+ * unlike setting the values in a loop with relative sleeps, the timing errors
+ * don't accumulate. The steps are copied and the lines validated when the
+ * waveform is created, so playing a step costs a single ioctl.
+ *
+ * If the steps are not sorted by time, errno is set to EINVAL.
  */
-struct gpiod_line *
-gpiod_line_get(const char *device, unsigned int offset) GPIOD_API;
+struct gpiod_waveform *
+gpiod_waveform_new(struct gpiod_line_bulk *bulk,
+		   const struct gpiod_waveform_step *steps,
+		   unsigned int num_steps) GPIOD_API;
 
 /**
- * @brief Find a GPIO line by its name.
- * @param name Name of the GPIO line.
- * @return Returns the GPIO line handle if the line exists in the system or
- *         NULL if it couldn't be located or an error occurred.
+ * @brief Stop the playback and release all resources associated with a
+ *        waveform.
+ * @param waveform Waveform object.
  *
- * If this routine succeeds, the user must manually close the GPIO chip owning
- * this line to avoid memory leaks. If the line could not be found, this
- * functions sets errno to ENOENT.
+ * The lines are not released.
  */
-struct gpiod_line *gpiod_line_find(const char *name) GPIOD_API;
+void gpiod_waveform_free(struct gpiod_waveform *waveform) GPIOD_API;
 
 /**
- * @brief Close a GPIO chip owning this line and release all resources.
- * @param line GPIO line object
- *
- * After this function returns, the line must no longer be used.
+ * @brief Set the scheduling policy and priority of the playback thread.
+ * @param waveform Waveform object.
+ * @param policy Scheduling policy (SCHED_OTHER, SCHED_FIFO or SCHED_RR).
+ * @param priority Scheduling priority, only used by the realtime policies.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the waveform is
+ *         playing.
  */
-void gpiod_line_close_chip(struct gpiod_line *line) GPIOD_API;
+int gpiod_waveform_set_sched(struct gpiod_waveform *waveform,
+			     int policy, int priority) GPIOD_API;
 
 /**
- * @brief Get the handle to the GPIO chip controlling this line.
- * @param line The GPIO line object.
- * @return Pointer to the GPIO chip handle controlling this line.
+ * @brief Pin the playback thread to a single CPU.
+ * @param waveform Waveform object.
+ * @param cpu CPU number or -1 to let the thread run on any CPU.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the waveform is
+ *         playing.
  */
-struct gpiod_chip *gpiod_line_get_chip(struct gpiod_line *line) GPIOD_API;
+int gpiod_waveform_set_cpu(struct gpiod_waveform *waveform,
+			   int cpu) GPIOD_API;
 
 /**
- * @}
- *
- * @}
+ * @brief Set the length of the busy-wait tail before every step.
+ * @param waveform Waveform object.
+ * @param spin_ns Number of nanoseconds before the time of every step at
+ *                which the thread stops sleeping and starts polling the
+ *                clock. 0 disables busy-waiting.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the waveform is
+ *         playing.
  *
- * @defgroup __iterators__ Iterators for GPIO chips and lines
- * @{
+ * Busy-waiting the last few microseconds makes the timing independent of the
+ * wake-up latency of the scheduler, at the cost of keeping a CPU busy.
+ */
+int gpiod_waveform_set_spin(struct gpiod_waveform *waveform,
+			    uint64_t spin_ns) GPIOD_API;
+
+/**
+ * @brief Start playing a waveform.
+ * @param waveform Waveform object.
+ * @param start Absolute CLOCK_MONOTONIC time to which the times of the steps
+ *              are relative. Can be NULL in which case the playback starts
+ *              immediately.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the waveform is
+ *         already playing.
  *
- * These functions and data structures allow easy iterating over GPIO
- * chips and lines.
+ * A waveform which finished playing can be started again.
  */
+int gpiod_waveform_start(struct gpiod_waveform *waveform,
+			 const struct timespec *start) GPIOD_API;
 
 /**
- * @brief Create a new gpiochip iterator.
- * @return Pointer to a new chip iterator object or NULL if an error occurred.
+ * @brief Stop playing a waveform.
+ * @param waveform Waveform object.
  *
- * Internally this routine scans the /dev/ directory for GPIO chip device
- * files, opens them and stores their the handles until ::gpiod_chip_iter_free
- * or ::gpiod_chip_iter_free_noclose is called.
+ * The lines keep the values set by the last played step.
  */
-struct gpiod_chip_iter *gpiod_chip_iter_new(void) GPIOD_API;
+void gpiod_waveform_stop(struct gpiod_waveform *waveform) GPIOD_API;
 
 /**
- * @brief Release all resources allocated for the gpiochip iterator and close
- *        the most recently opened gpiochip (if any).
- * @param iter The gpiochip iterator object.
+ * @brief Wait until a waveform finishes playing.
+ * @param waveform Waveform object.
+ * @param timeout Wait time limit. Can be NULL in which case the routine
+ *                blocks until the playback finishes.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if the playback
+ *         finished. If setting the values failed during the playback, -1 is
+ *         returned and errno is set to the error of the failed call. If the
+ *         waveform is not playing, errno is set to EINVAL.
  */
-void gpiod_chip_iter_free(struct gpiod_chip_iter *iter) GPIOD_API;
+int gpiod_waveform_wait(struct gpiod_waveform *waveform,
+			const struct timespec *timeout) GPIOD_API;
 
 /**
- * @brief Release all resources allocated for the gpiochip iterator but
- *        don't close the most recently opened gpiochip (if any).
- * @param iter The gpiochip iterator object.
+ * @brief Get the timing statistics of the last playback of a waveform.
+ * @param waveform Waveform object.
+ * @param stats Buffer in which the statistics will be stored.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the waveform is
+ *         playing.
+ */
+int gpiod_waveform_get_stats(struct gpiod_waveform *waveform,
+			     struct gpiod_waveform_stats *stats) GPIOD_API;
+
+/**
+ * @brief Timing statistics of a software PWM.
  *
- * Users may want to break the loop when iterating over gpiochips and keep
- * the most recently opened chip active while freeing the iterator data.
- * This routine enables that.
+ * The latency of an edge is the time between its scheduled and its actual
+ * occurrence. Edges of multiple channels occurring at the same instant are
+ * counted once.
+ */
+struct gpiod_pwm_stats {
+	uint64_t edges;
+	/**< Number of times the line values were changed. */
+	uint64_t min_latency;
+	/**< Lowest latency in nanoseconds. */
+	uint64_t max_latency;
+	/**< Highest latency in nanoseconds. */
+	uint64_t total_latency;
+	/**< Sum of the latencies of all edges in nanoseconds. */
+};
+
+/**
+ * @brief Create a new software PWM.
+ * @param bulk Set of GPIO lines requested together as outputs. Every line
+ *             is a PWM channel, numbered by its index in the bulk.
+ * @param period_ns Initial period of all channels in nanoseconds.
+ * @return New PWM object or NULL if an error occurred.
+ *
+ * A software PWM generates pulses on all its channels from a dedicated
+ * thread. The edges of all channels are merged into a single schedule and
+ * every instant at which any channel changes costs a single ioctl, no matter
+ * how many channels change at once. The duty cycle of all channels is
+ * initially 0.
  */
-void gpiod_chip_iter_free_noclose(struct gpiod_chip_iter *iter) GPIOD_API;
+struct gpiod_pwm *gpiod_pwm_new(struct gpiod_line_bulk *bulk,
+				uint32_t period_ns) GPIOD_API;
 
 /**
- * @brief Get the next gpiochip handle.
- * @param iter The gpiochip iterator object.
+ * @brief Stop the PWM and release all resources associated with it.
+ * @param pwm PWM object.
+ *
+ * The lines are not released.
+ */
+void gpiod_pwm_free(struct gpiod_pwm *pwm) GPIOD_API;
+
+/**
+ * @brief Set the scheduling policy and priority of the PWM thread.
+ * @param pwm PWM object.
+ * @param policy Scheduling policy (SCHED_OTHER, SCHED_FIFO or SCHED_RR).
+ * @param priority Scheduling priority, only used by the realtime policies.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the PWM is
+ *         running.
+ */
+int gpiod_pwm_set_sched(struct gpiod_pwm *pwm,
+			int policy, int priority) GPIOD_API;
+
+/**
+ * @brief Pin the PWM thread to a single CPU.
+ * @param pwm PWM object.
+ * @param cpu CPU number or -1 to let the thread run on any CPU.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the PWM is
+ *         running.
+ */
+int gpiod_pwm_set_cpu(struct gpiod_pwm *pwm, int cpu) GPIOD_API;
+
+/**
+ * @brief Set the period and duty cycle of a PWM channel.
+ * @param pwm PWM object.
+ * @param channel Index of the channel.
+ * @param period_ns Period in nanoseconds. Must not be 0.
+ * @param duty_ns Length of the pulse in nanoseconds. Must not exceed the
+ *                period.
+ * @return 0 on success, -1 on failure.
+ *
+ * Can be called at any time, including while the PWM is running. The update
+ * takes no locks and the PWM thread applies it at the start of the next
+ * period of the channel, so the current pulse is never cut short.
+ */
+int gpiod_pwm_set_channel(struct gpiod_pwm *pwm, unsigned int channel,
+			  uint32_t period_ns, uint32_t duty_ns) GPIOD_API;
+
+/**
+ * @brief Start generating pulses.
+ * @param pwm PWM object.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the PWM is
+ *         already running.
+ *
+ * The first periods of all channels start together.
+ */
+int gpiod_pwm_start(struct gpiod_pwm *pwm) GPIOD_API;
+
+/**
+ * @brief Stop generating pulses.
+ * @param pwm PWM object.
+ *
+ * All lines are set to inactive.
+ */
+void gpiod_pwm_stop(struct gpiod_pwm *pwm) GPIOD_API;
+
+/**
+ * @brief Get the timing statistics of a PWM.
+ * @param pwm PWM object.
+ * @param stats Buffer in which the statistics will be stored.
+ * @return 0 on success, -1 on failure. If setting the values failed, the PWM
+ *         thread exits and errno is set to the error of the failed call.
+ *
+ * Can be called while the PWM is running. The statistics are reset when the
+ * PWM is started.
+ */
+int gpiod_pwm_get_stats(struct gpiod_pwm *pwm,
+			struct gpiod_pwm_stats *stats) GPIOD_API;
+
+/**
+ * @}
+ *
+ * @defgroup __line_event__ Line events handling
+ * @{
+ */
+
+/**
+ * @brief Event types.
+ */
+enum {
+	GPIOD_LINE_EVENT_RISING_EDGE = 1,
+	/**< Rising edge event. */
+	GPIOD_LINE_EVENT_FALLING_EDGE,
+	/**< Falling edge event. */
+};
+
+/**
+ * @brief Maximum number of events that can be read from a line at once.
+ *
+ * This corresponds with the size of the kernel's per-line event queue in
+ * the v1 uAPI.
+ */
+#define GPIOD_LINE_EVENT_MAX_EVENTS	16
+
+/**
+ * @brief Structure holding event info.
+ */
+struct gpiod_line_event {
+	struct timespec ts;
+	/**< Best estimate of time of event occurrence. */
+	int event_type;
+	/**< Type of the event that occurred. */
+	unsigned int offset;
+	/**< Offset of the line on which the event occurred. */
+	unsigned int seqno;
+	/**< Sequence number of the event among all events of the request or 0
+	 *   if the line was requested using the v1 uAPI. */
+	unsigned int line_seqno;
+	/**< Sequence number of the event among the events of this line or 0
+	 *   if the line was requested using the v1 uAPI. */
+};
+
+/**
+ * @brief Structure holding event statistics of a line.
+ */
+struct gpiod_line_event_stats {
+	uint64_t received;
+	/**< Number of events read from the line. */
+	uint64_t dropped;
+	/**< Number of events lost by the kernel before they could be read. */
+};
+
+/**
+ * @brief Get the event statistics of a line.
+ * @param line GPIO line object. Must be requested for events.
+ * @param stats Buffer in which the statistics will be stored.
+ * @return 0 on success, -1 on failure.
+ *
+ * The statistics are reset when the line is requested and cover the events
+ * read using ::gpiod_line_event_read and ::gpiod_line_event_read_multiple.
+ * Events read directly from the file descriptor are not accounted for.
+ *
+ * With the v2 uAPI, dropped events are counted exactly using the kernel's
+ * sequence numbers. The v1 uAPI has no sequence numbers, so drops can only
+ * be detected if both edges are requested: two consecutive events of the
+ * same type mean that at least one event was lost, so the counter is a lower
+ * bound in this case. Drops are never detected on v1 lines requested for a
+ * single edge.
+ */
+int gpiod_line_event_get_stats(struct gpiod_line *line,
+			       struct gpiod_line_event_stats *stats) GPIOD_API;
+
+/**
+ * @brief Reset the event statistics of a line.
+ * @param line GPIO line object.
+ */
+void gpiod_line_event_reset_stats(struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Wait for an event on a single line.
+ * @param line GPIO line object.
+ * @param timeout Wait time limit.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if an event
+ *         occurred.
+ */
+int gpiod_line_event_wait(struct gpiod_line *line,
+			  const struct timespec *timeout) GPIOD_API;
+
+/**
+ * @brief Wait for events on a set of lines.
+ * @param bulk Set of GPIO lines to monitor.
+ * @param timeout Wait time limit.
+ * @param event_bulk Bulk object in which to store the line handles on which
+ *                   events occurred. Can be NULL.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if at least one
+ *         event occurred.
+ */
+int gpiod_line_event_wait_bulk(struct gpiod_line_bulk *bulk,
+			       const struct timespec *timeout,
+			       struct gpiod_line_bulk *event_bulk) GPIOD_API;
+
+/**
+ * @brief Create a new, empty event waiter.
+ * @return New event waiter object or NULL if an error occurred.
+ *
+ * An event waiter registers the file descriptors of lines requested for
+ * events with an epoll instance once and can then be used to wait for events
+ * repeatedly without rebuilding the set of descriptors on every call. The
+ * cost of a single wait is proportional to the number of lines on which
+ * events occurred rather than to the number of monitored lines.
+ */
+struct gpiod_event_waiter *gpiod_event_waiter_new(void) GPIOD_API;
+
+/**
+ * @brief Release all resources associated with an event waiter.
+ * @param waiter Event waiter object.
+ *
+ * The lines registered with this waiter are not released.
+ */
+void gpiod_event_waiter_free(struct gpiod_event_waiter *waiter) GPIOD_API;
+
+/**
+ * @brief Add a single line to the set of lines monitored by an event waiter.
+ * @param waiter Event waiter object.
+ * @param line GPIO line object. Must be requested for events.
+ * @return 0 if the line was added, -1 on error.
+ *
+ * If the line was not requested for events, errno is set to EPERM. If it was
+ * already added, errno is set to EEXIST. Any number of lines of a request made
+ * with GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD can be added.
+ */
+int gpiod_event_waiter_add_line(struct gpiod_event_waiter *waiter,
+				struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Add a set of lines to the set of lines monitored by an event waiter.
+ * @param waiter Event waiter object.
+ * @param bulk Set of GPIO lines. All lines must be requested for events.
+ * @return 0 if all lines were added, -1 on error. If an error occurs, none of
+ *         the lines from the bulk object is added.
+ */
+int gpiod_event_waiter_add_bulk(struct gpiod_event_waiter *waiter,
+				struct gpiod_line_bulk *bulk) GPIOD_API;
+
+/**
+ * @brief Stop monitoring a line with given event waiter.
+ * @param waiter Event waiter object.
+ * @param line GPIO line object.
+ * @return 0 if the line was removed, -1 on error.
+ * @note Lines should be removed from the waiter before they are released.
+ */
+int gpiod_event_waiter_remove_line(struct gpiod_event_waiter *waiter,
+				   struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Get the file descriptor associated with an event waiter.
+ * @param waiter Event waiter object.
+ * @return File descriptor number.
+ *
+ * The returned descriptor becomes readable whenever an event is pending on
+ * any of the monitored lines. It can be polled by the user (for instance:
+ * embedded in an application's main loop) after which
+ * ::gpiod_event_waiter_wait can be called with a zero timeout.
+ *
+ * Events of shared event descriptor requests which were already reported by
+ * ::gpiod_event_waiter_wait but not read don't make this descriptor readable
+ * again.
+ */
+int gpiod_event_waiter_get_fd(struct gpiod_event_waiter *waiter) GPIOD_API;
+
+/**
+ * @brief Wait for events on the lines monitored by an event waiter.
+ * @param waiter Event waiter object.
+ * @param timeout Wait time limit. Can be NULL in which case the routine
+ *                blocks until an event occurs.
+ * @param event_bulk Bulk object in which to store the line handles on which
+ *                   events occurred. Can be NULL.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if at least one
+ *         event occurred.
+ *
+ * No more than ::GPIOD_LINE_BULK_MAX_LINES lines are reported by a single
+ * call. The remaining lines are reported by subsequent calls.
+ *
+ * For lines sharing an event file descriptor, the lines on which the pending
+ * events occurred are reported. The waiter reads these events ahead to find
+ * out where they come from and keeps them in the request until they're read
+ * with gpiod_line_event_read() or gpiod_line_event_read_multiple(), so they
+ * must not be read from the file descriptor directly.
+ */
+int gpiod_event_waiter_wait(struct gpiod_event_waiter *waiter,
+			    const struct timespec *timeout,
+			    struct gpiod_line_bulk *event_bulk) GPIOD_API;
+
+/**
+ * @brief Read the last event from the GPIO line.
+ * @param line GPIO line object.
+ * @param event Buffer to which the event data will be copied.
+ * @return 0 if the event was read correctly, -1 on error.
+ * @note This function will block if no event was queued for this line.
+ */
+int gpiod_line_event_read(struct gpiod_line *line,
+			  struct gpiod_line_event *event) GPIOD_API;
+
+/**
+ * @brief Read up to a certain number of events from the GPIO line.
+ * @param line GPIO line object.
+ * @param events Buffer to which the event data will be copied. Must hold at
+ *               least the amount of events specified in num_events.
+ * @param num_events Specifies how many events can be stored in the buffer.
+ * @return On success returns the number of events stored in the buffer, on
+ *         failure -1 is returned.
+ * @note This function will block if no event was queued for this line.
+ *
+ * All queued events (but no more than num_events and
+ * ::GPIOD_LINE_EVENT_MAX_EVENTS) are retrieved with a single system call.
+ */
+int gpiod_line_event_read_multiple(struct gpiod_line *line,
+				   struct gpiod_line_event *events,
+				   unsigned int num_events) GPIOD_API;
+
+/**
+ * @brief Get the event file descriptor.
+ * @param line GPIO line object.
+ * @return Number of the event file descriptor or -1 if the user tries to
+ *         retrieve the descriptor from a line that wasn't configured for
+ *         event monitoring.
+ *
+ * Users may want to poll the event file descriptor on their own. This routine
+ * allows to access it.
+ *
+ * Reading the descriptor yields struct gpioevent_data of the v1 uAPI unless
+ * the line was requested with GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD,
+ * GPIOD_LINE_REQUEST_FLAG_DEBOUNCE or a non-default event buffer size (or the
+ * kernel lacks the v1 uAPI) - such requests use the v2 uAPI and the descriptor
+ * yields struct gpio_v2_line_event. ::gpiod_line_event_decode handles both.
+ */
+int gpiod_line_event_get_fd(struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Read the last GPIO event directly from a file descriptor.
+ * @param fd File descriptor.
+ * @param event Buffer in which the event data will be stored.
+ * @return 0 if the event was read correctly, -1 on error.
+ *
+ * Users who directly poll the file descriptor for incoming events can also
+ * directly read the event data from it using this routine. This function
+ * translates the kernel representation of the event to the libgpiod format.
+ */
+int gpiod_line_event_read_fd(int fd, struct gpiod_line_event *event) GPIOD_API;
+
+/**
+ * @brief Read up to a certain number of events directly from a file
+ *        descriptor.
+ * @param fd File descriptor.
+ * @param events Buffer to which the event data will be copied. Must hold at
+ *               least the amount of events specified in num_events.
+ * @param num_events Specifies how many events can be stored in the buffer.
+ * @return On success returns the number of events stored in the buffer, on
+ *         failure -1 is returned.
+ */
+int gpiod_line_event_read_fd_multiple(int fd, struct gpiod_line_event *events,
+				      unsigned int num_events) GPIOD_API;
+
+/**
+ * @brief Decode raw event data read from the event file descriptor of a line.
+ * @param line GPIO line object. Must be requested for events.
+ * @param buf Event data as read from the file descriptor of the line.
+ * @param size Size of the event data in bytes.
+ * @param events Buffer to which the decoded events will be stored.
+ * @param num_events Specifies how many events can be stored in the buffer.
+ * @return On success returns the number of decoded events, on failure -1 is
+ *         returned. If the data doesn't fit in the buffer, errno is set to
+ *         ENOBUFS.
+ *
+ * Allows users who read the event data by other means - for example
+ * asynchronously - to translate it to the libgpiod format. The line
+ * statistics are updated just as if the events had been read with
+ * ::gpiod_line_event_read_multiple.
+ */
+int gpiod_line_event_decode(struct gpiod_line *line, const void *buf,
+			    size_t size, struct gpiod_line_event *events,
+			    unsigned int num_events) GPIOD_API;
+
+/**
+ * @brief Create a new event drain.
+ * @param ring_size Number of events the drain can buffer. Rounded up to the
+ *                  nearest power of two.
+ * @return New event drain object or NULL if an error occurred.
+ *
+ * An event drain runs a dedicated thread which reads the events queued in the
+ * kernel for a set of lines as soon as they arrive and stores them in a large
+ * ring buffer in userspace. This keeps the small kernel FIFOs from
+ * overflowing when the consumer falls behind. The ring has a single producer
+ * (the drain thread) and a single consumer so it requires no locking and
+ * popping events from it involves no system calls.
+ *
+ * Lines must be requested for events and added to the drain before it's
+ * started. While the drain is running, events must not be read from its
+ * lines by any other means.
+ */
+struct gpiod_event_drain *gpiod_event_drain_new(unsigned int ring_size) GPIOD_API;
+
+/**
+ * @brief Stop the drain thread and release all resources associated with an
+ *        event drain.
+ * @param drain Event drain object.
+ *
+ * The lines drained by this object are not released.
+ */
+void gpiod_event_drain_free(struct gpiod_event_drain *drain) GPIOD_API;
+
+/**
+ * @brief Set the scheduling policy and priority of the drain thread.
+ * @param drain Event drain object.
+ * @param policy Scheduling policy (SCHED_OTHER, SCHED_FIFO or SCHED_RR).
+ * @param priority Scheduling priority, only used by the realtime policies.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the drain is
+ *         running.
+ *
+ * Starting the drain fails if the process is not allowed to use the policy.
+ */
+int gpiod_event_drain_set_sched(struct gpiod_event_drain *drain,
+				int policy, int priority) GPIOD_API;
+
+/**
+ * @brief Pin the drain thread to a single CPU.
+ * @param drain Event drain object.
+ * @param cpu CPU number or -1 to let the thread run on any CPU.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the drain is
+ *         running.
+ */
+int gpiod_event_drain_set_cpu(struct gpiod_event_drain *drain,
+			      int cpu) GPIOD_API;
+
+/**
+ * @brief Lock the memory used by the drain thread.
+ * @param drain Event drain object.
+ * @param lock If true, the ring and the stack of the drain thread are locked
+ *             in memory while the drain is running.
+ * @return 0 on success, -1 on failure. Fails with EBUSY if the drain is
+ *         running.
+ *
+ * Together with a realtime scheduling policy this makes the drain thread
+ * suitable for latency sensitive uses: the stack is preallocated and both
+ * buffers are faulted in when the drain is started and the thread makes no
+ * allocations afterwards. Starting the drain fails if the process is not
+ * allowed to lock enough memory. The code of the library and the rest of the
+ * process are not locked - call mlockall() for that.
+ */
+int gpiod_event_drain_set_mlock(struct gpiod_event_drain *drain,
+				bool lock) GPIOD_API;
+
+/**
+ * @brief Add a line to the set of lines drained by an event drain.
+ * @param drain Event drain object.
+ * @param line GPIO line object. Must be requested for events.
+ * @return 0 if the line was added, -1 on error.
+ *
+ * Lines requested with a shared event file descriptor are all drained through
+ * the first of them added, adding the others has no effect.
+ */
+int gpiod_event_drain_add_line(struct gpiod_event_drain *drain,
+			       struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Add a set of lines to the set of lines drained by an event drain.
+ * @param drain Event drain object.
+ * @param bulk Set of GPIO lines. All lines must be requested for events.
+ * @return 0 if all lines were added, -1 on error.
+ */
+int gpiod_event_drain_add_bulk(struct gpiod_event_drain *drain,
+			       struct gpiod_line_bulk *bulk) GPIOD_API;
+
+/**
+ * @brief Start the drain thread.
+ * @param drain Event drain object.
+ * @return 0 if the thread was started, -1 on error.
+ */
+int gpiod_event_drain_start(struct gpiod_event_drain *drain) GPIOD_API;
+
+/**
+ * @brief Stop the drain thread.
+ * @param drain Event drain object.
+ *
+ * Events already stored in the ring can still be popped.
+ */
+void gpiod_event_drain_stop(struct gpiod_event_drain *drain) GPIOD_API;
+
+/**
+ * @brief Pop events from the ring of an event drain.
+ * @param drain Event drain object.
+ * @param events Buffer in which the events will be stored.
+ * @param lines Buffer in which the lines from which the events were read
+ *              will be stored. Can be NULL.
+ * @param num_events Number of entries the buffers can hold.
+ * @return Number of events stored in the buffer, 0 if the ring is empty.
+ *
+ * This routine never blocks and makes no system calls. It must only be
+ * called from a single thread at a time.
+ */
+int gpiod_event_drain_pop(struct gpiod_event_drain *drain,
+			  struct gpiod_line_event *events,
+			  struct gpiod_line **lines,
+			  unsigned int num_events) GPIOD_API;
+
+/**
+ * @brief Wait until there are events in the ring of an event drain.
+ * @param drain Event drain object.
+ * @param timeout Wait time limit. Can be NULL in which case the routine
+ *                blocks until an event arrives.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if there are events
+ *         to pop.
+ *
+ * This only makes a system call if the ring is empty.
+ *
+ * If the drain thread fails to read the events of a line, it stops draining
+ * that line and, once the ring is empty, this routine returns -1 with errno
+ * set to the error of the failed read. The error is reported once.
+ */
+int gpiod_event_drain_wait(struct gpiod_event_drain *drain,
+			   const struct timespec *timeout) GPIOD_API;
+
+/**
+ * @brief Get the notification file descriptor of an event drain.
+ * @param drain Event drain object.
+ * @return File descriptor which becomes readable when the drain thread pushes
+ *         new events to the ring or fails to read the events of a line.
+ *
+ * Allows to integrate the drain with external event loops. The descriptor is
+ * an eventfd which should be read by the user to clear the notification.
+ */
+int gpiod_event_drain_get_fd(struct gpiod_event_drain *drain) GPIOD_API;
+
+/**
+ * @brief Get the number of events discarded because the ring was full.
+ * @param drain Event drain object.
+ * @return Number of discarded events.
+ */
+uint64_t gpiod_event_drain_overruns(struct gpiod_event_drain *drain) GPIOD_API;
+
+/**
+ * @brief Create a new io_uring based event reader.
+ * @param max_lines Maximum number of event file descriptors the reader can
+ *                  monitor.
+ * @return New event reader object or NULL if an error occurred. If the
+ *         library was built without io_uring support or the running kernel
+ *         lacks the required features, errno is set to ENOTSUP.
+ *
+ * An io_uring event reader keeps a read armed on the event file descriptor
+ * of every added line at all times. The kernel completes the reads as the
+ * events arrive, so collecting the events of any number of lines costs a
+ * single system call which also re-arms the reads consumed by the previous
+ * call.
+ */
+struct gpiod_event_uring *
+gpiod_event_uring_new(unsigned int max_lines) GPIOD_API;
+
+/**
+ * @brief Cancel all pending reads and release all resources associated with
+ *        an io_uring event reader.
+ * @param uring Event reader object.
+ *
+ * The lines monitored by this object are not released.
+ */
+void gpiod_event_uring_free(struct gpiod_event_uring *uring) GPIOD_API;
+
+/**
+ * @brief Add a line to the set of lines monitored by an io_uring event
+ *        reader.
+ * @param uring Event reader object.
+ * @param line GPIO line object. Must be requested for events.
+ * @return 0 if the line was added, -1 on error. If the reader already
+ *         monitors max_lines descriptors, errno is set to ENOSPC.
+ *
+ * Lines requested with a shared event file descriptor share a single read.
+ */
+int gpiod_event_uring_add_line(struct gpiod_event_uring *uring,
+			       struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Add a set of lines to the set of lines monitored by an io_uring
+ *        event reader.
+ * @param uring Event reader object.
+ * @param bulk Set of GPIO lines. All lines must be requested for events.
+ * @return 0 if all lines were added, -1 on error.
+ */
+int gpiod_event_uring_add_bulk(struct gpiod_event_uring *uring,
+			       struct gpiod_line_bulk *bulk) GPIOD_API;
+
+/**
+ * @brief Wait for events and read them from an io_uring event reader.
+ * @param uring Event reader object.
+ * @param timeout Wait time limit or NULL to wait indefinitely. A zero
+ *                timeout only collects the events which already arrived.
+ * @param events Buffer to which the events will be stored.
+ * @param lines Optional buffer to which the line on which each event
+ *              occurred will be stored. May be NULL.
+ * @param num_events Maximum number of events to store.
+ * @return Number of events stored, 0 if the timeout expired and -1 on error.
+ *
+ * Events which don't fit in the buffers are kept and returned by the next
+ * call. While the reader is in use, events must not be read from its lines
+ * by any other means.
+ */
+int gpiod_event_uring_read(struct gpiod_event_uring *uring,
+			   const struct timespec *timeout,
+			   struct gpiod_line_event *events,
+			   struct gpiod_line **lines,
+			   unsigned int num_events) GPIOD_API;
+
+/**
+ * @brief Function type used by event sources to deliver line events.
+ * @param line Line on which the event occurred.
+ * @param event Line event.
+ * @param data Data pointer passed when the line was added to the source.
+ */
+typedef void (*gpiod_event_source_cb)(struct gpiod_line *line,
+				      const struct gpiod_line_event *event,
+				      void *data);
+
+/**
+ * @brief Create a new, empty event source.
+ * @return New event source object or NULL if an error occurred.
+ *
+ * An event source aggregates the event requests of any number of lines from
+ * any number of chips behind a single file descriptor which can be embedded
+ * in an external event loop. Whenever the descriptor becomes readable, the
+ * user calls ::gpiod_event_source_dispatch which reads the pending events
+ * and passes each of them to the callback of the line on which it occurred.
+ */
+struct gpiod_event_source *gpiod_event_source_new(void) GPIOD_API;
+
+/**
+ * @brief Release all resources associated with an event source.
+ * @param source Event source object.
+ *
+ * The lines added to this source are not released.
+ */
+void gpiod_event_source_free(struct gpiod_event_source *source) GPIOD_API;
+
+/**
+ * @brief Add a line to an event source.
+ * @param source Event source object.
+ * @param line GPIO line object. Must be requested for events.
+ * @param cb Callback called for every event occurring on this line.
+ * @param data User data passed to the callback.
+ * @return 0 if the line was added, -1 on error.
+ *
+ * Adding a line which is already in the source replaces its callback. All
+ * lines sharing an event file descriptor can be added, events occurring on
+ * the lines which were not added are discarded.
+ *
+ * Lines must be removed from the source before they are released. If a line
+ * still in the source was released and requested again, it must be added
+ * again to receive events. Any other lines of the released request which
+ * are still in the source must be added again as well.
+ */
+int gpiod_event_source_add_line(struct gpiod_event_source *source,
+				struct gpiod_line *line,
+				gpiod_event_source_cb cb, void *data) GPIOD_API;
+
+/**
+ * @brief Add a set of lines to an event source.
+ * @param source Event source object.
+ * @param bulk Set of GPIO lines. All lines must be requested for events.
+ * @param cb Callback called for every event occurring on any of the lines.
+ * @param data User data passed to the callback.
+ * @return 0 if all lines were added, -1 on error. If an error occurs, the
+ *         source is left as it was before the call: lines which were not in
+ *         it are removed and lines which were keep their previous callbacks.
+ */
+int gpiod_event_source_add_bulk(struct gpiod_event_source *source,
+				struct gpiod_line_bulk *bulk,
+				gpiod_event_source_cb cb, void *data) GPIOD_API;
+
+/**
+ * @brief Remove a line from an event source.
+ * @param source Event source object.
+ * @param line GPIO line object.
+ * @return 0 if the line was removed, -1 on error. If the line is not in the
+ *         source, errno is set to ENOENT.
+ *
+ * Lines must be removed from the source before they are released.
+ */
+int gpiod_event_source_remove_line(struct gpiod_event_source *source,
+				   struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Get the file descriptor of an event source.
+ * @param source Event source object.
+ * @return File descriptor which becomes readable when events are pending on
+ *         any of the lines in the source.
+ */
+int gpiod_event_source_get_fd(struct gpiod_event_source *source) GPIOD_API;
+
+/**
+ * @brief Read pending events and pass them to the line callbacks.
+ * @param source Event source object.
+ * @return Number of events read or -1 on error.
+ *
+ * This function never blocks. Events are read in batches of up to
+ * ::GPIOD_LINE_EVENT_MAX_EVENTS per file descriptor, any events left behind
+ * keep the descriptor of the source readable.
+ */
+int gpiod_event_source_dispatch(struct gpiod_event_source *source) GPIOD_API;
+
+/**
+ * @brief Register an event source with an epoll instance.
+ * @param source Event source object.
+ * @param epfd File descriptor of the epoll instance.
+ * @param data Value stored in the data.ptr field of the epoll event reported
+ *             when the source is readable.
+ * @return 0 on success, -1 on failure.
+ */
+int gpiod_event_source_attach_epoll(struct gpiod_event_source *source,
+				    int epfd, void *data) GPIOD_API;
+
+/**
+ * @brief Unregister an event source from an epoll instance.
+ * @param source Event source object.
+ * @param epfd File descriptor of the epoll instance.
+ * @return 0 on success, -1 on failure.
+ */
+int gpiod_event_source_detach_epoll(struct gpiod_event_source *source,
+				    int epfd) GPIOD_API;
+
+/**
+ * @}
+ *
+ * @defgroup __line_array__ Operating on large sets of lines
+ * @{
+ *
+ * Line arrays are heap-allocated, growable containers for GPIO lines that
+ * are not limited to ::GPIOD_LINE_BULK_MAX_LINES entries. All lines in an
+ * array must belong to the same GPIO chip. When requested, the lines are
+ * split into consecutive groups of ::GPIOD_LINE_BULK_MAX_LINES lines each of
+ * which gets its own kernel line handle and the value and event routines
+ * fan out over all of them.
+ */
+
+/**
+ * @brief Create a new, empty line array.
+ * @return New line array object or NULL if an error occurred.
+ */
+struct gpiod_line_array *gpiod_line_array_new(void) GPIOD_API;
+
+/**
+ * @brief Release all resources associated with a line array.
+ * @param array Line array object.
+ *
+ * The lines held by the array are not released.
+ */
+void gpiod_line_array_free(struct gpiod_line_array *array) GPIOD_API;
+
+/**
+ * @brief Add a single line to a line array.
+ * @param array Line array object.
+ * @param line Line to add.
+ * @return 0 if the line was added, -1 on error.
+ *
+ * If the line belongs to a different chip than the lines already held by
+ * the array, errno is set to EINVAL.
+ */
+int gpiod_line_array_add(struct gpiod_line_array *array,
+			 struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Get the number of lines held by a line array.
+ * @param array Line array object.
+ * @return Number of lines.
+ */
+unsigned int
+gpiod_line_array_num_lines(struct gpiod_line_array *array) GPIOD_API;
+
+/**
+ * @brief Retrieve the line at given index from a line array.
+ * @param array Line array object.
+ * @param index Index of the line to retrieve.
+ * @return Line at given index or NULL if the index is out of range.
+ */
+struct gpiod_line *gpiod_line_array_get_line(struct gpiod_line_array *array,
+					     unsigned int index) GPIOD_API;
+
+/**
+ * @brief Request all lines held by a line array.
+ * @param array Line array object.
+ * @param config Request options.
+ * @param default_vals Initial line values - only relevant if we're setting
+ *                     the direction to output. Can be NULL.
+ * @return 0 if all lines were requested, -1 on error. If the request fails
+ *         for any of the kernel line handles, the lines requested so far are
+ *         released.
+ */
+int gpiod_line_array_request(struct gpiod_line_array *array,
+			     const struct gpiod_line_request_config *config,
+			     const int *default_vals) GPIOD_API;
+
+/**
+ * @brief Release all lines held by a line array.
+ * @param array Line array object.
+ */
+void gpiod_line_array_release(struct gpiod_line_array *array) GPIOD_API;
+
+/**
+ * @brief Read current values of all lines held by a line array.
+ * @param array Line array object. All lines must have been requested with
+ *              ::gpiod_line_array_request.
+ * @param values An array big enough to hold the number of values equal to
+ *               the number of lines in the line array.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_array_get_values(struct gpiod_line_array *array,
+				int *values) GPIOD_API;
+
+/**
+ * @brief Set the values of all lines held by a line array.
+ * @param array Line array object. All lines must have been requested with
+ *              ::gpiod_line_array_request.
+ * @param values An array holding the number of values equal to the number
+ *               of lines in the line array.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ *
+ * The values are set one kernel line handle at a time, so the update is
+ * only atomic for arrays of up to ::GPIOD_LINE_BULK_MAX_LINES lines.
+ */
+int gpiod_line_array_set_values(struct gpiod_line_array *array,
+				const int *values) GPIOD_API;
+
+/**
+ * @brief Wait for events on the lines held by a line array.
+ * @param array Line array object. All lines must have been requested for
+ *              events with ::gpiod_line_array_request.
+ * @param timeout Wait time limit.
+ * @param event_array Line array object in which to store the lines on
+ *                    which events occurred. Its previous contents are
+ *                    discarded. Can be NULL.
+ * @return 0 if wait timed out, -1 if an error occurred, 1 if at least one
+ *         event occurred.
+ *
+ * The set of polled file descriptors is built by the first call and reused
+ * until lines are added to the array or it is requested or released again.
+ * Lines released or requested separately from the array are detected and the
+ * set is rebuilt. If any of the lines is no longer requested for events, errno
+ * is set to EPERM.
+ */
+int gpiod_line_array_event_wait(struct gpiod_line_array *array,
+				const struct timespec *timeout,
+				struct gpiod_line_array *event_array) GPIOD_API;
+
+/**
+ * @}
+ *
+ * @defgroup __line_group__ Operating on lines from multiple chips
+ * @{
+ *
+ * Line groups can hold lines belonging to any number of GPIO chips. Lines
+ * are kept in a separate line array for every chip internally, the value
+ * routines issue the per-chip calls back to back and the event routine waits
+ * for events on the lines of all chips at once. Values are always passed in
+ * the order in which the lines were added to the group.
+ */
+
+/**
+ * @brief Create a new, empty line group.
+ * @return New line group object or NULL if an error occurred.
+ */
+struct gpiod_line_group *gpiod_line_group_new(void) GPIOD_API;
+
+/**
+ * @brief Release all resources associated with a line group.
+ * @param group Line group object.
+ *
+ * The lines held by the group are not released.
+ */
+void gpiod_line_group_free(struct gpiod_line_group *group) GPIOD_API;
+
+/**
+ * @brief Add a single line to a line group.
+ * @param group Line group object.
+ * @param line Line to add. Can belong to any GPIO chip.
+ * @return 0 if the line was added, -1 on error.
+ */
+int gpiod_line_group_add(struct gpiod_line_group *group,
+			 struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Get the number of lines held by a line group.
+ * @param group Line group object.
+ * @return Number of lines.
+ */
+unsigned int
+gpiod_line_group_num_lines(struct gpiod_line_group *group) GPIOD_API;
+
+/**
+ * @brief Get the number of distinct GPIO chips the lines of a group belong to.
+ * @param group Line group object.
+ * @return Number of chips.
+ */
+unsigned int
+gpiod_line_group_num_chips(struct gpiod_line_group *group) GPIOD_API;
+
+/**
+ * @brief Retrieve the line at given index from a line group.
+ * @param group Line group object.
+ * @param index Index of the line to retrieve.
+ * @return Line at given index or NULL if the index is out of range.
+ */
+struct gpiod_line *gpiod_line_group_get_line(struct gpiod_line_group *group,
+					     unsigned int index) GPIOD_API;
+
+/**
+ * @brief Request all lines held by a line group.
+ * @param group Line group object.
+ * @param config Request options.
+ * @param default_vals Initial line values - only relevant if we're setting
+ *                     the direction to output. Can be NULL.
+ * @return 0 if all lines were requested, -1 on error. If the request fails
+ *         for any of the chips, the lines requested so far are released.
+ */
+int gpiod_line_group_request(struct gpiod_line_group *group,
+			     const struct gpiod_line_request_config *config,
+			     const int *default_vals) GPIOD_API;
+
+/**
+ * @brief Release all lines held by a line group.
+ * @param group Line group object.
+ */
+void gpiod_line_group_release(struct gpiod_line_group *group) GPIOD_API;
+
+/**
+ * @brief Read current values of all lines held by a line group.
+ * @param group Line group object. All lines must have been requested with
+ *              ::gpiod_line_group_request.
+ * @param values An array big enough to hold the number of values equal to
+ *               the number of lines in the line group.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ */
+int gpiod_line_group_get_values(struct gpiod_line_group *group,
+				int *values) GPIOD_API;
+
+/**
+ * @brief Set the values of all lines held by a line group.
+ * @param group Line group object. All lines must have been requested with
+ *              ::gpiod_line_group_request.
+ * @param values An array holding the number of values equal to the number
+ *               of lines in the line group.
+ * @return 0 is the operation succeeds. In case of an error this routine
+ *         returns -1 and sets the last error number.
+ *
+ * The lines of every chip are set with a separate system call, so the update
+ * is not atomic across chips.
+ */
+int gpiod_line_group_set_values(struct gpiod_line_group *group,
+				const int *values) GPIOD_API;
+
+/**
+ * @brief Wait for events on the lines held by a line group.
+ * @param group Line group object. All lines must have been requested for
+ *              events.
+ * @param timeout Wait time limit.
+ * @param indices An array big enough to hold the number of entries equal to
+ *                the number of lines in the group. If not NULL, it's filled
+ *                with the indices of lines on which events occurred.
+ * @return 0 if wait timed out, -1 if an error occurred or the number of lines
+ *         on which events occurred.
+ *
+ * The set of polled file descriptors is built by the first call and reused
+ * for as long as the group and the descriptors of its lines don't change.
+ */
+int gpiod_line_group_event_wait(struct gpiod_line_group *group,
+				const struct timespec *timeout,
+				unsigned int *indices) GPIOD_API;
+
+/**
+ * @}
+ *
+ * @defgroup __line_misc__ Misc line functions
+ * @{
+ */
+
+/**
+ * @brief Get a GPIO line handle by GPIO chip description and offset.
+ * @param device String describing the gpiochip.
+ * @param offset The offset of the GPIO line.
+ * @return GPIO line handle or NULL if an error occurred.
+ *
+ * This routine provides a shorter alternative to calling
+ * ::gpiod_chip_open_lookup and ::gpiod_chip_get_line.
+ *
+ * If this function succeeds, the caller is responsible for closing the
+ * associated GPIO chip.
+ */
+struct gpiod_line *
+gpiod_line_get(const char *device, unsigned int offset) GPIOD_API;
+
+/**
+ * @brief Find a GPIO line by its name.
+ * @param name Name of the GPIO line.
+ * @return Returns the GPIO line handle if the line exists in the system or
+ *         NULL if it couldn't be located or an error occurred.
+ *
+ * If this routine succeeds, the user must manually close the GPIO chip owning
+ * this line to avoid memory leaks. If the line could not be found, this
+ * functions sets errno to ENOENT.
+ *
+ * If the GPIOD_LINE_CACHE environment variable is set, the line is looked up
+ * in the line name cache stored at the path it points to (see
+ * ::gpiod_line_cache_find) first. All GPIO chips are still scanned if the
+ * line is not in the cache.
+ */
+struct gpiod_line *gpiod_line_find(const char *name) GPIOD_API;
+
+/**
+ * @brief Look up a GPIO line by name in a persistent line name cache.
+ * @param path Path to the cache file.
+ * @param name The name of the GPIO line to lookup.
+ * @param chipname Buffer in which the name of the GPIO chip will be stored.
+ * @param chipname_size Size of the chip name buffer.
+ * @param offset Pointer to an integer in which the line offset will be stored.
+ * @return -1 on error, 0 if the line with given name doesn't exist and 1 if
+ *         the line was found. In the first two cases the contents of chipname
+ *         and offset remain unchanged.
+ *
+ * The cache maps the names of all lines in the system to their chips and
+ * offsets and is stored in a file which is mapped into memory. Before it's
+ * used, it's validated against the set of GPIO character devices currently
+ * present in /dev (their names, device numbers and creation times) - this
+ * doesn't require opening any GPIO chip. If the file doesn't exist or is
+ * stale, it's rebuilt by scanning all chips and atomically replaced. A cache
+ * which can't be written doesn't make the lookup fail.
+ *
+ * Lines are visited in the same order as with ::gpiod_line_find so if several
+ * lines share a name, the same one is returned. Names of 32 characters or
+ * longer are never cached.
+ */
+int gpiod_line_cache_find(const char *path, const char *name, char *chipname,
+			  size_t chipname_size, unsigned int *offset) GPIOD_API;
+
+/**
+ * @brief Close a GPIO chip owning this line and release all resources.
+ * @param line GPIO line object
+ *
+ * After this function returns, the line must no longer be used.
+ */
+void gpiod_line_close_chip(struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @brief Get the handle to the GPIO chip controlling this line.
+ * @param line The GPIO line object.
+ * @return Pointer to the GPIO chip handle controlling this line.
+ */
+struct gpiod_chip *gpiod_line_get_chip(struct gpiod_line *line) GPIOD_API;
+
+/**
+ * @}
+ *
+ * @}
+ *
+ * @defgroup __iterators__ Iterators for GPIO chips and lines
+ * @{
+ *
+ * These functions and data structures allow easy iterating over GPIO
+ * chips and lines.
+ */
+
+/**
+ * @brief Create a new gpiochip iterator.
+ * @return Pointer to a new chip iterator object or NULL if an error occurred.
+ *
+ * Internally this routine scans the /dev/ directory for GPIO chip device
+ * files and stores their names. Every chip is only opened once the iterator
+ * reaches it, so callers which stop at the first matching chip don't pay
+ * for opening the remaining ones.
+ */
+struct gpiod_chip_iter *gpiod_chip_iter_new(void) GPIOD_API;
+
+/**
+ * @brief Flags which can be passed to gpiod_chip_iter_new_flags().
+ */
+enum {
+	GPIOD_CHIP_ITER_FLAG_EAGER = GPIOD_BIT(0),
+	/**< Open all chips when creating the iterator. */
+};
+
+/**
+ * @brief Create a new gpiochip iterator with additional flags.
+ * @param flags Combination of GPIOD_CHIP_ITER_FLAG_* values.
+ * @return Pointer to a new chip iterator object or NULL if an error occurred.
+ *
+ * With GPIOD_CHIP_ITER_FLAG_EAGER all chips are opened by this routine and
+ * their handles are stored until ::gpiod_chip_iter_free or
+ * ::gpiod_chip_iter_free_noclose is called. Failing to open any of them
+ * makes this routine fail.
+ */
+struct gpiod_chip_iter *gpiod_chip_iter_new_flags(int flags) GPIOD_API;
+
+/**
+ * @brief Release all resources allocated for the gpiochip iterator and close
+ *        the most recently opened gpiochip (if any).
+ * @param iter The gpiochip iterator object.
+ */
+void gpiod_chip_iter_free(struct gpiod_chip_iter *iter) GPIOD_API;
+
+/**
+ * @brief Release all resources allocated for the gpiochip iterator but
+ *        don't close the most recently opened gpiochip (if any).
+ * @param iter The gpiochip iterator object.
+ *
+ * Users may want to break the loop when iterating over gpiochips and keep
+ * the most recently opened chip active while freeing the iterator data.
+ * This routine enables that.
+ */
+void gpiod_chip_iter_free_noclose(struct gpiod_chip_iter *iter) GPIOD_API;
+
+/**
+ * @brief Get the next gpiochip handle.
+ * @param iter The gpiochip iterator object.
  * @return Pointer to the next open gpiochip handle or NULL if no more chips
- *         are present in the system.
+ *         are present in the system or if opening the next chip failed.
  * @note The previous chip handle will be closed using ::gpiod_chip_iter_free.
+ *
+ * Unless the iterator was created with GPIOD_CHIP_ITER_FLAG_EAGER, the chip
+ * is opened by this routine. If that fails, NULL is returned, errno is set
+ * and the iteration ends. In order to tell the end of iteration from an
+ * error, set errno to 0 before calling this function - just like with
+ * readdir().
  */
 struct gpiod_chip *
 gpiod_chip_iter_next(struct gpiod_chip_iter *iter) GPIOD_API;
@@ -1306,7 +2796,7 @@ gpiod_chip_iter_next(struct gpiod_chip_iter *iter) GPIOD_API;
  * @brief Get the next gpiochip handle without closing the previous one.
  * @param iter The gpiochip iterator object.
  * @return Pointer to the next open gpiochip handle or NULL if no more chips
- *         are present in the system.
+ *         are present in the system or if opening the next chip failed.
  * @note This function works just like ::gpiod_chip_iter_next but doesn't
  *       close the most recently opened chip handle.
  */
@@ -0,0 +1,319 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Dynamically sized sets of GPIO lines. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <poll.h>
+#include <string.h>
+
+/*
+ * Lines are stored in chunks of GPIOD_LINE_BULK_MAX_LINES, each of which is
+ * requested as a separate kernel line handle. Storing the chunks as regular
+ * bulk objects allows to pass them to the bulk routines without copying.
+ */
+struct gpiod_line_array {
+	struct gpiod_line_bulk *chunks;
+	unsigned int max_chunks;
+	unsigned int num_lines;
+
+	/*
+	 * The poll set of the event wait is filled in once and reused until
+	 * the array changes or its lines are requested or released again.
+	 * The lines can also be released and requested directly, so the
+	 * descriptors are checked against the lines before every wait.
+	 */
+	struct pollfd *poll_fds;
+	unsigned int max_poll_fds;
+	bool poll_fds_valid;
+};
+
+static unsigned int line_array_num_chunks(struct gpiod_line_array *array)
+{
+	return (array->num_lines + GPIOD_LINE_BULK_MAX_LINES - 1) /
+	       GPIOD_LINE_BULK_MAX_LINES;
+}
+
+#define line_array_foreach_chunk(array, chunk, index)			\
+	for ((index) = 0, (chunk) = (array)->chunks;			\
+	     (index) < line_array_num_chunks(array);			\
+	     (index)++, (chunk)++)
+
+struct gpiod_line_array *gpiod_line_array_new(void)
+{
+	struct gpiod_line_array *array;
+
+	array = malloc(sizeof(*array));
+	if (!array)
+		return NULL;
+
+	memset(array, 0, sizeof(*array));
+
+	return array;
+}
+
+void gpiod_line_array_free(struct gpiod_line_array *array)
+{
+	free(array->poll_fds);
+	free(array->chunks);
+	free(array);
+}
+
+int gpiod_line_array_add(struct gpiod_line_array *array,
+			 struct gpiod_line *line)
+{
+	unsigned int index = array->num_lines / GPIOD_LINE_BULK_MAX_LINES;
+	struct gpiod_line_bulk *chunks;
+	struct gpiod_line *first;
+	unsigned int max_chunks;
+
+	if (array->num_lines) {
+		first = gpiod_line_bulk_get_line(&array->chunks[0], 0);
+		if (gpiod_line_get_chip(first) != gpiod_line_get_chip(line)) {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+
+	if (index >= array->max_chunks) {
+		max_chunks = array->max_chunks ? array->max_chunks * 2 : 1;
+
+		chunks = realloc(array->chunks, sizeof(*chunks) * max_chunks);
+		if (!chunks)
+			return -1;
+
+		array->chunks = chunks;
+		array->max_chunks = max_chunks;
+	}
+
+	if (array->num_lines % GPIOD_LINE_BULK_MAX_LINES == 0)
+		gpiod_line_bulk_init(&array->chunks[index]);
+
+	gpiod_line_bulk_add(&array->chunks[index], line);
+	array->num_lines++;
+	array->poll_fds_valid = false;
+
+	return 0;
+}
+
+unsigned int gpiod_line_array_num_lines(struct gpiod_line_array *array)
+{
+	return array->num_lines;
+}
+
+struct gpiod_line *gpiod_line_array_get_line(struct gpiod_line_array *array,
+					     unsigned int index)
+{
+	if (index >= array->num_lines) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return gpiod_line_bulk_get_line(
+			&array->chunks[index / GPIOD_LINE_BULK_MAX_LINES],
+			index % GPIOD_LINE_BULK_MAX_LINES);
+}
+
+static void line_array_release_chunks(struct gpiod_line_array *array,
+				      unsigned int num_chunks)
+{
+	unsigned int i;
+	int errsv;
+
+	errsv = errno;
+	for (i = 0; i < num_chunks; i++)
+		gpiod_line_release_bulk(&array->chunks[i]);
+	errno = errsv;
+}
+
+int gpiod_line_array_request(struct gpiod_line_array *array,
+			     const struct gpiod_line_request_config *config,
+			     const int *default_vals)
+{
+	struct gpiod_line_bulk *chunk;
+	const int *chunk_vals;
+	unsigned int i;
+	int rv;
+
+	if (!array->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	array->poll_fds_valid = false;
+
+	line_array_foreach_chunk(array, chunk, i) {
+		chunk_vals = default_vals;
+		if (chunk_vals)
+			chunk_vals += i * GPIOD_LINE_BULK_MAX_LINES;
+
+		rv = gpiod_line_request_bulk(chunk, config, chunk_vals);
+		if (rv < 0) {
+			line_array_release_chunks(array, i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void gpiod_line_array_release(struct gpiod_line_array *array)
+{
+	line_array_release_chunks(array, line_array_num_chunks(array));
+	array->poll_fds_valid = false;
+}
+
+int gpiod_line_array_get_values(struct gpiod_line_array *array, int *values)
+{
+	struct gpiod_line_bulk *chunk;
+	unsigned int i;
+	int rv;
+
+	if (!array->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	line_array_foreach_chunk(array, chunk, i) {
+		rv = gpiod_line_get_value_bulk(chunk,
+				values + i * GPIOD_LINE_BULK_MAX_LINES);
+		if (rv < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+int gpiod_line_array_set_values(struct gpiod_line_array *array,
+				const int *values)
+{
+	struct gpiod_line_bulk *chunk;
+	unsigned int i;
+	int rv;
+
+	if (!array->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	line_array_foreach_chunk(array, chunk, i) {
+		rv = gpiod_line_set_value_bulk(chunk,
+				values + i * GPIOD_LINE_BULK_MAX_LINES);
+		if (rv < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int line_array_fill_poll_fds(struct gpiod_line_array *array)
+{
+	struct gpiod_line *line;
+	struct pollfd *fds;
+	unsigned int i;
+
+	array->poll_fds_valid = false;
+
+	if (array->max_poll_fds < array->num_lines) {
+		fds = realloc(array->poll_fds, sizeof(*fds) * array->num_lines);
+		if (!fds)
+			return -1;
+
+		array->poll_fds = fds;
+		array->max_poll_fds = array->num_lines;
+	}
+
+	fds = array->poll_fds;
+	memset(fds, 0, sizeof(*fds) * array->num_lines);
+
+	for (i = 0; i < array->num_lines; i++) {
+		line = gpiod_line_array_get_line(array, i);
+
+		fds[i].fd = gpiod_line_event_get_fd(line);
+		if (fds[i].fd < 0)
+			return -1;
+
+		fds[i].events = POLLIN | POLLPRI;
+	}
+
+	array->poll_fds_valid = true;
+
+	return 0;
+}
+
+static bool line_array_poll_fds_valid(struct gpiod_line_array *array)
+{
+	struct gpiod_line *line;
+	unsigned int i;
+
+	if (!array->poll_fds_valid)
+		return false;
+
+	for (i = 0; i < array->num_lines; i++) {
+		line = gpiod_line_array_get_line(array, i);
+		if (array->poll_fds[i].fd != gpiod_line_event_get_fd(line))
+			return false;
+	}
+
+	return true;
+}
+
+int gpiod_line_array_event_wait(struct gpiod_line_array *array,
+				const struct timespec *timeout,
+				struct gpiod_line_array *event_array)
+{
+	struct gpiod_line *line;
+	struct pollfd *fds;
+	unsigned int i;
+	int rv;
+
+	if (!array->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!line_array_poll_fds_valid(array)) {
+		rv = line_array_fill_poll_fds(array);
+		if (rv < 0)
+			return -1;
+	}
+
+	fds = array->poll_fds;
+
+	rv = ppoll(fds, array->num_lines, timeout, NULL);
+	if (rv < 0)
+		return -1;
+	else if (rv == 0)
+		return 0;
+
+	if (event_array) {
+		event_array->num_lines = 0;
+		event_array->poll_fds_valid = false;
+	}
+
+	for (i = 0; i < array->num_lines; i++) {
+		if (fds[i].revents) {
+			if (fds[i].revents & POLLNVAL) {
+				array->poll_fds_valid = false;
+				errno = EINVAL;
+				return -1;
+			}
+
+			if (event_array) {
+				line = gpiod_line_array_get_line(array, i);
+				if (gpiod_line_array_add(event_array, line))
+					return -1;
+			}
+
+			if (!--rv)
+				break;
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,431 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Persistent, system-wide cache of GPIO line names. */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <gpiod.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "internal.h"
+
+/*
+ * The cache file consists of a header, an entry for every GPIO chip present
+ * in the system when the cache was built and an open-addressing hash table
+ * of line names. Every part has a fixed size so that the file can be mapped
+ * into memory and used as is.
+ *
+ * The chip entries store the device number and the ctime of the character
+ * device: both change when a chip is unregistered and registered again, so
+ * comparing them against a fresh scan of /dev is enough to tell whether the
+ * cache is stale without opening any chip.
+ */
+
+#define LINE_CACHE_MAGIC	"GPIODLC1"
+#define LINE_CACHE_SLOT_EMPTY	UINT32_MAX
+
+struct line_cache_header {
+	char magic[8];
+	uint32_t num_chips;
+	uint32_t table_size;
+};
+
+struct line_cache_chip {
+	char name[32];
+	char label[32];
+	uint32_t num_lines;
+	uint32_t padding;
+	uint64_t rdev;
+	int64_t ctime_sec;
+	int64_t ctime_nsec;
+};
+
+struct line_cache_slot {
+	char name[32];
+	uint32_t hash;
+	uint32_t chip_index;
+	uint32_t offset;
+};
+
+struct line_cache_devs {
+	struct dirent **dirs;
+	struct stat *stats;
+	unsigned int num_devs;
+};
+
+/* FNV-1a */
+static uint32_t line_cache_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	for (; *name; name++) {
+		hash ^= (unsigned char)*name;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static size_t line_cache_size(uint32_t num_chips, uint32_t table_size)
+{
+	return sizeof(struct line_cache_header) +
+	       sizeof(struct line_cache_chip) * num_chips +
+	       sizeof(struct line_cache_slot) * table_size;
+}
+
+static struct line_cache_chip *
+line_cache_chips(const struct line_cache_header *hdr)
+{
+	return (struct line_cache_chip *)(hdr + 1);
+}
+
+static struct line_cache_slot *
+line_cache_slots(const struct line_cache_header *hdr)
+{
+	return (struct line_cache_slot *)(line_cache_chips(hdr) +
+					  hdr->num_chips);
+}
+
+static void line_cache_free_devs(struct line_cache_devs *devs)
+{
+	unsigned int i;
+
+	for (i = 0; i < devs->num_devs; i++)
+		free(devs->dirs[i]);
+	free(devs->dirs);
+	free(devs->stats);
+}
+
+static int line_cache_scan_devs(struct line_cache_devs *devs)
+{
+	char path[sizeof("/dev/") + NAME_MAX];
+	int num_devs, rv, errsv;
+	unsigned int i;
+
+	num_devs = scandir("/dev", &devs->dirs, chip_dir_filter,
+			   alphasort);
+	if (num_devs < 0)
+		return -1;
+
+	devs->num_devs = num_devs;
+	devs->stats = calloc(num_devs ? num_devs : 1, sizeof(*devs->stats));
+	if (!devs->stats)
+		goto err_free_devs;
+
+	for (i = 0; i < devs->num_devs; i++) {
+		snprintf(path, sizeof(path), "/dev/%s", devs->dirs[i]->d_name);
+		rv = stat(path, &devs->stats[i]);
+		if (rv < 0)
+			goto err_free_devs;
+	}
+
+	return 0;
+
+err_free_devs:
+	errsv = errno;
+	line_cache_free_devs(devs);
+	errno = errsv;
+
+	return -1;
+}
+
+static bool line_cache_valid(const struct line_cache_header *hdr, size_t size,
+			     const struct line_cache_devs *devs)
+{
+	const struct line_cache_chip *chip;
+	const struct stat *st;
+	unsigned int i;
+
+	if (size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, LINE_CACHE_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->num_chips != devs->num_devs ||
+	    size != line_cache_size(hdr->num_chips, hdr->table_size))
+		return false;
+
+	/* The table size is always a power of two. */
+	if (!hdr->table_size || (hdr->table_size & (hdr->table_size - 1)))
+		return false;
+
+	for (i = 0; i < devs->num_devs; i++) {
+		chip = &line_cache_chips(hdr)[i];
+		st = &devs->stats[i];
+
+		if (strncmp(chip->name, devs->dirs[i]->d_name,
+			    sizeof(chip->name)) != 0 ||
+		    chip->rdev != (uint64_t)st->st_rdev ||
+		    chip->ctime_sec != (int64_t)st->st_ctim.tv_sec ||
+		    chip->ctime_nsec != (int64_t)st->st_ctim.tv_nsec)
+			return false;
+	}
+
+	return true;
+}
+
+static void line_cache_insert(struct line_cache_header *hdr, const char *name,
+			      uint32_t chip_index, uint32_t offset)
+{
+	uint32_t hash, mask = hdr->table_size - 1, pos;
+	struct line_cache_slot *slot;
+
+	hash = line_cache_hash(name);
+
+	for (pos = hash & mask;; pos = (pos + 1) & mask) {
+		slot = &line_cache_slots(hdr)[pos];
+		if (slot->chip_index == LINE_CACHE_SLOT_EMPTY)
+			break;
+
+		/*
+		 * Chips and lines are inserted in the order in which
+		 * gpiod_line_find() visits them - keep the first match.
+		 */
+		if (slot->hash == hash &&
+		    strncmp(slot->name, name, sizeof(slot->name)) == 0)
+			return;
+	}
+
+	strncpy(slot->name, name, sizeof(slot->name) - 1);
+	slot->hash = hash;
+	slot->chip_index = chip_index;
+	slot->offset = offset;
+}
+
+static int line_cache_write(const char *path,
+			    const struct line_cache_header *hdr, size_t size)
+{
+	char *tmppath;
+	ssize_t wr;
+	int rv, fd;
+
+	rv = asprintf(&tmppath, "%s.XXXXXX", path);
+	if (rv < 0)
+		return -1;
+
+	fd = mkstemp(tmppath);
+	if (fd < 0)
+		goto err_free_path;
+
+	wr = write(fd, hdr, size);
+	if (wr < 0 || (size_t)wr != size)
+		goto err_unlink;
+
+	rv = fchmod(fd, 0644);
+	if (rv < 0)
+		goto err_unlink;
+
+	rv = close(fd);
+	fd = -1;
+	if (rv < 0)
+		goto err_unlink;
+
+	/* Readers either see the old or the new file, never a partial one. */
+	rv = rename(tmppath, path);
+	if (rv < 0)
+		goto err_unlink;
+
+	free(tmppath);
+
+	return 0;
+
+err_unlink:
+	if (fd >= 0)
+		close(fd);
+	unlink(tmppath);
+
+err_free_path:
+	free(tmppath);
+
+	return -1;
+}
+
+static struct line_cache_header *
+line_cache_build(const struct line_cache_devs *devs, size_t *size)
+{
+	uint32_t table_size = 1, num_lines = 0;
+	struct line_cache_chip *cache_chip;
+	struct line_cache_header *hdr;
+	struct gpiod_chip **chips;
+	struct gpiod_line *line;
+	unsigned int i, offset;
+	const char *name;
+	int errsv;
+
+	chips = calloc(devs->num_devs ? devs->num_devs : 1, sizeof(*chips));
+	if (!chips)
+		return NULL;
+
+	for (i = 0; i < devs->num_devs; i++) {
+		chips[i] = gpiod_chip_open_by_name(devs->dirs[i]->d_name);
+		if (!chips[i])
+			goto err_close_chips;
+
+		num_lines += gpiod_chip_num_lines(chips[i]);
+	}
+
+	/* Keep the load factor at or below 0.5. */
+	while (table_size < num_lines * 2)
+		table_size <<= 1;
+
+	*size = line_cache_size(devs->num_devs, table_size);
+	hdr = malloc(*size);
+	if (!hdr)
+		goto err_close_chips;
+
+	memset(hdr, 0, *size);
+	memcpy(hdr->magic, LINE_CACHE_MAGIC, sizeof(hdr->magic));
+	hdr->num_chips = devs->num_devs;
+	hdr->table_size = table_size;
+
+	for (i = 0; i < table_size; i++)
+		line_cache_slots(hdr)[i].chip_index = LINE_CACHE_SLOT_EMPTY;
+
+	for (i = 0; i < devs->num_devs; i++) {
+		cache_chip = &line_cache_chips(hdr)[i];
+
+		/* The whole header has been zeroed - names stay terminated. */
+		memcpy(cache_chip->name, devs->dirs[i]->d_name,
+		       strnlen(devs->dirs[i]->d_name,
+			       sizeof(cache_chip->name) - 1));
+		snprintf(cache_chip->label, sizeof(cache_chip->label), "%s",
+			 gpiod_chip_label(chips[i]));
+		cache_chip->num_lines = gpiod_chip_num_lines(chips[i]);
+		cache_chip->rdev = devs->stats[i].st_rdev;
+		cache_chip->ctime_sec = devs->stats[i].st_ctim.tv_sec;
+		cache_chip->ctime_nsec = devs->stats[i].st_ctim.tv_nsec;
+
+		for (offset = 0; offset < cache_chip->num_lines; offset++) {
+			line = gpiod_chip_get_line(chips[i], offset);
+			if (!line)
+				goto err_free_hdr;
+
+			/* Names which don't fit in a slot are never cached. */
+			name = gpiod_line_name(line);
+			if (name && strnlen(name, 32) < 32)
+				line_cache_insert(hdr, name, i, offset);
+		}
+	}
+
+	for (i = 0; i < devs->num_devs; i++)
+		gpiod_chip_close(chips[i]);
+	free(chips);
+
+	return hdr;
+
+err_free_hdr:
+	free(hdr);
+
+err_close_chips:
+	errsv = errno;
+	for (i = 0; i < devs->num_devs; i++) {
+		if (chips[i])
+			gpiod_chip_close(chips[i]);
+	}
+	free(chips);
+	errno = errsv;
+
+	return NULL;
+}
+
+static int line_cache_lookup(const struct line_cache_header *hdr,
+			     const char *name, char *chipname,
+			     size_t chipname_size, unsigned int *offset)
+{
+	uint32_t hash, mask = hdr->table_size - 1, pos, i;
+	const struct line_cache_slot *slot;
+	const struct line_cache_chip *chip;
+
+	hash = line_cache_hash(name);
+
+	/* Don't trust the file to contain an empty slot. */
+	for (i = 0, pos = hash & mask;; i++, pos = (pos + 1) & mask) {
+		slot = &line_cache_slots(hdr)[pos];
+		if (i == hdr->table_size ||
+		    slot->chip_index == LINE_CACHE_SLOT_EMPTY)
+			return 0;
+
+		if (slot->hash == hash &&
+		    strncmp(slot->name, name, sizeof(slot->name)) == 0 &&
+		    slot->chip_index < hdr->num_chips)
+			break;
+	}
+
+	chip = &line_cache_chips(hdr)[slot->chip_index];
+	snprintf(chipname, chipname_size, "%.*s",
+		 (int)sizeof(chip->name), chip->name);
+	*offset = slot->offset;
+
+	return 1;
+}
+
+int gpiod_line_cache_find(const char *path, const char *name, char *chipname,
+			  size_t chipname_size, unsigned int *offset)
+{
+	struct line_cache_header *hdr = NULL;
+	struct line_cache_devs devs;
+	struct stat st;
+	int rv, fd;
+	size_t size;
+	void *map;
+
+	if (strlen(name) >= sizeof(((struct line_cache_slot *)0)->name))
+		return 0;
+
+	rv = line_cache_scan_devs(&devs);
+	if (rv < 0)
+		return -1;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		rv = fstat(fd, &st);
+		if (rv == 0 && st.st_size > 0) {
+			map = mmap(NULL, st.st_size, PROT_READ,
+				   MAP_SHARED, fd, 0);
+			if (map != MAP_FAILED) {
+				if (line_cache_valid(map, st.st_size, &devs)) {
+					rv = line_cache_lookup(map, name,
+							       chipname,
+							       chipname_size,
+							       offset);
+					munmap(map, st.st_size);
+					close(fd);
+					line_cache_free_devs(&devs);
+
+					return rv;
+				}
+
+				munmap(map, st.st_size);
+			}
+		}
+
+		close(fd);
+	}
+
+	/* Missing or stale - rebuild it. */
+	hdr = line_cache_build(&devs, &size);
+	line_cache_free_devs(&devs);
+	if (!hdr)
+		return -1;
+
+	/*
+	 * The cache is only an optimization: if it can't be stored (for
+	 * instance because the file system is still mounted read-only
+	 * early at boot), still answer the query.
+	 */
+	line_cache_write(path, hdr, size);
+
+	rv = line_cache_lookup(hdr, name, chipname, chipname_size, offset);
+	free(hdr);
+
+	return rv;
+}
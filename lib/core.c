@@ -7,11 +7,14 @@
 
 /* Low-level, core library code. */
 
+#include <endian.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <gpiod.h>
+#include <limits.h>
 #include <linux/gpio.h>
 #include <poll.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -21,6 +24,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "internal.h"
+
 enum {
 	LINE_FREE = 0,
 	LINE_REQUESTED_VALUES,
@@ -30,47 +35,169 @@ enum {
 struct line_fd_handle {
 	int fd;
 	int refcount;
+	bool uapi_v2;
+
+	/* Events read ahead by line_event_peek(), allocated on first use. */
+	struct gpiod_line_event *pending;
+	unsigned int num_pending;
+	unsigned int next_pending;
 };
 
+/*
+ * Line data is split in two: the state needed to request lines and to get or
+ * set their values is kept in struct gpiod_line while the line info (which is
+ * only needed when the user queries it) lives in a separate array of
+ * struct line_info, indexed by offset. This keeps the line objects small and
+ * densely packed for the bulk loops.
+ */
 struct gpiod_line {
+	struct gpiod_chip *chip;
+	struct line_fd_handle *fd_handle;
 	unsigned int offset;
+	int state;
+};
+
+struct line_info {
 	int direction;
 	int active_state;
 	bool used;
 	bool open_source;
 	bool open_drain;
-
-	int state;
 	bool up_to_date;
-
-	struct gpiod_chip *chip;
-	struct line_fd_handle *fd_handle;
+	bool stale;
 
 	char name[32];
 	char consumer[32];
 };
 
+/*
+ * Event statistics are only needed for lines requested for events, so they
+ * live in yet another per-chip array allocated on the first event request.
+ */
+struct line_event_stats {
+	uint64_t received;
+	uint64_t dropped;
+	unsigned int last_line_seqno;
+	int last_event_type;
+	bool both_edges;
+};
+
+#define LINE_NAME_SLOT_EMPTY	UINT_MAX
+
+/*
+ * Open-addressing hash table mapping line names to offsets. Only the hashes
+ * are stored - candidates are verified against the name of the line itself.
+ */
+struct line_name_slot {
+	uint32_t hash;
+	unsigned int offset;
+};
+
 struct gpiod_chip {
-	struct gpiod_line **lines;
+	/*
+	 * Line objects are allocated in a single block sized to num_lines
+	 * when the first line is retrieved. Entries which have never been
+	 * retrieved have their chip pointer set to NULL.
+	 *
+	 * The lazily allocated tables and line objects are published with
+	 * release stores so that the lookups can skip the lock once they
+	 * have been set up. The lock only serializes their allocation.
+	 */
+	struct gpiod_line *lines;
+	struct line_info *line_info;
+	struct line_event_stats *event_stats;
 	unsigned int num_lines;
 
 	int fd;
 
 	char name[32];
 	char label[32];
+
+	struct line_name_slot *name_index;
+	unsigned int name_index_mask;
+
+	int line_info_policy;
+
+	bool uapi_v2;
+	unsigned int event_buffer_size;
+
+	pthread_mutex_t lock;
 };
 
-static bool is_gpiochip_cdev(const char *path)
+static struct line_info *line_get_info(struct gpiod_line *line)
+{
+	return &line->chip->line_info[line->offset];
+}
+
+static int sysfs_gpio_dirfd = -1;
+
+/*
+ * Return a descriptor of the sysfs directory holding GPIO devices. It's
+ * opened once and shared by all threads: if two threads race to open it, the
+ * loser closes its own descriptor and uses the winner's. If the cached
+ * descriptor became invalid (for instance: a daemon closed all its file
+ * descriptors), it's dropped and the directory is opened again.
+ */
+static int get_sysfs_gpio_dirfd(bool reopen)
+{
+	int fd, cached;
+
+	cached = __atomic_load_n(&sysfs_gpio_dirfd, __ATOMIC_ACQUIRE);
+	if (cached >= 0 && !reopen)
+		return cached;
+
+	fd = open("/sys/bus/gpio/devices",
+		  O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+
+	if (!__atomic_compare_exchange_n(&sysfs_gpio_dirfd, &cached, fd,
+					 false, __ATOMIC_ACQ_REL,
+					 __ATOMIC_ACQUIRE)) {
+		close(fd);
+		return cached;
+	}
+
+	return fd;
+}
+
+static int open_sysfs_dev_attr(const char *name)
+{
+	char attr[NAME_MAX + sizeof("/dev")];
+	int dirfd, fd;
+
+	if (snprintf(attr, sizeof(attr), "%s/dev", name) >= (int)sizeof(attr)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	dirfd = get_sysfs_gpio_dirfd(false);
+	if (dirfd < 0)
+		return -1;
+
+	fd = openat(dirfd, attr, O_RDONLY | O_CLOEXEC);
+	if (fd < 0 && (errno == EBADF || errno == ENOTDIR)) {
+		dirfd = get_sysfs_gpio_dirfd(true);
+		if (dirfd < 0)
+			return -1;
+
+		fd = openat(dirfd, attr, O_RDONLY | O_CLOEXEC);
+	}
+
+	return fd;
+}
+
+static bool is_gpiochip_cdev(int fd, const char *path)
 {
-	char *name, *pathcpy, *sysfsp, sysfsdev[16], devstr[16];
+	char sysfsdev[16], devstr[16];
 	struct stat statbuf;
-	bool ret = false;
-	int rv, fd;
+	const char *name;
+	int rv, attrfd;
 	ssize_t rd;
 
-	rv = lstat(path, &statbuf);
+	rv = fstat(fd, &statbuf);
 	if (rv)
-		goto out;
+		return false;
 
 	/* Is it a character device? */
 	if (!S_ISCHR(statbuf.st_mode)) {
@@ -81,22 +208,16 @@ static bool is_gpiochip_cdev(const char *path)
 		 * libgpiod from before the introduction of this routine.
 		 */
 		errno = ENOTTY;
-		goto out;
+		return false;
 	}
 
 	/* Get the basename. */
-	pathcpy = strdup(path);
-	if (!pathcpy)
-		goto out;
-
-	name = basename(pathcpy);
+	name = strrchr(path, '/');
+	name = name ? name + 1 : path;
 
 	/* Do we have a corresponding sysfs attribute? */
-	rv = asprintf(&sysfsp, "/sys/bus/gpio/devices/%s/dev", name);
-	if (rv < 0)
-		goto out_free_pathcpy;
-
-	if (access(sysfsp, R_OK) != 0) {
+	attrfd = open_sysfs_dev_attr(name);
+	if (attrfd < 0) {
 		/*
 		 * This is a character device but not the one we're after.
 		 * Before the introduction of this function, we'd fail with
@@ -104,10 +225,20 @@ static bool is_gpiochip_cdev(const char *path)
 		 * descriptor. Let's stay compatible here and keep returning
 		 * the same error code.
 		 */
-		errno = ENOTTY;
-		goto out_free_sysfsp;
+		if (errno == ENOENT)
+			errno = ENOTTY;
+		return false;
 	}
 
+	memset(sysfsdev, 0, sizeof(sysfsdev));
+	rd = read(attrfd, sysfsdev, sizeof(sysfsdev) - 1);
+	close(attrfd);
+	if (rd < 0)
+		return false;
+
+	if (rd > 0 && sysfsdev[rd - 1] == '\n')
+		sysfsdev[rd - 1] = '\0';
+
 	/*
 	 * Make sure the major and minor numbers of the character device
 	 * correspond with the ones in the dev attribute in sysfs.
@@ -115,32 +246,46 @@ static bool is_gpiochip_cdev(const char *path)
 	snprintf(devstr, sizeof(devstr), "%u:%u",
 		 major(statbuf.st_rdev), minor(statbuf.st_rdev));
 
-	fd = open(sysfsp, O_RDONLY);
-	if (fd < 0)
-		goto out_free_sysfsp;
-
-	memset(sysfsdev, 0, sizeof(sysfsdev));
-	rd = read(fd, sysfsdev, strlen(devstr));
-	close(fd);
-	if (rd < 0)
-		goto out_free_sysfsp;
-
 	if (strcmp(sysfsdev, devstr) != 0) {
 		errno = ENODEV;
-		goto out_free_sysfsp;
+		return false;
 	}
 
-	ret = true;
+	return true;
+}
+
+/*
+ * The v2 uAPI is used whenever the kernel supports it. There's no dedicated
+ * ioctl() to query the uAPI version, so probe it with the v2 line info ioctl()
+ * on the first line. Old kernels fail it with EINVAL or ENOTTY.
+ */
+static bool chip_has_uapi_v2(struct gpiod_chip *chip)
+{
+#if HAVE_DECL_GPIO_V2_GET_LINE_IOCTL
+	struct gpio_v2_line_info info;
+	int errsv, rv;
+
+	if (!chip->num_lines)
+		return false;
 
-out_free_sysfsp:
-	free(sysfsp);
-out_free_pathcpy:
-	free(pathcpy);
-out:
-	return ret;
+	memset(&info, 0, sizeof(info));
+
+	errsv = errno;
+	rv = ioctl(chip->fd, GPIO_V2_GET_LINEINFO_IOCTL, &info);
+	errno = errsv;
+
+	return rv == 0;
+#else /* !HAVE_DECL_GPIO_V2_GET_LINE_IOCTL */
+	return false;
+#endif /* HAVE_DECL_GPIO_V2_GET_LINE_IOCTL */
 }
 
 struct gpiod_chip *gpiod_chip_open(const char *path)
+{
+	return gpiod_chip_open_flags(path, 0);
+}
+
+struct gpiod_chip *gpiod_chip_open_flags(const char *path, int flags)
 {
 	struct gpiochip_info info;
 	struct gpiod_chip *chip;
@@ -154,7 +299,8 @@ struct gpiod_chip *gpiod_chip_open(const char *path)
 	 * We were able to open the file but is it really a gpiochip character
 	 * device?
 	 */
-	if (!is_gpiochip_cdev(path)) {
+	if (!(flags & GPIOD_CHIP_OPEN_FLAG_NO_VERIFY) &&
+	    !is_gpiochip_cdev(fd, path)) {
 		close(fd);
 		return NULL;
 	}
@@ -170,8 +316,18 @@ struct gpiod_chip *gpiod_chip_open(const char *path)
 	if (rv < 0)
 		goto err_free_chip;
 
+	rv = pthread_mutex_init(&chip->lock, NULL);
+	if (rv) {
+		errno = rv;
+		goto err_free_chip;
+	}
+
 	chip->fd = fd;
 	chip->num_lines = info.lines;
+	chip->line_info_policy = GPIOD_LINE_INFO_REFRESH_ALWAYS;
+
+	if (!(flags & GPIOD_CHIP_OPEN_FLAG_UAPI_V1))
+		chip->uapi_v2 = chip_has_uapi_v2(chip);
 
 	/*
 	 * GPIO device must have a name - don't bother checking this field. In
@@ -206,16 +362,18 @@ void gpiod_chip_close(struct gpiod_chip *chip)
 
 	if (chip->lines) {
 		for (i = 0; i < chip->num_lines; i++) {
-			line = chip->lines[i];
-			if (line) {
+			line = &chip->lines[i];
+			if (line->chip)
 				gpiod_line_release(line);
-				free(line);
-			}
 		}
 
 		free(chip->lines);
+		free(chip->line_info);
+		free(chip->event_stats);
 	}
 
+	free(chip->name_index);
+	pthread_mutex_destroy(&chip->lock);
 	close(chip->fd);
 	free(chip);
 }
@@ -235,10 +393,44 @@ unsigned int gpiod_chip_num_lines(struct gpiod_chip *chip)
 	return chip->num_lines;
 }
 
+static struct gpiod_line *chip_get_lines(struct gpiod_chip *chip)
+{
+	struct gpiod_line *lines;
+
+	lines = __atomic_load_n(&chip->lines, __ATOMIC_ACQUIRE);
+	if (lines)
+		return lines;
+
+	pthread_mutex_lock(&chip->lock);
+
+	lines = chip->lines;
+	if (lines)
+		goto out;
+
+	chip->line_info = calloc(chip->num_lines, sizeof(*chip->line_info));
+	if (!chip->line_info)
+		goto out;
+
+	lines = calloc(chip->num_lines, sizeof(*lines));
+	if (!lines) {
+		free(chip->line_info);
+		chip->line_info = NULL;
+		goto out;
+	}
+
+	/* Publish the info table together with the line objects. */
+	__atomic_store_n(&chip->lines, lines, __ATOMIC_RELEASE);
+
+out:
+	pthread_mutex_unlock(&chip->lock);
+
+	return lines;
+}
+
 struct gpiod_line *
 gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset)
 {
-	struct gpiod_line *line;
+	struct gpiod_line *lines, *line;
 	int rv;
 
 	if (offset >= chip->num_lines) {
@@ -246,504 +438,1835 @@ gpiod_chip_get_line(struct gpiod_chip *chip, unsigned int offset)
 		return NULL;
 	}
 
-	if (!chip->lines) {
-		chip->lines = calloc(chip->num_lines,
-				     sizeof(struct gpiod_line *));
-		if (!chip->lines)
-			return NULL;
-	}
+	lines = chip_get_lines(chip);
+	if (!lines)
+		return NULL;
 
-	if (!chip->lines[offset]) {
-		line = malloc(sizeof(*line));
-		if (!line)
-			return NULL;
+	line = &lines[offset];
+	if (!__atomic_load_n(&line->chip, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&chip->lock);
+
+		if (!line->chip) {
+			line->offset = offset;
 
-		memset(line, 0, sizeof(*line));
+			/* Loaded on first access unless refreshed below. */
+			chip->line_info[offset].stale = true;
 
-		line->offset = offset;
-		line->chip = chip;
+			__atomic_store_n(&line->chip, chip, __ATOMIC_RELEASE);
+		}
 
-		chip->lines[offset] = line;
-	} else {
-		line = chip->lines[offset];
+		pthread_mutex_unlock(&chip->lock);
 	}
 
-	rv = gpiod_line_update(line);
-	if (rv < 0)
-		return NULL;
+	if (chip->line_info_policy == GPIOD_LINE_INFO_REFRESH_ALWAYS) {
+		rv = gpiod_line_update(line);
+		if (rv < 0)
+			return NULL;
+	}
 
 	return line;
 }
 
-static struct line_fd_handle *line_make_fd_handle(int fd)
+/* FNV-1a */
+static uint32_t line_name_hash(const char *name, size_t len)
 {
-	struct line_fd_handle *handle;
-
-	handle = malloc(sizeof(*handle));
-	if (!handle)
-		return NULL;
+	uint32_t hash = 2166136261U;
+	size_t i;
 
-	handle->fd = fd;
-	handle->refcount = 0;
+	for (i = 0; i < len && name[i]; i++) {
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619U;
+	}
 
-	return handle;
+	return hash;
 }
 
-static void line_fd_incref(struct gpiod_line *line)
+static int chip_read_line_info(struct gpiod_chip *chip, unsigned int offset,
+			       struct line_info *line_info);
+
+/*
+ * Line names are assigned by the kernel when the chip is registered and don't
+ * change afterwards so the index is built once - on the first lookup - with a
+ * single pass over the line info of all lines. The info is read the same way
+ * as by gpiod_line_update() but into a temporary buffer, so that the cached
+ * info of the lines is left alone.
+ */
+static int chip_build_name_index(struct gpiod_chip *chip)
 {
-	line->fd_handle->refcount++;
+	struct line_name_slot *slots;
+	struct line_info info;
+	unsigned int size, offset;
+	uint32_t hash, pos;
+	int rv;
+
+	/* Keep the load factor at or below 0.5. */
+	for (size = 1; size < chip->num_lines * 2; size <<= 1)
+		;
+
+	slots = malloc(sizeof(*slots) * size);
+	if (!slots)
+		return -1;
+
+	for (pos = 0; pos < size; pos++)
+		slots[pos].offset = LINE_NAME_SLOT_EMPTY;
+
+	for (offset = 0; offset < chip->num_lines; offset++) {
+		memset(&info, 0, sizeof(info));
+
+		rv = chip_read_line_info(chip, offset, &info);
+		if (rv < 0) {
+			free(slots);
+			return -1;
+		}
+
+		if (info.name[0] == '\0')
+			continue;
+
+		/*
+		 * Lines are inserted in the order of their offsets, so if
+		 * several lines share a name, the lookup will find the one
+		 * with the lowest offset first - just like a linear scan.
+		 */
+		hash = line_name_hash(info.name, sizeof(info.name));
+		for (pos = hash & (size - 1);
+		     slots[pos].offset != LINE_NAME_SLOT_EMPTY;
+		     pos = (pos + 1) & (size - 1))
+			;
+
+		slots[pos].hash = hash;
+		slots[pos].offset = offset;
+	}
+
+	chip->name_index_mask = size - 1;
+	__atomic_store_n(&chip->name_index, slots, __ATOMIC_RELEASE);
+
+	return 0;
 }
 
-static void line_fd_decref(struct gpiod_line *line)
+struct gpiod_line *
+gpiod_chip_find_line(struct gpiod_chip *chip, const char *name)
 {
-	struct line_fd_handle *handle = line->fd_handle;
+	struct line_name_slot *slot;
+	struct gpiod_line *line;
+	uint32_t hash, pos;
+	int rv;
+
+	if (!__atomic_load_n(&chip->name_index, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&chip->lock);
+		rv = chip->name_index ? 0 : chip_build_name_index(chip);
+		pthread_mutex_unlock(&chip->lock);
+		if (rv < 0)
+			return NULL;
+	}
 
-	handle->refcount--;
+	hash = line_name_hash(name, SIZE_MAX);
 
-	if (handle->refcount == 0) {
-		close(handle->fd);
-		free(handle);
-		line->fd_handle = NULL;
+	for (pos = hash & chip->name_index_mask;
+	     chip->name_index[pos].offset != LINE_NAME_SLOT_EMPTY;
+	     pos = (pos + 1) & chip->name_index_mask) {
+		slot = &chip->name_index[pos];
+		if (slot->hash != hash)
+			continue;
+
+		line = gpiod_chip_get_line(chip, slot->offset);
+		if (!line)
+			return NULL;
+
+		if (strncmp(line_get_info(line)->name, name,
+			    sizeof(chip->line_info->name)) == 0 &&
+		    strlen(name) < sizeof(chip->line_info->name))
+			return line;
 	}
+
+	errno = ENOENT;
+
+	return NULL;
 }
 
-static void line_set_fd(struct gpiod_line *line, struct line_fd_handle *handle)
+int gpiod_chip_set_line_info_policy(struct gpiod_chip *chip, int policy)
 {
-	line->fd_handle = handle;
-	line_fd_incref(line);
+	if (policy != GPIOD_LINE_INFO_REFRESH_ALWAYS &&
+	    policy != GPIOD_LINE_INFO_REFRESH_IF_STALE &&
+	    policy != GPIOD_LINE_INFO_REFRESH_NEVER) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	chip->line_info_policy = policy;
+
+	return 0;
 }
 
-static int line_get_fd(struct gpiod_line *line)
+int gpiod_chip_get_line_info_policy(struct gpiod_chip *chip)
 {
-	return line->fd_handle->fd;
+	return chip->line_info_policy;
 }
 
-static void line_maybe_update(struct gpiod_line *line)
+void gpiod_chip_invalidate_line_info(struct gpiod_chip *chip)
 {
-	int rv;
+	unsigned int i;
 
-	rv = gpiod_line_update(line);
-	if (rv < 0)
-		line->up_to_date = false;
+	if (!chip->lines)
+		return;
+
+	for (i = 0; i < chip->num_lines; i++)
+		chip->line_info[i].stale = true;
 }
 
-struct gpiod_chip *gpiod_line_get_chip(struct gpiod_line *line)
+int gpiod_chip_uapi_version(struct gpiod_chip *chip)
 {
-	return line->chip;
+	return chip->uapi_v2 ? 2 : 1;
 }
 
-unsigned int gpiod_line_offset(struct gpiod_line *line)
+int gpiod_chip_set_event_buffer_size(struct gpiod_chip *chip,
+				     unsigned int size)
 {
-	return line->offset;
+	/* The v1 uAPI has a fixed, per-line event queue. */
+	if (!chip->uapi_v2) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	chip->event_buffer_size = size;
+
+	return 0;
 }
 
-const char *gpiod_line_name(struct gpiod_line *line)
+unsigned int gpiod_chip_get_event_buffer_size(struct gpiod_chip *chip)
 {
-	return line->name[0] == '\0' ? NULL : line->name;
+	return chip->event_buffer_size;
 }
 
-const char *gpiod_line_consumer(struct gpiod_line *line)
+static struct line_fd_handle *line_make_fd_handle(int fd, bool uapi_v2)
 {
-	return line->consumer[0] == '\0' ? NULL : line->consumer;
+	struct line_fd_handle *handle;
+
+	handle = malloc(sizeof(*handle));
+	if (!handle)
+		return NULL;
+
+	memset(handle, 0, sizeof(*handle));
+	handle->fd = fd;
+	handle->uapi_v2 = uapi_v2;
+
+	return handle;
 }
 
-int gpiod_line_direction(struct gpiod_line *line)
+/*
+ * Lines sharing a handle may be released from different threads, so the
+ * reference count is only ever modified atomically.
+ */
+static void line_fd_handle_incref(struct line_fd_handle *handle)
 {
-	return line->direction;
+	__atomic_fetch_add(&handle->refcount, 1, __ATOMIC_RELAXED);
 }
 
-int gpiod_line_active_state(struct gpiod_line *line)
+static void line_fd_handle_decref(struct line_fd_handle *handle)
 {
-	return line->active_state;
+	if (__atomic_sub_fetch(&handle->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+		close(handle->fd);
+		free(handle->pending);
+		free(handle);
+	}
 }
 
-bool gpiod_line_is_used(struct gpiod_line *line)
+static void line_fd_incref(struct gpiod_line *line)
 {
-	return line->used;
+	line_fd_handle_incref(line->fd_handle);
 }
 
-bool gpiod_line_is_open_drain(struct gpiod_line *line)
+static void line_fd_decref(struct gpiod_line *line)
 {
-	return line->open_drain;
+	line_fd_handle_decref(line->fd_handle);
+	line->fd_handle = NULL;
 }
 
-bool gpiod_line_is_open_source(struct gpiod_line *line)
+static void line_set_fd(struct gpiod_line *line, struct line_fd_handle *handle)
 {
-	return line->open_source;
+	line->fd_handle = handle;
+	line_fd_incref(line);
 }
 
-bool gpiod_line_needs_update(struct gpiod_line *line)
+static int line_get_fd(struct gpiod_line *line)
 {
-	return !line->up_to_date;
+	return line->fd_handle->fd;
 }
 
-int gpiod_line_update(struct gpiod_line *line)
+/*
+ * Requesting a line changes its info but the user may never look at it, so
+ * instead of issuing GPIO_GET_LINEINFO_IOCTL for every requested line, the
+ * info is marked as stale and refreshed on first access.
+ */
+static void line_mark_stale(struct gpiod_line *line)
 {
-	struct gpioline_info info;
-	int rv;
-
-	memset(&info, 0, sizeof(info));
-	info.line_offset = line->offset;
-
-	rv = ioctl(line->chip->fd, GPIO_GET_LINEINFO_IOCTL, &info);
-	if (rv < 0)
-		return -1;
-
-	line->direction = info.flags & GPIOLINE_FLAG_IS_OUT
-						? GPIOD_LINE_DIRECTION_OUTPUT
-						: GPIOD_LINE_DIRECTION_INPUT;
-	line->active_state = info.flags & GPIOLINE_FLAG_ACTIVE_LOW
-						? GPIOD_LINE_ACTIVE_STATE_LOW
-						: GPIOD_LINE_ACTIVE_STATE_HIGH;
+	if (line->chip->line_info_policy != GPIOD_LINE_INFO_REFRESH_NEVER)
+		line_get_info(line)->stale = true;
+}
 
-	line->used = info.flags & GPIOLINE_FLAG_KERNEL;
-	line->open_drain = info.flags & GPIOLINE_FLAG_OPEN_DRAIN;
-	line->open_source = info.flags & GPIOLINE_FLAG_OPEN_SOURCE;
+static struct line_info *line_get_fresh_info(struct gpiod_line *line)
+{
+	struct line_info *info = line_get_info(line);
+	int rv;
 
-	strncpy(line->name, info.name, sizeof(line->name));
-	strncpy(line->consumer, info.consumer, sizeof(line->consumer));
+	if (info->stale) {
+		info->stale = false;
 
-	line->up_to_date = true;
+		rv = gpiod_line_update(line);
+		if (rv < 0)
+			info->up_to_date = false;
+	}
 
-	return 0;
+	return info;
 }
 
-static bool line_bulk_same_chip(struct gpiod_line_bulk *bulk)
+static uint64_t line_values_mask(unsigned int num_lines)
 {
-	struct gpiod_line *first_line, *line;
-	struct gpiod_chip *first_chip, *chip;
-	unsigned int i;
+	return num_lines >= 64 ? UINT64_MAX : (1ULL << num_lines) - 1;
+}
 
-	if (bulk->num_lines == 1)
-		return true;
+static bool line_request_is_direction(int request)
+{
+	return request == GPIOD_LINE_REQUEST_DIRECTION_AS_IS ||
+	       request == GPIOD_LINE_REQUEST_DIRECTION_INPUT ||
+	       request == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+}
 
-	first_line = gpiod_line_bulk_get_line(bulk, 0);
-	first_chip = gpiod_line_get_chip(first_line);
+static bool line_request_is_events(int request)
+{
+	return request == GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE ||
+	       request == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE ||
+	       request == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+}
 
-	for (i = 1; i < bulk->num_lines; i++) {
-		line = bulk->lines[i];
-		chip = gpiod_line_get_chip(line);
+#define LINE_REQUEST_FLAG_BIAS_MASK					\
+		(GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE |			\
+		 GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN |		\
+		 GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP)
 
-		if (first_chip != chip) {
-			errno = EINVAL;
-			return false;
+/* Flags applying to the request as a whole which can't be set per line. */
+#define LINE_REQUEST_FLAG_REQUEST_MASK					\
+		(GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD |		\
+		 GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG)
+
+/*
+ * Get the config of a single line of a request: the config of the whole
+ * request with the per-line overrides for this line applied. Also checks
+ * the resulting config for consistency.
+ */
+static int line_get_request_config(
+			const struct gpiod_line_request_config *config,
+			struct gpiod_line *line,
+			struct gpiod_line_request_config *line_config)
+{
+	const struct gpiod_line_config *override;
+	unsigned int i;
+	int bias;
+
+	/*
+	 * Only touch the fields added after the original three when the flags
+	 * say they're in use - callers built against older headers pass a
+	 * smaller struct.
+	 */
+	memset(line_config, 0, sizeof(*line_config));
+	line_config->consumer = config->consumer;
+	line_config->request_type = config->request_type;
+	line_config->flags = config->flags &
+			     ~GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_DEBOUNCE)
+		line_config->debounce_period_us = config->debounce_period_us;
+
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG) {
+		for (i = 0; i < config->num_line_configs; i++) {
+			override = &config->line_configs[i];
+			if (override->offset != line->offset)
+				continue;
+
+			if (override->request_type)
+				line_config->request_type =
+						override->request_type;
+
+			line_config->flags =
+				(override->flags &
+				 ~LINE_REQUEST_FLAG_REQUEST_MASK) |
+				(config->flags &
+				 GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD);
+			line_config->debounce_period_us =
+						override->debounce_period_us;
+			break;
 		}
 	}
 
-	return true;
+	/* Lines can't be requested for values and events at the same time. */
+	if (line_request_is_direction(line_config->request_type) !=
+			line_request_is_direction(config->request_type) ||
+	    line_request_is_events(line_config->request_type) !=
+			line_request_is_events(config->request_type)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((line_config->request_type !=
+			GPIOD_LINE_REQUEST_DIRECTION_OUTPUT) &&
+	    (line_config->flags & (GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN |
+				   GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((line_config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN) &&
+	    (line_config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	bias = line_config->flags & LINE_REQUEST_FLAG_BIAS_MASK;
+	if (bias & (bias - 1)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
 }
 
-static bool line_bulk_all_requested(struct gpiod_line_bulk *bulk)
+static int line_bulk_check_request_config(struct gpiod_line_bulk *bulk,
+			const struct gpiod_line_request_config *config)
 {
+	struct gpiod_line_request_config line_config;
 	struct gpiod_line *line, **lineptr;
+	int rv;
 
 	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
-		if (!gpiod_line_is_requested(line)) {
-			errno = EPERM;
-			return false;
-		}
+		rv = line_get_request_config(config, line, &line_config);
+		if (rv)
+			return -1;
 	}
 
-	return true;
+	return 0;
 }
 
-static bool line_bulk_all_free(struct gpiod_line_bulk *bulk)
+static int line_event_stats_init(struct gpiod_line *line, int request_type)
 {
-	struct gpiod_line *line, **lineptr;
+	struct gpiod_chip *chip = line->chip;
+	struct line_event_stats *stats;
 
-	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
-		if (!gpiod_line_is_free(line)) {
-			errno = EBUSY;
-			return false;
+	if (!__atomic_load_n(&chip->event_stats, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&chip->lock);
+
+		if (!chip->event_stats) {
+			stats = calloc(chip->num_lines, sizeof(*stats));
+			if (!stats) {
+				pthread_mutex_unlock(&chip->lock);
+				return -1;
+			}
+
+			__atomic_store_n(&chip->event_stats, stats,
+					 __ATOMIC_RELEASE);
 		}
+
+		pthread_mutex_unlock(&chip->lock);
 	}
 
-	return true;
+	stats = &chip->event_stats[line->offset];
+	memset(stats, 0, sizeof(*stats));
+	stats->both_edges =
+			request_type == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+
+	return 0;
 }
 
-static int line_request_values(struct gpiod_line_bulk *bulk,
-			       const struct gpiod_line_request_config *config,
-			       const int *default_vals)
+/*
+ * Routines talking to the kernel using the v2 uAPI. A v2 request covers up to
+ * GPIO_V2_LINES_MAX lines with a single file descriptor for both values and
+ * edge events. Line values are passed as bitmaps indexed by the position of
+ * the line in the request.
+ */
+
+/* Set once any lines have been requested using the given uAPI version. */
+static bool uapi_v1_requested;
+static bool uapi_v2_requested;
+
+#if HAVE_DECL_GPIO_V2_GET_LINE_IOCTL
+
+static uint64_t
+line_request_v2_flags(const struct gpiod_line_request_config *config)
 {
-	struct gpiod_line *line, **lineptr;
-	struct line_fd_handle *line_fd;
-	struct gpiohandle_request req;
+	uint64_t flags = 0;
+
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN)
+		flags |= GPIO_V2_LINE_FLAG_OPEN_DRAIN;
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)
+		flags |= GPIO_V2_LINE_FLAG_OPEN_SOURCE;
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW)
+		flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE)
+		flags |= GPIO_V2_LINE_FLAG_BIAS_DISABLED;
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN)
+		flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP)
+		flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+
+	switch (config->request_type) {
+	case GPIOD_LINE_REQUEST_DIRECTION_INPUT:
+		flags |= GPIO_V2_LINE_FLAG_INPUT;
+		break;
+	case GPIOD_LINE_REQUEST_DIRECTION_OUTPUT:
+		flags |= GPIO_V2_LINE_FLAG_OUTPUT;
+		break;
+	case GPIOD_LINE_REQUEST_EVENT_RISING_EDGE:
+		flags |= GPIO_V2_LINE_FLAG_INPUT |
+			 GPIO_V2_LINE_FLAG_EDGE_RISING;
+		break;
+	case GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE:
+		flags |= GPIO_V2_LINE_FLAG_INPUT |
+			 GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		break;
+	case GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES:
+		flags |= GPIO_V2_LINE_FLAG_INPUT |
+			 GPIO_V2_LINE_FLAG_EDGE_RISING |
+			 GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		break;
+	}
+
+	return flags;
+}
+
+/*
+ * Lines whose config differs from the defaults of the request are covered by
+ * config attributes. Lines sharing the same value of an attribute share a
+ * single entry in the attribute array.
+ */
+static int line_config_v2_add_attr(struct gpio_v2_line_config *config,
+				   uint32_t id, uint64_t value,
+				   unsigned int index)
+{
+	struct gpio_v2_line_config_attribute *attr;
 	unsigned int i;
-	int rv, fd;
 
-	if ((config->request_type != GPIOD_LINE_REQUEST_DIRECTION_OUTPUT) &&
-	    (config->flags & (GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN |
-			      GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE))) {
-		errno = EINVAL;
-		return -1;
+	for (i = 0; i < config->num_attrs; i++) {
+		attr = &config->attrs[i];
+		if (attr->attr.id != id)
+			continue;
+
+		if ((id == GPIO_V2_LINE_ATTR_ID_FLAGS &&
+		     attr->attr.flags == value) ||
+		    (id == GPIO_V2_LINE_ATTR_ID_DEBOUNCE &&
+		     attr->attr.debounce_period_us == value)) {
+			attr->mask |= 1ULL << index;
+			return 0;
+		}
 	}
 
-	if ((config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN) &&
-	    (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)) {
-		errno = EINVAL;
+	if (config->num_attrs == GPIO_V2_LINE_NUM_ATTRS_MAX) {
+		errno = E2BIG;
 		return -1;
 	}
 
-	memset(&req, 0, sizeof(req));
+	attr = &config->attrs[config->num_attrs++];
+	attr->attr.id = id;
+	attr->mask = 1ULL << index;
 
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN)
-		req.flags |= GPIOHANDLE_REQUEST_OPEN_DRAIN;
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)
-		req.flags |= GPIOHANDLE_REQUEST_OPEN_SOURCE;
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW)
-		req.flags |= GPIOHANDLE_REQUEST_ACTIVE_LOW;
+	if (id == GPIO_V2_LINE_ATTR_ID_FLAGS)
+		attr->attr.flags = value;
+	else
+		attr->attr.debounce_period_us = value;
 
-	if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_INPUT)
-		req.flags |= GPIOHANDLE_REQUEST_INPUT;
-	else if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT)
-		req.flags |= GPIOHANDLE_REQUEST_OUTPUT;
+	return 0;
+}
 
-	req.lines = gpiod_line_bulk_num_lines(bulk);
+static int line_request_v2(struct gpiod_line_bulk *bulk,
+			   const struct gpiod_line_request_config *config,
+			   const int *default_vals, int state)
+{
+	struct gpiod_line_request_config line_config;
+	struct gpio_v2_line_config_attribute *attr;
+	uint64_t flags, outputs = 0, values = 0;
+	struct gpiod_line *line, **lineptr;
+	struct gpio_v2_line_request req;
+	struct line_fd_handle *line_fd;
+	struct gpiod_chip *chip;
+	unsigned int i;
+	int rv;
+
+	chip = gpiod_line_bulk_get_line(bulk, 0)->chip;
+
+	memset(&req, 0, sizeof(req));
+
+	req.num_lines = gpiod_line_bulk_num_lines(bulk);
+	req.event_buffer_size = chip->event_buffer_size;
+	req.config.flags = line_request_v2_flags(config);
 
 	gpiod_line_bulk_foreach_line_off(bulk, line, i) {
-		req.lineoffsets[i] = gpiod_line_offset(line);
-		if (config->request_type ==
-				GPIOD_LINE_REQUEST_DIRECTION_OUTPUT &&
-		    default_vals)
-			req.default_values[i] = !!default_vals[i];
+		req.offsets[i] = gpiod_line_offset(line);
+
+		rv = line_get_request_config(config, line, &line_config);
+		if (rv)
+			return -1;
+
+		flags = line_request_v2_flags(&line_config);
+		if (flags != req.config.flags) {
+			rv = line_config_v2_add_attr(&req.config,
+						GPIO_V2_LINE_ATTR_ID_FLAGS,
+						flags, i);
+			if (rv)
+				return -1;
+		}
+
+		if ((line_config.flags & GPIOD_LINE_REQUEST_FLAG_DEBOUNCE) &&
+		    line_config.debounce_period_us) {
+			rv = line_config_v2_add_attr(&req.config,
+					GPIO_V2_LINE_ATTR_ID_DEBOUNCE,
+					line_config.debounce_period_us, i);
+			if (rv)
+				return -1;
+		}
+
+		if (state == LINE_REQUESTED_EVENTS) {
+			rv = line_event_stats_init(line,
+						   line_config.request_type);
+			if (rv)
+				return -1;
+		}
+
+		if (line_config.request_type ==
+				GPIOD_LINE_REQUEST_DIRECTION_OUTPUT) {
+			outputs |= 1ULL << i;
+			if (default_vals && default_vals[i])
+				values |= 1ULL << i;
+		}
 	}
 
-	if (config->consumer)
-		strncpy(req.consumer_label, config->consumer,
-			sizeof(req.consumer_label) - 1);
+	if (outputs && default_vals) {
+		if (req.config.num_attrs == GPIO_V2_LINE_NUM_ATTRS_MAX) {
+			errno = E2BIG;
+			return -1;
+		}
 
-	line = gpiod_line_bulk_get_line(bulk, 0);
-	fd = line->chip->fd;
+		attr = &req.config.attrs[req.config.num_attrs++];
+		attr->attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		attr->attr.values = values;
+		attr->mask = outputs;
+	}
 
-	rv = ioctl(fd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+	if (config->consumer)
+		strncpy(req.consumer, config->consumer,
+			sizeof(req.consumer) - 1);
+
+	rv = ioctl(chip->fd, GPIO_V2_GET_LINE_IOCTL, &req);
 	if (rv < 0)
 		return -1;
 
-	line_fd = line_make_fd_handle(req.fd);
-	if (!line_fd)
+	line_fd = line_make_fd_handle(req.fd, true);
+	if (!line_fd) {
+		close(req.fd);
 		return -1;
+	}
+
+	__atomic_store_n(&uapi_v2_requested, true, __ATOMIC_RELAXED);
 
 	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
-		line->state = LINE_REQUESTED_VALUES;
+		line->state = state;
 		line_set_fd(line, line_fd);
-		line_maybe_update(line);
+		line_mark_stale(line);
 	}
 
 	return 0;
 }
 
-static int line_request_event_single(struct gpiod_line *line,
-			const struct gpiod_line_request_config *config)
+static int line_info_read_v2(struct gpiod_chip *chip, unsigned int offset,
+			     struct line_info *line_info)
 {
-	struct line_fd_handle *line_fd;
-	struct gpioevent_request req;
+	struct gpio_v2_line_info info;
 	int rv;
 
-	memset(&req, 0, sizeof(req));
+	memset(&info, 0, sizeof(info));
+	info.offset = offset;
 
-	if (config->consumer)
-		strncpy(req.consumer_label, config->consumer,
-			sizeof(req.consumer_label) - 1);
+	rv = ioctl(chip->fd, GPIO_V2_GET_LINEINFO_IOCTL, &info);
+	if (rv < 0)
+		return -1;
 
-	req.lineoffset = gpiod_line_offset(line);
-	req.handleflags |= GPIOHANDLE_REQUEST_INPUT;
+	line_info->direction = info.flags & GPIO_V2_LINE_FLAG_OUTPUT
+						? GPIOD_LINE_DIRECTION_OUTPUT
+						: GPIOD_LINE_DIRECTION_INPUT;
+	line_info->active_state = info.flags & GPIO_V2_LINE_FLAG_ACTIVE_LOW
+						? GPIOD_LINE_ACTIVE_STATE_LOW
+						: GPIOD_LINE_ACTIVE_STATE_HIGH;
 
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN)
-		req.handleflags |= GPIOHANDLE_REQUEST_OPEN_DRAIN;
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)
-		req.handleflags |= GPIOHANDLE_REQUEST_OPEN_SOURCE;
-	if (config->flags & GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW)
-		req.handleflags |= GPIOHANDLE_REQUEST_ACTIVE_LOW;
+	line_info->used = info.flags & GPIO_V2_LINE_FLAG_USED;
+	line_info->open_drain = info.flags & GPIO_V2_LINE_FLAG_OPEN_DRAIN;
+	line_info->open_source = info.flags & GPIO_V2_LINE_FLAG_OPEN_SOURCE;
 
-	if (config->request_type == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE)
-		req.eventflags |= GPIOEVENT_REQUEST_RISING_EDGE;
-	else if (config->request_type == GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE)
-		req.eventflags |= GPIOEVENT_REQUEST_FALLING_EDGE;
-	else if (config->request_type == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES)
-		req.eventflags |= GPIOEVENT_REQUEST_BOTH_EDGES;
+	strncpy(line_info->name, info.name, sizeof(line_info->name));
+	strncpy(line_info->consumer, info.consumer,
+		sizeof(line_info->consumer));
 
-	rv = ioctl(line->chip->fd, GPIO_GET_LINEEVENT_IOCTL, &req);
+	return 0;
+}
+
+static int line_handle_get_bits_v2(struct line_fd_handle *handle,
+				   uint64_t mask, uint64_t *bits)
+{
+	struct gpio_v2_line_values values;
+	int rv;
+
+	values.bits = 0;
+	values.mask = mask;
+
+	rv = ioctl(handle->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values);
 	if (rv < 0)
 		return -1;
 
-	line_fd = line_make_fd_handle(req.fd);
-	if (!line_fd)
-		return -1;
+	*bits = values.bits & mask;
 
-	line->state = LINE_REQUESTED_EVENTS;
-	line_set_fd(line, line_fd);
-	line_maybe_update(line);
+	return 0;
+}
+
+static int line_handle_set_bits_v2(struct line_fd_handle *handle,
+				   uint64_t mask, uint64_t bits)
+{
+	struct gpio_v2_line_values values;
+	int rv;
+
+	values.bits = bits;
+	values.mask = mask;
+
+	rv = ioctl(handle->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values);
+	if (rv < 0)
+		return -1;
 
 	return 0;
 }
 
-static int line_request_events(struct gpiod_line_bulk *bulk,
-			       const struct gpiod_line_request_config *config)
+static int line_handle_set_config_v2(struct line_fd_handle *handle,
+			const struct gpiod_line_request_config *config,
+			unsigned int num_lines, const int *values)
 {
-	struct gpiod_line *line;
-	unsigned int off;
-	int rv, rev;
+	struct gpio_v2_line_config_attribute *attr;
+	struct gpio_v2_line_config line_config;
+	unsigned int i;
+	int rv;
 
-	gpiod_line_bulk_foreach_line_off(bulk, line, off) {
-		rv = line_request_event_single(line, config);
-		if (rv) {
-			for (rev = off - 1; rev >= 0; rev--) {
-				line = gpiod_line_bulk_get_line(bulk, rev);
-				gpiod_line_release(line);
-			}
+	memset(&line_config, 0, sizeof(line_config));
+	line_config.flags = line_request_v2_flags(config);
 
-			return -1;
+	if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT &&
+	    values) {
+		attr = &line_config.attrs[line_config.num_attrs++];
+		attr->attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		attr->mask = line_values_mask(num_lines);
+
+		for (i = 0; i < num_lines; i++) {
+			if (values[i])
+				attr->attr.values |= 1ULL << i;
 		}
 	}
 
+	rv = ioctl(handle->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &line_config);
+	if (rv < 0)
+		return -1;
+
 	return 0;
 }
 
-int gpiod_line_request(struct gpiod_line *line,
-		       const struct gpiod_line_request_config *config,
-		       int default_val)
+static int line_event_parse_v2(const void *buf, size_t size,
+			       struct gpiod_line_event *events,
+			       unsigned int num_events)
 {
-	struct gpiod_line_bulk bulk;
+	const struct gpio_v2_line_event *evdata = buf, *curr;
+	struct gpiod_line_event *event;
+	unsigned int i;
 
-	gpiod_line_bulk_init(&bulk);
-	gpiod_line_bulk_add(&bulk, line);
+	if (size < sizeof(*evdata) || size % sizeof(*evdata)) {
+		errno = EIO;
+		return -1;
+	}
 
-	return gpiod_line_request_bulk(&bulk, config, &default_val);
+	if (size / sizeof(*evdata) > num_events) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	num_events = size / sizeof(*evdata);
+
+	for (i = 0; i < num_events; i++) {
+		curr = &evdata[i];
+		event = &events[i];
+
+		event->event_type = curr->id == GPIO_V2_LINE_EVENT_RISING_EDGE
+						? GPIOD_LINE_EVENT_RISING_EDGE
+						: GPIOD_LINE_EVENT_FALLING_EDGE;
+
+		event->ts.tv_sec = curr->timestamp_ns / 1000000000ULL;
+		event->ts.tv_nsec = curr->timestamp_ns % 1000000000ULL;
+
+		event->offset = curr->offset;
+		event->seqno = curr->seqno;
+		event->line_seqno = curr->line_seqno;
+	}
+
+	return num_events;
 }
 
-static bool line_request_is_direction(int request)
+static int line_event_read_v2(int fd, struct gpiod_line_event *events,
+			      unsigned int num_events)
 {
-	return request == GPIOD_LINE_REQUEST_DIRECTION_AS_IS ||
-	       request == GPIOD_LINE_REQUEST_DIRECTION_INPUT ||
-	       request == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+	struct gpio_v2_line_event evdata[GPIOD_LINE_EVENT_MAX_EVENTS];
+	ssize_t rd;
+
+	rd = read(fd, evdata, num_events * sizeof(*evdata));
+	if (rd < 0)
+		return -1;
+
+	return line_event_parse_v2(evdata, rd, events, num_events);
 }
 
-static bool line_request_is_events(int request)
+#else /* !HAVE_DECL_GPIO_V2_GET_LINE_IOCTL */
+
+/*
+ * Without the v2 definitions in the kernel headers chip->uapi_v2 is never
+ * set and these are never called.
+ */
+
+static int line_request_v2(struct gpiod_line_bulk *bulk GPIOD_UNUSED,
+		const struct gpiod_line_request_config *config GPIOD_UNUSED,
+		const int *default_vals GPIOD_UNUSED, int state GPIOD_UNUSED)
 {
-	return request == GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE ||
-	       request == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE ||
-	       request == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+	errno = ENOTSUP;
+	return -1;
 }
 
-int gpiod_line_request_bulk(struct gpiod_line_bulk *bulk,
-			    const struct gpiod_line_request_config *config,
-			    const int *default_vals)
+static int line_info_read_v2(struct gpiod_chip *chip GPIOD_UNUSED,
+			     unsigned int offset GPIOD_UNUSED,
+			     struct line_info *line_info GPIOD_UNUSED)
 {
-	if (!line_bulk_same_chip(bulk) || !line_bulk_all_free(bulk))
-		return -1;
+	errno = ENOTSUP;
+	return -1;
+}
+
+static int line_handle_get_bits_v2(
+			struct line_fd_handle *handle GPIOD_UNUSED,
+			uint64_t mask GPIOD_UNUSED, uint64_t *bits GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+static int line_handle_set_bits_v2(
+			struct line_fd_handle *handle GPIOD_UNUSED,
+			uint64_t mask GPIOD_UNUSED, uint64_t bits GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+static int line_handle_set_config_v2(
+		struct line_fd_handle *handle GPIOD_UNUSED,
+		const struct gpiod_line_request_config *config GPIOD_UNUSED,
+		unsigned int num_lines GPIOD_UNUSED,
+		const int *values GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+static int line_event_parse_v2(const void *buf GPIOD_UNUSED,
+			       size_t size GPIOD_UNUSED,
+			       struct gpiod_line_event *events GPIOD_UNUSED,
+			       unsigned int num_events GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+static int line_event_read_v2(int fd GPIOD_UNUSED,
+			      struct gpiod_line_event *events GPIOD_UNUSED,
+			      unsigned int num_events GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+#endif /* HAVE_DECL_GPIO_V2_GET_LINE_IOCTL */
+
+struct gpiod_chip *gpiod_line_get_chip(struct gpiod_line *line)
+{
+	return line->chip;
+}
+
+unsigned int gpiod_line_offset(struct gpiod_line *line)
+{
+	return line->offset;
+}
+
+const char *gpiod_line_name(struct gpiod_line *line)
+{
+	struct line_info *info = line_get_fresh_info(line);
+
+	return info->name[0] == '\0' ? NULL : info->name;
+}
+
+const char *gpiod_line_consumer(struct gpiod_line *line)
+{
+	struct line_info *info = line_get_fresh_info(line);
+
+	return info->consumer[0] == '\0' ? NULL : info->consumer;
+}
+
+int gpiod_line_direction(struct gpiod_line *line)
+{
+	return line_get_fresh_info(line)->direction;
+}
+
+int gpiod_line_active_state(struct gpiod_line *line)
+{
+	return line_get_fresh_info(line)->active_state;
+}
+
+bool gpiod_line_is_used(struct gpiod_line *line)
+{
+	return line_get_fresh_info(line)->used;
+}
+
+bool gpiod_line_is_open_drain(struct gpiod_line *line)
+{
+	return line_get_fresh_info(line)->open_drain;
+}
+
+bool gpiod_line_is_open_source(struct gpiod_line *line)
+{
+	return line_get_fresh_info(line)->open_source;
+}
+
+bool gpiod_line_needs_update(struct gpiod_line *line)
+{
+	return !line_get_fresh_info(line)->up_to_date;
+}
+
+static int line_info_read_v1(struct gpiod_chip *chip, unsigned int offset,
+			     struct line_info *line_info)
+{
+	struct gpioline_info info;
+	int rv;
+
+	memset(&info, 0, sizeof(info));
+	info.line_offset = offset;
+
+	rv = ioctl(chip->fd, GPIO_GET_LINEINFO_IOCTL, &info);
+	if (rv < 0)
+		return -1;
+
+	line_info->direction = info.flags & GPIOLINE_FLAG_IS_OUT
+						? GPIOD_LINE_DIRECTION_OUTPUT
+						: GPIOD_LINE_DIRECTION_INPUT;
+	line_info->active_state = info.flags & GPIOLINE_FLAG_ACTIVE_LOW
+						? GPIOD_LINE_ACTIVE_STATE_LOW
+						: GPIOD_LINE_ACTIVE_STATE_HIGH;
+
+	line_info->used = info.flags & GPIOLINE_FLAG_KERNEL;
+	line_info->open_drain = info.flags & GPIOLINE_FLAG_OPEN_DRAIN;
+	line_info->open_source = info.flags & GPIOLINE_FLAG_OPEN_SOURCE;
+
+	strncpy(line_info->name, info.name, sizeof(line_info->name));
+	strncpy(line_info->consumer, info.consumer,
+		sizeof(line_info->consumer));
+
+	return 0;
+}
+
+static int chip_read_line_info(struct gpiod_chip *chip, unsigned int offset,
+			       struct line_info *line_info)
+{
+	if (chip->uapi_v2)
+		return line_info_read_v2(chip, offset, line_info);
+
+	return line_info_read_v1(chip, offset, line_info);
+}
+
+int gpiod_line_update(struct gpiod_line *line)
+{
+	struct line_info *line_info = line_get_info(line);
+	int rv;
+
+	rv = chip_read_line_info(line->chip, line->offset, line_info);
+	if (rv < 0)
+		return -1;
+
+	line_info->up_to_date = true;
+	line_info->stale = false;
+
+	return 0;
+}
+
+static bool line_bulk_same_chip(struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *first_line, *line;
+	struct gpiod_chip *first_chip, *chip;
+	unsigned int i;
+
+	if (bulk->num_lines == 1)
+		return true;
+
+	first_line = gpiod_line_bulk_get_line(bulk, 0);
+	first_chip = gpiod_line_get_chip(first_line);
+
+	for (i = 1; i < bulk->num_lines; i++) {
+		line = bulk->lines[i];
+		chip = gpiod_line_get_chip(line);
+
+		if (first_chip != chip) {
+			errno = EINVAL;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool line_bulk_all_requested(struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		if (!gpiod_line_is_requested(line)) {
+			errno = EPERM;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool line_bulk_all_free(struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		if (!gpiod_line_is_free(line)) {
+			errno = EBUSY;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * The v1 uAPI only takes a single config for all lines of a request and
+ * doesn't support debouncing. Bias is supported since linux v5.5.
+ */
+static int line_request_v1_check(const struct gpiod_line_request_config *config)
+{
+	int unsupported = GPIOD_LINE_REQUEST_FLAG_DEBOUNCE |
+			  GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+
+#ifndef GPIOHANDLE_REQUEST_BIAS_DISABLE
+	unsupported |= LINE_REQUEST_FLAG_BIAS_MASK;
+#endif /* GPIOHANDLE_REQUEST_BIAS_DISABLE */
+
+	if (config->flags & unsupported) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	return 0;
+}
+
+static uint32_t line_request_v1_flags(int flags)
+{
+	uint32_t handleflags = 0;
+
+	if (flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN)
+		handleflags |= GPIOHANDLE_REQUEST_OPEN_DRAIN;
+	if (flags & GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE)
+		handleflags |= GPIOHANDLE_REQUEST_OPEN_SOURCE;
+	if (flags & GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW)
+		handleflags |= GPIOHANDLE_REQUEST_ACTIVE_LOW;
+#ifdef GPIOHANDLE_REQUEST_BIAS_DISABLE
+	if (flags & GPIOD_LINE_REQUEST_FLAG_BIAS_DISABLE)
+		handleflags |= GPIOHANDLE_REQUEST_BIAS_DISABLE;
+	if (flags & GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN)
+		handleflags |= GPIOHANDLE_REQUEST_BIAS_PULL_DOWN;
+	if (flags & GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP)
+		handleflags |= GPIOHANDLE_REQUEST_BIAS_PULL_UP;
+#endif /* GPIOHANDLE_REQUEST_BIAS_DISABLE */
+
+	return handleflags;
+}
+
+static int line_request_values(struct gpiod_line_bulk *bulk,
+			       const struct gpiod_line_request_config *config,
+			       const int *default_vals)
+{
+	struct gpiod_line *line, **lineptr;
+	struct line_fd_handle *line_fd;
+	struct gpiohandle_request req;
+	unsigned int i;
+	int rv, fd;
+
+	rv = line_bulk_check_request_config(bulk, config);
+	if (rv)
+		return -1;
+
+	line = gpiod_line_bulk_get_line(bulk, 0);
+	if (line->chip->uapi_v2)
+		return line_request_v2(bulk, config, default_vals,
+				       LINE_REQUESTED_VALUES);
+
+	rv = line_request_v1_check(config);
+	if (rv)
+		return -1;
+
+	memset(&req, 0, sizeof(req));
+
+	req.flags = line_request_v1_flags(config->flags);
+
+	if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_INPUT)
+		req.flags |= GPIOHANDLE_REQUEST_INPUT;
+	else if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT)
+		req.flags |= GPIOHANDLE_REQUEST_OUTPUT;
+
+	req.lines = gpiod_line_bulk_num_lines(bulk);
+
+	gpiod_line_bulk_foreach_line_off(bulk, line, i) {
+		req.lineoffsets[i] = gpiod_line_offset(line);
+		if (config->request_type ==
+				GPIOD_LINE_REQUEST_DIRECTION_OUTPUT &&
+		    default_vals)
+			req.default_values[i] = !!default_vals[i];
+	}
+
+	if (config->consumer)
+		strncpy(req.consumer_label, config->consumer,
+			sizeof(req.consumer_label) - 1);
+
+	line = gpiod_line_bulk_get_line(bulk, 0);
+	fd = line->chip->fd;
+
+	rv = ioctl(fd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+	if (rv < 0)
+		return -1;
+
+	line_fd = line_make_fd_handle(req.fd, false);
+	if (!line_fd)
+		return -1;
+
+	__atomic_store_n(&uapi_v1_requested, true, __ATOMIC_RELAXED);
+
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		line->state = LINE_REQUESTED_VALUES;
+		line_set_fd(line, line_fd);
+		line_mark_stale(line);
+	}
+
+	return 0;
+}
+
+static int line_request_event_single(struct gpiod_line *line,
+			const struct gpiod_line_request_config *config)
+{
+	struct line_fd_handle *line_fd;
+	struct gpioevent_request req;
+	struct gpiod_line_bulk bulk;
+	int rv;
+
+	/*
+	 * Users may read the event file descriptor on their own, so keep
+	 * requesting single lines using the v1 uAPI - and getting the v1
+	 * event layout - unless the request needs a feature only the v2 uAPI
+	 * has or the kernel was built without the v1 uAPI.
+	 */
+	rv = line_request_v1_check(config);
+	if (line->chip->uapi_v2 && (rv || line->chip->event_buffer_size))
+		goto request_v2;
+	if (rv)
+		return -1;
+
+	rv = line_event_stats_init(line, config->request_type);
+	if (rv)
+		return -1;
+
+	memset(&req, 0, sizeof(req));
+
+	if (config->consumer)
+		strncpy(req.consumer_label, config->consumer,
+			sizeof(req.consumer_label) - 1);
+
+	req.lineoffset = gpiod_line_offset(line);
+	req.handleflags = line_request_v1_flags(config->flags) |
+			  GPIOHANDLE_REQUEST_INPUT;
+
+	if (config->request_type == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE)
+		req.eventflags |= GPIOEVENT_REQUEST_RISING_EDGE;
+	else if (config->request_type == GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE)
+		req.eventflags |= GPIOEVENT_REQUEST_FALLING_EDGE;
+	else if (config->request_type == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES)
+		req.eventflags |= GPIOEVENT_REQUEST_BOTH_EDGES;
+
+	rv = ioctl(line->chip->fd, GPIO_GET_LINEEVENT_IOCTL, &req);
+	if (rv < 0) {
+		if (errno == ENOTTY && line->chip->uapi_v2)
+			goto request_v2;
+
+		return -1;
+	}
+
+	line_fd = line_make_fd_handle(req.fd, false);
+	if (!line_fd)
+		return -1;
+
+	__atomic_store_n(&uapi_v1_requested, true, __ATOMIC_RELAXED);
+
+	line->state = LINE_REQUESTED_EVENTS;
+	line_set_fd(line, line_fd);
+	line_mark_stale(line);
+
+	return 0;
+
+request_v2:
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	return line_request_v2(&bulk, config, NULL, LINE_REQUESTED_EVENTS);
+}
+
+static int line_request_events(struct gpiod_line_bulk *bulk,
+			       const struct gpiod_line_request_config *config)
+{
+	struct gpiod_line_request_config line_config;
+	struct gpiod_line *line;
+	unsigned int off;
+	int rv, rev;
+
+	rv = line_bulk_check_request_config(bulk, config);
+	if (rv)
+		return -1;
+
+	if (config->flags & GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD) {
+		line = gpiod_line_bulk_get_line(bulk, 0);
+		if (!line->chip->uapi_v2) {
+			errno = ENOTSUP;
+			return -1;
+		}
+
+		return line_request_v2(bulk, config, NULL,
+				       LINE_REQUESTED_EVENTS);
+	}
+
+	/*
+	 * Every line gets its own request, so per-line configs are supported
+	 * even by the v1 uAPI.
+	 */
+	gpiod_line_bulk_foreach_line_off(bulk, line, off) {
+		line_get_request_config(config, line, &line_config);
+
+		rv = line_request_event_single(line, &line_config);
+		if (rv) {
+			for (rev = off - 1; rev >= 0; rev--) {
+				line = gpiod_line_bulk_get_line(bulk, rev);
+				gpiod_line_release(line);
+			}
+
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int gpiod_line_request(struct gpiod_line *line,
+		       const struct gpiod_line_request_config *config,
+		       int default_val)
+{
+	struct gpiod_line_bulk bulk;
+
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	return gpiod_line_request_bulk(&bulk, config, &default_val);
+}
+
+int gpiod_line_request_bulk(struct gpiod_line_bulk *bulk,
+			    const struct gpiod_line_request_config *config,
+			    const int *default_vals)
+{
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_free(bulk))
+		return -1;
+
+	if (line_request_is_direction(config->request_type))
+		return line_request_values(bulk, config, default_vals);
+	else if (line_request_is_events(config->request_type))
+		return line_request_events(bulk, config);
+
+	errno = EINVAL;
+	return -1;
+}
+
+void gpiod_line_release(struct gpiod_line *line)
+{
+	struct gpiod_line_bulk bulk;
+
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	gpiod_line_release_bulk(&bulk);
+}
+
+void gpiod_line_release_bulk(struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		if (line->state != LINE_FREE) {
+			line_fd_decref(line);
+			line->state = LINE_FREE;
+		}
+	}
+}
+
+bool gpiod_line_is_requested(struct gpiod_line *line)
+{
+	return (line->state == LINE_REQUESTED_VALUES ||
+		line->state == LINE_REQUESTED_EVENTS);
+}
+
+bool gpiod_line_is_free(struct gpiod_line *line)
+{
+	return line->state == LINE_FREE;
+}
+
+int gpiod_line_get_value(struct gpiod_line *line)
+{
+	struct gpiod_line_bulk bulk;
+	int rv, value;
+
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	rv = gpiod_line_get_value_bulk(&bulk, &value);
+	if (rv < 0)
+		return -1;
+
+	return value;
+}
+
+/*
+ * Pack line values stored one per byte (each either 0 or 1) into a bitmask.
+ * Eight values at a time are gathered into a single byte by multiplying the
+ * little-endian word holding them by a constant that shifts the lowest bit of
+ * byte N into bit 56 + N, with no carries between the partial products.
+ */
+static uint64_t line_values_to_mask(const uint8_t *values,
+				    unsigned int num_lines)
+{
+	uint64_t mask = 0, word;
+	unsigned int i;
+
+	for (i = 0; i < num_lines; i += 8) {
+		memcpy(&word, values + i, sizeof(word));
+		word = le64toh(word);
+		mask |= ((word * 0x0102040810204080ULL) >> 56) << i;
+	}
+
+	return mask & line_values_mask(num_lines);
+}
+
+/*
+ * Inverse of line_values_to_mask(): spread each byte of the mask over eight
+ * bytes by broadcasting it, isolating bit N in byte N and normalizing every
+ * non-zero byte to 1.
+ */
+static void line_mask_to_values(uint64_t mask, uint8_t *values,
+				unsigned int num_lines)
+{
+	uint64_t word;
+	unsigned int i;
+
+	mask &= line_values_mask(num_lines);
+
+	for (i = 0; i < num_lines; i += 8) {
+		word = ((mask >> i) & 0xff) * 0x0101010101010101ULL;
+		word &= 0x8040201008040201ULL;
+		word = ((word + 0x7f7f7f7f7f7f7f7fULL) >> 7) &
+		       0x0101010101010101ULL;
+		word = htole64(word);
+		memcpy(values + i, &word, sizeof(word));
+	}
+}
+
+/*
+ * The v1 uAPI passes line values one per byte while the v2 uAPI uses bitmaps.
+ * These routines take whichever representation is more convenient for the
+ * caller and convert it if the line handle uses the other one.
+ */
+static int line_handle_get_values(struct line_fd_handle *handle,
+				  unsigned int num_lines,
+				  struct gpiohandle_data *data)
+{
+	uint64_t bits;
+	int rv;
+
+	if (handle->uapi_v2) {
+		rv = line_handle_get_bits_v2(handle,
+					     line_values_mask(num_lines),
+					     &bits);
+		if (rv < 0)
+			return -1;
+
+		line_mask_to_values(bits, data->values, num_lines);
+
+		return 0;
+	}
+
+	rv = ioctl(handle->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, data);
+	if (rv < 0)
+		return -1;
+
+	return 0;
+}
+
+static int line_handle_set_values(struct line_fd_handle *handle,
+				  unsigned int num_lines,
+				  struct gpiohandle_data *data)
+{
+	int rv;
+
+	if (handle->uapi_v2)
+		return line_handle_set_bits_v2(handle,
+				line_values_mask(num_lines),
+				line_values_to_mask(data->values, num_lines));
+
+	rv = ioctl(handle->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, data);
+	if (rv < 0)
+		return -1;
+
+	return 0;
+}
+
+static int line_handle_get_mask(struct line_fd_handle *handle,
+				unsigned int num_lines, uint64_t *values)
+{
+	struct gpiohandle_data data;
+	int rv;
+
+	if (handle->uapi_v2)
+		return line_handle_get_bits_v2(handle,
+					       line_values_mask(num_lines),
+					       values);
+
+	memset(&data, 0, sizeof(data));
+
+	rv = ioctl(handle->fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+	if (rv < 0)
+		return -1;
+
+	*values = line_values_to_mask(data.values, num_lines);
+
+	return 0;
+}
+
+static int line_handle_set_mask(struct line_fd_handle *handle,
+				unsigned int num_lines, uint64_t values)
+{
+	struct gpiohandle_data data;
+	int rv;
+
+	if (handle->uapi_v2)
+		return line_handle_set_bits_v2(handle,
+					       line_values_mask(num_lines),
+					       values);
+
+	memset(&data, 0, sizeof(data));
+	line_mask_to_values(values, data.values, num_lines);
+
+	rv = ioctl(handle->fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+	if (rv < 0)
+		return -1;
+
+	return 0;
+}
+
+static int line_bulk_get_data(struct gpiod_line_bulk *bulk,
+			      struct gpiohandle_data *data)
+{
+	struct gpiod_line *first;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	first = gpiod_line_bulk_get_line(bulk, 0);
+
+	memset(data, 0, sizeof(*data));
+
+	return line_handle_get_values(first->fd_handle,
+				      gpiod_line_bulk_num_lines(bulk), data);
+}
+
+static int line_bulk_set_data(struct gpiod_line_bulk *bulk,
+			      struct gpiohandle_data *data)
+{
+	struct gpiod_line *first;
+
+	first = gpiod_line_bulk_get_line(bulk, 0);
+
+	return line_handle_set_values(first->fd_handle,
+				      gpiod_line_bulk_num_lines(bulk), data);
+}
+
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values)
+{
+	struct gpiohandle_data data;
+	unsigned int i;
+	int rv;
+
+	rv = line_bulk_get_data(bulk, &data);
+	if (rv < 0)
+		return -1;
+
+	for (i = 0; i < gpiod_line_bulk_num_lines(bulk); i++)
+		values[i] = data.values[i];
+
+	return 0;
+}
+
+int gpiod_line_get_value_bulk_mask(struct gpiod_line_bulk *bulk,
+				   uint64_t *values)
+{
+	struct gpiod_line *first;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	first = gpiod_line_bulk_get_line(bulk, 0);
+
+	return line_handle_get_mask(first->fd_handle,
+				    gpiod_line_bulk_num_lines(bulk), values);
+}
+
+int gpiod_line_set_value(struct gpiod_line *line, int value)
+{
+	struct gpiod_line_bulk bulk;
+
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	return gpiod_line_set_value_bulk(&bulk, &value);
+}
+
+int gpiod_line_set_value_bulk(struct gpiod_line_bulk *bulk, const int *values)
+{
+	struct gpiohandle_data data;
+	unsigned int i;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	memset(&data, 0, sizeof(data));
+
+	for (i = 0; i < gpiod_line_bulk_num_lines(bulk); i++)
+		data.values[i] = (uint8_t)!!values[i];
+
+	return line_bulk_set_data(bulk, &data);
+}
+
+int gpiod_line_set_value_bulk_mask(struct gpiod_line_bulk *bulk,
+				   uint64_t values)
+{
+	struct gpiod_line *first;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	first = gpiod_line_bulk_get_line(bulk, 0);
+
+	return line_handle_set_mask(first->fd_handle,
+				    gpiod_line_bulk_num_lines(bulk), values);
+}
+
+int gpiod_line_set_value_bulk_masked(struct gpiod_line_bulk *bulk,
+				     uint64_t mask, uint64_t values)
+{
+	struct line_fd_handle *handle;
+	uint64_t curr, all;
+	int rv;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	all = line_values_mask(gpiod_line_bulk_num_lines(bulk));
+	handle = gpiod_line_bulk_get_line(bulk, 0)->fd_handle;
+
+	/* The v2 uAPI can change a subset of lines without reading them. */
+	if (handle->uapi_v2) {
+		if (!(mask & all))
+			return 0;
+
+		return line_handle_set_bits_v2(handle, mask & all, values);
+	}
+
+	/* Skip the read if all lines are being changed anyway. */
+	if ((mask & all) == all)
+		return gpiod_line_set_value_bulk_mask(bulk, values);
+
+	rv = gpiod_line_get_value_bulk_mask(bulk, &curr);
+	if (rv < 0)
+		return -1;
+
+	return gpiod_line_set_value_bulk_mask(bulk,
+					      (curr & ~mask) | (values & mask));
+}
+
+/* Flags which can be changed on lines already requested for values. */
+#define LINE_CONFIG_FLAG_MASK						\
+		(GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN |			\
+		 GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE |			\
+		 GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW |			\
+		 LINE_REQUEST_FLAG_BIAS_MASK)
+
+#ifdef GPIOHANDLE_SET_CONFIG_IOCTL
+
+static int line_handle_set_config_v1(struct line_fd_handle *handle,
+			const struct gpiod_line_request_config *config,
+			unsigned int num_lines, const int *values)
+{
+	struct gpiohandle_config handle_config;
+	unsigned int i;
+	int rv;
+
+	rv = line_request_v1_check(config);
+	if (rv)
+		return -1;
+
+	memset(&handle_config, 0, sizeof(handle_config));
+	handle_config.flags = line_request_v1_flags(config->flags);
+
+	if (config->request_type == GPIOD_LINE_REQUEST_DIRECTION_INPUT) {
+		handle_config.flags |= GPIOHANDLE_REQUEST_INPUT;
+	} else if (config->request_type ==
+				GPIOD_LINE_REQUEST_DIRECTION_OUTPUT) {
+		handle_config.flags |= GPIOHANDLE_REQUEST_OUTPUT;
+
+		if (values) {
+			for (i = 0; i < num_lines; i++)
+				handle_config.default_values[i] =
+							(uint8_t)!!values[i];
+		}
+	}
+
+	rv = ioctl(handle->fd, GPIOHANDLE_SET_CONFIG_IOCTL, &handle_config);
+	if (rv < 0)
+		return -1;
+
+	return 0;
+}
+
+#else /* !GPIOHANDLE_SET_CONFIG_IOCTL */
+
+/* Kernel headers older than v5.5 don't define the set-config ioctl. */
+static int line_handle_set_config_v1(
+		struct line_fd_handle *handle GPIOD_UNUSED,
+		const struct gpiod_line_request_config *config GPIOD_UNUSED,
+		unsigned int num_lines GPIOD_UNUSED,
+		const int *values GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+#endif /* GPIOHANDLE_SET_CONFIG_IOCTL */
+
+int gpiod_line_set_config(struct gpiod_line *line, int direction,
+			  int flags, int value)
+{
+	struct gpiod_line_bulk bulk;
+
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line);
+
+	return gpiod_line_set_config_bulk(&bulk, direction, flags, &value);
+}
+
+int gpiod_line_set_config_bulk(struct gpiod_line_bulk *bulk, int direction,
+			       int flags, const int *values)
+{
+	struct gpiod_line_request_config config;
+	struct gpiod_line *line, **lineptr;
+	struct line_fd_handle *handle;
+	unsigned int num_lines;
+	int rv;
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return -1;
+
+	if (!line_request_is_direction(direction) ||
+	    (flags & ~LINE_CONFIG_FLAG_MASK)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	handle = gpiod_line_bulk_get_line(bulk, 0)->fd_handle;
+
+	/*
+	 * The kernel applies the new config to all lines of a handle, so the
+	 * lines must be requested for values, together and in a single
+	 * request.
+	 */
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		if (line->state != LINE_REQUESTED_VALUES) {
+			errno = EPERM;
+			return -1;
+		}
+
+		if (line->fd_handle != handle) {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+
+	memset(&config, 0, sizeof(config));
+	config.request_type = direction;
+	config.flags = flags;
 
-	if (line_request_is_direction(config->request_type))
-		return line_request_values(bulk, config, default_vals);
-	else if (line_request_is_events(config->request_type))
-		return line_request_events(bulk, config);
+	rv = line_bulk_check_request_config(bulk, &config);
+	if (rv)
+		return -1;
 
-	errno = EINVAL;
-	return -1;
-}
+	num_lines = gpiod_line_bulk_num_lines(bulk);
 
-void gpiod_line_release(struct gpiod_line *line)
-{
-	struct gpiod_line_bulk bulk;
+	if (handle->uapi_v2)
+		rv = line_handle_set_config_v2(handle, &config,
+					       num_lines, values);
+	else
+		rv = line_handle_set_config_v1(handle, &config,
+					       num_lines, values);
+	if (rv)
+		return -1;
 
-	gpiod_line_bulk_init(&bulk);
-	gpiod_line_bulk_add(&bulk, line);
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr)
+		line_mark_stale(line);
 
-	gpiod_line_release_bulk(&bulk);
+	return 0;
 }
 
-void gpiod_line_release_bulk(struct gpiod_line_bulk *bulk)
+struct gpiod_line_prepared {
+	struct line_fd_handle *fd_handle;
+	unsigned int num_lines;
+	/*
+	 * Kept zeroed past num_lines so that it can be passed to the kernel
+	 * as is, without clearing it on every call.
+	 */
+	struct gpiohandle_data data;
+};
+
+struct gpiod_line_prepared *
+gpiod_line_prepared_new(struct gpiod_line_bulk *bulk)
 {
+	struct gpiod_line_prepared *prepared;
 	struct gpiod_line *line, **lineptr;
+	struct line_fd_handle *handle;
+
+	if (!gpiod_line_bulk_num_lines(bulk)) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
+		return NULL;
 
+	handle = gpiod_line_bulk_get_line(bulk, 0)->fd_handle;
 	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
-		if (line->state != LINE_FREE) {
-			line_fd_decref(line);
-			line->state = LINE_FREE;
+		if (line->fd_handle != handle) {
+			errno = EINVAL;
+			return NULL;
 		}
 	}
+
+	prepared = malloc(sizeof(*prepared));
+	if (!prepared)
+		return NULL;
+
+	memset(prepared, 0, sizeof(*prepared));
+	prepared->num_lines = gpiod_line_bulk_num_lines(bulk);
+	prepared->fd_handle = handle;
+	line_fd_handle_incref(handle);
+
+	return prepared;
 }
 
-bool gpiod_line_is_requested(struct gpiod_line *line)
+void gpiod_line_prepared_free(struct gpiod_line_prepared *prepared)
 {
-	return (line->state == LINE_REQUESTED_VALUES ||
-		line->state == LINE_REQUESTED_EVENTS);
+	line_fd_handle_decref(prepared->fd_handle);
+	free(prepared);
 }
 
-bool gpiod_line_is_free(struct gpiod_line *line)
+unsigned int gpiod_line_prepared_num_lines(struct gpiod_line_prepared *prepared)
 {
-	return line->state == LINE_FREE;
+	return prepared->num_lines;
 }
 
-int gpiod_line_get_value(struct gpiod_line *line)
+int gpiod_line_prepared_get_values(struct gpiod_line_prepared *prepared,
+				   int *values)
 {
-	struct gpiod_line_bulk bulk;
-	int rv, value;
-
-	gpiod_line_bulk_init(&bulk);
-	gpiod_line_bulk_add(&bulk, line);
+	unsigned int i;
+	int rv;
 
-	rv = gpiod_line_get_value_bulk(&bulk, &value);
+	rv = line_handle_get_values(prepared->fd_handle, prepared->num_lines,
+				    &prepared->data);
 	if (rv < 0)
 		return -1;
 
-	return value;
+	for (i = 0; i < prepared->num_lines; i++)
+		values[i] = prepared->data.values[i];
+
+	return 0;
 }
 
-int gpiod_line_get_value_bulk(struct gpiod_line_bulk *bulk, int *values)
+int gpiod_line_prepared_set_values(struct gpiod_line_prepared *prepared,
+				   const int *values)
 {
-	struct gpiohandle_data data;
-	struct gpiod_line *first;
 	unsigned int i;
-	int rv, fd;
 
-	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
-		return -1;
+	for (i = 0; i < prepared->num_lines; i++)
+		prepared->data.values[i] = (uint8_t)!!values[i];
 
-	first = gpiod_line_bulk_get_line(bulk, 0);
+	return line_handle_set_values(prepared->fd_handle, prepared->num_lines,
+				      &prepared->data);
+}
 
-	memset(&data, 0, sizeof(data));
+int gpiod_line_prepared_get_values_mask(struct gpiod_line_prepared *prepared,
+					uint64_t *values)
+{
+	int rv;
 
-	fd = line_get_fd(first);
+	if (prepared->fd_handle->uapi_v2)
+		return line_handle_get_mask(prepared->fd_handle,
+					    prepared->num_lines, values);
 
-	rv = ioctl(fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data);
+	rv = ioctl(prepared->fd_handle->fd,
+		   GPIOHANDLE_GET_LINE_VALUES_IOCTL, &prepared->data);
 	if (rv < 0)
 		return -1;
 
-	for (i = 0; i < gpiod_line_bulk_num_lines(bulk); i++)
-		values[i] = data.values[i];
+	*values = line_values_to_mask(prepared->data.values,
+				      prepared->num_lines);
 
 	return 0;
 }
 
-int gpiod_line_set_value(struct gpiod_line *line, int value)
-{
-	struct gpiod_line_bulk bulk;
-
-	gpiod_line_bulk_init(&bulk);
-	gpiod_line_bulk_add(&bulk, line);
-
-	return gpiod_line_set_value_bulk(&bulk, &value);
-}
-
-int gpiod_line_set_value_bulk(struct gpiod_line_bulk *bulk, const int *values)
+int gpiod_line_prepared_set_values_mask(struct gpiod_line_prepared *prepared,
+					uint64_t values)
 {
-	struct gpiohandle_data data;
-	struct gpiod_line *line;
-	unsigned int i;
-	int rv, fd;
-
-	if (!line_bulk_same_chip(bulk) || !line_bulk_all_requested(bulk))
-		return -1;
-
-	memset(&data, 0, sizeof(data));
+	int rv;
 
-	for (i = 0; i < gpiod_line_bulk_num_lines(bulk); i++)
-		data.values[i] = (uint8_t)!!values[i];
+	if (prepared->fd_handle->uapi_v2)
+		return line_handle_set_mask(prepared->fd_handle,
+					    prepared->num_lines, values);
 
-	line = gpiod_line_bulk_get_line(bulk, 0);
-	fd = line_get_fd(line);
+	line_mask_to_values(values, prepared->data.values,
+			    prepared->num_lines);
 
-	rv = ioctl(fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data);
+	rv = ioctl(prepared->fd_handle->fd,
+		   GPIOHANDLE_SET_LINE_VALUES_IOCTL, &prepared->data);
 	if (rv < 0)
 		return -1;
 
@@ -813,49 +2336,331 @@ int gpiod_line_event_wait_bulk(struct gpiod_line_bulk *bulk,
 int gpiod_line_event_read(struct gpiod_line *line,
 			  struct gpiod_line_event *event)
 {
-	int fd;
+	int rv;
+
+	rv = gpiod_line_event_read_multiple(line, event, 1);
+	if (rv < 0)
+		return -1;
+
+	return 0;
+}
+
+int gpiod_line_event_get_fd(struct gpiod_line *line)
+{
+	if (line->state != LINE_REQUESTED_EVENTS) {
+		errno = EPERM;
+		return -1;
+	}
+
+	return line_get_fd(line);
+}
+
+static int line_event_parse_v1(const void *buf, size_t size,
+			       struct gpiod_line_event *events,
+			       unsigned int num_events)
+{
+	const struct gpioevent_data *evdata = buf, *curr;
+	struct gpiod_line_event *event;
+	unsigned int i;
+
+	if (size < sizeof(*evdata) || size % sizeof(*evdata)) {
+		errno = EIO;
+		return -1;
+	}
+
+	if (size / sizeof(*evdata) > num_events) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	num_events = size / sizeof(*evdata);
+
+	for (i = 0; i < num_events; i++) {
+		curr = &evdata[i];
+		event = &events[i];
+
+		event->event_type = curr->id == GPIOEVENT_EVENT_RISING_EDGE
+						? GPIOD_LINE_EVENT_RISING_EDGE
+						: GPIOD_LINE_EVENT_FALLING_EDGE;
+
+		event->ts.tv_sec = curr->timestamp / 1000000000ULL;
+		event->ts.tv_nsec = curr->timestamp % 1000000000ULL;
+
+		/* The v1 uAPI doesn't report offsets nor sequence numbers. */
+		event->offset = 0;
+		event->seqno = 0;
+		event->line_seqno = 0;
+	}
+
+	return num_events;
+}
+
+static int line_event_read_v1(int fd, struct gpiod_line_event *events,
+			      unsigned int num_events)
+{
+	/*
+	 * The kernel never queues more than GPIOD_LINE_EVENT_MAX_EVENTS events
+	 * for a single line so we can keep the buffer on the stack and drain
+	 * the whole FIFO with a single read().
+	 */
+	struct gpioevent_data evdata[GPIOD_LINE_EVENT_MAX_EVENTS];
+	ssize_t rd;
+
+	rd = read(fd, evdata, num_events * sizeof(*evdata));
+	if (rd < 0)
+		return -1;
+
+	return line_event_parse_v1(evdata, rd, events, num_events);
+}
+
+static int line_event_read(int fd, bool uapi_v2,
+			   struct gpiod_line_event *events,
+			   unsigned int num_events)
+{
+	if (num_events == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (num_events > GPIOD_LINE_EVENT_MAX_EVENTS)
+		num_events = GPIOD_LINE_EVENT_MAX_EVENTS;
+
+	if (uapi_v2)
+		return line_event_read_v2(fd, events, num_events);
+
+	return line_event_read_v1(fd, events, num_events);
+}
+
+/*
+ * Gaps in the per-line sequence numbers tell exactly how many events the
+ * kernel dropped. The v1 uAPI has no sequence numbers but if both edges are
+ * requested, the edges must alternate - two consecutive events of the same
+ * type mean that an odd number of events was lost, which we count as one.
+ */
+static void line_event_stats_update(struct gpiod_chip *chip,
+				    const struct gpiod_line_event *event)
+{
+	struct line_event_stats *stats;
+
+	if (event->offset >= chip->num_lines)
+		return;
+
+	stats = &chip->event_stats[event->offset];
+	stats->received++;
+
+	if (event->line_seqno) {
+		/* Sequence numbers start at 1 for every request. */
+		if (event->line_seqno > stats->last_line_seqno + 1)
+			stats->dropped += event->line_seqno -
+					  stats->last_line_seqno - 1;
+
+		stats->last_line_seqno = event->line_seqno;
+	} else if (stats->both_edges &&
+		   event->event_type == stats->last_event_type) {
+		stats->dropped++;
+	}
+
+	stats->last_event_type = event->event_type;
+}
+
+/* Fill in what the raw event data doesn't carry and update the statistics. */
+static void line_event_finish(struct gpiod_line *line,
+			      struct gpiod_line_event *events, int num_events)
+{
+	int i;
+
+	/* v1 event requests only ever cover a single line. */
+	if (!line->fd_handle->uapi_v2) {
+		for (i = 0; i < num_events; i++)
+			events[i].offset = line->offset;
+	}
+
+	for (i = 0; i < num_events; i++)
+		line_event_stats_update(line->chip, &events[i]);
+}
+
+static unsigned int line_event_num_pending(struct line_fd_handle *handle)
+{
+	return handle->num_pending - handle->next_pending;
+}
+
+int gpiod_line_event_read_multiple(struct gpiod_line *line,
+				   struct gpiod_line_event *events,
+				   unsigned int num_events)
+{
+	struct line_fd_handle *handle;
+	unsigned int num_pending;
+	int rv;
 
 	if (line->state != LINE_REQUESTED_EVENTS) {
 		errno = EPERM;
 		return -1;
 	}
 
-	fd = line_get_fd(line);
+	/* Events read ahead by line_event_peek() come first. */
+	handle = line->fd_handle;
+	num_pending = line_event_num_pending(handle);
+	if (num_pending) {
+		if (num_events == 0) {
+			errno = EINVAL;
+			return -1;
+		}
+
+		if (num_events > num_pending)
+			num_events = num_pending;
+
+		memcpy(events, handle->pending + handle->next_pending,
+		       num_events * sizeof(*events));
+		handle->next_pending += num_events;
+
+		return num_events;
+	}
+
+	rv = line_event_read(line_get_fd(line), line->fd_handle->uapi_v2,
+			     events, num_events);
+	if (rv < 0)
+		return -1;
 
-	return gpiod_line_event_read_fd(fd, event);
+	line_event_finish(line, events, rv);
+
+	return rv;
 }
 
-int gpiod_line_event_get_fd(struct gpiod_line *line)
+int line_event_peek(struct gpiod_line *line,
+		    const struct gpiod_line_event **events)
 {
+	struct line_fd_handle *handle;
+	int rv;
+
 	if (line->state != LINE_REQUESTED_EVENTS) {
 		errno = EPERM;
 		return -1;
 	}
 
-	return line_get_fd(line);
+	handle = line->fd_handle;
+
+	if (!line_event_num_pending(handle)) {
+		if (!handle->pending) {
+			handle->pending = malloc(GPIOD_LINE_EVENT_MAX_EVENTS *
+						 sizeof(*handle->pending));
+			if (!handle->pending)
+				return -1;
+		}
+
+		rv = gpiod_line_event_read_multiple(line, handle->pending,
+						GPIOD_LINE_EVENT_MAX_EVENTS);
+		if (rv < 0)
+			return -1;
+
+		handle->num_pending = rv;
+		handle->next_pending = 0;
+	}
+
+	*events = handle->pending + handle->next_pending;
+
+	return line_event_num_pending(handle);
 }
 
-int gpiod_line_event_read_fd(int fd, struct gpiod_line_event *event)
+bool line_event_pending(struct gpiod_line *line)
 {
-	struct gpioevent_data evdata;
-	ssize_t rd;
+	return line->state == LINE_REQUESTED_EVENTS &&
+	       line_event_num_pending(line->fd_handle) > 0;
+}
 
-	memset(&evdata, 0, sizeof(evdata));
+int gpiod_line_event_decode(struct gpiod_line *line, const void *buf,
+			    size_t size, struct gpiod_line_event *events,
+			    unsigned int num_events)
+{
+	int rv;
 
-	rd = read(fd, &evdata, sizeof(evdata));
-	if (rd < 0) {
+	if (line->state != LINE_REQUESTED_EVENTS) {
+		errno = EPERM;
 		return -1;
-	} else if (rd != sizeof(evdata)) {
-		errno = EIO;
+	}
+
+	if (line->fd_handle->uapi_v2)
+		rv = line_event_parse_v2(buf, size, events, num_events);
+	else
+		rv = line_event_parse_v1(buf, size, events, num_events);
+	if (rv < 0)
+		return -1;
+
+	line_event_finish(line, events, rv);
+
+	return rv;
+}
+
+int gpiod_line_event_get_stats(struct gpiod_line *line,
+			       struct gpiod_line_event_stats *stats)
+{
+	struct line_event_stats *line_stats;
+
+	if (line->state != LINE_REQUESTED_EVENTS) {
+		errno = EPERM;
 		return -1;
 	}
 
-	event->event_type = evdata.id == GPIOEVENT_EVENT_RISING_EDGE
-						? GPIOD_LINE_EVENT_RISING_EDGE
-						: GPIOD_LINE_EVENT_FALLING_EDGE;
+	line_stats = &line->chip->event_stats[line->offset];
+
+	stats->received = line_stats->received;
+	stats->dropped = line_stats->dropped;
+
+	return 0;
+}
+
+void gpiod_line_event_reset_stats(struct gpiod_line *line)
+{
+	struct line_event_stats *stats;
+
+	if (line->state != LINE_REQUESTED_EVENTS)
+		return;
+
+	stats = &line->chip->event_stats[line->offset];
+	stats->received = 0;
+	stats->dropped = 0;
+}
+
+/*
+ * Events read from v1 and v2 file descriptors have different layouts and
+ * there's no ioctl() telling them apart. If this process only requested lines
+ * using a single uAPI version, assume it's that one. Otherwise look at the
+ * name of the anonymous inode backing the descriptor, which costs a syscall
+ * per read.
+ */
+static bool fd_is_uapi_v2(int fd)
+{
+	bool v1 = __atomic_load_n(&uapi_v1_requested, __ATOMIC_RELAXED);
+	bool v2 = __atomic_load_n(&uapi_v2_requested, __ATOMIC_RELAXED);
+	char path[32], link[32];
+	ssize_t len;
+
+	if (v1 != v2)
+		return v2;
+
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+
+	len = readlink(path, link, sizeof(link) - 1);
+	if (len < 0)
+		return v2;
+
+	link[len] = '\0';
+
+	return strcmp(link, "anon_inode:gpio-line") == 0;
+}
+
+int gpiod_line_event_read_fd(int fd, struct gpiod_line_event *event)
+{
+	int rv;
 
-	event->ts.tv_sec = evdata.timestamp / 1000000000ULL;
-	event->ts.tv_nsec = evdata.timestamp % 1000000000ULL;
+	rv = gpiod_line_event_read_fd_multiple(fd, event, 1);
+	if (rv < 0)
+		return -1;
 
 	return 0;
 }
+
+int gpiod_line_event_read_fd_multiple(int fd, struct gpiod_line_event *events,
+				      unsigned int num_events)
+{
+	return line_event_read(fd, fd_is_uapi_v2(fd), events, num_events);
+}
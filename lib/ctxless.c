@@ -10,10 +10,11 @@
 
 #include <errno.h>
 #include <gpiod.h>
-#include <poll.h>
 #include <stdio.h>
 #include <string.h>
 
+#define ARRAY_SIZE(x)	(sizeof(x) / sizeof(*(x)))
+
 int gpiod_ctxless_get_value(const char *device, unsigned int offset,
 			    bool active_low, const char *consumer)
 {
@@ -27,18 +28,51 @@ int gpiod_ctxless_get_value(const char *device, unsigned int offset,
 	return value;
 }
 
+static struct gpiod_line_array *
+ctxless_get_lines(struct gpiod_chip *chip, const unsigned int *offsets,
+		  unsigned int num_lines)
+{
+	struct gpiod_line_array *array;
+	struct gpiod_line *line;
+	unsigned int i;
+	int rv;
+
+	array = gpiod_line_array_new();
+	if (!array)
+		return NULL;
+
+	/* We only need the handles - don't read the info of every line. */
+	gpiod_chip_set_line_info_policy(chip, GPIOD_LINE_INFO_REFRESH_IF_STALE);
+
+	for (i = 0; i < num_lines; i++) {
+		line = gpiod_chip_get_line(chip, offsets[i]);
+		if (!line)
+			goto err_free;
+
+		rv = gpiod_line_array_add(array, line);
+		if (rv < 0)
+			goto err_free;
+	}
+
+	return array;
+
+err_free:
+	gpiod_line_array_free(array);
+
+	return NULL;
+}
+
 int gpiod_ctxless_get_value_multiple(const char *device,
 				     const unsigned int *offsets, int *values,
 				     unsigned int num_lines, bool active_low,
 				     const char *consumer)
 {
-	struct gpiod_line_bulk bulk;
+	struct gpiod_line_request_config conf;
+	struct gpiod_line_array *array;
 	struct gpiod_chip *chip;
-	struct gpiod_line *line;
-	unsigned int i;
-	int rv, flags;
+	int rv;
 
-	if (!num_lines || num_lines > GPIOD_LINE_BULK_MAX_LINES) {
+	if (!num_lines) {
 		errno = EINVAL;
 		return -1;
 	}
@@ -47,29 +81,24 @@ int gpiod_ctxless_get_value_multiple(const char *device,
 	if (!chip)
 		return -1;
 
-	gpiod_line_bulk_init(&bulk);
-
-	for (i = 0; i < num_lines; i++) {
-		line = gpiod_chip_get_line(chip, offsets[i]);
-		if (!line) {
-			gpiod_chip_close(chip);
-			return -1;
-		}
-
-		gpiod_line_bulk_add(&bulk, line);
-	}
-
-	flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
-
-	rv = gpiod_line_request_bulk_input_flags(&bulk, consumer, flags);
-	if (rv < 0) {
+	array = ctxless_get_lines(chip, offsets, num_lines);
+	if (!array) {
 		gpiod_chip_close(chip);
 		return -1;
 	}
 
-	memset(values, 0, sizeof(*values) * num_lines);
-	rv = gpiod_line_get_value_bulk(&bulk, values);
+	memset(&conf, 0, sizeof(conf));
+	conf.consumer = consumer;
+	conf.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+	conf.flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
+
+	rv = gpiod_line_array_request(array, &conf, NULL);
+	if (rv == 0) {
+		memset(values, 0, sizeof(*values) * num_lines);
+		rv = gpiod_line_array_get_values(array, values);
+	}
 
+	gpiod_line_array_free(array);
 	gpiod_chip_close(chip);
 
 	return rv;
@@ -89,13 +118,12 @@ int gpiod_ctxless_set_value_multiple(const char *device,
 				     bool active_low, const char *consumer,
 				     gpiod_ctxless_set_value_cb cb, void *data)
 {
-	struct gpiod_line_bulk bulk;
+	struct gpiod_line_request_config conf;
+	struct gpiod_line_array *array;
 	struct gpiod_chip *chip;
-	struct gpiod_line *line;
-	unsigned int i;
-	int rv, flags;
+	int rv;
 
-	if (!num_lines || num_lines > GPIOD_LINE_BULK_MAX_LINES) {
+	if (!num_lines) {
 		errno = EINVAL;
 		return -1;
 	}
@@ -104,74 +132,25 @@ int gpiod_ctxless_set_value_multiple(const char *device,
 	if (!chip)
 		return -1;
 
-	gpiod_line_bulk_init(&bulk);
-
-	for (i = 0; i < num_lines; i++) {
-		line = gpiod_chip_get_line(chip, offsets[i]);
-		if (!line) {
-			gpiod_chip_close(chip);
-			return -1;
-		}
-
-		gpiod_line_bulk_add(&bulk, line);
-	}
-
-	flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
-
-	rv = gpiod_line_request_bulk_output_flags(&bulk, consumer,
-						  flags, values);
-	if (rv < 0) {
+	array = ctxless_get_lines(chip, offsets, num_lines);
+	if (!array) {
 		gpiod_chip_close(chip);
 		return -1;
 	}
 
-	if (cb)
+	memset(&conf, 0, sizeof(conf));
+	conf.consumer = consumer;
+	conf.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+	conf.flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
+
+	rv = gpiod_line_array_request(array, &conf, values);
+	if (rv == 0 && cb)
 		cb(data);
 
+	gpiod_line_array_free(array);
 	gpiod_chip_close(chip);
 
-	return 0;
-}
-
-static int basic_event_poll(unsigned int num_lines,
-			    struct gpiod_ctxless_event_poll_fd *fds,
-			    const struct timespec *timeout,
-			    void *data GPIOD_UNUSED)
-{
-	struct pollfd poll_fds[GPIOD_LINE_BULK_MAX_LINES];
-	unsigned int i;
-	int rv, ret;
-
-	if (!num_lines || num_lines > GPIOD_LINE_BULK_MAX_LINES)
-		return GPIOD_CTXLESS_EVENT_POLL_RET_ERR;
-
-	memset(poll_fds, 0, sizeof(poll_fds));
-
-	for (i = 0; i < num_lines; i++) {
-		poll_fds[i].fd = fds[i].fd;
-		poll_fds[i].events = POLLIN | POLLPRI;
-	}
-
-	rv = ppoll(poll_fds, num_lines, timeout, NULL);
-	if (rv < 0) {
-		if (errno == EINTR)
-			return GPIOD_CTXLESS_EVENT_POLL_RET_TIMEOUT;
-		else
-			return GPIOD_CTXLESS_EVENT_POLL_RET_ERR;
-	} else if (rv == 0) {
-		return GPIOD_CTXLESS_EVENT_POLL_RET_TIMEOUT;
-	}
-
-	ret = rv;
-	for (i = 0; i < num_lines; i++) {
-		if (poll_fds[i].revents) {
-			fds[i].event = true;
-			if (!--rv)
-				break;
-		}
-	}
-
-	return ret;
+	return rv;
 }
 
 int gpiod_ctxless_event_loop(const char *device, unsigned int offset,
@@ -216,6 +195,87 @@ int gpiod_ctxless_event_monitor(const char *device, int event_type,
 						    poll_cb, event_cb, data);
 }
 
+/*
+ * Read all events queued for given line with a single system call and pass
+ * them to the user callback. Returns one of the GPIOD_CTXLESS_EVENT_CB_RET_*
+ * values.
+ */
+static int
+ctxless_handle_line_events(struct gpiod_line *line,
+			   gpiod_ctxless_event_handle_cb event_cb, void *data,
+			   int flags)
+{
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	struct gpiod_line_event_stats stats;
+	int rv, num_events, evtype, i;
+	uint64_t dropped = 0;
+
+	if (flags & GPIOD_CTXLESS_FLAG_REPORT_DROPPED) {
+		rv = gpiod_line_event_get_stats(line, &stats);
+		if (rv)
+			return GPIOD_CTXLESS_EVENT_CB_RET_ERR;
+
+		dropped = stats.dropped;
+	}
+
+	num_events = gpiod_line_event_read_multiple(line, events,
+						    ARRAY_SIZE(events));
+	if (num_events < 0)
+		return GPIOD_CTXLESS_EVENT_CB_RET_ERR;
+
+	if (flags & GPIOD_CTXLESS_FLAG_REPORT_DROPPED) {
+		rv = gpiod_line_event_get_stats(line, &stats);
+		if (rv)
+			return GPIOD_CTXLESS_EVENT_CB_RET_ERR;
+
+		for (; dropped < stats.dropped; dropped++) {
+			rv = event_cb(GPIOD_CTXLESS_EVENT_CB_DROPPED_EVENT,
+				      gpiod_line_offset(line),
+				      &events[0].ts, data);
+			if (rv != GPIOD_CTXLESS_EVENT_CB_RET_OK)
+				return rv;
+		}
+	}
+
+	for (i = 0; i < num_events; i++) {
+		if (events[i].event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+			evtype = GPIOD_CTXLESS_EVENT_CB_RISING_EDGE;
+		else
+			evtype = GPIOD_CTXLESS_EVENT_CB_FALLING_EDGE;
+
+		rv = event_cb(evtype, gpiod_line_offset(line),
+			      &events[i].ts, data);
+		if (rv != GPIOD_CTXLESS_EVENT_CB_RET_OK)
+			return rv;
+	}
+
+	return GPIOD_CTXLESS_EVENT_CB_RET_OK;
+}
+
+/*
+ * Wait for events using the persistent waiter. Lines on which events occurred
+ * are stored in the ready bulk. Returns the number of such lines or one of
+ * the GPIOD_CTXLESS_EVENT_POLL_RET_* values.
+ */
+static int ctxless_waiter_poll(struct gpiod_event_waiter *waiter,
+			       const struct timespec *timeout,
+			       struct gpiod_line_bulk *ready)
+{
+	int rv;
+
+	rv = gpiod_event_waiter_wait(waiter, timeout, ready);
+	if (rv < 0) {
+		if (errno == EINTR)
+			return GPIOD_CTXLESS_EVENT_POLL_RET_TIMEOUT;
+		else
+			return GPIOD_CTXLESS_EVENT_POLL_RET_ERR;
+	} else if (rv == 0) {
+		return GPIOD_CTXLESS_EVENT_POLL_RET_TIMEOUT;
+	}
+
+	return gpiod_line_bulk_num_lines(ready);
+}
+
 int gpiod_ctxless_event_monitor_multiple(
 			const char *device, int event_type,
 			const unsigned int *offsets,
@@ -226,39 +286,50 @@ int gpiod_ctxless_event_monitor_multiple(
 			gpiod_ctxless_event_handle_cb event_cb,
 			void *data)
 {
-	struct gpiod_ctxless_event_poll_fd fds[GPIOD_LINE_BULK_MAX_LINES];
+	return gpiod_ctxless_event_monitor_multiple_ext(device, event_type,
+							offsets, num_lines,
+							active_low, consumer,
+							timeout, poll_cb,
+							event_cb, data, 0);
+}
+
+int gpiod_ctxless_event_monitor_multiple_ext(
+			const char *device, int event_type,
+			const unsigned int *offsets,
+			unsigned int num_lines, bool active_low,
+			const char *consumer,
+			const struct timespec *timeout,
+			gpiod_ctxless_event_poll_cb poll_cb,
+			gpiod_ctxless_event_handle_cb event_cb,
+			void *data, int flags)
+{
+	struct gpiod_ctxless_event_poll_fd *fds = NULL;
+	struct gpiod_event_waiter *waiter = NULL;
 	struct gpiod_line_request_config conf;
-	struct gpiod_line_event event;
-	struct gpiod_line_bulk bulk;
-	int rv, ret, evtype, cnt;
+	struct gpiod_line_array *array = NULL;
+	struct timespec ts = { 0, 0 };
+	struct gpiod_line_bulk ready;
 	struct gpiod_chip *chip;
 	struct gpiod_line *line;
+	int rv, ret, cnt;
 	unsigned int i;
 
-	if (!num_lines || num_lines > GPIOD_LINE_BULK_MAX_LINES) {
+	if (!num_lines) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	if (!poll_cb)
-		poll_cb = basic_event_poll;
-
 	chip = gpiod_chip_open_lookup(device);
 	if (!chip)
 		return -1;
 
-	gpiod_line_bulk_init(&bulk);
-
-	for (i = 0; i < num_lines; i++) {
-		line = gpiod_chip_get_line(chip, offsets[i]);
-		if (!line) {
-			gpiod_chip_close(chip);
-			return -1;
-		}
-
-		gpiod_line_bulk_add(&bulk, line);
+	array = ctxless_get_lines(chip, offsets, num_lines);
+	if (!array) {
+		ret = -1;
+		goto out;
 	}
 
+	memset(&conf, 0, sizeof(conf));
 	conf.flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
 	conf.consumer = consumer;
 
@@ -274,29 +345,56 @@ int gpiod_ctxless_event_monitor_multiple(
 		goto out;
 	}
 
-	rv = gpiod_line_request_bulk(&bulk, &conf, NULL);
+	rv = gpiod_line_array_request(array, &conf, NULL);
 	if (rv) {
 		ret = -1;
 		goto out;
 	}
 
-	memset(fds, 0, sizeof(fds));
-	for (i = 0; i < num_lines; i++) {
-		line = gpiod_line_bulk_get_line(&bulk, i);
-		fds[i].fd = gpiod_line_event_get_fd(line);
+	if (poll_cb) {
+		fds = calloc(num_lines, sizeof(*fds));
+		if (!fds) {
+			ret = -1;
+			goto out;
+		}
+
+		for (i = 0; i < num_lines; i++) {
+			line = gpiod_line_array_get_line(array, i);
+			fds[i].fd = gpiod_line_event_get_fd(line);
+		}
+	} else {
+		waiter = gpiod_event_waiter_new();
+		if (!waiter) {
+			ret = -1;
+			goto out;
+		}
+
+		for (i = 0; i < num_lines; i++) {
+			line = gpiod_line_array_get_line(array, i);
+			rv = gpiod_event_waiter_add_line(waiter, line);
+			if (rv) {
+				ret = -1;
+				goto out;
+			}
+		}
 	}
 
 	for (;;) {
-		for (i = 0; i < num_lines; i++)
-			fds[i].event = false;
+		if (waiter) {
+			cnt = ctxless_waiter_poll(waiter, timeout, &ready);
+		} else {
+			for (i = 0; i < num_lines; i++)
+				fds[i].event = false;
+
+			cnt = poll_cb(num_lines, fds, timeout, data);
+		}
 
-		cnt = poll_cb(num_lines, fds, timeout, data);
 		if (cnt == GPIOD_CTXLESS_EVENT_POLL_RET_ERR) {
 			ret = -1;
 			goto out;
 		} else if (cnt == GPIOD_CTXLESS_EVENT_POLL_RET_TIMEOUT) {
 			rv = event_cb(GPIOD_CTXLESS_EVENT_CB_TIMEOUT,
-				      0, &event.ts, data);
+				      0, &ts, data);
 			if (rv == GPIOD_CTXLESS_EVENT_CB_RET_ERR) {
 				ret = -1;
 				goto out;
@@ -304,43 +402,50 @@ int gpiod_ctxless_event_monitor_multiple(
 				ret = 0;
 				goto out;
 			}
+
+			continue;
 		} else if (cnt == GPIOD_CTXLESS_EVENT_POLL_RET_STOP) {
 			ret = 0;
 			goto out;
 		}
 
-		for (i = 0; i < num_lines; i++) {
-			if (!fds[i].event)
-				continue;
+		rv = GPIOD_CTXLESS_EVENT_CB_RET_OK;
 
-			line = gpiod_line_bulk_get_line(&bulk, i);
-			rv = gpiod_line_event_read(line, &event);
-			if (rv < 0) {
-				ret = rv;
-				goto out;
+		if (waiter) {
+			gpiod_line_bulk_foreach_line_off(&ready, line, i) {
+				rv = ctxless_handle_line_events(line, event_cb,
+								data, flags);
+				if (rv != GPIOD_CTXLESS_EVENT_CB_RET_OK)
+					break;
 			}
-
-			if (event.event_type == GPIOD_LINE_EVENT_RISING_EDGE)
-				evtype = GPIOD_CTXLESS_EVENT_CB_RISING_EDGE;
-			else
-				evtype = GPIOD_CTXLESS_EVENT_CB_FALLING_EDGE;
-
-			rv = event_cb(evtype, gpiod_line_offset(line),
-				      &event.ts, data);
-			if (rv == GPIOD_CTXLESS_EVENT_CB_RET_ERR) {
-				ret = -1;
-				goto out;
-			} else if (rv == GPIOD_CTXLESS_EVENT_CB_RET_STOP) {
-				ret = 0;
-				goto out;
+		} else {
+			for (i = 0; i < num_lines; i++) {
+				if (!fds[i].event)
+					continue;
+
+				line = gpiod_line_array_get_line(array, i);
+				rv = ctxless_handle_line_events(line, event_cb,
+								data, flags);
+				if (rv != GPIOD_CTXLESS_EVENT_CB_RET_OK)
+					break;
 			}
+		}
 
-			if (!--cnt)
-				break;
+		if (rv == GPIOD_CTXLESS_EVENT_CB_RET_ERR) {
+			ret = -1;
+			goto out;
+		} else if (rv == GPIOD_CTXLESS_EVENT_CB_RET_STOP) {
+			ret = 0;
+			goto out;
 		}
 	}
 
 out:
+	if (waiter)
+		gpiod_event_waiter_free(waiter);
+	free(fds);
+	if (array)
+		gpiod_line_array_free(array);
 	gpiod_chip_close(chip);
 
 	return ret;
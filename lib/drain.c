@@ -0,0 +1,555 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Background thread draining line events into a userspace ring buffer. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * The ring is a single-producer, single-consumer queue: only the drain
+ * thread advances the tail and only the consumer advances the head. Both
+ * indices run freely and are masked on access, so the ring size must be a
+ * power of two.
+ */
+struct drain_entry {
+	struct gpiod_line *line;
+	struct gpiod_line_event event;
+};
+
+struct gpiod_event_drain {
+	struct drain_entry *ring;
+	unsigned int ring_mask;
+	unsigned int head;
+	unsigned int tail;
+	uint64_t overruns;
+	int error;
+
+	int epfd;
+	int stopfd;
+	int notifyfd;
+	unsigned int num_lines;
+
+	int sched_policy;
+	int sched_priority;
+	int cpu;
+	bool lock_memory;
+
+	void *stack;
+	size_t stack_size;
+	pthread_t thread;
+	bool running;
+};
+
+#define DRAIN_MAX_READY		16
+#define DRAIN_STACK_SIZE	(128 * 1024)
+
+static unsigned int drain_ring_size(unsigned int size)
+{
+	unsigned int ret = 1;
+
+	while (ret < size)
+		ret <<= 1;
+
+	return ret;
+}
+
+struct gpiod_event_drain *gpiod_event_drain_new(unsigned int ring_size)
+{
+	struct gpiod_event_drain *drain;
+	struct epoll_event event;
+	int rv;
+
+	if (!ring_size || ring_size > (UINT32_MAX >> 1) + 1) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	drain = malloc(sizeof(*drain));
+	if (!drain)
+		return NULL;
+
+	memset(drain, 0, sizeof(*drain));
+	drain->epfd = drain->stopfd = drain->notifyfd = -1;
+	drain->sched_policy = SCHED_OTHER;
+	drain->cpu = -1;
+
+	ring_size = drain_ring_size(ring_size);
+	drain->ring_mask = ring_size - 1;
+	drain->ring = calloc(ring_size, sizeof(*drain->ring));
+	if (!drain->ring)
+		goto err_free;
+
+	drain->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (drain->epfd < 0)
+		goto err_free;
+
+	drain->stopfd = eventfd(0, EFD_CLOEXEC);
+	if (drain->stopfd < 0)
+		goto err_free;
+
+	drain->notifyfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (drain->notifyfd < 0)
+		goto err_free;
+
+	/* A NULL pointer marks the stop descriptor. */
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+
+	rv = epoll_ctl(drain->epfd, EPOLL_CTL_ADD, drain->stopfd, &event);
+	if (rv < 0)
+		goto err_free;
+
+	return drain;
+
+err_free:
+	gpiod_event_drain_free(drain);
+	return NULL;
+}
+
+void gpiod_event_drain_free(struct gpiod_event_drain *drain)
+{
+	gpiod_event_drain_stop(drain);
+
+	if (drain->notifyfd >= 0)
+		close(drain->notifyfd);
+	if (drain->stopfd >= 0)
+		close(drain->stopfd);
+	if (drain->epfd >= 0)
+		close(drain->epfd);
+
+	free(drain->ring);
+	free(drain);
+}
+
+int gpiod_event_drain_set_sched(struct gpiod_event_drain *drain,
+				int policy, int priority)
+{
+	if (drain->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	drain->sched_policy = policy;
+	drain->sched_priority = priority;
+
+	return 0;
+}
+
+int gpiod_event_drain_set_cpu(struct gpiod_event_drain *drain, int cpu)
+{
+	if (drain->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (cpu >= CPU_SETSIZE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	drain->cpu = cpu;
+
+	return 0;
+}
+
+int gpiod_event_drain_set_mlock(struct gpiod_event_drain *drain, bool lock)
+{
+	if (drain->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	drain->lock_memory = lock;
+
+	return 0;
+}
+
+/*
+ * Returns 1 if the descriptor of the line was added to the epoll set and 0 if
+ * it was already there.
+ */
+static int drain_add_line(struct gpiod_event_drain *drain,
+			  struct gpiod_line *line)
+{
+	struct epoll_event event;
+	int rv, fd;
+
+	fd = gpiod_line_event_get_fd(line);
+	if (fd < 0)
+		return -1;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLPRI;
+	event.data.ptr = line;
+
+	rv = epoll_ctl(drain->epfd, EPOLL_CTL_ADD, fd, &event);
+	if (rv < 0) {
+		/*
+		 * Lines requested with a shared event descriptor are all
+		 * drained through the first one added.
+		 */
+		return errno == EEXIST ? 0 : -1;
+	}
+
+	drain->num_lines++;
+
+	return 1;
+}
+
+int gpiod_event_drain_add_line(struct gpiod_event_drain *drain,
+			       struct gpiod_line *line)
+{
+	return drain_add_line(drain, line) < 0 ? -1 : 0;
+}
+
+int gpiod_event_drain_add_bulk(struct gpiod_event_drain *drain,
+			       struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line;
+	uint64_t added = 0;
+	unsigned int i;
+	int rv;
+
+	gpiod_line_bulk_foreach_line_off(bulk, line, i) {
+		rv = drain_add_line(drain, line);
+		if (rv < 0)
+			goto err_remove;
+		else if (rv > 0)
+			added |= 1ULL << i;
+	}
+
+	return 0;
+
+err_remove:
+	/* Only remove the lines this call added. */
+	while (i--) {
+		if (!(added & (1ULL << i)))
+			continue;
+
+		line = gpiod_line_bulk_get_line(bulk, i);
+		epoll_ctl(drain->epfd, EPOLL_CTL_DEL,
+			  gpiod_line_event_get_fd(line), NULL);
+		drain->num_lines--;
+	}
+
+	return -1;
+}
+
+/*
+ * The epoll set is level-triggered, so a descriptor which can't be read would
+ * wake the thread up again immediately. Stop watching it and let the consumer
+ * know - the error is reported by the next gpiod_event_drain_wait().
+ */
+static void drain_line_error(struct gpiod_event_drain *drain,
+			     struct gpiod_line *line)
+{
+	int error = errno;
+
+	epoll_ctl(drain->epfd, EPOLL_CTL_DEL,
+		  gpiod_line_event_get_fd(line), NULL);
+
+	__atomic_store_n(&drain->error, error, __ATOMIC_RELEASE);
+	eventfd_write(drain->notifyfd, 1);
+}
+
+/*
+ * Move all events queued in the kernel for given line to the ring. Events
+ * that don't fit are discarded and accounted for as overruns. Returns the
+ * number of events pushed.
+ */
+static int drain_line_events(struct gpiod_event_drain *drain,
+			     struct gpiod_line *line)
+{
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	unsigned int head, tail, i;
+	int num_events;
+
+	num_events = gpiod_line_event_read_multiple(line, events,
+						    GPIOD_LINE_EVENT_MAX_EVENTS);
+	if (num_events < 0) {
+		if (errno != EINTR && errno != EAGAIN)
+			drain_line_error(drain, line);
+
+		return 0;
+	}
+
+	tail = drain->tail;
+	head = __atomic_load_n(&drain->head, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < (unsigned int)num_events; i++) {
+		if (tail - head > drain->ring_mask) {
+			__atomic_fetch_add(&drain->overruns, num_events - i,
+					   __ATOMIC_RELAXED);
+			break;
+		}
+
+		drain->ring[tail & drain->ring_mask].line = line;
+		drain->ring[tail & drain->ring_mask].event = events[i];
+		tail++;
+	}
+
+	__atomic_store_n(&drain->tail, tail, __ATOMIC_RELEASE);
+
+	return i;
+}
+
+static void *drain_thread_func(void *data)
+{
+	struct epoll_event events[DRAIN_MAX_READY];
+	struct gpiod_event_drain *drain = data;
+	int rv, i, pushed;
+
+	for (;;) {
+		rv = epoll_wait(drain->epfd, events, DRAIN_MAX_READY, -1);
+		if (rv < 0) {
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		pushed = 0;
+		for (i = 0; i < rv; i++) {
+			if (!events[i].data.ptr)
+				return NULL;
+
+			pushed += drain_line_events(drain, events[i].data.ptr);
+		}
+
+		if (pushed > 0)
+			eventfd_write(drain->notifyfd, pushed);
+	}
+
+	return NULL;
+}
+
+/*
+ * Lock the ring and a preallocated stack for the drain thread in memory.
+ * Locking faults all the pages in, so the drain thread never takes a page
+ * fault on its own data once it's running.
+ */
+static int drain_lock_memory(struct gpiod_event_drain *drain)
+{
+	long page_size, stack_min;
+	size_t ring_size;
+	int rv;
+
+	page_size = sysconf(_SC_PAGESIZE);
+	stack_min = sysconf(_SC_THREAD_STACK_MIN);
+	drain->stack_size = DRAIN_STACK_SIZE;
+	if (stack_min > DRAIN_STACK_SIZE)
+		drain->stack_size = stack_min;
+
+	rv = posix_memalign(&drain->stack, page_size, drain->stack_size);
+	if (rv) {
+		drain->stack = NULL;
+		return rv;
+	}
+
+	ring_size = sizeof(*drain->ring) * (drain->ring_mask + 1);
+
+	rv = mlock(drain->ring, ring_size);
+	if (rv < 0) {
+		rv = errno;
+		goto err_free_stack;
+	}
+
+	rv = mlock(drain->stack, drain->stack_size);
+	if (rv < 0) {
+		rv = errno;
+		munlock(drain->ring, ring_size);
+		goto err_free_stack;
+	}
+
+	return 0;
+
+err_free_stack:
+	free(drain->stack);
+	drain->stack = NULL;
+	return rv;
+}
+
+static void drain_unlock_memory(struct gpiod_event_drain *drain)
+{
+	if (!drain->stack)
+		return;
+
+	munlock(drain->ring, sizeof(*drain->ring) * (drain->ring_mask + 1));
+	munlock(drain->stack, drain->stack_size);
+	free(drain->stack);
+	drain->stack = NULL;
+}
+
+int gpiod_event_drain_start(struct gpiod_event_drain *drain)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	cpu_set_t cpuset;
+	int rv;
+
+	if (drain->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (!drain->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	rv = pthread_attr_init(&attr);
+	if (rv) {
+		errno = rv;
+		return -1;
+	}
+
+	if (drain->lock_memory) {
+		rv = drain_lock_memory(drain);
+		if (rv)
+			goto out;
+
+		rv = pthread_attr_setstack(&attr, drain->stack,
+					   drain->stack_size);
+		if (rv)
+			goto out;
+	}
+
+	if (drain->sched_policy != SCHED_OTHER) {
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = drain->sched_priority;
+
+		rv = pthread_attr_setinheritsched(&attr,
+						  PTHREAD_EXPLICIT_SCHED);
+		if (!rv)
+			rv = pthread_attr_setschedpolicy(&attr,
+							 drain->sched_policy);
+		if (!rv)
+			rv = pthread_attr_setschedparam(&attr, &param);
+		if (rv)
+			goto out;
+	}
+
+	if (drain->cpu >= 0) {
+		CPU_ZERO(&cpuset);
+		CPU_SET(drain->cpu, &cpuset);
+
+		rv = pthread_attr_setaffinity_np(&attr, sizeof(cpuset),
+						 &cpuset);
+		if (rv)
+			goto out;
+	}
+
+	rv = pthread_create(&drain->thread, &attr, drain_thread_func, drain);
+	if (!rv)
+		drain->running = true;
+
+out:
+	pthread_attr_destroy(&attr);
+	if (rv) {
+		drain_unlock_memory(drain);
+		errno = rv;
+		return -1;
+	}
+
+	return 0;
+}
+
+void gpiod_event_drain_stop(struct gpiod_event_drain *drain)
+{
+	eventfd_t count;
+
+	if (!drain->running)
+		return;
+
+	eventfd_write(drain->stopfd, 1);
+	pthread_join(drain->thread, NULL);
+	eventfd_read(drain->stopfd, &count);
+	drain_unlock_memory(drain);
+
+	drain->running = false;
+}
+
+int gpiod_event_drain_pop(struct gpiod_event_drain *drain,
+			  struct gpiod_line_event *events,
+			  struct gpiod_line **lines, unsigned int num_events)
+{
+	unsigned int head, tail, i;
+	struct drain_entry *entry;
+
+	head = drain->head;
+	tail = __atomic_load_n(&drain->tail, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < num_events && head != tail; i++, head++) {
+		entry = &drain->ring[head & drain->ring_mask];
+
+		events[i] = entry->event;
+		if (lines)
+			lines[i] = entry->line;
+	}
+
+	__atomic_store_n(&drain->head, head, __ATOMIC_RELEASE);
+
+	return i;
+}
+
+int gpiod_event_drain_wait(struct gpiod_event_drain *drain,
+			   const struct timespec *timeout)
+{
+	struct pollfd pfd;
+	eventfd_t count;
+	int rv, error;
+
+	for (;;) {
+		if (__atomic_load_n(&drain->tail, __ATOMIC_ACQUIRE) !=
+		    drain->head)
+			return 1;
+
+		error = __atomic_exchange_n(&drain->error, 0, __ATOMIC_ACQUIRE);
+		if (error) {
+			errno = error;
+			return -1;
+		}
+
+		memset(&pfd, 0, sizeof(pfd));
+		pfd.fd = drain->notifyfd;
+		pfd.events = POLLIN;
+
+		rv = ppoll(&pfd, 1, timeout, NULL);
+		if (rv < 0)
+			return -1;
+		else if (rv == 0)
+			return 0;
+
+		/*
+		 * Clear the notification and check the ring again - the events
+		 * may have been consumed before we got here.
+		 */
+		eventfd_read(drain->notifyfd, &count);
+	}
+}
+
+int gpiod_event_drain_get_fd(struct gpiod_event_drain *drain)
+{
+	return drain->notifyfd;
+}
+
+uint64_t gpiod_event_drain_overruns(struct gpiod_event_drain *drain)
+{
+	return __atomic_load_n(&drain->overruns, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,385 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Sets of GPIO lines spanning multiple chips. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <poll.h>
+#include <string.h>
+
+/*
+ * Lines are kept in a separate line array for every chip. The values passed
+ * by the user are in insertion order, so for every line we remember which
+ * chip it belongs to and its index within that chip's array and use scratch
+ * buffers to scatter and gather the values around the per-chip calls.
+ */
+struct group_chip {
+	struct gpiod_chip *chip;
+	struct gpiod_line_array *array;
+	int *values;
+};
+
+struct group_entry {
+	struct gpiod_line *line;
+	unsigned int chip_index;
+	unsigned int array_index;
+};
+
+struct gpiod_line_group {
+	struct group_chip *chips;
+	unsigned int num_chips;
+
+	struct group_entry *entries;
+	unsigned int num_lines;
+	unsigned int max_lines;
+
+	/*
+	 * A single poll set covers the lines of all chips. Like the one of
+	 * line arrays, it is reused across event waits as long as the
+	 * descriptors of the lines don't change.
+	 */
+	struct pollfd *poll_fds;
+	unsigned int max_poll_fds;
+	bool poll_fds_valid;
+};
+
+struct gpiod_line_group *gpiod_line_group_new(void)
+{
+	struct gpiod_line_group *group;
+
+	group = malloc(sizeof(*group));
+	if (!group)
+		return NULL;
+
+	memset(group, 0, sizeof(*group));
+
+	return group;
+}
+
+void gpiod_line_group_free(struct gpiod_line_group *group)
+{
+	unsigned int i;
+
+	for (i = 0; i < group->num_chips; i++) {
+		gpiod_line_array_free(group->chips[i].array);
+		free(group->chips[i].values);
+	}
+
+	free(group->poll_fds);
+	free(group->entries);
+	free(group->chips);
+	free(group);
+}
+
+static int line_group_get_chip(struct gpiod_line_group *group,
+			       struct gpiod_chip *chip)
+{
+	struct group_chip *chips, *new;
+	unsigned int i;
+
+	for (i = 0; i < group->num_chips; i++) {
+		if (group->chips[i].chip == chip)
+			return i;
+	}
+
+	chips = realloc(group->chips, sizeof(*chips) * (group->num_chips + 1));
+	if (!chips)
+		return -1;
+
+	group->chips = chips;
+
+	new = &group->chips[group->num_chips];
+	memset(new, 0, sizeof(*new));
+
+	new->chip = chip;
+	new->array = gpiod_line_array_new();
+	if (!new->array)
+		return -1;
+
+	return group->num_chips++;
+}
+
+int gpiod_line_group_add(struct gpiod_line_group *group,
+			 struct gpiod_line *line)
+{
+	struct group_entry *entries, *entry;
+	struct group_chip *chip;
+	unsigned int max_lines;
+	int *values, index, rv;
+
+	if (group->num_lines == group->max_lines) {
+		max_lines = group->max_lines ? group->max_lines * 2 : 8;
+
+		entries = realloc(group->entries,
+				  sizeof(*entries) * max_lines);
+		if (!entries)
+			return -1;
+
+		group->entries = entries;
+		group->max_lines = max_lines;
+	}
+
+	index = line_group_get_chip(group, gpiod_line_get_chip(line));
+	if (index < 0)
+		return -1;
+
+	chip = &group->chips[index];
+
+	values = realloc(chip->values, sizeof(*values) *
+			 (gpiod_line_array_num_lines(chip->array) + 1));
+	if (!values)
+		return -1;
+
+	chip->values = values;
+
+	rv = gpiod_line_array_add(chip->array, line);
+	if (rv < 0)
+		return -1;
+
+	entry = &group->entries[group->num_lines++];
+	entry->line = line;
+	entry->chip_index = index;
+	entry->array_index = gpiod_line_array_num_lines(chip->array) - 1;
+	group->poll_fds_valid = false;
+
+	return 0;
+}
+
+unsigned int gpiod_line_group_num_lines(struct gpiod_line_group *group)
+{
+	return group->num_lines;
+}
+
+unsigned int gpiod_line_group_num_chips(struct gpiod_line_group *group)
+{
+	return group->num_chips;
+}
+
+struct gpiod_line *gpiod_line_group_get_line(struct gpiod_line_group *group,
+					     unsigned int index)
+{
+	if (index >= group->num_lines) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return group->entries[index].line;
+}
+
+static void line_group_scatter(struct gpiod_line_group *group,
+			       const int *values)
+{
+	struct group_entry *entry;
+	unsigned int i;
+
+	for (i = 0; i < group->num_lines; i++) {
+		entry = &group->entries[i];
+		group->chips[entry->chip_index].values[entry->array_index] =
+								values[i];
+	}
+}
+
+static void line_group_gather(struct gpiod_line_group *group, int *values)
+{
+	struct group_entry *entry;
+	unsigned int i;
+
+	for (i = 0; i < group->num_lines; i++) {
+		entry = &group->entries[i];
+		values[i] = group->chips[entry->chip_index].values[
+							entry->array_index];
+	}
+}
+
+int gpiod_line_group_request(struct gpiod_line_group *group,
+			     const struct gpiod_line_request_config *config,
+			     const int *default_vals)
+{
+	const int *chip_vals = NULL;
+	unsigned int i;
+	int rv, errsv;
+
+	if (!group->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	group->poll_fds_valid = false;
+
+	if (default_vals)
+		line_group_scatter(group, default_vals);
+
+	for (i = 0; i < group->num_chips; i++) {
+		if (default_vals)
+			chip_vals = group->chips[i].values;
+
+		rv = gpiod_line_array_request(group->chips[i].array,
+					      config, chip_vals);
+		if (rv < 0) {
+			errsv = errno;
+			while (i--)
+				gpiod_line_array_release(group->chips[i].array);
+			errno = errsv;
+
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void gpiod_line_group_release(struct gpiod_line_group *group)
+{
+	unsigned int i;
+
+	for (i = 0; i < group->num_chips; i++)
+		gpiod_line_array_release(group->chips[i].array);
+
+	group->poll_fds_valid = false;
+}
+
+int gpiod_line_group_get_values(struct gpiod_line_group *group, int *values)
+{
+	unsigned int i;
+	int rv;
+
+	if (!group->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < group->num_chips; i++) {
+		rv = gpiod_line_array_get_values(group->chips[i].array,
+						 group->chips[i].values);
+		if (rv < 0)
+			return -1;
+	}
+
+	line_group_gather(group, values);
+
+	return 0;
+}
+
+int gpiod_line_group_set_values(struct gpiod_line_group *group,
+				const int *values)
+{
+	unsigned int i;
+	int rv;
+
+	if (!group->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	line_group_scatter(group, values);
+
+	for (i = 0; i < group->num_chips; i++) {
+		rv = gpiod_line_array_set_values(group->chips[i].array,
+						 group->chips[i].values);
+		if (rv < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int line_group_fill_poll_fds(struct gpiod_line_group *group)
+{
+	struct pollfd *fds;
+	unsigned int i;
+
+	group->poll_fds_valid = false;
+
+	if (group->max_poll_fds < group->num_lines) {
+		fds = realloc(group->poll_fds, sizeof(*fds) * group->num_lines);
+		if (!fds)
+			return -1;
+
+		group->poll_fds = fds;
+		group->max_poll_fds = group->num_lines;
+	}
+
+	fds = group->poll_fds;
+	memset(fds, 0, sizeof(*fds) * group->num_lines);
+
+	for (i = 0; i < group->num_lines; i++) {
+		fds[i].fd = gpiod_line_event_get_fd(group->entries[i].line);
+		if (fds[i].fd < 0)
+			return -1;
+
+		fds[i].events = POLLIN | POLLPRI;
+	}
+
+	group->poll_fds_valid = true;
+
+	return 0;
+}
+
+static bool line_group_poll_fds_valid(struct gpiod_line_group *group)
+{
+	struct gpiod_line *line;
+	unsigned int i;
+
+	if (!group->poll_fds_valid)
+		return false;
+
+	for (i = 0; i < group->num_lines; i++) {
+		line = group->entries[i].line;
+		if (group->poll_fds[i].fd != gpiod_line_event_get_fd(line))
+			return false;
+	}
+
+	return true;
+}
+
+int gpiod_line_group_event_wait(struct gpiod_line_group *group,
+				const struct timespec *timeout,
+				unsigned int *indices)
+{
+	unsigned int i, num_events = 0;
+	struct pollfd *fds;
+	int rv;
+
+	if (!group->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!line_group_poll_fds_valid(group)) {
+		rv = line_group_fill_poll_fds(group);
+		if (rv < 0)
+			return -1;
+	}
+
+	fds = group->poll_fds;
+
+	rv = ppoll(fds, group->num_lines, timeout, NULL);
+	if (rv < 0)
+		return -1;
+	else if (rv == 0)
+		return 0;
+
+	for (i = 0; i < group->num_lines; i++) {
+		if (fds[i].revents) {
+			if (fds[i].revents & POLLNVAL) {
+				group->poll_fds_valid = false;
+				errno = EINVAL;
+				return -1;
+			}
+
+			if (indices)
+				indices[num_events] = i;
+			num_events++;
+
+			if (!--rv)
+				break;
+		}
+	}
+
+	return num_events;
+}
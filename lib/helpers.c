@@ -65,14 +65,19 @@ struct gpiod_chip *gpiod_chip_open_by_label(const char *label)
 	if (!iter)
 		return NULL;
 
+	/* Chips are opened lazily - errno tells the end from an error. */
+	errno = 0;
 	gpiod_foreach_chip(iter, chip) {
 		if (strcmp(label, gpiod_chip_label(chip)) == 0) {
 			gpiod_chip_iter_free_noclose(iter);
 			return chip;
 		}
+
+		errno = 0;
 	}
 
-	errno = ENOENT;
+	if (!errno)
+		errno = ENOENT;
 	gpiod_chip_iter_free(iter);
 
 	return NULL;
@@ -122,6 +127,11 @@ int gpiod_chip_get_all_lines(struct gpiod_chip *chip,
 	struct gpiod_line_iter *iter;
 	struct gpiod_line *line;
 
+	if (gpiod_chip_num_lines(chip) > GPIOD_LINE_BULK_MAX_LINES) {
+		errno = E2BIG;
+		return -1;
+	}
+
 	gpiod_line_bulk_init(bulk);
 
 	iter = gpiod_line_iter_new(chip);
@@ -136,31 +146,6 @@ int gpiod_chip_get_all_lines(struct gpiod_chip *chip,
 	return 0;
 }
 
-struct gpiod_line *
-gpiod_chip_find_line(struct gpiod_chip *chip, const char *name)
-{
-	struct gpiod_line_iter *iter;
-	struct gpiod_line *line;
-	const char *tmp;
-
-	iter = gpiod_line_iter_new(chip);
-	if (!iter)
-		return NULL;
-
-	gpiod_foreach_line(iter, line) {
-		tmp = gpiod_line_name(line);
-		if (tmp && strcmp(tmp, name) == 0) {
-			gpiod_line_iter_free(iter);
-			return line;
-		}
-	}
-
-	errno = ENOENT;
-	gpiod_line_iter_free(iter);
-
-	return NULL;
-}
-
 int gpiod_chip_find_lines(struct gpiod_chip *chip,
 			  const char **names, struct gpiod_line_bulk *bulk)
 {
@@ -170,6 +155,11 @@ int gpiod_chip_find_lines(struct gpiod_chip *chip,
 	gpiod_line_bulk_init(bulk);
 
 	for (i = 0; names[i]; i++) {
+		if (i == GPIOD_LINE_BULK_MAX_LINES) {
+			errno = E2BIG;
+			return -1;
+		}
+
 		line = gpiod_chip_find_line(chip, names[i]);
 		if (!line)
 			return -1;
@@ -406,16 +396,62 @@ struct gpiod_line *gpiod_line_get(const char *device, unsigned int offset)
 	return line;
 }
 
+/*
+ * Returns 1 and the line if the cache knows it. Otherwise the caller should
+ * fall back to scanning all chips: lines missing from the cache may still
+ * exist (for instance if their names are too long to be cached).
+ */
+static int line_find_cached(const char *path, const char *name,
+			    struct gpiod_line **line)
+{
+	struct gpiod_chip *chip;
+	unsigned int offset;
+	const char *tmp;
+	char chipname[32];
+	int rv;
+
+	rv = gpiod_line_cache_find(path, name, chipname,
+				   sizeof(chipname), &offset);
+	if (rv <= 0)
+		return rv;
+
+	chip = gpiod_chip_open_by_name(chipname);
+	if (!chip)
+		return -1;
+
+	/* Double-check the answer - it's cheap now that the chip is open. */
+	*line = gpiod_chip_get_line(chip, offset);
+	if (*line) {
+		tmp = gpiod_line_name(*line);
+		if (tmp && strcmp(tmp, name) == 0)
+			return 1;
+	}
+
+	gpiod_chip_close(chip);
+
+	return -1;
+}
+
 struct gpiod_line *gpiod_line_find(const char *name)
 {
 	struct gpiod_chip_iter *iter;
 	struct gpiod_chip *chip;
 	struct gpiod_line *line;
+	const char *path;
+	int rv;
+
+	path = secure_getenv("GPIOD_LINE_CACHE");
+	if (path && path[0]) {
+		rv = line_find_cached(path, name, &line);
+		if (rv > 0)
+			return line;
+	}
 
 	iter = gpiod_chip_iter_new();
 	if (!iter)
 		return NULL;
 
+	errno = 0;
 	gpiod_foreach_chip(iter, chip) {
 		line = gpiod_chip_find_line(chip, name);
 		if (line) {
@@ -425,8 +461,13 @@ struct gpiod_line *gpiod_line_find(const char *name)
 
 		if (errno != ENOENT)
 			goto out;
+
+		errno = 0;
 	}
 
+	if (errno)
+		goto out;
+
 	errno = ENOENT;
 
 out:
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Interfaces shared by the library modules, not exported to users. */
+
+#ifndef __GPIOD_INTERNAL_H__
+#define __GPIOD_INTERNAL_H__
+
+#include <dirent.h>
+#include <gpiod.h>
+#include <stdbool.h>
+
+/* scandir() filter selecting the GPIO character devices in /dev. */
+int chip_dir_filter(const struct dirent *dir);
+
+/*
+ * Lines sharing an event file descriptor can't tell which of them the pending
+ * events belong to without reading them. These read the pending events into
+ * a buffer of the request - served before the descriptor by every subsequent
+ * gpiod_line_event_read*() call on any of its lines - and let the caller
+ * look at them.
+ *
+ * line_event_peek() only reads from the descriptor if the buffer is empty,
+ * so it blocks if there are no events pending at all. It returns the number
+ * of buffered events and stores a pointer to them in events, or -1 on error.
+ */
+int line_event_peek(struct gpiod_line *line,
+		    const struct gpiod_line_event **events);
+bool line_event_pending(struct gpiod_line *line);
+
+#endif /* __GPIOD_INTERNAL_H__ */
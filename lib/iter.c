@@ -11,8 +11,16 @@
 #include <gpiod.h>
 #include <string.h>
 
+#include "internal.h"
+
+/*
+ * Chip handles are opened when the iterator reaches them (unless the caller
+ * asked for the eager behavior) so the entries of the chips array are NULL
+ * until then. Names of the device files are kept until the iterator is freed.
+ */
 struct gpiod_chip_iter {
 	struct gpiod_chip **chips;
+	struct dirent **dirs;
 	unsigned int num_chips;
 	unsigned int offset;
 };
@@ -23,27 +31,32 @@ struct gpiod_line_iter {
 	unsigned int offset;
 };
 
-static int dir_filter(const struct dirent *dir)
+int chip_dir_filter(const struct dirent *dir)
 {
 	return !strncmp(dir->d_name, "gpiochip", 8);
 }
 
-static void free_dirs(struct dirent ***dirs, unsigned int num_dirs)
+static void free_dirs(struct dirent **dirs, unsigned int num_dirs)
 {
 	unsigned int i;
 
 	for (i = 0; i < num_dirs; i++)
-		free((*dirs)[i]);
-	free(*dirs);
+		free(dirs[i]);
+	free(dirs);
 }
 
 struct gpiod_chip_iter *gpiod_chip_iter_new(void)
+{
+	return gpiod_chip_iter_new_flags(0);
+}
+
+struct gpiod_chip_iter *gpiod_chip_iter_new_flags(int flags)
 {
 	struct gpiod_chip_iter *iter;
 	struct dirent **dirs;
 	int i, num_chips;
 
-	num_chips = scandir("/dev", &dirs, dir_filter, alphasort);
+	num_chips = scandir("/dev", &dirs, chip_dir_filter, alphasort);
 	if (num_chips < 0)
 		return NULL;
 
@@ -53,6 +66,7 @@ struct gpiod_chip_iter *gpiod_chip_iter_new(void)
 
 	iter->num_chips = num_chips;
 	iter->offset = 0;
+	iter->dirs = dirs;
 
 	if (num_chips == 0) {
 		iter->chips = NULL;
@@ -63,14 +77,15 @@ struct gpiod_chip_iter *gpiod_chip_iter_new(void)
 	if (!iter->chips)
 		goto err_free_iter;
 
+	if (!(flags & GPIOD_CHIP_ITER_FLAG_EAGER))
+		return iter;
+
 	for (i = 0; i < num_chips; i++) {
 		iter->chips[i] = gpiod_chip_open_by_name(dirs[i]->d_name);
 		if (!iter->chips[i])
 			goto err_close_chips;
 	}
 
-	free_dirs(&dirs, num_chips);
-
 	return iter;
 
 err_close_chips:
@@ -85,15 +100,18 @@ err_free_iter:
 	free(iter);
 
 err_free_dirs:
-	free_dirs(&dirs, num_chips);
+	free_dirs(dirs, num_chips);
 
 	return NULL;
 }
 
 void gpiod_chip_iter_free(struct gpiod_chip_iter *iter)
 {
-	if (iter->offset > 0 && iter->offset < iter->num_chips)
+	if (iter->offset > 0 && iter->chips[iter->offset - 1]) {
 		gpiod_chip_close(iter->chips[iter->offset - 1]);
+		iter->chips[iter->offset - 1] = NULL;
+	}
+
 	gpiod_chip_iter_free_noclose(iter);
 }
 
@@ -109,12 +127,13 @@ void gpiod_chip_iter_free_noclose(struct gpiod_chip_iter *iter)
 	if (iter->chips)
 		free(iter->chips);
 
+	free_dirs(iter->dirs, iter->num_chips);
 	free(iter);
 }
 
 struct gpiod_chip *gpiod_chip_iter_next(struct gpiod_chip_iter *iter)
 {
-	if (iter->offset > 0) {
+	if (iter->offset > 0 && iter->chips[iter->offset - 1]) {
 		gpiod_chip_close(iter->chips[iter->offset - 1]);
 		iter->chips[iter->offset - 1] = NULL;
 	}
@@ -124,8 +143,26 @@ struct gpiod_chip *gpiod_chip_iter_next(struct gpiod_chip_iter *iter)
 
 struct gpiod_chip *gpiod_chip_iter_next_noclose(struct gpiod_chip_iter *iter)
 {
-	return iter->offset < (iter->num_chips)
-					? iter->chips[iter->offset++] : NULL;
+	struct gpiod_chip *chip;
+
+	if (iter->offset >= iter->num_chips)
+		return NULL;
+
+	chip = iter->chips[iter->offset];
+	if (!chip) {
+		chip = gpiod_chip_open_by_name(iter->dirs[iter->offset]->d_name);
+		if (!chip) {
+			/* Don't retry this chip - end the iteration instead. */
+			iter->offset = iter->num_chips;
+			return NULL;
+		}
+
+		iter->chips[iter->offset] = chip;
+	}
+
+	iter->offset++;
+
+	return chip;
 }
 
 struct gpiod_line_iter *gpiod_line_iter_new(struct gpiod_chip *chip)
@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Multi-channel software PWM. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Every channel is a line of a single request. The PWM thread keeps the time
+ * of the next transition of every channel, sleeps until the earliest one and
+ * then applies all transitions due at that instant with a single ioctl() on a
+ * prepared request, no matter how many channels change.
+ *
+ * The period and duty cycle of a channel are packed in a single 64-bit word
+ * so that they can be updated atomically without locking. The thread picks
+ * the new values up at the beginning of the next period of the channel, so
+ * updates never produce truncated pulses.
+ */
+struct pwm_channel {
+	uint64_t config;
+	uint64_t period_end;
+	uint64_t next;
+};
+
+struct gpiod_pwm {
+	struct gpiod_line_prepared *prepared;
+	struct pwm_channel *channels;
+	unsigned int num_channels;
+
+	int sched_policy;
+	int sched_priority;
+	int cpu;
+
+	struct gpiod_pwm_stats stats;
+	int error;
+
+	pthread_t thread;
+	bool running;
+};
+
+#define NSEC_PER_SEC		1000000000ULL
+
+static uint64_t pwm_config(uint32_t period_ns, uint32_t duty_ns)
+{
+	return ((uint64_t)period_ns << 32) | duty_ns;
+}
+
+static uint64_t pwm_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+struct gpiod_pwm *gpiod_pwm_new(struct gpiod_line_bulk *bulk,
+				uint32_t period_ns)
+{
+	struct gpiod_pwm *pwm;
+	unsigned int i;
+
+	if (!period_ns) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	pwm = malloc(sizeof(*pwm));
+	if (!pwm)
+		return NULL;
+
+	memset(pwm, 0, sizeof(*pwm));
+	pwm->sched_policy = SCHED_OTHER;
+	pwm->cpu = -1;
+
+	pwm->prepared = gpiod_line_prepared_new(bulk);
+	if (!pwm->prepared)
+		goto err_free;
+
+	pwm->num_channels = gpiod_line_prepared_num_lines(pwm->prepared);
+	pwm->channels = calloc(pwm->num_channels, sizeof(*pwm->channels));
+	if (!pwm->channels)
+		goto err_free;
+
+	for (i = 0; i < pwm->num_channels; i++)
+		pwm->channels[i].config = pwm_config(period_ns, 0);
+
+	return pwm;
+
+err_free:
+	gpiod_pwm_free(pwm);
+	return NULL;
+}
+
+void gpiod_pwm_free(struct gpiod_pwm *pwm)
+{
+	gpiod_pwm_stop(pwm);
+
+	if (pwm->prepared)
+		gpiod_line_prepared_free(pwm->prepared);
+
+	free(pwm->channels);
+	free(pwm);
+}
+
+int gpiod_pwm_set_sched(struct gpiod_pwm *pwm, int policy, int priority)
+{
+	if (pwm->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	pwm->sched_policy = policy;
+	pwm->sched_priority = priority;
+
+	return 0;
+}
+
+int gpiod_pwm_set_cpu(struct gpiod_pwm *pwm, int cpu)
+{
+	if (pwm->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (cpu >= CPU_SETSIZE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	pwm->cpu = cpu;
+
+	return 0;
+}
+
+int gpiod_pwm_set_channel(struct gpiod_pwm *pwm, unsigned int channel,
+			  uint32_t period_ns, uint32_t duty_ns)
+{
+	if (channel >= pwm->num_channels || !period_ns || duty_ns > period_ns) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	__atomic_store_n(&pwm->channels[channel].config,
+			 pwm_config(period_ns, duty_ns), __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+/*
+ * Apply the transition of a channel scheduled for given time to the values
+ * of all lines and schedule its next transition.
+ */
+static void pwm_channel_step(struct pwm_channel *channel, unsigned int index,
+			     uint64_t time, uint64_t *values)
+{
+	uint32_t period, duty;
+	uint64_t config;
+
+	if (channel->next != channel->period_end) {
+		/* End of the pulse. */
+		*values &= ~(1ULL << index);
+		channel->next = channel->period_end;
+		return;
+	}
+
+	config = __atomic_load_n(&channel->config, __ATOMIC_RELAXED);
+	period = config >> 32;
+	duty = config & UINT32_MAX;
+
+	channel->period_end = time + period;
+
+	if (duty)
+		*values |= 1ULL << index;
+	else
+		*values &= ~(1ULL << index);
+
+	if (duty && duty < period)
+		channel->next = time + duty;
+	else
+		channel->next = channel->period_end;
+}
+
+static void pwm_sleep_until(uint64_t deadline)
+{
+	struct timespec ts;
+	int rv;
+
+	ts.tv_sec = deadline / NSEC_PER_SEC;
+	ts.tv_nsec = deadline % NSEC_PER_SEC;
+
+	/* The sleep is the only point at which the thread can be cancelled. */
+	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+	do {
+		rv = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+	} while (rv == EINTR);
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+}
+
+/*
+ * The stats can be read while the thread is running, so every field is
+ * stored atomically. The fields are not updated together though.
+ */
+static void pwm_update_stats(struct gpiod_pwm_stats *stats, uint64_t latency)
+{
+	uint64_t edges = stats->edges;
+
+	if (!edges || latency < stats->min_latency)
+		__atomic_store_n(&stats->min_latency, latency,
+				 __ATOMIC_RELAXED);
+	if (latency > stats->max_latency)
+		__atomic_store_n(&stats->max_latency, latency,
+				 __ATOMIC_RELAXED);
+
+	__atomic_store_n(&stats->total_latency,
+			 stats->total_latency + latency, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats->edges, edges + 1, __ATOMIC_RELAXED);
+}
+
+static void *pwm_thread_func(void *data)
+{
+	uint64_t deadline, now, values = 0, prev = ~0ULL;
+	struct gpiod_pwm *pwm = data;
+	struct pwm_channel *channel;
+	unsigned int i;
+	int rv;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+	/* All channels start their first period together. */
+	deadline = pwm_now();
+	for (i = 0; i < pwm->num_channels; i++)
+		pwm->channels[i].next = pwm->channels[i].period_end = deadline;
+
+	for (;;) {
+		deadline = UINT64_MAX;
+		for (i = 0; i < pwm->num_channels; i++) {
+			if (pwm->channels[i].next < deadline)
+				deadline = pwm->channels[i].next;
+		}
+
+		pwm_sleep_until(deadline);
+
+		for (i = 0; i < pwm->num_channels; i++) {
+			channel = &pwm->channels[i];
+			if (channel->next == deadline)
+				pwm_channel_step(channel, i, deadline, &values);
+		}
+
+		/* Starting a period doesn't always change the value. */
+		if (values == prev)
+			continue;
+
+		now = pwm_now();
+		rv = gpiod_line_prepared_set_values_mask(pwm->prepared,
+							 values);
+		if (rv < 0) {
+			__atomic_store_n(&pwm->error, errno, __ATOMIC_RELAXED);
+			break;
+		}
+
+		pwm_update_stats(&pwm->stats,
+				 now > deadline ? now - deadline : 0);
+		prev = values;
+	}
+
+	return NULL;
+}
+
+int gpiod_pwm_start(struct gpiod_pwm *pwm)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	cpu_set_t cpuset;
+	int rv;
+
+	if (pwm->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	memset(&pwm->stats, 0, sizeof(pwm->stats));
+	pwm->error = 0;
+
+	rv = pthread_attr_init(&attr);
+	if (rv) {
+		errno = rv;
+		return -1;
+	}
+
+	if (pwm->sched_policy != SCHED_OTHER) {
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = pwm->sched_priority;
+
+		rv = pthread_attr_setinheritsched(&attr,
+						  PTHREAD_EXPLICIT_SCHED);
+		if (!rv)
+			rv = pthread_attr_setschedpolicy(&attr,
+							 pwm->sched_policy);
+		if (!rv)
+			rv = pthread_attr_setschedparam(&attr, &param);
+		if (rv)
+			goto out;
+	}
+
+	if (pwm->cpu >= 0) {
+		CPU_ZERO(&cpuset);
+		CPU_SET(pwm->cpu, &cpuset);
+
+		rv = pthread_attr_setaffinity_np(&attr, sizeof(cpuset),
+						 &cpuset);
+		if (rv)
+			goto out;
+	}
+
+	rv = pthread_create(&pwm->thread, &attr, pwm_thread_func, pwm);
+	if (!rv)
+		pwm->running = true;
+
+out:
+	pthread_attr_destroy(&attr);
+	if (rv) {
+		errno = rv;
+		return -1;
+	}
+
+	return 0;
+}
+
+void gpiod_pwm_stop(struct gpiod_pwm *pwm)
+{
+	if (!pwm->running)
+		return;
+
+	pthread_cancel(pwm->thread);
+	pthread_join(pwm->thread, NULL);
+	pwm->running = false;
+
+	gpiod_line_prepared_set_values_mask(pwm->prepared, 0);
+}
+
+int gpiod_pwm_get_stats(struct gpiod_pwm *pwm, struct gpiod_pwm_stats *stats)
+{
+	int error;
+
+	error = __atomic_load_n(&pwm->error, __ATOMIC_RELAXED);
+	if (error) {
+		errno = error;
+		return -1;
+	}
+
+	stats->edges = __atomic_load_n(&pwm->stats.edges, __ATOMIC_RELAXED);
+	stats->min_latency = __atomic_load_n(&pwm->stats.min_latency,
+					     __ATOMIC_RELAXED);
+	stats->max_latency = __atomic_load_n(&pwm->stats.max_latency,
+					     __ATOMIC_RELAXED);
+	stats->total_latency = __atomic_load_n(&pwm->stats.total_latency,
+					       __ATOMIC_RELAXED);
+
+	return 0;
+}
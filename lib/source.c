@@ -0,0 +1,420 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Event sources for integrating line events with external event loops. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+/*
+ * Every chip with lines in the source has a table of handlers indexed by line
+ * offset, so the handler of an event is found without searching no matter
+ * how many lines share the request it was read from. Every event descriptor
+ * is registered with the epoll instance once, with its index in the
+ * descriptor array stored as the epoll data, and is read through any of the
+ * lines using it.
+ */
+struct source_handler {
+	struct gpiod_line *line;
+	gpiod_event_source_cb cb;
+	void *data;
+	unsigned int fd_index;
+};
+
+struct source_chip {
+	struct gpiod_chip *chip;
+	struct source_handler *handlers;
+};
+
+struct source_fd {
+	int fd;
+	struct gpiod_line *line;
+	unsigned int chip_index;
+	unsigned int num_lines;
+};
+
+struct gpiod_event_source {
+	int epfd;
+
+	struct source_chip *chips;
+	unsigned int num_chips;
+
+	struct source_fd *fds;
+	unsigned int num_fds;
+};
+
+#define SOURCE_MAX_READY	16
+
+struct gpiod_event_source *gpiod_event_source_new(void)
+{
+	struct gpiod_event_source *source;
+
+	source = malloc(sizeof(*source));
+	if (!source)
+		return NULL;
+
+	memset(source, 0, sizeof(*source));
+
+	source->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (source->epfd < 0) {
+		free(source);
+		return NULL;
+	}
+
+	return source;
+}
+
+void gpiod_event_source_free(struct gpiod_event_source *source)
+{
+	unsigned int i;
+
+	for (i = 0; i < source->num_chips; i++)
+		free(source->chips[i].handlers);
+
+	free(source->chips);
+	free(source->fds);
+	close(source->epfd);
+	free(source);
+}
+
+static int source_get_chip(struct gpiod_event_source *source,
+			   struct gpiod_chip *chip)
+{
+	struct source_chip *chips, *new;
+	unsigned int i;
+
+	for (i = 0; i < source->num_chips; i++) {
+		if (source->chips[i].chip == chip)
+			return i;
+	}
+
+	chips = realloc(source->chips,
+			sizeof(*chips) * (source->num_chips + 1));
+	if (!chips)
+		return -1;
+
+	source->chips = chips;
+
+	new = &source->chips[source->num_chips];
+	new->chip = chip;
+	new->handlers = calloc(gpiod_chip_num_lines(chip),
+			       sizeof(*new->handlers));
+	if (!new->handlers)
+		return -1;
+
+	return source->num_chips++;
+}
+
+/*
+ * Slots are looked up by descriptor number, so a slot may belong to a request
+ * which was released without its lines being removed from the source and
+ * whose descriptor number was then reused by another request. The kernel
+ * drops closed descriptors from the epoll set: if the descriptor can be added
+ * to it again, the slot is stale. Drop the handlers of the lines which were
+ * read through it and start over with the new descriptor.
+ */
+static int source_check_fd(struct gpiod_event_source *source,
+			   unsigned int index, struct gpiod_line *line,
+			   unsigned int chip_index)
+{
+	struct source_fd *sfd = &source->fds[index];
+	struct source_handler *handler;
+	struct epoll_event event;
+	struct source_chip *chip;
+	unsigned int i;
+	int rv;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLPRI;
+	event.data.u32 = index;
+
+	rv = epoll_ctl(source->epfd, EPOLL_CTL_ADD, sfd->fd, &event);
+	if (rv < 0)
+		return errno == EEXIST ? (int)index : -1;
+
+	chip = &source->chips[sfd->chip_index];
+	for (i = 0; i < gpiod_chip_num_lines(chip->chip); i++) {
+		handler = &chip->handlers[i];
+		if (handler->cb && handler->fd_index == index)
+			memset(handler, 0, sizeof(*handler));
+	}
+
+	sfd->line = line;
+	sfd->chip_index = chip_index;
+	sfd->num_lines = 0;
+
+	return index;
+}
+
+static int source_get_fd(struct gpiod_event_source *source,
+			 struct gpiod_line *line, unsigned int chip_index)
+{
+	struct source_fd *fds, *new;
+	struct epoll_event event;
+	unsigned int i, index;
+	int fd, rv;
+
+	fd = gpiod_line_event_get_fd(line);
+	if (fd < 0)
+		return -1;
+
+	/* Slots of removed descriptors are reused. */
+	index = source->num_fds;
+	for (i = 0; i < source->num_fds; i++) {
+		if (source->fds[i].fd == fd)
+			return source_check_fd(source, i, line, chip_index);
+		else if (source->fds[i].fd < 0)
+			index = i;
+	}
+
+	if (index == source->num_fds) {
+		fds = realloc(source->fds,
+			      sizeof(*fds) * (source->num_fds + 1));
+		if (!fds)
+			return -1;
+
+		source->fds = fds;
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLPRI;
+	event.data.u32 = index;
+
+	rv = epoll_ctl(source->epfd, EPOLL_CTL_ADD, fd, &event);
+	if (rv < 0)
+		return -1;
+
+	new = &source->fds[index];
+	new->fd = fd;
+	new->line = line;
+	new->chip_index = chip_index;
+	new->num_lines = 0;
+
+	if (index == source->num_fds)
+		source->num_fds++;
+
+	return index;
+}
+
+static struct source_handler *
+source_find_handler(struct gpiod_event_source *source,
+		    struct gpiod_line *line)
+{
+	struct gpiod_chip *chip = gpiod_line_get_chip(line);
+	unsigned int i;
+
+	for (i = 0; i < source->num_chips; i++) {
+		if (source->chips[i].chip == chip)
+			return &source->chips[i].handlers[
+						gpiod_line_offset(line)];
+	}
+
+	return NULL;
+}
+
+int gpiod_event_source_add_line(struct gpiod_event_source *source,
+				struct gpiod_line *line,
+				gpiod_event_source_cb cb, void *data)
+{
+	struct source_handler *handler;
+	int chip_index, fd_index;
+
+	if (!cb) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	chip_index = source_get_chip(source, gpiod_line_get_chip(line));
+	if (chip_index < 0)
+		return -1;
+
+	fd_index = source_get_fd(source, line, chip_index);
+	if (fd_index < 0)
+		return -1;
+
+	handler = &source->chips[chip_index].handlers[gpiod_line_offset(line)];
+
+	/* The line was re-requested without being removed from the source. */
+	if (handler->cb && handler->fd_index != (unsigned int)fd_index)
+		gpiod_event_source_remove_line(source, line);
+
+	if (!handler->cb)
+		source->fds[fd_index].num_lines++;
+
+	handler->line = line;
+	handler->cb = cb;
+	handler->data = data;
+	handler->fd_index = fd_index;
+
+	return 0;
+}
+
+int gpiod_event_source_add_bulk(struct gpiod_event_source *source,
+				struct gpiod_line_bulk *bulk,
+				gpiod_event_source_cb cb, void *data)
+{
+	struct source_handler prev[GPIOD_LINE_BULK_MAX_LINES], *handler;
+	struct gpiod_line *line;
+	uint64_t added = 0;
+	unsigned int i;
+	int rv;
+
+	gpiod_line_bulk_foreach_line_off(bulk, line, i) {
+		/* Lines already in the source only get their handler replaced. */
+		handler = source_find_handler(source, line);
+		if (handler && handler->cb)
+			prev[i] = *handler;
+		else
+			added |= 1ULL << i;
+
+		rv = gpiod_event_source_add_line(source, line, cb, data);
+		if (rv < 0)
+			goto err_restore;
+	}
+
+	return 0;
+
+err_restore:
+	/* Undo only what this call did. */
+	while (i--) {
+		line = gpiod_line_bulk_get_line(bulk, i);
+
+		handler = source_find_handler(source, line);
+
+		/* A stale handler can't be restored, the line has moved. */
+		if ((added & (1ULL << i)) ||
+		    handler->fd_index != prev[i].fd_index)
+			gpiod_event_source_remove_line(source, line);
+		else
+			*handler = prev[i];
+	}
+
+	return -1;
+}
+
+int gpiod_event_source_remove_line(struct gpiod_event_source *source,
+				   struct gpiod_line *line)
+{
+	unsigned int i, fd_index, num_lines;
+	struct source_handler *handler;
+	struct source_chip *chip;
+	struct source_fd *sfd;
+
+	handler = source_find_handler(source, line);
+	if (!handler || !handler->cb) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	fd_index = handler->fd_index;
+	sfd = &source->fds[fd_index];
+	memset(handler, 0, sizeof(*handler));
+
+	if (--sfd->num_lines == 0) {
+		epoll_ctl(source->epfd, EPOLL_CTL_DEL, sfd->fd, NULL);
+		sfd->fd = -1;
+		sfd->line = NULL;
+	} else if (sfd->line == line) {
+		/* Keep reading the descriptor through another line. */
+		chip = &source->chips[sfd->chip_index];
+		num_lines = gpiod_chip_num_lines(chip->chip);
+
+		for (i = 0; i < num_lines; i++) {
+			handler = &chip->handlers[i];
+			if (handler->cb && handler->fd_index == fd_index) {
+				sfd->line = handler->line;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int gpiod_event_source_get_fd(struct gpiod_event_source *source)
+{
+	return source->epfd;
+}
+
+static int source_dispatch_fd(struct gpiod_event_source *source,
+			      struct source_fd *sfd)
+{
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	struct source_chip *chip = &source->chips[sfd->chip_index];
+	struct source_handler *handler;
+	int num_events, i;
+
+	num_events = gpiod_line_event_read_multiple(sfd->line, events,
+						    GPIOD_LINE_EVENT_MAX_EVENTS);
+	if (num_events < 0)
+		return -1;
+
+	for (i = 0; i < num_events; i++) {
+		if (events[i].offset >= gpiod_chip_num_lines(chip->chip))
+			continue;
+
+		/* Lines of a shared request may not all be in the source. */
+		handler = &chip->handlers[events[i].offset];
+		if (handler->cb)
+			handler->cb(handler->line, &events[i], handler->data);
+	}
+
+	return num_events;
+}
+
+int gpiod_event_source_dispatch(struct gpiod_event_source *source)
+{
+	struct epoll_event events[SOURCE_MAX_READY];
+	int rv, i, num_ready, num_events = 0;
+	struct source_fd *sfd;
+
+	num_ready = epoll_wait(source->epfd, events, SOURCE_MAX_READY, 0);
+	if (num_ready < 0)
+		return -1;
+
+	for (i = 0; i < num_ready; i++) {
+		sfd = &source->fds[events[i].data.u32];
+		if (sfd->fd < 0)
+			continue;
+
+		if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+			errno = EIO;
+			return -1;
+		}
+
+		rv = source_dispatch_fd(source, sfd);
+		if (rv < 0)
+			return -1;
+
+		num_events += rv;
+	}
+
+	return num_events;
+}
+
+int gpiod_event_source_attach_epoll(struct gpiod_event_source *source,
+				    int epfd, void *data)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.ptr = data;
+
+	return epoll_ctl(epfd, EPOLL_CTL_ADD, source->epfd, &event);
+}
+
+int gpiod_event_source_detach_epoll(struct gpiod_event_source *source,
+				    int epfd)
+{
+	return epoll_ctl(epfd, EPOLL_CTL_DEL, source->epfd, NULL);
+}
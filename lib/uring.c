@@ -0,0 +1,612 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* io_uring based line event reader. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <linux/gpio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if HAVE_DECL_IORING_FEAT_EXT_ARG && HAVE_DECL___NR_IO_URING_SETUP
+
+#include <linux/io_uring.h>
+
+/*
+ * Every monitored event file descriptor has a slot with a buffer large enough
+ * for GPIOD_LINE_EVENT_MAX_EVENTS events and a read into that buffer is armed
+ * whenever the slot holds no undelivered events. Completed reads are decoded
+ * into the slot which is then put on the ready list until all its events have
+ * been handed over to the user. The read is re-armed at that point but only
+ * submitted by the next io_uring_enter() call which also waits for new
+ * completions.
+ *
+ * Every slot has at most one request in flight and the submission queue has
+ * at least one entry per slot, so it never overflows.
+ */
+
+#if HAVE_DECL_GPIO_V2_GET_LINE_IOCTL
+#define URING_EVENT_DATA_SIZE	sizeof(struct gpio_v2_line_event)
+#else
+#define URING_EVENT_DATA_SIZE	sizeof(struct gpioevent_data)
+#endif
+
+#define URING_BUF_SIZE		(GPIOD_LINE_EVENT_MAX_EVENTS * \
+				 URING_EVENT_DATA_SIZE)
+
+/* Tags the completions of the cancel requests issued when freeing. */
+#define URING_CANCEL_TAG	UINT64_MAX
+
+/*
+ * The event file descriptors are blocking. With IORING_FEAT_FAST_POLL the
+ * kernel arms an internal poll on the descriptor when a read finds no data
+ * and retries the read once an event arrives, instead of punting it to an
+ * io-wq worker thread which would block in read() for every armed slot.
+ */
+#define URING_REQUIRED_FEATURES	(IORING_FEAT_SINGLE_MMAP | \
+				 IORING_FEAT_FAST_POLL | \
+				 IORING_FEAT_RW_CUR_POS | \
+				 IORING_FEAT_EXT_ARG)
+
+struct uring_slot {
+	int fd;
+	struct gpiod_line_bulk lines;
+	bool armed;
+
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	unsigned int num_events;
+	unsigned int next_event;
+
+	unsigned char buf[URING_BUF_SIZE];
+};
+
+struct gpiod_event_uring {
+	int fd;
+
+	void *ring;
+	size_t ring_size;
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+
+	unsigned int *sq_head;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	struct uring_slot *slots;
+	unsigned int num_slots;
+	unsigned int max_slots;
+
+	unsigned int *ready;
+	unsigned int ready_head;
+	unsigned int num_ready;
+};
+
+static int uring_setup(unsigned int entries, struct io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned int to_submit,
+		       unsigned int min_complete, unsigned int flags,
+		       void *arg, size_t argsz)
+{
+	return syscall(__NR_io_uring_enter, fd, to_submit,
+		       min_complete, flags, arg, argsz);
+}
+
+static void uring_release(struct gpiod_event_uring *uring)
+{
+	if (uring->sqes)
+		munmap(uring->sqes, uring->sqes_size);
+	if (uring->ring)
+		munmap(uring->ring, uring->ring_size);
+	if (uring->fd >= 0)
+		close(uring->fd);
+
+	free(uring->ready);
+	free(uring->slots);
+	free(uring);
+}
+
+static int uring_map(struct gpiod_event_uring *uring,
+		     struct io_uring_params *params)
+{
+	size_t sq_size, cq_size;
+	unsigned char *base;
+	void *ptr;
+
+	sq_size = params->sq_off.array +
+		  params->sq_entries * sizeof(unsigned int);
+	cq_size = params->cq_off.cqes +
+		  params->cq_entries * sizeof(struct io_uring_cqe);
+
+	/* Both rings live in a single mapping. */
+	uring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+	ptr = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+	if (ptr == MAP_FAILED)
+		return -1;
+
+	uring->ring = ptr;
+
+	uring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+	ptr = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+	if (ptr == MAP_FAILED)
+		return -1;
+
+	uring->sqes = ptr;
+
+	base = uring->ring;
+	uring->sq_head = (unsigned int *)(base + params->sq_off.head);
+	uring->sq_tail = (unsigned int *)(base + params->sq_off.tail);
+	uring->sq_mask = (unsigned int *)(base + params->sq_off.ring_mask);
+	uring->sq_array = (unsigned int *)(base + params->sq_off.array);
+
+	uring->cq_head = (unsigned int *)(base + params->cq_off.head);
+	uring->cq_tail = (unsigned int *)(base + params->cq_off.tail);
+	uring->cq_mask = (unsigned int *)(base + params->cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe *)(base + params->cq_off.cqes);
+
+	return 0;
+}
+
+struct gpiod_event_uring *gpiod_event_uring_new(unsigned int max_lines)
+{
+	struct gpiod_event_uring *uring;
+	struct io_uring_params params;
+	int rv;
+
+	if (!max_lines) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	uring = malloc(sizeof(*uring));
+	if (!uring)
+		return NULL;
+
+	memset(uring, 0, sizeof(*uring));
+	uring->fd = -1;
+	uring->max_slots = max_lines;
+
+	uring->slots = calloc(max_lines, sizeof(*uring->slots));
+	if (!uring->slots)
+		goto err_release;
+
+	uring->ready = calloc(max_lines, sizeof(*uring->ready));
+	if (!uring->ready)
+		goto err_release;
+
+	/*
+	 * The completion queue is twice the size of the submission queue
+	 * which leaves room for both the reads and their cancellations.
+	 */
+	memset(&params, 0, sizeof(params));
+	uring->fd = uring_setup(max_lines, &params);
+	if (uring->fd < 0) {
+		if (errno == ENOSYS)
+			errno = ENOTSUP;
+		goto err_release;
+	}
+
+	if ((params.features & URING_REQUIRED_FEATURES) !=
+	    URING_REQUIRED_FEATURES) {
+		errno = ENOTSUP;
+		goto err_release;
+	}
+
+	rv = uring_map(uring, &params);
+	if (rv < 0)
+		goto err_release;
+
+	return uring;
+
+err_release:
+	uring_release(uring);
+	return NULL;
+}
+
+static struct io_uring_sqe *uring_get_sqe(struct gpiod_event_uring *uring)
+{
+	unsigned int index = *uring->sq_tail & *uring->sq_mask;
+	struct io_uring_sqe *sqe = &uring->sqes[index];
+
+	memset(sqe, 0, sizeof(*sqe));
+	uring->sq_array[index] = index;
+
+	return sqe;
+}
+
+static void uring_queue_sqe(struct gpiod_event_uring *uring)
+{
+	__atomic_store_n(uring->sq_tail, *uring->sq_tail + 1,
+			 __ATOMIC_RELEASE);
+}
+
+static unsigned int uring_sq_pending(struct gpiod_event_uring *uring)
+{
+	return *uring->sq_tail -
+	       __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+}
+
+static void uring_arm_slot(struct gpiod_event_uring *uring,
+			   unsigned int index)
+{
+	struct uring_slot *slot = &uring->slots[index];
+	struct io_uring_sqe *sqe;
+
+	sqe = uring_get_sqe(uring);
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = slot->fd;
+	sqe->addr = (uintptr_t)slot->buf;
+	sqe->len = sizeof(slot->buf);
+	/* Line event descriptors are streams, read at the current position. */
+	sqe->off = (uint64_t)-1;
+	sqe->user_data = index;
+	uring_queue_sqe(uring);
+
+	slot->armed = true;
+}
+
+static void uring_cancel_slot(struct gpiod_event_uring *uring,
+			      unsigned int index)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = uring_get_sqe(uring);
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = index;
+	sqe->user_data = URING_CANCEL_TAG;
+	uring_queue_sqe(uring);
+}
+
+/*
+ * Submit all queued requests and wait for at least min_complete completions
+ * or until the timeout expires.
+ */
+static int uring_submit_and_wait(struct gpiod_event_uring *uring,
+				 unsigned int min_complete,
+				 const struct timespec *timeout)
+{
+	struct io_uring_getevents_arg arg;
+	struct __kernel_timespec ts;
+	unsigned int flags = 0;
+	size_t argsz = 0;
+	void *argp = NULL;
+
+	if (min_complete)
+		flags |= IORING_ENTER_GETEVENTS;
+
+	if (min_complete && timeout) {
+		ts.tv_sec = timeout->tv_sec;
+		ts.tv_nsec = timeout->tv_nsec;
+
+		memset(&arg, 0, sizeof(arg));
+		arg.ts = (uintptr_t)&ts;
+
+		flags |= IORING_ENTER_EXT_ARG;
+		argp = &arg;
+		argsz = sizeof(arg);
+	}
+
+	return uring_enter(uring->fd, uring_sq_pending(uring), min_complete,
+			   flags, argp, argsz);
+}
+
+void gpiod_event_uring_free(struct gpiod_event_uring *uring)
+{
+	struct io_uring_cqe *cqe;
+	unsigned int i, head, tail, num_armed = 0;
+	int rv;
+
+	/*
+	 * The kernel keeps writing to the buffers of the armed reads until
+	 * they complete, so cancel them and wait for their completions before
+	 * the buffers are freed. Queued reads are submitted first to make
+	 * room for the cancel requests.
+	 */
+	if (uring_sq_pending(uring))
+		uring_submit_and_wait(uring, 0, NULL);
+
+	for (i = 0; i < uring->num_slots; i++) {
+		if (uring->slots[i].armed) {
+			uring_cancel_slot(uring, i);
+			num_armed++;
+		}
+	}
+
+	while (num_armed) {
+		rv = uring_submit_and_wait(uring, 1, NULL);
+		if (rv < 0 && errno != EINTR)
+			break;
+
+		head = *uring->cq_head;
+		tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+		for (; head != tail; head++) {
+			cqe = &uring->cqes[head & *uring->cq_mask];
+			if (cqe->user_data != URING_CANCEL_TAG &&
+			    uring->slots[cqe->user_data].armed) {
+				uring->slots[cqe->user_data].armed = false;
+				num_armed--;
+			}
+		}
+
+		__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+	}
+
+	uring_release(uring);
+}
+
+int gpiod_event_uring_add_line(struct gpiod_event_uring *uring,
+			       struct gpiod_line *line)
+{
+	struct gpiod_line *curr, **lineptr;
+	struct uring_slot *slot;
+	unsigned int i;
+	int fd;
+
+	fd = gpiod_line_event_get_fd(line);
+	if (fd < 0)
+		return -1;
+
+	/* Lines sharing a descriptor share the read as well. */
+	for (i = 0; i < uring->num_slots; i++) {
+		slot = &uring->slots[i];
+		if (slot->fd != fd)
+			continue;
+
+		gpiod_line_bulk_foreach_line(&slot->lines, curr, lineptr) {
+			if (curr == line)
+				return 0;
+		}
+
+		gpiod_line_bulk_add(&slot->lines, line);
+		return 0;
+	}
+
+	if (uring->num_slots == uring->max_slots) {
+		errno = ENOSPC;
+		return -1;
+	}
+
+	slot = &uring->slots[uring->num_slots];
+	slot->fd = fd;
+	gpiod_line_bulk_init(&slot->lines);
+	gpiod_line_bulk_add(&slot->lines, line);
+
+	uring_arm_slot(uring, uring->num_slots++);
+
+	return 0;
+}
+
+int gpiod_event_uring_add_bulk(struct gpiod_event_uring *uring,
+			       struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line, **lineptr;
+	int rv;
+
+	gpiod_line_bulk_foreach_line(bulk, line, lineptr) {
+		rv = gpiod_event_uring_add_line(uring, line);
+		if (rv < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static struct gpiod_line *uring_slot_get_line(struct uring_slot *slot,
+					      unsigned int offset)
+{
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(&slot->lines, line, lineptr) {
+		if (gpiod_line_offset(line) == offset)
+			return line;
+	}
+
+	return gpiod_line_bulk_get_line(&slot->lines, 0);
+}
+
+/*
+ * Hand the decoded events over to the user in the order in which the reads
+ * completed and re-arm the reads of the slots which have been emptied.
+ */
+static unsigned int uring_flush_ready(struct gpiod_event_uring *uring,
+				      struct gpiod_line_event *events,
+				      struct gpiod_line **lines,
+				      unsigned int num_events)
+{
+	struct gpiod_line_event *event;
+	unsigned int index, count = 0;
+	struct uring_slot *slot;
+
+	while (uring->num_ready && count < num_events) {
+		index = uring->ready[uring->ready_head];
+		slot = &uring->slots[index];
+
+		while (slot->next_event < slot->num_events &&
+		       count < num_events) {
+			event = &slot->events[slot->next_event++];
+
+			events[count] = *event;
+			if (lines)
+				lines[count] = uring_slot_get_line(slot,
+								   event->offset);
+			count++;
+		}
+
+		if (slot->next_event < slot->num_events)
+			break;
+
+		uring->ready_head = (uring->ready_head + 1) % uring->max_slots;
+		uring->num_ready--;
+
+		uring_arm_slot(uring, index);
+	}
+
+	return count;
+}
+
+static void uring_slot_ready(struct gpiod_event_uring *uring,
+			     unsigned int index, int num_events)
+{
+	struct uring_slot *slot = &uring->slots[index];
+
+	slot->num_events = num_events;
+	slot->next_event = 0;
+
+	uring->ready[(uring->ready_head + uring->num_ready) %
+		     uring->max_slots] = index;
+	uring->num_ready++;
+}
+
+/*
+ * Decode the data of all completed reads. Failed reads are not re-armed
+ * unless they were interrupted and the error is only reported if no events
+ * are ready.
+ */
+static int uring_reap(struct gpiod_event_uring *uring)
+{
+	unsigned int head, tail, index;
+	struct io_uring_cqe *cqe;
+	struct uring_slot *slot;
+	int rv, error = 0;
+
+	head = *uring->cq_head;
+	tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; head++) {
+		cqe = &uring->cqes[head & *uring->cq_mask];
+		if (cqe->user_data == URING_CANCEL_TAG)
+			continue;
+
+		index = cqe->user_data;
+		slot = &uring->slots[index];
+		slot->armed = false;
+
+		if (cqe->res == -EINTR || cqe->res == -EAGAIN) {
+			uring_arm_slot(uring, index);
+			continue;
+		} else if (cqe->res < 0) {
+			error = -cqe->res;
+			continue;
+		}
+
+		rv = gpiod_line_event_decode(
+				gpiod_line_bulk_get_line(&slot->lines, 0),
+				slot->buf, cqe->res, slot->events,
+				GPIOD_LINE_EVENT_MAX_EVENTS);
+		if (rv < 0) {
+			error = errno;
+			uring_arm_slot(uring, index);
+			continue;
+		}
+
+		uring_slot_ready(uring, index, rv);
+	}
+
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+	if (error && !uring->num_ready) {
+		errno = error;
+		return -1;
+	}
+
+	return 0;
+}
+
+int gpiod_event_uring_read(struct gpiod_event_uring *uring,
+			   const struct timespec *timeout,
+			   struct gpiod_line_event *events,
+			   struct gpiod_line **lines,
+			   unsigned int num_events)
+{
+	unsigned int count, min_complete = 1;
+	int rv;
+
+	if (!uring->num_slots || !num_events) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	count = uring_flush_ready(uring, events, lines, num_events);
+	if (count)
+		return count;
+
+	if (timeout && !timeout->tv_sec && !timeout->tv_nsec)
+		min_complete = 0;
+
+	if (min_complete || uring_sq_pending(uring)) {
+		rv = uring_submit_and_wait(uring, min_complete, timeout);
+		if (rv < 0 && errno != ETIME)
+			return -1;
+	}
+
+	rv = uring_reap(uring);
+	if (rv < 0)
+		return -1;
+
+	return uring_flush_ready(uring, events, lines, num_events);
+}
+
+#else /* !(HAVE_DECL_IORING_FEAT_EXT_ARG && HAVE_DECL___NR_IO_URING_SETUP) */
+
+/*
+ * Without io_uring support in the kernel headers no reader can be created
+ * and the remaining routines are never called.
+ */
+
+struct gpiod_event_uring *
+gpiod_event_uring_new(unsigned int max_lines GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return NULL;
+}
+
+void gpiod_event_uring_free(struct gpiod_event_uring *uring GPIOD_UNUSED)
+{
+}
+
+int gpiod_event_uring_add_line(struct gpiod_event_uring *uring GPIOD_UNUSED,
+			       struct gpiod_line *line GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+int gpiod_event_uring_add_bulk(struct gpiod_event_uring *uring GPIOD_UNUSED,
+			       struct gpiod_line_bulk *bulk GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+int gpiod_event_uring_read(struct gpiod_event_uring *uring GPIOD_UNUSED,
+			   const struct timespec *timeout GPIOD_UNUSED,
+			   struct gpiod_line_event *events GPIOD_UNUSED,
+			   struct gpiod_line **lines GPIOD_UNUSED,
+			   unsigned int num_events GPIOD_UNUSED)
+{
+	errno = ENOTSUP;
+	return -1;
+}
+
+#endif /* HAVE_DECL_IORING_FEAT_EXT_ARG && HAVE_DECL___NR_IO_URING_SETUP */
@@ -0,0 +1,391 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Persistent, epoll-based line event waiter. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "internal.h"
+
+/*
+ * Every monitored event file descriptor has a record listing the lines added
+ * through it - more than one if the lines were requested with a shared event
+ * descriptor - and the record is what the epoll data points to. The events
+ * of a shared descriptor are peeked at to report the lines they actually
+ * occurred on. Peeked events stay buffered in the request until the user
+ * reads them, so the descriptor is no longer readable: records with peeked
+ * events are checked before every wait.
+ */
+struct waiter_fd {
+	int fd;
+	struct gpiod_line *lines[GPIOD_LINE_BULK_MAX_LINES];
+	unsigned int num_lines;
+	bool peeked;
+	bool ready;
+	struct waiter_fd *next;
+};
+
+struct gpiod_event_waiter {
+	int epfd;
+	unsigned int num_lines;
+	struct waiter_fd *fds;
+	unsigned int num_peeked;
+};
+
+struct gpiod_event_waiter *gpiod_event_waiter_new(void)
+{
+	struct gpiod_event_waiter *waiter;
+
+	waiter = malloc(sizeof(*waiter));
+	if (!waiter)
+		return NULL;
+
+	memset(waiter, 0, sizeof(*waiter));
+
+	waiter->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (waiter->epfd < 0) {
+		free(waiter);
+		return NULL;
+	}
+
+	return waiter;
+}
+
+void gpiod_event_waiter_free(struct gpiod_event_waiter *waiter)
+{
+	struct waiter_fd *wfd, *next;
+
+	for (wfd = waiter->fds; wfd; wfd = next) {
+		next = wfd->next;
+		free(wfd);
+	}
+
+	close(waiter->epfd);
+	free(waiter);
+}
+
+static struct waiter_fd *waiter_find_fd(struct gpiod_event_waiter *waiter,
+					int fd)
+{
+	struct waiter_fd *wfd;
+
+	for (wfd = waiter->fds; wfd; wfd = wfd->next) {
+		if (wfd->fd == fd)
+			return wfd;
+	}
+
+	return NULL;
+}
+
+static int waiter_epoll_add(struct gpiod_event_waiter *waiter,
+			    struct waiter_fd *wfd)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLPRI;
+	event.data.ptr = wfd;
+
+	return epoll_ctl(waiter->epfd, EPOLL_CTL_ADD, wfd->fd, &event);
+}
+
+static void waiter_clear_peeked(struct gpiod_event_waiter *waiter,
+				struct waiter_fd *wfd)
+{
+	if (wfd->peeked) {
+		wfd->peeked = false;
+		waiter->num_peeked--;
+	}
+}
+
+int gpiod_event_waiter_add_line(struct gpiod_event_waiter *waiter,
+				struct gpiod_line *line)
+{
+	struct waiter_fd *wfd;
+	unsigned int i;
+	int rv, fd;
+
+	fd = gpiod_line_event_get_fd(line);
+	if (fd < 0)
+		return -1;
+
+	wfd = waiter_find_fd(waiter, fd);
+	if (wfd) {
+		/*
+		 * The kernel drops closed descriptors from the epoll set. If
+		 * the descriptor can be added again, the lines of this record
+		 * were released without being removed and the number was
+		 * reused by a new request.
+		 */
+		rv = waiter_epoll_add(waiter, wfd);
+		if (rv == 0) {
+			waiter->num_lines -= wfd->num_lines;
+			wfd->num_lines = 0;
+			waiter_clear_peeked(waiter, wfd);
+		} else if (errno != EEXIST) {
+			return -1;
+		}
+
+		for (i = 0; i < wfd->num_lines; i++) {
+			if (wfd->lines[i] == line) {
+				errno = EEXIST;
+				return -1;
+			}
+		}
+
+		if (wfd->num_lines == GPIOD_LINE_BULK_MAX_LINES) {
+			errno = ENOSPC;
+			return -1;
+		}
+	} else {
+		wfd = malloc(sizeof(*wfd));
+		if (!wfd)
+			return -1;
+
+		memset(wfd, 0, sizeof(*wfd));
+		wfd->fd = fd;
+
+		rv = waiter_epoll_add(waiter, wfd);
+		if (rv < 0) {
+			free(wfd);
+			return -1;
+		}
+
+		wfd->next = waiter->fds;
+		waiter->fds = wfd;
+	}
+
+	wfd->lines[wfd->num_lines++] = line;
+	waiter->num_lines++;
+
+	return 0;
+}
+
+int gpiod_event_waiter_add_bulk(struct gpiod_event_waiter *waiter,
+				struct gpiod_line_bulk *bulk)
+{
+	struct gpiod_line *line;
+	unsigned int i;
+	int rv;
+
+	/* Adding a line twice fails, so all lines before i are new. */
+	gpiod_line_bulk_foreach_line_off(bulk, line, i) {
+		rv = gpiod_event_waiter_add_line(waiter, line);
+		if (rv < 0) {
+			while (i--) {
+				line = gpiod_line_bulk_get_line(bulk, i);
+				gpiod_event_waiter_remove_line(waiter, line);
+			}
+
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int gpiod_event_waiter_remove_line(struct gpiod_event_waiter *waiter,
+				   struct gpiod_line *line)
+{
+	struct waiter_fd *wfd, **wfdptr;
+	unsigned int i;
+	int fd;
+
+	fd = gpiod_line_event_get_fd(line);
+	if (fd < 0)
+		return -1;
+
+	for (wfdptr = &waiter->fds; *wfdptr; wfdptr = &(*wfdptr)->next) {
+		if ((*wfdptr)->fd == fd)
+			break;
+	}
+
+	wfd = *wfdptr;
+	if (!wfd) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	for (i = 0; i < wfd->num_lines; i++) {
+		if (wfd->lines[i] == line)
+			break;
+	}
+
+	if (i == wfd->num_lines) {
+		errno = ENOENT;
+		return -1;
+	}
+
+	wfd->lines[i] = wfd->lines[--wfd->num_lines];
+	waiter->num_lines--;
+
+	if (wfd->num_lines == 0) {
+		epoll_ctl(waiter->epfd, EPOLL_CTL_DEL, fd, NULL);
+		waiter_clear_peeked(waiter, wfd);
+		*wfdptr = wfd->next;
+		free(wfd);
+	}
+
+	return 0;
+}
+
+int gpiod_event_waiter_get_fd(struct gpiod_event_waiter *waiter)
+{
+	return waiter->epfd;
+}
+
+static int timespec_to_ms(const struct timespec *ts)
+{
+	long long ms;
+
+	if (!ts)
+		return -1;
+
+	/* Round up - never return before the timeout expires. */
+	ms = (long long)ts->tv_sec * 1000 + (ts->tv_nsec + 999999) / 1000000;
+
+	return ms > INT_MAX ? INT_MAX : (int)ms;
+}
+
+static int waiter_epoll_wait(struct gpiod_event_waiter *waiter,
+			     struct epoll_event *events, int max_events,
+			     const struct timespec *timeout)
+{
+#ifdef HAVE_EPOLL_PWAIT2
+	int rv;
+
+	rv = epoll_pwait2(waiter->epfd, events, max_events, timeout, NULL);
+	if (rv >= 0 || errno != ENOSYS)
+		return rv;
+#endif /* HAVE_EPOLL_PWAIT2 */
+
+	return epoll_pwait(waiter->epfd, events, max_events,
+			   timespec_to_ms(timeout), NULL);
+}
+
+/* Check which records still have peeked events left unread by the user. */
+static bool waiter_check_peeked(struct gpiod_event_waiter *waiter)
+{
+	struct waiter_fd *wfd;
+	bool pending = false;
+
+	for (wfd = waiter->fds; wfd && waiter->num_peeked; wfd = wfd->next) {
+		if (!wfd->peeked)
+			continue;
+
+		if (line_event_pending(wfd->lines[0])) {
+			wfd->ready = true;
+			pending = true;
+		} else {
+			waiter_clear_peeked(waiter, wfd);
+		}
+	}
+
+	return pending;
+}
+
+static void waiter_bulk_add(struct gpiod_line_bulk *bulk,
+			    struct gpiod_line *line)
+{
+	if (gpiod_line_bulk_num_lines(bulk) < GPIOD_LINE_BULK_MAX_LINES)
+		gpiod_line_bulk_add(bulk, line);
+}
+
+static int waiter_report(struct gpiod_event_waiter *waiter,
+			 struct waiter_fd *wfd, struct gpiod_line_bulk *bulk)
+{
+	const struct gpiod_line_event *events;
+	unsigned int i, num_added;
+	int num_events, j;
+
+	if (wfd->num_lines == 1) {
+		waiter_bulk_add(bulk, wfd->lines[0]);
+		return 0;
+	}
+
+	num_events = line_event_peek(wfd->lines[0], &events);
+	if (num_events < 0)
+		return -1;
+
+	if (!wfd->peeked) {
+		wfd->peeked = true;
+		waiter->num_peeked++;
+	}
+
+	num_added = gpiod_line_bulk_num_lines(bulk);
+
+	for (i = 0; i < wfd->num_lines; i++) {
+		for (j = 0; j < num_events; j++) {
+			if (events[j].offset ==
+			    gpiod_line_offset(wfd->lines[i])) {
+				waiter_bulk_add(bulk, wfd->lines[i]);
+				break;
+			}
+		}
+	}
+
+	/*
+	 * The events belong to lines of the request which were not added to
+	 * the waiter. Reading any of its lines returns them.
+	 */
+	if (num_added == gpiod_line_bulk_num_lines(bulk))
+		waiter_bulk_add(bulk, wfd->lines[0]);
+
+	return 0;
+}
+
+int gpiod_event_waiter_wait(struct gpiod_event_waiter *waiter,
+			    const struct timespec *timeout,
+			    struct gpiod_line_bulk *event_bulk)
+{
+	struct epoll_event events[GPIOD_LINE_BULK_MAX_LINES];
+	struct timespec no_wait = { 0, 0 };
+	struct waiter_fd *wfd;
+	bool pending = false;
+	int rv, i;
+
+	if (!waiter->num_lines) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (waiter->num_peeked)
+		pending = waiter_check_peeked(waiter);
+
+	rv = waiter_epoll_wait(waiter, events, GPIOD_LINE_BULK_MAX_LINES,
+			       pending ? &no_wait : timeout);
+	if (rv < 0)
+		return -1;
+	else if (rv == 0 && !pending)
+		return 0;
+
+	for (i = 0; i < rv; i++) {
+		wfd = events[i].data.ptr;
+		wfd->ready = true;
+	}
+
+	if (event_bulk)
+		gpiod_line_bulk_init(event_bulk);
+
+	rv = 0;
+	for (wfd = waiter->fds; wfd; wfd = wfd->next) {
+		if (!wfd->ready)
+			continue;
+
+		wfd->ready = false;
+		if (event_bulk && rv == 0)
+			rv = waiter_report(waiter, wfd, event_bulk);
+	}
+
+	return rv < 0 ? -1 : 1;
+}
@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Timed playback of preloaded output waveforms. */
+
+#include <errno.h>
+#include <gpiod.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * The playback thread sleeps until the deadline of every step on an absolute
+ * CLOCK_MONOTONIC time, so errors don't accumulate over the waveform. All the
+ * checks and conversions are done when the waveform is created: playing a
+ * step is a single ioctl() on a prepared request.
+ */
+struct gpiod_waveform {
+	struct gpiod_line_prepared *prepared;
+	struct gpiod_waveform_step *steps;
+	unsigned int num_steps;
+
+	int sched_policy;
+	int sched_priority;
+	int cpu;
+	uint64_t spin_ns;
+
+	uint64_t start_ns;
+	struct gpiod_waveform_stats stats;
+	int error;
+	bool stop;
+
+	int donefd;
+	pthread_t thread;
+	bool running;
+};
+
+#define NSEC_PER_SEC		1000000000ULL
+
+static uint64_t waveform_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+struct gpiod_waveform *
+gpiod_waveform_new(struct gpiod_line_bulk *bulk,
+		   const struct gpiod_waveform_step *steps,
+		   unsigned int num_steps)
+{
+	struct gpiod_waveform *waveform;
+	unsigned int i;
+
+	if (!num_steps) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	for (i = 1; i < num_steps; i++) {
+		if (steps[i].time < steps[i - 1].time) {
+			errno = EINVAL;
+			return NULL;
+		}
+	}
+
+	waveform = malloc(sizeof(*waveform));
+	if (!waveform)
+		return NULL;
+
+	memset(waveform, 0, sizeof(*waveform));
+	waveform->donefd = -1;
+	waveform->sched_policy = SCHED_OTHER;
+	waveform->cpu = -1;
+	waveform->num_steps = num_steps;
+
+	waveform->steps = malloc(sizeof(*steps) * num_steps);
+	if (!waveform->steps)
+		goto err_free;
+
+	memcpy(waveform->steps, steps, sizeof(*steps) * num_steps);
+
+	waveform->donefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (waveform->donefd < 0)
+		goto err_free;
+
+	waveform->prepared = gpiod_line_prepared_new(bulk);
+	if (!waveform->prepared)
+		goto err_free;
+
+	return waveform;
+
+err_free:
+	gpiod_waveform_free(waveform);
+	return NULL;
+}
+
+void gpiod_waveform_free(struct gpiod_waveform *waveform)
+{
+	gpiod_waveform_stop(waveform);
+
+	if (waveform->prepared)
+		gpiod_line_prepared_free(waveform->prepared);
+	if (waveform->donefd >= 0)
+		close(waveform->donefd);
+
+	free(waveform->steps);
+	free(waveform);
+}
+
+int gpiod_waveform_set_sched(struct gpiod_waveform *waveform,
+			     int policy, int priority)
+{
+	if (waveform->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	waveform->sched_policy = policy;
+	waveform->sched_priority = priority;
+
+	return 0;
+}
+
+int gpiod_waveform_set_cpu(struct gpiod_waveform *waveform, int cpu)
+{
+	if (waveform->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (cpu >= CPU_SETSIZE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	waveform->cpu = cpu;
+
+	return 0;
+}
+
+int gpiod_waveform_set_spin(struct gpiod_waveform *waveform, uint64_t spin_ns)
+{
+	if (waveform->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	waveform->spin_ns = spin_ns;
+
+	return 0;
+}
+
+/*
+ * Sleep until given deadline. If a busy-wait tail is configured, wake up that
+ * much earlier and spin on the clock for the rest of the time - this trades
+ * CPU time for not depending on the wake-up latency of the scheduler.
+ */
+static void waveform_wait_until(struct gpiod_waveform *waveform,
+				uint64_t deadline)
+{
+	struct timespec ts;
+	uint64_t wakeup;
+	int rv;
+
+	wakeup = 0;
+	if (deadline > waveform->spin_ns)
+		wakeup = deadline - waveform->spin_ns;
+
+	ts.tv_sec = wakeup / NSEC_PER_SEC;
+	ts.tv_nsec = wakeup % NSEC_PER_SEC;
+
+	/* The sleep is the only point at which the thread can be cancelled. */
+	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+	do {
+		rv = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+	} while (rv == EINTR);
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+	if (waveform->spin_ns) {
+		while (waveform_now() < deadline)
+			;
+	}
+}
+
+static void waveform_update_stats(struct gpiod_waveform_stats *stats,
+				  uint64_t latency)
+{
+	if (!stats->steps || latency < stats->min_latency)
+		stats->min_latency = latency;
+	if (latency > stats->max_latency)
+		stats->max_latency = latency;
+
+	stats->total_latency += latency;
+	stats->steps++;
+}
+
+static void *waveform_thread_func(void *data)
+{
+	struct gpiod_waveform *waveform = data;
+	struct gpiod_waveform_step *step;
+	uint64_t deadline, now;
+	unsigned int i;
+	int rv;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+	for (i = 0; i < waveform->num_steps; i++) {
+		if (__atomic_load_n(&waveform->stop, __ATOMIC_RELAXED))
+			break;
+
+		step = &waveform->steps[i];
+		deadline = waveform->start_ns + step->time;
+
+		waveform_wait_until(waveform, deadline);
+
+		now = waveform_now();
+		rv = gpiod_line_prepared_set_values_mask(waveform->prepared,
+							 step->values);
+		if (rv < 0) {
+			waveform->error = errno;
+			break;
+		}
+
+		/* Record how late the step was played. */
+		waveform_update_stats(&waveform->stats,
+				      now > deadline ? now - deadline : 0);
+	}
+
+	eventfd_write(waveform->donefd, 1);
+
+	return NULL;
+}
+
+int gpiod_waveform_start(struct gpiod_waveform *waveform,
+			 const struct timespec *start)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	cpu_set_t cpuset;
+	eventfd_t count;
+	int rv;
+
+	if (waveform->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (start)
+		waveform->start_ns = start->tv_sec * NSEC_PER_SEC +
+				     start->tv_nsec;
+	else
+		waveform->start_ns = waveform_now();
+
+	memset(&waveform->stats, 0, sizeof(waveform->stats));
+	waveform->error = 0;
+	waveform->stop = false;
+	eventfd_read(waveform->donefd, &count);
+
+	rv = pthread_attr_init(&attr);
+	if (rv) {
+		errno = rv;
+		return -1;
+	}
+
+	if (waveform->sched_policy != SCHED_OTHER) {
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = waveform->sched_priority;
+
+		rv = pthread_attr_setinheritsched(&attr,
+						  PTHREAD_EXPLICIT_SCHED);
+		if (!rv)
+			rv = pthread_attr_setschedpolicy(&attr,
+						waveform->sched_policy);
+		if (!rv)
+			rv = pthread_attr_setschedparam(&attr, &param);
+		if (rv)
+			goto out;
+	}
+
+	if (waveform->cpu >= 0) {
+		CPU_ZERO(&cpuset);
+		CPU_SET(waveform->cpu, &cpuset);
+
+		rv = pthread_attr_setaffinity_np(&attr, sizeof(cpuset),
+						 &cpuset);
+		if (rv)
+			goto out;
+	}
+
+	rv = pthread_create(&waveform->thread, &attr,
+			    waveform_thread_func, waveform);
+	if (!rv)
+		waveform->running = true;
+
+out:
+	pthread_attr_destroy(&attr);
+	if (rv) {
+		errno = rv;
+		return -1;
+	}
+
+	return 0;
+}
+
+void gpiod_waveform_stop(struct gpiod_waveform *waveform)
+{
+	if (!waveform->running)
+		return;
+
+	__atomic_store_n(&waveform->stop, true, __ATOMIC_RELAXED);
+	pthread_cancel(waveform->thread);
+	pthread_join(waveform->thread, NULL);
+
+	waveform->running = false;
+}
+
+int gpiod_waveform_wait(struct gpiod_waveform *waveform,
+			const struct timespec *timeout)
+{
+	struct pollfd pfd;
+	int rv;
+
+	if (!waveform->running) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.fd = waveform->donefd;
+	pfd.events = POLLIN;
+
+	rv = ppoll(&pfd, 1, timeout, NULL);
+	if (rv <= 0)
+		return rv;
+
+	/* The thread is done, reap it so that the stats can be read. */
+	pthread_join(waveform->thread, NULL);
+	waveform->running = false;
+
+	if (waveform->error) {
+		errno = waveform->error;
+		return -1;
+	}
+
+	return 1;
+}
+
+int gpiod_waveform_get_stats(struct gpiod_waveform *waveform,
+			     struct gpiod_waveform_stats *stats)
+{
+	if (waveform->running) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	*stats = waveform->stats;
+
+	return 0;
+}
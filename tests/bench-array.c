@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the per-line cost of requesting, reading and setting line arrays of
+ * growing size. Arrays are split into kernel line handles of
+ * GPIOD_LINE_BULK_MAX_LINES lines each, so the cost per line should stay flat
+ * as the array grows past the 64-line limit of a single bulk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		512
+#define DEF_ITERATIONS		10000
+
+static const unsigned int line_counts[] = { 64, 128, 256, 512 };
+
+enum {
+	OP_REQUEST,
+	OP_GET,
+	OP_SET,
+};
+
+static const char *const op_names[] = {
+	[OP_REQUEST] = "request + release",
+	[OP_GET] = "get",
+	[OP_SET] = "set",
+};
+
+static void request_array(struct gpiod_line_array *array, int op)
+{
+	struct gpiod_line_request_config config;
+	int rv;
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = BENCH_CONSUMER;
+	config.request_type = op == OP_SET
+				? GPIOD_LINE_REQUEST_DIRECTION_OUTPUT
+				: GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+
+	rv = gpiod_line_array_request(array, &config, NULL);
+	if (rv)
+		bench_die_perr("error requesting the line array");
+}
+
+static void run(struct gpiod_chip *chip, unsigned int num_lines,
+		unsigned int iterations, int op)
+{
+	static int values[NUM_LINES];
+	struct gpiod_line_array *array;
+	uint64_t start, elapsed;
+	unsigned int i, j;
+	char name[64];
+	int rv;
+
+	array = gpiod_line_array_new();
+	if (!array)
+		bench_die_perr("error creating the line array");
+
+	for (i = 0; i < num_lines; i++) {
+		rv = gpiod_line_array_add(array, gpiod_chip_get_line(chip, i));
+		if (rv)
+			bench_die_perr("error adding line to the array");
+	}
+
+	if (op != OP_REQUEST)
+		request_array(array, op);
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		if (op == OP_REQUEST) {
+			request_array(array, op);
+			gpiod_line_array_release(array);
+			continue;
+		}
+
+		if (op == OP_GET) {
+			rv = gpiod_line_array_get_values(array, values);
+		} else {
+			for (j = 0; j < num_lines; j++)
+				values[j] = i & 1;
+			rv = gpiod_line_array_set_values(array, values);
+		}
+		if (rv)
+			bench_die_perr("error accessing line values");
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	/* Report the cost per line, not per call. */
+	snprintf(name, sizeof(name), "%s, %u lines", op_names[op], num_lines);
+	bench_report(name, (uint64_t)iterations * num_lines, elapsed);
+
+	gpiod_line_array_release(array);
+	gpiod_line_array_free(array);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, line_counts[i], iterations, OP_REQUEST);
+		run(chip, line_counts[i], iterations, OP_GET);
+		run(chip, line_counts[i], iterations, OP_SET);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
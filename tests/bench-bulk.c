@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the latency and the CPU time of reading and setting the values of
+ * a full 64-line bulk. Apart from the ioctl() itself, the cost is dominated
+ * by the loops over the line objects, which only touch the densely packed
+ * request state and never the line info.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		GPIOD_LINE_BULK_MAX_LINES
+#define DEF_ITERATIONS		100000
+
+enum {
+	OP_GET,
+	OP_SET,
+};
+
+static void run(struct gpiod_line_bulk *bulk, unsigned int iterations, int op)
+{
+	uint64_t start, cpu_start, elapsed, cpu;
+	int values[NUM_LINES] = { 0 };
+	unsigned int i, j;
+	int rv;
+
+	if (op == OP_GET)
+		rv = gpiod_line_request_bulk_input(bulk, BENCH_CONSUMER);
+	else
+		rv = gpiod_line_request_bulk_output(bulk, BENCH_CONSUMER, NULL);
+	if (rv)
+		bench_die_perr("error requesting lines");
+
+	start = bench_now_ns();
+	cpu_start = bench_cpu_ns();
+
+	for (i = 0; i < iterations; i++) {
+		if (op == OP_GET) {
+			rv = gpiod_line_get_value_bulk(bulk, values);
+		} else {
+			for (j = 0; j < NUM_LINES; j++)
+				values[j] = i & 1;
+			rv = gpiod_line_set_value_bulk(bulk, values);
+		}
+		if (rv)
+			bench_die_perr("error accessing line values");
+	}
+
+	cpu = bench_cpu_ns() - cpu_start;
+	elapsed = bench_now_ns() - start;
+
+	bench_report_cpu(op == OP_GET ? "get, 64 lines" : "set, 64 lines",
+			 iterations, elapsed, cpu);
+
+	gpiod_line_release_bulk(bulk);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations;
+	struct gpiod_line_bulk bulk;
+	struct gpiod_chip *chip;
+	int rv;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	rv = gpiod_chip_get_all_lines(chip, &bulk);
+	if (rv)
+		bench_die_perr("error retrieving lines");
+
+	run(&bulk, iterations, OP_GET);
+	run(&bulk, iterations, OP_SET);
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
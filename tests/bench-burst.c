@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure how well bursts of edges are absorbed while the consumer is busy:
+ * a burst is generated on a line nobody is reading and only collected once
+ * it's over. Without a drain the events must fit in the kernel FIFO of the
+ * line, with an event drain they're moved to its ring as they arrive. The
+ * events which were not received were dropped either by the kernel or, with
+ * the drain, because the ring overflowed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bench-common.h"
+
+#define DEF_ITERATIONS		10
+#define RING_SIZE		4096
+#define MAX_EVENTS		64
+
+static const unsigned int burst_sizes[] = { 16, 64, 256, 1024 };
+
+/* The simulated line value persists across the runs. */
+static int value;
+
+static void burst(int event_fd, unsigned int num_edges)
+{
+	struct timespec settle = { 0, 50000000 };
+	unsigned int i;
+
+	for (i = 0; i < num_edges; i++) {
+		value = !value;
+		bench_event_set(event_fd, value);
+	}
+
+	/* Give the kernel (and the drain thread) time to catch up. */
+	nanosleep(&settle, NULL);
+}
+
+static uint64_t collect_direct(struct gpiod_line *line)
+{
+	struct gpiod_line_event events[MAX_EVENTS];
+	struct timespec ts = { 0, 0 };
+	uint64_t received = 0;
+	int rv;
+
+	for (;;) {
+		rv = gpiod_line_event_wait(line, &ts);
+		if (rv < 0)
+			bench_die_perr("error waiting for events");
+		else if (rv == 0)
+			return received;
+
+		rv = gpiod_line_event_read_multiple(line, events, MAX_EVENTS);
+		if (rv < 0)
+			bench_die_perr("error reading events");
+
+		received += rv;
+	}
+}
+
+static uint64_t collect_drain(struct gpiod_event_drain *drain)
+{
+	struct gpiod_line_event events[MAX_EVENTS];
+	uint64_t received = 0;
+	int rv;
+
+	for (;;) {
+		rv = gpiod_event_drain_pop(drain, events, NULL, MAX_EVENTS);
+		if (rv == 0)
+			return received;
+
+		received += rv;
+	}
+}
+
+static void run(struct gpiod_chip *chip, int event_fd, unsigned int num_edges,
+		unsigned int iterations, bool use_drain)
+{
+	struct gpiod_event_drain *drain = NULL;
+	uint64_t sent, received = 0;
+	struct gpiod_line *line;
+	unsigned int i;
+	char name[64];
+	int rv;
+
+	line = gpiod_chip_get_line(chip, 0);
+	if (!line)
+		bench_die_perr("error retrieving line");
+
+	rv = gpiod_line_request_both_edges_events(line, BENCH_CONSUMER);
+	if (rv)
+		bench_die_perr("error requesting line");
+
+	if (use_drain) {
+		drain = gpiod_event_drain_new(RING_SIZE);
+		if (!drain ||
+		    gpiod_event_drain_add_line(drain, line) ||
+		    gpiod_event_drain_start(drain))
+			bench_die_perr("error setting up the event drain");
+	}
+
+	for (i = 0; i < iterations; i++) {
+		burst(event_fd, num_edges);
+
+		if (use_drain)
+			received += collect_drain(drain);
+		else
+			received += collect_direct(line);
+	}
+
+	sent = (uint64_t)iterations * num_edges;
+
+	snprintf(name, sizeof(name), "%s, bursts of %u",
+		 use_drain ? "drain" : "direct", num_edges);
+	printf("%-40s %10llu sent %10llu received %10llu dropped",
+	       name, (unsigned long long)sent,
+	       (unsigned long long)received,
+	       (unsigned long long)(sent - received));
+
+	if (use_drain) {
+		gpiod_event_drain_stop(drain);
+		printf(" (%llu ring overruns)",
+		       (unsigned long long)gpiod_event_drain_overruns(drain));
+		gpiod_event_drain_free(drain);
+	}
+
+	printf("\n");
+
+	gpiod_line_release(line);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = 1, iterations, i;
+	struct gpiod_chip *chip;
+	int event_fd;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+	event_fd = bench_event_fd_open(0, 0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(burst_sizes); i++) {
+		run(chip, event_fd, burst_sizes[i], iterations, false);
+		run(chip, event_fd, burst_sizes[i], iterations, true);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
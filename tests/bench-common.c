@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libkmod.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench-common.h"
+
+#define BENCH_CHIP_TIMEOUT_MS	5000
+
+static struct {
+	struct kmod_ctx *module_ctx;
+	struct kmod_module *module;
+	bool loaded;
+} globals;
+
+void bench_die(const char *fmt, ...)
+{
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "FATAL: ");
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, "\n");
+	va_end(va);
+
+	exit(EXIT_FAILURE);
+}
+
+void bench_die_perr(const char *fmt, ...)
+{
+	int errnum = errno;
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "FATAL: ");
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, ": %s\n", strerror(errnum));
+	va_end(va);
+
+	exit(EXIT_FAILURE);
+}
+
+unsigned int bench_parse_iterations(int argc, char **argv,
+				    unsigned int def_iterations)
+{
+	unsigned long iterations;
+	char *end;
+
+	if (argc < 2)
+		return def_iterations;
+
+	iterations = strtoul(argv[1], &end, 10);
+	if (*end != '\0' || iterations == 0 || iterations > UINT32_MAX)
+		bench_die("invalid iteration count: %s", argv[1]);
+
+	return iterations;
+}
+
+static void mockup_unload(void)
+{
+	if (globals.loaded)
+		kmod_module_remove_module(globals.module, 0);
+
+	kmod_module_unref(globals.module);
+	kmod_unref(globals.module_ctx);
+}
+
+void bench_mockup_load(const unsigned int *num_lines, unsigned int num_chips)
+{
+	char modarg[256];
+	unsigned int i;
+	size_t len = 0;
+	int rv;
+
+	globals.module_ctx = kmod_new(NULL, NULL);
+	if (!globals.module_ctx)
+		bench_die_perr("error creating kernel module context");
+
+	rv = kmod_module_new_from_name(globals.module_ctx,
+				       "gpio-mockup", &globals.module);
+	if (rv)
+		bench_die_perr("error allocating module info");
+
+	atexit(mockup_unload);
+
+	/* Don't run against chips left behind by somebody else. */
+	if (kmod_module_get_initstate(globals.module) == KMOD_MODULE_LIVE) {
+		rv = kmod_module_remove_module(globals.module, 0);
+		if (rv)
+			bench_die_perr("gpio-mockup is in use");
+	}
+
+	len += snprintf(modarg, sizeof(modarg), "gpio_mockup_ranges=");
+	for (i = 0; i < num_chips && len < sizeof(modarg); i++)
+		len += snprintf(modarg + len, sizeof(modarg) - len, "-1,%u%s",
+				num_lines[i], i < num_chips - 1 ? "," : "");
+	if (len >= sizeof(modarg))
+		bench_die("too many mockup chips");
+
+	rv = kmod_module_probe_insert_module(globals.module, 0,
+					     modarg, NULL, NULL, NULL);
+	if (rv)
+		bench_die_perr("unable to load gpio-mockup");
+
+	globals.loaded = true;
+
+	/* The device nodes show up asynchronously. */
+	for (i = 0; i < num_chips; i++)
+		gpiod_chip_close(bench_chip_open(i));
+}
+
+struct gpiod_chip *bench_chip_open(unsigned int index)
+{
+	struct timespec ts = { 0, 10000000 };
+	struct gpiod_chip *chip;
+	char label[32];
+	unsigned int i;
+
+	snprintf(label, sizeof(label), "gpio-mockup-%c", 'A' + index);
+
+	for (i = 0; i < BENCH_CHIP_TIMEOUT_MS / 10; i++) {
+		chip = gpiod_chip_open_by_label(label);
+		if (chip)
+			return chip;
+
+		nanosleep(&ts, NULL);
+	}
+
+	bench_die("timeout waiting for %s", label);
+}
+
+int bench_event_fd_open(unsigned int chip_index, unsigned int offset)
+{
+	char path[128];
+	int fd;
+
+	snprintf(path, sizeof(path),
+		 "/sys/kernel/debug/gpio-mockup-event/gpio-mockup-%c/%u",
+		 'A' + chip_index, offset);
+
+	fd = open(path, O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		bench_die_perr("error opening %s", path);
+
+	return fd;
+}
+
+void bench_event_set(int fd, int value)
+{
+	ssize_t wr;
+
+	wr = pwrite(fd, value ? "1" : "0", 1, 0);
+	if (wr != 1)
+		bench_die_perr("error writing to the gpio event file");
+}
+
+static uint64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t bench_now_ns(void)
+{
+	return clock_ns(CLOCK_MONOTONIC);
+}
+
+uint64_t bench_cpu_ns(void)
+{
+	return clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void bench_report(const char *name, uint64_t ops, uint64_t elapsed_ns)
+{
+	printf("%-40s %10llu ops %10.0f ns/op %12.0f ops/s\n", name,
+	       (unsigned long long)ops, (double)elapsed_ns / ops,
+	       ops * 1000000000.0 / elapsed_ns);
+}
+
+void bench_report_cpu(const char *name, uint64_t ops,
+		      uint64_t elapsed_ns, uint64_t cpu_ns)
+{
+	printf("%-40s %10llu ops %10.0f ns/op %12.0f ops/s %8.0f cpu ns/op\n",
+	       name, (unsigned long long)ops, (double)elapsed_ns / ops,
+	       ops * 1000000000.0 / elapsed_ns, (double)cpu_ns / ops);
+}
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/* Helpers shared by the benchmark programs. */
+
+#ifndef __GPIOD_BENCH_COMMON_H__
+#define __GPIOD_BENCH_COMMON_H__
+
+#include <gpiod.h>
+#include <stdint.h>
+
+#define BENCH_CONSUMER		"gpiod-bench"
+
+#define BENCH_PRINTF(fmt, arg)	__attribute__((format(printf, fmt, arg)))
+#define BENCH_NORETURN		__attribute__((noreturn))
+
+#define BENCH_ARRAY_SIZE(x)	(sizeof(x) / sizeof(*(x)))
+
+void bench_die(const char *fmt, ...) BENCH_PRINTF(1, 2) BENCH_NORETURN;
+void bench_die_perr(const char *fmt, ...) BENCH_PRINTF(1, 2) BENCH_NORETURN;
+
+/*
+ * Parse the optional iteration count passed as the only argument of the
+ * benchmark program.
+ */
+unsigned int bench_parse_iterations(int argc, char **argv,
+				    unsigned int def_iterations);
+
+/*
+ * Load the gpio-mockup module with given number of chips and lines and wait
+ * for the chips to appear. The module is unloaded when the program exits.
+ */
+void bench_mockup_load(const unsigned int *num_lines, unsigned int num_chips);
+struct gpiod_chip *bench_chip_open(unsigned int index);
+
+/*
+ * Open the debugfs file used to simulate edges on a mockup line and pull the
+ * line up or down through it.
+ */
+int bench_event_fd_open(unsigned int chip_index, unsigned int offset);
+void bench_event_set(int fd, int value);
+
+uint64_t bench_now_ns(void);
+uint64_t bench_cpu_ns(void);
+
+void bench_report(const char *name, uint64_t ops, uint64_t elapsed_ns);
+/* Same as above but also print the CPU time consumed per operation. */
+void bench_report_cpu(const char *name, uint64_t ops,
+		      uint64_t elapsed_ns, uint64_t cpu_ns);
+
+#endif /* __GPIOD_BENCH_COMMON_H__ */
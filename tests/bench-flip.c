@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the latency of switching the direction of requested lines between
+ * input and output in place with gpiod_line_set_config_bulk() against
+ * releasing the lines and requesting them again with the new direction.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		GPIOD_LINE_BULK_MAX_LINES
+#define DEF_ITERATIONS		10000
+
+static const unsigned int line_counts[] = { 1, 16, 64 };
+
+static int flip_rerequest(struct gpiod_line_bulk *bulk, bool output)
+{
+	gpiod_line_release_bulk(bulk);
+
+	if (output)
+		return gpiod_line_request_bulk_output(bulk, BENCH_CONSUMER,
+						      NULL);
+
+	return gpiod_line_request_bulk_input(bulk, BENCH_CONSUMER);
+}
+
+static int flip_set_config(struct gpiod_line_bulk *bulk, bool output)
+{
+	return gpiod_line_set_config_bulk(bulk, output
+					? GPIOD_LINE_REQUEST_DIRECTION_OUTPUT
+					: GPIOD_LINE_REQUEST_DIRECTION_INPUT,
+					  0, NULL);
+}
+
+static void run(struct gpiod_chip *chip, unsigned int num_lines,
+		unsigned int iterations, bool set_config)
+{
+	struct gpiod_line_bulk bulk;
+	uint64_t start, elapsed;
+	unsigned int i;
+	char name[64];
+	int rv;
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	rv = gpiod_line_request_bulk_input(&bulk, BENCH_CONSUMER);
+	if (rv)
+		bench_die_perr("error requesting lines");
+
+	snprintf(name, sizeof(name), "%s, %u lines",
+		 set_config ? "set config" : "release + request", num_lines);
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		if (set_config)
+			rv = flip_set_config(&bulk, !(i & 1));
+		else
+			rv = flip_rerequest(&bulk, !(i & 1));
+		if (rv && set_config && i == 0 &&
+		    (errno == ENOTSUP || errno == ENOTTY)) {
+			printf("%-40s not supported\n", name);
+			gpiod_line_release_bulk(&bulk);
+			return;
+		}
+		if (rv)
+			bench_die_perr("error changing the direction");
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	bench_report(name, iterations, elapsed);
+
+	gpiod_line_release_bulk(&bulk);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, line_counts[i], iterations, false);
+		run(chip, line_counts[i], iterations, true);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Compare the per-call latency of reading and setting lines spread across
+ * three chips using a single line group against using three separate bulks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-common.h"
+
+#define NUM_CHIPS		3
+#define NUM_LINES		8
+#define DEF_ITERATIONS		100000
+
+enum {
+	OP_GET,
+	OP_SET,
+};
+
+struct setup {
+	struct gpiod_chip *chips[NUM_CHIPS];
+	struct gpiod_line_bulk bulks[NUM_CHIPS];
+	struct gpiod_line_group *group;
+};
+
+static void fill_values(int *values, unsigned int num_values, int value)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_values; i++)
+		values[i] = value;
+}
+
+static void setup_lines(struct setup *setup)
+{
+	unsigned int i, j;
+	int rv;
+
+	setup->group = gpiod_line_group_new();
+	if (!setup->group)
+		bench_die_perr("error creating the line group");
+
+	for (i = 0; i < NUM_CHIPS; i++) {
+		setup->chips[i] = bench_chip_open(i);
+		gpiod_line_bulk_init(&setup->bulks[i]);
+
+		for (j = 0; j < NUM_LINES; j++) {
+			gpiod_line_bulk_add(&setup->bulks[i],
+				gpiod_chip_get_line(setup->chips[i], j));
+
+			rv = gpiod_line_group_add(setup->group,
+				gpiod_chip_get_line(setup->chips[i], j));
+			if (rv)
+				bench_die_perr("error adding line to the group");
+		}
+	}
+}
+
+static void request_bulks(struct setup *setup, int op)
+{
+	unsigned int i;
+	int rv;
+
+	for (i = 0; i < NUM_CHIPS; i++) {
+		if (op == OP_GET)
+			rv = gpiod_line_request_bulk_input(&setup->bulks[i],
+							   BENCH_CONSUMER);
+		else
+			rv = gpiod_line_request_bulk_output(&setup->bulks[i],
+							    BENCH_CONSUMER,
+							    NULL);
+		if (rv)
+			bench_die_perr("error requesting lines");
+	}
+}
+
+static void release_bulks(struct setup *setup)
+{
+	unsigned int i;
+
+	for (i = 0; i < NUM_CHIPS; i++)
+		gpiod_line_release_bulk(&setup->bulks[i]);
+}
+
+static void request_group(struct setup *setup, int op)
+{
+	struct gpiod_line_request_config config;
+	int rv;
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = BENCH_CONSUMER;
+	config.request_type = op == OP_GET
+				? GPIOD_LINE_REQUEST_DIRECTION_INPUT
+				: GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+
+	rv = gpiod_line_group_request(setup->group, &config, NULL);
+	if (rv)
+		bench_die_perr("error requesting the line group");
+}
+
+static void run_bulks(struct setup *setup, unsigned int iterations, int op)
+{
+	int values[NUM_CHIPS][NUM_LINES] = { { 0 } };
+	uint64_t start, elapsed;
+	unsigned int i, j;
+	int rv;
+
+	request_bulks(setup, op);
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		for (j = 0; j < NUM_CHIPS; j++) {
+			if (op == OP_GET) {
+				rv = gpiod_line_get_value_bulk(
+						&setup->bulks[j], values[j]);
+			} else {
+				fill_values(values[j], NUM_LINES, i & 1);
+				rv = gpiod_line_set_value_bulk(
+						&setup->bulks[j], values[j]);
+			}
+			if (rv)
+				bench_die_perr("error accessing line values");
+		}
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	bench_report(op == OP_GET ? "get, three bulks" : "set, three bulks",
+		     iterations, elapsed);
+
+	release_bulks(setup);
+}
+
+static void run_group(struct setup *setup, unsigned int iterations, int op)
+{
+	int values[NUM_CHIPS * NUM_LINES] = { 0 };
+	uint64_t start, elapsed;
+	unsigned int i;
+	int rv;
+
+	request_group(setup, op);
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		if (op == OP_GET) {
+			rv = gpiod_line_group_get_values(setup->group, values);
+		} else {
+			fill_values(values, NUM_CHIPS * NUM_LINES, i & 1);
+			rv = gpiod_line_group_set_values(setup->group, values);
+		}
+		if (rv)
+			bench_die_perr("error accessing line values");
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	bench_report(op == OP_GET ? "get, line group" : "set, line group",
+		     iterations, elapsed);
+
+	gpiod_line_group_release(setup->group);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines[NUM_CHIPS], iterations, i;
+	struct setup setup;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	for (i = 0; i < NUM_CHIPS; i++)
+		num_lines[i] = NUM_LINES;
+
+	bench_mockup_load(num_lines, NUM_CHIPS);
+	setup_lines(&setup);
+
+	run_bulks(&setup, iterations, OP_GET);
+	run_group(&setup, iterations, OP_GET);
+	run_bulks(&setup, iterations, OP_SET);
+	run_group(&setup, iterations, OP_SET);
+
+	gpiod_line_group_free(setup.group);
+	for (i = 0; i < NUM_CHIPS; i++)
+		gpiod_chip_close(setup.chips[i]);
+
+	return EXIT_SUCCESS;
+}
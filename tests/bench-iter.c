@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the time it takes a chip iterator to return the first chip with
+ * chips opened lazily, as the iterator reaches them, and with all chips
+ * opened upfront (GPIOD_CHIP_ITER_FLAG_EAGER). The former is what lookups
+ * which stop at the first match - like gpiod_line_find() - pay.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_CHIPS		8
+#define DEF_ITERATIONS		10000
+
+static void run(unsigned int iterations, int flags)
+{
+	struct gpiod_chip_iter *iter;
+	uint64_t start, elapsed;
+	struct gpiod_chip *chip;
+	unsigned int i;
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		iter = gpiod_chip_iter_new_flags(flags);
+		if (!iter)
+			bench_die_perr("error creating the chip iterator");
+
+		chip = gpiod_chip_iter_next(iter);
+		if (!chip)
+			bench_die_perr("error opening the first chip");
+
+		gpiod_chip_iter_free(iter);
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	bench_report(flags & GPIOD_CHIP_ITER_FLAG_EAGER
+				? "first chip, eager iterator"
+				: "first chip, lazy iterator",
+		     iterations, elapsed);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines[NUM_CHIPS], iterations, i;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	for (i = 0; i < NUM_CHIPS; i++)
+		num_lines[i] = 8;
+
+	bench_mockup_load(num_lines, NUM_CHIPS);
+
+	run(iterations, 0);
+	run(iterations, GPIOD_CHIP_ITER_FLAG_EAGER);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the number of chip open/close cycles per second with the default
+ * check of the device file against sysfs and with the check skipped using
+ * GPIOD_CHIP_OPEN_FLAG_NO_VERIFY.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define DEF_ITERATIONS		100000
+
+static void run(const char *path, unsigned int iterations, int flags)
+{
+	struct gpiod_chip *chip;
+	uint64_t start, elapsed;
+	unsigned int i;
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		chip = gpiod_chip_open_flags(path, flags);
+		if (!chip)
+			bench_die_perr("error opening %s", path);
+
+		gpiod_chip_close(chip);
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	bench_report(flags & GPIOD_CHIP_OPEN_FLAG_NO_VERIFY
+				? "open + close, no verification"
+				: "open + close, verified",
+		     iterations, elapsed);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = 8, iterations;
+	struct gpiod_chip *chip;
+	char path[64];
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+
+	chip = bench_chip_open(0);
+	snprintf(path, sizeof(path), "/dev/%s", gpiod_chip_name(chip));
+	gpiod_chip_close(chip);
+
+	run(path, iterations, 0);
+	run(path, iterations, GPIOD_CHIP_OPEN_FLAG_NO_VERIFY);
+
+	return EXIT_SUCCESS;
+}
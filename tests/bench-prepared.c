@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Compare the toggle rate of output lines set with prepared requests against
+ * gpiod_line_set_value() and gpiod_line_set_value_bulk().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		8
+#define DEF_ITERATIONS		200000
+
+static const unsigned int line_counts[] = { 1, 8 };
+
+enum {
+	SET_VALUE_BULK,
+	SET_PREPARED,
+	SET_PREPARED_MASK,
+};
+
+static const char *const mode_names[] = {
+	[SET_VALUE_BULK] = "gpiod_line_set_value_bulk()",
+	[SET_PREPARED] = "prepared, values array",
+	[SET_PREPARED_MASK] = "prepared, bitmask",
+};
+
+static void run(struct gpiod_chip *chip, unsigned int num_lines,
+		unsigned int iterations, int mode)
+{
+	struct gpiod_line_prepared *prepared;
+	int values[NUM_LINES] = { 0 };
+	struct gpiod_line_bulk bulk;
+	uint64_t start, elapsed, mask;
+	unsigned int i, j;
+	char name[64];
+	int rv;
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	rv = gpiod_line_request_bulk_output(&bulk, BENCH_CONSUMER, values);
+	if (rv)
+		bench_die_perr("error requesting lines");
+
+	prepared = gpiod_line_prepared_new(&bulk);
+	if (!prepared)
+		bench_die_perr("error preparing the request");
+
+	mask = (1ULL << num_lines) - 1;
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		for (j = 0; j < num_lines; j++)
+			values[j] = i & 1;
+
+		if (mode == SET_PREPARED_MASK)
+			rv = gpiod_line_prepared_set_values_mask(prepared,
+							i & 1 ? mask : 0);
+		else if (mode == SET_PREPARED)
+			rv = gpiod_line_prepared_set_values(prepared, values);
+		else if (num_lines == 1)
+			rv = gpiod_line_set_value(
+				gpiod_line_bulk_get_line(&bulk, 0), values[0]);
+		else
+			rv = gpiod_line_set_value_bulk(&bulk, values);
+		if (rv)
+			bench_die_perr("error setting values");
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	snprintf(name, sizeof(name), "%s, %u lines",
+		 num_lines == 1 && mode == SET_VALUE_BULK
+				? "gpiod_line_set_value()" : mode_names[mode],
+		 num_lines);
+	bench_report(name, iterations, elapsed);
+
+	gpiod_line_prepared_free(prepared);
+	gpiod_line_release_bulk(&bulk);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, line_counts[i], iterations, SET_VALUE_BULK);
+		run(chip, line_counts[i], iterations, SET_PREPARED);
+		run(chip, line_counts[i], iterations, SET_PREPARED_MASK);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
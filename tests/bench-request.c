@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the latency of requesting and releasing 1, 16 and 64 lines. The
+ * line info is only marked stale by a request, so for comparison every line
+ * count is also run with the info of each line re-read right after the
+ * request, which is what every request used to cost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		GPIOD_LINE_BULK_MAX_LINES
+#define DEF_ITERATIONS		10000
+
+static const unsigned int line_counts[] = { 1, 16, 64 };
+
+static void run(struct gpiod_chip *chip, unsigned int num_lines,
+		unsigned int iterations, bool update)
+{
+	struct gpiod_line *line, **lineptr;
+	struct gpiod_line_bulk bulk;
+	uint64_t start, elapsed;
+	unsigned int i;
+	char name[64];
+	int rv;
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		rv = gpiod_line_request_bulk_output(&bulk, BENCH_CONSUMER, NULL);
+		if (rv)
+			bench_die_perr("error requesting lines");
+
+		if (update) {
+			gpiod_line_bulk_foreach_line(&bulk, line, lineptr) {
+				if (gpiod_line_update(line))
+					bench_die_perr("error updating line info");
+			}
+		}
+
+		gpiod_line_release_bulk(&bulk);
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	snprintf(name, sizeof(name), "request + release, %u lines%s",
+		 num_lines, update ? ", info read" : "");
+	bench_report(name, iterations, elapsed);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, line_counts[i], iterations, false);
+		run(chip, line_counts[i], iterations, true);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
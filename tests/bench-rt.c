@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure the latency between an edge and the moment its event can be popped
+ * from an event drain, once with the drain thread using the default
+ * scheduling and once with it running with SCHED_FIFO, pinned to a single CPU
+ * and with its memory locked.
+ *
+ * The latency is the difference between CLOCK_MONOTONIC read right after the
+ * event was popped and the event timestamp which the kernel takes from the
+ * same clock. The main thread busy-polls the ring so that its own wake-up
+ * doesn't add to the result.
+ */
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "bench-common.h"
+
+#define DEF_ITERATIONS		10000
+#define RING_SIZE		64
+#define RT_PRIORITY		80
+#define TIMEOUT_NS		1000000000ULL
+
+/* Bucket i counts the latencies below 2^i microseconds. */
+#define NUM_BUCKETS		16
+
+struct histogram {
+	uint64_t buckets[NUM_BUCKETS + 1];
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+	uint64_t count;
+};
+
+static void histogram_add(struct histogram *hist, uint64_t latency)
+{
+	uint64_t usec = latency / 1000;
+	unsigned int i = 0;
+
+	while (i < NUM_BUCKETS && usec >= (1ULL << i))
+		i++;
+
+	hist->buckets[i]++;
+	hist->total += latency;
+	hist->count++;
+
+	if (latency < hist->min)
+		hist->min = latency;
+	if (latency > hist->max)
+		hist->max = latency;
+}
+
+static void histogram_print(const char *name, const struct histogram *hist)
+{
+	unsigned int i;
+
+	printf("%s\n", name);
+	printf("  min %llu ns, avg %llu ns, max %llu ns\n",
+	       (unsigned long long)hist->min,
+	       (unsigned long long)(hist->total / hist->count),
+	       (unsigned long long)hist->max);
+
+	for (i = 0; i < NUM_BUCKETS; i++) {
+		if (hist->buckets[i])
+			printf("  < %6llu us %10llu\n", 1ULL << i,
+			       (unsigned long long)hist->buckets[i]);
+	}
+
+	if (hist->buckets[NUM_BUCKETS])
+		printf("  >= %5llu us %10llu\n", 1ULL << (NUM_BUCKETS - 1),
+		       (unsigned long long)hist->buckets[NUM_BUCKETS]);
+}
+
+static void pop_event(struct gpiod_event_drain *drain,
+		      struct gpiod_line_event *event)
+{
+	struct timespec no_wait = { 0, 0 };
+	uint64_t start = bench_now_ns();
+
+	while (gpiod_event_drain_pop(drain, event, NULL, 1) == 0) {
+		if (bench_now_ns() - start < TIMEOUT_NS)
+			continue;
+
+		/* Report the error of the drain thread, if any. */
+		if (gpiod_event_drain_wait(drain, &no_wait) < 0)
+			bench_die_perr("error reading events");
+
+		bench_die("timeout waiting for events");
+	}
+}
+
+static void run(struct gpiod_chip *chip, int event_fd,
+		unsigned int iterations, bool rt)
+{
+	struct gpiod_line_event event;
+	struct gpiod_event_drain *drain;
+	struct histogram hist = { .min = UINT64_MAX };
+	struct gpiod_line *line;
+	uint64_t now, ts;
+	unsigned int i;
+	int cpu, rv;
+
+	line = gpiod_chip_get_line(chip, 0);
+	rv = gpiod_line_request_both_edges_events(line, BENCH_CONSUMER);
+	if (rv)
+		bench_die_perr("error requesting line");
+
+	drain = gpiod_event_drain_new(RING_SIZE);
+	if (!drain)
+		bench_die_perr("error creating the event drain");
+
+	if (rt) {
+		/* Pin the drain thread to the last online CPU. */
+		cpu = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+
+		if (gpiod_event_drain_set_sched(drain, SCHED_FIFO,
+						RT_PRIORITY) ||
+		    gpiod_event_drain_set_cpu(drain, cpu) ||
+		    gpiod_event_drain_set_mlock(drain, true))
+			bench_die_perr("error configuring the event drain");
+	}
+
+	if (gpiod_event_drain_add_line(drain, line))
+		bench_die_perr("error adding line to the event drain");
+
+	if (gpiod_event_drain_start(drain))
+		bench_die_perr("error starting the event drain");
+
+	for (i = 0; i < iterations; i++) {
+		bench_event_set(event_fd, !(i & 1));
+		pop_event(drain, &event);
+		now = bench_now_ns();
+
+		ts = event.ts.tv_sec * 1000000000ULL + event.ts.tv_nsec;
+		histogram_add(&hist, now > ts ? now - ts : 0);
+	}
+
+	histogram_print(rt ? "SCHED_FIFO, pinned, mlocked"
+			   : "default scheduling", &hist);
+
+	gpiod_event_drain_free(drain);
+	gpiod_line_release(line);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = 1, iterations;
+	struct gpiod_chip *chip;
+	int event_fd;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+	event_fd = bench_event_fd_open(0, 0);
+
+	run(chip, event_fd, iterations, false);
+
+	/* The drain only locks its own buffers, lock the rest of us too. */
+	if (mlockall(MCL_CURRENT | MCL_FUTURE))
+		bench_die_perr("error locking memory");
+
+	run(chip, event_fd, iterations, true);
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Measure how the aggregate toggle rate scales with the number of threads
+ * each toggling its own line of the same chip through a separate request.
+ * For comparison, every thread count is also run with all value operations
+ * serialized by a global mutex, which is what sharing a chip between threads
+ * required before the library was made thread-safe.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-common.h"
+
+#define MAX_THREADS		16
+#define DEF_ITERATIONS		100000
+
+static const unsigned int thread_counts[] = { 1, 2, 4, 8, 16 };
+
+struct worker {
+	pthread_t thread;
+	struct gpiod_chip *chip;
+	unsigned int offset;
+	unsigned int iterations;
+	bool global_lock;
+};
+
+static pthread_barrier_t barrier;
+static pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *worker_func(void *data)
+{
+	struct worker *worker = data;
+	struct gpiod_line *line;
+	unsigned int i;
+	int rv;
+
+	line = gpiod_chip_get_line(worker->chip, worker->offset);
+	if (!line)
+		bench_die_perr("error retrieving line");
+
+	rv = gpiod_line_request_output(line, BENCH_CONSUMER, 0);
+	if (rv)
+		bench_die_perr("error requesting line");
+
+	/* Start all workers at once... */
+	pthread_barrier_wait(&barrier);
+
+	for (i = 0; i < worker->iterations; i++) {
+		if (worker->global_lock)
+			pthread_mutex_lock(&global_lock);
+
+		rv = gpiod_line_set_value(line, i & 1);
+
+		if (worker->global_lock)
+			pthread_mutex_unlock(&global_lock);
+
+		if (rv)
+			bench_die_perr("error setting value");
+	}
+
+	/* ...and stop the clock once the last one is done. */
+	pthread_barrier_wait(&barrier);
+
+	gpiod_line_release(line);
+
+	return NULL;
+}
+
+static void run(struct gpiod_chip *chip, unsigned int num_threads,
+		unsigned int iterations, bool global_lock)
+{
+	struct worker workers[MAX_THREADS];
+	uint64_t start, elapsed;
+	unsigned int i;
+	char name[64];
+	int rv;
+
+	rv = pthread_barrier_init(&barrier, NULL, num_threads + 1);
+	if (rv)
+		bench_die("error initializing the barrier: %s", strerror(rv));
+
+	for (i = 0; i < num_threads; i++) {
+		workers[i].chip = chip;
+		workers[i].offset = i;
+		workers[i].iterations = iterations;
+		workers[i].global_lock = global_lock;
+
+		rv = pthread_create(&workers[i].thread, NULL,
+				    worker_func, &workers[i]);
+		if (rv)
+			bench_die("error creating thread: %s", strerror(rv));
+	}
+
+	pthread_barrier_wait(&barrier);
+	start = bench_now_ns();
+	pthread_barrier_wait(&barrier);
+	elapsed = bench_now_ns() - start;
+
+	for (i = 0; i < num_threads; i++)
+		pthread_join(workers[i].thread, NULL);
+
+	pthread_barrier_destroy(&barrier);
+
+	snprintf(name, sizeof(name), "%u threads%s", num_threads,
+		 global_lock ? ", global mutex" : "");
+	bench_report(name, (uint64_t)num_threads * iterations, elapsed);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = MAX_THREADS, iterations, i;
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(thread_counts); i++) {
+		run(chip, thread_counts[i], iterations, false);
+		run(chip, thread_counts[i], iterations, true);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Compare the v1 and v2 kernel uAPIs: the time it takes to request and
+ * release lines for events and the event throughput. With v1 every line gets
+ * its own event file descriptor, with v2 the lines of a request can share a
+ * single one (GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD) so that all events are
+ * collected with a single read().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		GPIOD_LINE_BULK_MAX_LINES
+#define DEF_ITERATIONS		5000
+
+static const unsigned int line_counts[] = { 1, 16, 64 };
+
+enum {
+	UAPI_V1,
+	UAPI_V2,
+	UAPI_V2_SHARED,
+};
+
+static const char *const mode_names[] = {
+	[UAPI_V1] = "v1",
+	[UAPI_V2] = "v2",
+	[UAPI_V2_SHARED] = "v2 shared fd",
+};
+
+/* The simulated line values persist across the runs. */
+static int values[NUM_LINES];
+
+static void request(struct gpiod_line_bulk *bulk, int mode)
+{
+	int rv;
+
+	rv = gpiod_line_request_bulk_both_edges_events_flags(bulk,
+				BENCH_CONSUMER, mode == UAPI_V2_SHARED
+				? GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD : 0);
+	if (rv)
+		bench_die_perr("error requesting lines");
+}
+
+static void run_setup(struct gpiod_line_bulk *bulk, unsigned int iterations,
+		      int mode)
+{
+	uint64_t start, elapsed;
+	unsigned int i;
+	char name[64];
+
+	start = bench_now_ns();
+
+	for (i = 0; i < iterations; i++) {
+		request(bulk, mode);
+		gpiod_line_release_bulk(bulk);
+	}
+
+	elapsed = bench_now_ns() - start;
+
+	snprintf(name, sizeof(name), "setup, %s, %u lines", mode_names[mode],
+		 gpiod_line_bulk_num_lines(bulk));
+	bench_report(name, iterations, elapsed);
+}
+
+static unsigned int collect(struct gpiod_line_bulk *bulk, int mode)
+{
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	struct gpiod_line *line, **lineptr;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_bulk ev_bulk;
+	int rv;
+
+	rv = gpiod_line_event_wait_bulk(bulk, &ts, &ev_bulk);
+	if (rv < 0)
+		bench_die_perr("error waiting for events");
+	else if (rv == 0)
+		bench_die("timeout waiting for events");
+
+	/* Any line of a shared request returns the events of all of them. */
+	if (mode == UAPI_V2_SHARED) {
+		rv = gpiod_line_event_read_multiple(
+				gpiod_line_bulk_get_line(&ev_bulk, 0),
+				events, GPIOD_LINE_EVENT_MAX_EVENTS);
+		if (rv < 0)
+			bench_die_perr("error reading events");
+
+		return rv;
+	}
+
+	gpiod_line_bulk_foreach_line(&ev_bulk, line, lineptr) {
+		if (gpiod_line_event_read(line, events))
+			bench_die_perr("error reading event");
+	}
+
+	return gpiod_line_bulk_num_lines(&ev_bulk);
+}
+
+static void run_events(struct gpiod_line_bulk *bulk, const int *event_fds,
+		       unsigned int iterations, int mode)
+{
+	unsigned int num_lines = gpiod_line_bulk_num_lines(bulk);
+	uint64_t start, cpu_start, elapsed = 0, cpu = 0;
+	unsigned int i, j, num_events;
+	struct gpiod_line_bulk wait_bulk;
+	char name[64];
+
+	request(bulk, mode);
+
+	/* All lines of a shared request become readable at once. */
+	if (mode == UAPI_V2_SHARED) {
+		gpiod_line_bulk_init(&wait_bulk);
+		gpiod_line_bulk_add(&wait_bulk,
+				    gpiod_line_bulk_get_line(bulk, 0));
+	} else {
+		wait_bulk = *bulk;
+	}
+
+	for (i = 0; i < iterations; i++) {
+		for (j = 0; j < num_lines; j++) {
+			values[j] = !values[j];
+			bench_event_set(event_fds[j], values[j]);
+		}
+
+		start = bench_now_ns();
+		cpu_start = bench_cpu_ns();
+
+		for (num_events = 0; num_events < num_lines;)
+			num_events += collect(&wait_bulk, mode);
+
+		cpu += bench_cpu_ns() - cpu_start;
+		elapsed += bench_now_ns() - start;
+	}
+
+	snprintf(name, sizeof(name), "events, %s, %u lines", mode_names[mode],
+		 num_lines);
+	bench_report_cpu(name, (uint64_t)iterations * num_lines, elapsed, cpu);
+
+	gpiod_line_release_bulk(bulk);
+}
+
+static void run(struct gpiod_chip *chip, const int *event_fds,
+		unsigned int num_lines, unsigned int iterations, int mode)
+{
+	struct gpiod_line_bulk bulk;
+	unsigned int i;
+
+	if (mode != UAPI_V1 && gpiod_chip_uapi_version(chip) < 2) {
+		printf("%-40s not supported\n", mode_names[mode]);
+		return;
+	}
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	run_setup(&bulk, iterations, mode);
+	run_events(&bulk, event_fds, iterations, mode);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	struct gpiod_chip *chip_v1, *chip_v2;
+	int event_fds[NUM_LINES];
+	char path[64];
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+
+	/* The uAPI version is picked when the chip is opened. */
+	chip_v2 = bench_chip_open(0);
+	snprintf(path, sizeof(path), "/dev/%s", gpiod_chip_name(chip_v2));
+
+	chip_v1 = gpiod_chip_open_flags(path, GPIOD_CHIP_OPEN_FLAG_UAPI_V1);
+	if (!chip_v1)
+		bench_die_perr("error opening %s", path);
+
+	for (i = 0; i < NUM_LINES; i++)
+		event_fds[i] = bench_event_fd_open(0, i);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip_v1, event_fds, line_counts[i], iterations, UAPI_V1);
+		run(chip_v2, event_fds, line_counts[i], iterations, UAPI_V2);
+		run(chip_v2, event_fds, line_counts[i], iterations,
+		    UAPI_V2_SHARED);
+	}
+
+	gpiod_chip_close(chip_v1);
+	gpiod_chip_close(chip_v2);
+
+	return EXIT_SUCCESS;
+}
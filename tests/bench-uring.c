@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Compare the event throughput and the CPU time spent per event of the
+ * io_uring event reader against reading the events after waiting for them
+ * with ppoll() (gpiod_line_event_wait_bulk()) and with epoll (event waiter).
+ *
+ * Every iteration generates an edge on each monitored line and then collects
+ * all the resulting events. Only the collection is measured.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		64
+#define DEF_ITERATIONS		5000
+
+static const unsigned int line_counts[] = { 1, 8, 64 };
+
+enum {
+	READ_PPOLL,
+	READ_EPOLL,
+	READ_URING,
+};
+
+static const char *const mode_names[] = {
+	[READ_PPOLL] = "ppoll",
+	[READ_EPOLL] = "epoll (event waiter)",
+	[READ_URING] = "io_uring",
+};
+
+struct readers {
+	struct gpiod_line_bulk *bulk;
+	struct gpiod_event_waiter *waiter;
+	struct gpiod_event_uring *uring;
+	struct gpiod_line_event events[NUM_LINES];
+};
+
+/* The simulated line values persist across the runs. */
+static int values[NUM_LINES];
+
+static unsigned int read_bulk(struct gpiod_line_bulk *ev_bulk)
+{
+	struct gpiod_line_event event;
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(ev_bulk, line, lineptr) {
+		if (gpiod_line_event_read(line, &event))
+			bench_die_perr("error reading event");
+	}
+
+	return gpiod_line_bulk_num_lines(ev_bulk);
+}
+
+static unsigned int collect(struct readers *readers, unsigned int num_events,
+			    int mode)
+{
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_bulk ev_bulk;
+	int rv;
+
+	if (mode == READ_URING)
+		rv = gpiod_event_uring_read(readers->uring, &ts,
+					    readers->events, NULL, num_events);
+	else if (mode == READ_EPOLL)
+		rv = gpiod_event_waiter_wait(readers->waiter, &ts, &ev_bulk);
+	else
+		rv = gpiod_line_event_wait_bulk(readers->bulk, &ts, &ev_bulk);
+	if (rv < 0)
+		bench_die_perr("error waiting for events");
+	else if (rv == 0)
+		bench_die("timeout waiting for events");
+
+	return mode == READ_URING ? (unsigned int)rv : read_bulk(&ev_bulk);
+}
+
+static void run(struct gpiod_chip *chip, const int *event_fds,
+		unsigned int num_lines, unsigned int iterations, int mode)
+{
+	uint64_t start, cpu_start, elapsed = 0, cpu = 0;
+	struct gpiod_line_bulk bulk;
+	struct readers readers;
+	unsigned int i, j, num_events;
+	char name[64];
+	int rv;
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	rv = gpiod_line_request_bulk_both_edges_events(&bulk, BENCH_CONSUMER);
+	if (rv)
+		bench_die_perr("error requesting lines");
+
+	readers.bulk = &bulk;
+	readers.waiter = NULL;
+	readers.uring = NULL;
+
+	if (mode == READ_EPOLL) {
+		readers.waiter = gpiod_event_waiter_new();
+		if (!readers.waiter ||
+		    gpiod_event_waiter_add_bulk(readers.waiter, &bulk))
+			bench_die_perr("error setting up the event waiter");
+	} else if (mode == READ_URING) {
+		readers.uring = gpiod_event_uring_new(num_lines);
+		if (!readers.uring && errno == ENOTSUP) {
+			printf("%-40s not supported\n", mode_names[mode]);
+			gpiod_line_release_bulk(&bulk);
+			return;
+		}
+		if (!readers.uring ||
+		    gpiod_event_uring_add_bulk(readers.uring, &bulk))
+			bench_die_perr("error setting up the io_uring reader");
+	}
+
+	for (i = 0; i < iterations; i++) {
+		for (j = 0; j < num_lines; j++) {
+			values[j] = !values[j];
+			bench_event_set(event_fds[j], values[j]);
+		}
+
+		start = bench_now_ns();
+		cpu_start = bench_cpu_ns();
+
+		for (num_events = 0; num_events < num_lines;)
+			num_events += collect(&readers, num_lines - num_events,
+					      mode);
+
+		cpu += bench_cpu_ns() - cpu_start;
+		elapsed += bench_now_ns() - start;
+	}
+
+	snprintf(name, sizeof(name), "%s, %u lines",
+		 mode_names[mode], num_lines);
+	bench_report_cpu(name, (uint64_t)iterations * num_lines, elapsed, cpu);
+
+	if (readers.uring)
+		gpiod_event_uring_free(readers.uring);
+	if (readers.waiter)
+		gpiod_event_waiter_free(readers.waiter);
+	gpiod_line_release_bulk(&bulk);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	int event_fds[NUM_LINES];
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < NUM_LINES; i++)
+		event_fds[i] = bench_event_fd_open(0, i);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, event_fds, line_counts[i], iterations, READ_PPOLL);
+		run(chip, event_fds, line_counts[i], iterations, READ_EPOLL);
+		run(chip, event_fds, line_counts[i], iterations, READ_URING);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+/*
+ * This file is part of libgpiod.
+ *
+ * Copyright (C) 2019 Bartosz Golaszewski <bartekgola@gmail.com>
+ */
+
+/*
+ * Compare waiting for events with an event waiter against the ppoll() based
+ * gpiod_line_event_wait_bulk() for different numbers of monitored lines.
+ *
+ * Every iteration generates an edge on one of the lines (round-robin), waits
+ * for it and reads it. Only the time spent waiting and reading is measured.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-common.h"
+
+#define NUM_LINES		64
+#define DEF_ITERATIONS		20000
+
+static const unsigned int line_counts[] = { 1, 8, 64 };
+
+enum {
+	WAIT_PPOLL,
+	WAIT_WAITER,
+};
+
+static void read_events(struct gpiod_line_bulk *ev_bulk)
+{
+	struct gpiod_line_event event;
+	struct gpiod_line *line, **lineptr;
+
+	gpiod_line_bulk_foreach_line(ev_bulk, line, lineptr) {
+		if (gpiod_line_event_read(line, &event))
+			bench_die_perr("error reading event");
+	}
+}
+
+/* The simulated line values persist across the runs. */
+static int values[NUM_LINES];
+
+static void run(struct gpiod_chip *chip, const int *event_fds,
+		unsigned int num_lines, unsigned int iterations, int mode)
+{
+	struct gpiod_line_bulk bulk, ev_bulk;
+	struct gpiod_event_waiter *waiter;
+	struct timespec ts = { 1, 0 };
+	uint64_t start, elapsed = 0;
+	unsigned int i, offset;
+	char name[64];
+	int rv;
+
+	gpiod_line_bulk_init(&bulk);
+	for (i = 0; i < num_lines; i++)
+		gpiod_line_bulk_add(&bulk, gpiod_chip_get_line(chip, i));
+
+	rv = gpiod_line_request_bulk_both_edges_events(&bulk, BENCH_CONSUMER);
+	if (rv)
+		bench_die_perr("error requesting lines");
+
+	waiter = gpiod_event_waiter_new();
+	if (!waiter)
+		bench_die_perr("error creating the event waiter");
+
+	if (mode == WAIT_WAITER && gpiod_event_waiter_add_bulk(waiter, &bulk))
+		bench_die_perr("error adding lines to the event waiter");
+
+	for (i = 0; i < iterations; i++) {
+		offset = i % num_lines;
+		values[offset] = !values[offset];
+		bench_event_set(event_fds[offset], values[offset]);
+
+		start = bench_now_ns();
+
+		if (mode == WAIT_WAITER)
+			rv = gpiod_event_waiter_wait(waiter, &ts, &ev_bulk);
+		else
+			rv = gpiod_line_event_wait_bulk(&bulk, &ts, &ev_bulk);
+		if (rv < 0)
+			bench_die_perr("error waiting for events");
+		else if (rv == 0)
+			bench_die("timeout waiting for events");
+
+		read_events(&ev_bulk);
+
+		elapsed += bench_now_ns() - start;
+	}
+
+	snprintf(name, sizeof(name), "%s, %u lines",
+		 mode == WAIT_WAITER ? "event waiter" : "ppoll", num_lines);
+	bench_report(name, iterations, elapsed);
+
+	gpiod_event_waiter_free(waiter);
+	gpiod_line_release_bulk(&bulk);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int num_lines = NUM_LINES, iterations, i;
+	int event_fds[NUM_LINES];
+	struct gpiod_chip *chip;
+
+	iterations = bench_parse_iterations(argc, argv, DEF_ITERATIONS);
+
+	bench_mockup_load(&num_lines, 1);
+	chip = bench_chip_open(0);
+
+	for (i = 0; i < NUM_LINES; i++)
+		event_fds[i] = bench_event_fd_open(0, i);
+
+	for (i = 0; i < BENCH_ARRAY_SIZE(line_counts); i++) {
+		run(chip, event_fds, line_counts[i], iterations, WAIT_PPOLL);
+		run(chip, event_fds, line_counts[i], iterations, WAIT_WAITER);
+	}
+
+	gpiod_chip_close(chip);
+
+	return EXIT_SUCCESS;
+}
@@ -1049,6 +1049,60 @@ void test_free_chip_iter_noclose(struct gpiod_chip_iter **iter)
 		gpiod_chip_iter_free_noclose(*iter);
 }
 
+void test_free_event_waiter(struct gpiod_event_waiter **waiter)
+{
+	if (*waiter)
+		gpiod_event_waiter_free(*waiter);
+}
+
+void test_free_event_drain(struct gpiod_event_drain **drain)
+{
+	if (*drain)
+		gpiod_event_drain_free(*drain);
+}
+
+void test_free_event_uring(struct gpiod_event_uring **uring)
+{
+	if (*uring)
+		gpiod_event_uring_free(*uring);
+}
+
+void test_free_event_source(struct gpiod_event_source **source)
+{
+	if (*source)
+		gpiod_event_source_free(*source);
+}
+
+void test_free_line_prepared(struct gpiod_line_prepared **prepared)
+{
+	if (*prepared)
+		gpiod_line_prepared_free(*prepared);
+}
+
+void test_free_line_array(struct gpiod_line_array **array)
+{
+	if (*array)
+		gpiod_line_array_free(*array);
+}
+
+void test_free_line_group(struct gpiod_line_group **group)
+{
+	if (*group)
+		gpiod_line_group_free(*group);
+}
+
+void test_free_waveform(struct gpiod_waveform **waveform)
+{
+	if (*waveform)
+		gpiod_waveform_free(*waveform);
+}
+
+void test_free_pwm(struct gpiod_pwm **pwm)
+{
+	if (*pwm)
+		gpiod_pwm_free(*pwm);
+}
+
 const char *test_chip_path(unsigned int index)
 {
 	check_chip_index(index);
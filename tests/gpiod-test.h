@@ -127,6 +127,15 @@ void test_line_close_chip(struct gpiod_line **line);
 void test_free_chip_iter(struct gpiod_chip_iter **iter);
 void test_free_chip_iter_noclose(struct gpiod_chip_iter **iter);
 void test_free_line_iter(struct gpiod_line_iter **iter);
+void test_free_event_waiter(struct gpiod_event_waiter **waiter);
+void test_free_event_drain(struct gpiod_event_drain **drain);
+void test_free_event_uring(struct gpiod_event_uring **uring);
+void test_free_event_source(struct gpiod_event_source **source);
+void test_free_line_prepared(struct gpiod_line_prepared **prepared);
+void test_free_line_array(struct gpiod_line_array **array);
+void test_free_line_group(struct gpiod_line_group **group);
+void test_free_waveform(struct gpiod_waveform **waveform);
+void test_free_pwm(struct gpiod_pwm **pwm);
 
 #define TEST_CLEANUP_CHIP TEST_CLEANUP(test_close_chip)
 
@@ -47,6 +47,51 @@ TEST_DEFINE(chip_open_notty,
 	    "gpiod_chip_open() - notty",
 	    0, { 8 });
 
+static void chip_open_flags_no_verify(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+
+	chip = gpiod_chip_open_flags(test_chip_path(0),
+				     GPIOD_CHIP_OPEN_FLAG_NO_VERIFY);
+	TEST_ASSERT_NOT_NULL(chip);
+	TEST_ASSERT_STR_EQ(gpiod_chip_name(chip), test_chip_name(0));
+}
+TEST_DEFINE(chip_open_flags_no_verify,
+	    "gpiod_chip_open_flags() - don't verify the chip",
+	    0, { 8 });
+
+static void chip_open_flags_no_verify_notty(void)
+{
+	struct gpiod_chip *chip;
+
+	chip = gpiod_chip_open_flags("/dev/null",
+				     GPIOD_CHIP_OPEN_FLAG_NO_VERIFY);
+	TEST_ASSERT_NULL(chip);
+	TEST_ASSERT_ERRNO_IS(ENOTTY);
+}
+TEST_DEFINE(chip_open_flags_no_verify_notty,
+	    "gpiod_chip_open_flags() - don't verify the chip - notty",
+	    0, { 8 });
+
+static void chip_open_flags_uapi_v1(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	int rv;
+
+	chip = gpiod_chip_open_flags(test_chip_path(0),
+				     GPIOD_CHIP_OPEN_FLAG_UAPI_V1);
+	TEST_ASSERT_NOT_NULL(chip);
+	TEST_ASSERT_EQ(gpiod_chip_uapi_version(chip), 1);
+
+	rv = gpiod_chip_set_event_buffer_size(chip, 64);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(ENOTSUP);
+	TEST_ASSERT_EQ(gpiod_chip_get_event_buffer_size(chip), 0);
+}
+TEST_DEFINE(chip_open_flags_uapi_v1,
+	    "gpiod_chip_open_flags() - force the v1 uAPI",
+	    0, { 8 });
+
 static void chip_open_by_name_good(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
@@ -251,6 +296,93 @@ TEST_DEFINE(chip_get_all_lines,
 	    "gpiod_chip_get_all_lines()",
 	    0, { 4 });
 
+static void chip_line_info_policy(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	TEST_ASSERT_EQ(gpiod_chip_get_line_info_policy(chip),
+		       GPIOD_LINE_INFO_REFRESH_ALWAYS);
+
+	rv = gpiod_chip_set_line_info_policy(chip,
+					     GPIOD_LINE_INFO_REFRESH_NEVER);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(gpiod_chip_get_line_info_policy(chip),
+		       GPIOD_LINE_INFO_REFRESH_NEVER);
+
+	rv = gpiod_chip_set_line_info_policy(chip, 1234);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+	TEST_ASSERT_EQ(gpiod_chip_get_line_info_policy(chip),
+		       GPIOD_LINE_INFO_REFRESH_NEVER);
+}
+TEST_DEFINE(chip_line_info_policy,
+	    "gpiod_chip_set_line_info_policy() - set and get",
+	    0, { 8 });
+
+static void chip_line_info_policy_if_stale(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	rv = gpiod_chip_set_line_info_policy(chip,
+					     GPIOD_LINE_INFO_REFRESH_IF_STALE);
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+	TEST_ASSERT_NULL(gpiod_line_consumer(line));
+
+	rv = gpiod_line_request_output(line, TEST_CONSUMER, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_STR_EQ(gpiod_line_consumer(line), TEST_CONSUMER);
+	TEST_ASSERT_EQ(gpiod_line_direction(line),
+		       GPIOD_LINE_DIRECTION_OUTPUT);
+}
+TEST_DEFINE(chip_line_info_policy_if_stale,
+	    "gpiod_chip_set_line_info_policy() - refresh if stale",
+	    0, { 8 });
+
+static void chip_line_info_policy_never(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	rv = gpiod_chip_set_line_info_policy(chip,
+					     GPIOD_LINE_INFO_REFRESH_NEVER);
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+	TEST_ASSERT_NULL(gpiod_line_consumer(line));
+
+	rv = gpiod_line_request_output(line, TEST_CONSUMER, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* Neither the request nor retrieving the line again refresh it. */
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+	TEST_ASSERT_NULL(gpiod_line_consumer(line));
+
+	gpiod_chip_invalidate_line_info(chip);
+	TEST_ASSERT_STR_EQ(gpiod_line_consumer(line), TEST_CONSUMER);
+}
+TEST_DEFINE(chip_line_info_policy_never,
+	    "gpiod_chip_set_line_info_policy() - never refresh",
+	    0, { 8 });
+
 static void chip_find_line_good(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
@@ -284,6 +416,36 @@ TEST_DEFINE(chip_find_line_not_found,
 	    "gpiod_chip_find_line() - not found",
 	    TEST_FLAG_NAMED_LINES, { 8, 8, 8 });
 
+static void chip_find_line_repeated(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	char name[32];
+	unsigned int i;
+
+	chip = gpiod_chip_open(test_chip_path(1));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	/* The first lookup builds the index, the following ones reuse it. */
+	for (i = 16; i-- > 0;) {
+		snprintf(name, sizeof(name), "gpio-mockup-B-%u", i);
+		line = gpiod_chip_find_line(chip, name);
+		TEST_ASSERT_NOT_NULL(line);
+		TEST_ASSERT_EQ(gpiod_line_offset(line), i);
+	}
+
+	line = gpiod_chip_find_line(chip, "gpio-mockup-A-3");
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+
+	line = gpiod_chip_find_line(chip, "gpio-mockup-B-16");
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(chip_find_line_repeated,
+	    "gpiod_chip_find_line() - repeated lookups",
+	    TEST_FLAG_NAMED_LINES, { 8, 16, 8 });
+
 static void chip_find_lines_good(void)
 {
 	static const char *names[] = { "gpio-mockup-B-3",
@@ -8,6 +8,9 @@
 /* Test cases for GPIO line events. */
 
 #include <errno.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 
 #include "gpiod-test.h"
@@ -242,6 +245,163 @@ TEST_DEFINE(event_wait_multiple,
 	    "events - wait for events on multiple lines",
 	    0, { 8 });
 
+static void event_read_multiple(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_event events[GPIOD_LINE_EVENT_MAX_EVENTS];
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line *line;
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 2, TEST_EVENT_ALTERNATING, 100);
+
+	rv = gpiod_line_event_wait(line, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	/* Let a couple more events pile up in the kernel queue. */
+	usleep(350000);
+
+	rv = gpiod_line_event_read_multiple(line, events,
+					    TEST_ARRAY_SIZE(events));
+	TEST_ASSERT(rv > 1);
+
+	for (i = 1; i < rv; i++)
+		TEST_ASSERT_NOTEQ(events[i].event_type,
+				  events[i - 1].event_type);
+}
+TEST_DEFINE(event_read_multiple,
+	    "events - read multiple events at once",
+	    0, { 8 });
+
+static void event_shared_fd(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line *line2, *line5;
+	struct gpiod_line_event ev;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line2 = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line2);
+	line5 = gpiod_chip_get_line(chip, 5);
+	TEST_ASSERT_NOT_NULL(line5);
+
+	gpiod_line_bulk_add(&bulk, line2);
+	gpiod_line_bulk_add(&bulk, line5);
+
+	rv = gpiod_line_request_bulk_rising_edge_events_flags(&bulk,
+				TEST_CONSUMER,
+				GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD);
+	if (gpiod_chip_uapi_version(chip) < 2) {
+		TEST_ASSERT_EQ(rv, -1);
+		TEST_ASSERT_ERRNO_IS(ENOTSUP);
+		return;
+	}
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(gpiod_line_event_get_fd(line2),
+		       gpiod_line_event_get_fd(line5));
+
+	test_set_event(0, 5, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_event_wait(line2, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_line_event_read(line2, &ev);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(ev.event_type, GPIOD_LINE_EVENT_RISING_EDGE);
+	TEST_ASSERT_EQ(ev.offset, 5);
+	TEST_ASSERT_EQ(ev.seqno, 1);
+	TEST_ASSERT_EQ(ev.line_seqno, 1);
+}
+TEST_DEFINE(event_shared_fd,
+	    "events - multiple lines sharing a single event fd",
+	    0, { 8 });
+
+static void event_stats(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_event_stats stats;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_event ev;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_event_get_stats(line, &stats);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 3, TEST_EVENT_ALTERNATING, 100);
+
+	rv = gpiod_line_event_wait(line, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_line_event_read(line, &ev);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_event_get_stats(line, &stats);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(stats.received, 1);
+	TEST_ASSERT_EQ(stats.dropped, 0);
+
+	gpiod_line_event_reset_stats(line);
+
+	rv = gpiod_line_event_get_stats(line, &stats);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(stats.received, 0);
+}
+TEST_DEFINE(event_stats,
+	    "events - received and dropped event statistics",
+	    0, { 8 });
+
+static void event_read_multiple_when_values_requested(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_event events[4];
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_input(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_event_read_multiple(line, events,
+					    TEST_ARRAY_SIZE(events));
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+}
+TEST_DEFINE(event_read_multiple_when_values_requested,
+	    "events - gpiod_line_event_read_multiple(): line requested for values",
+	    0, { 8 });
+
 static void event_get_fd_when_values_requested(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
@@ -333,3 +493,831 @@ static void event_invalid_fd(void)
 TEST_DEFINE(event_invalid_fd,
 	    "events - gpiod_line_event_wait() error on closed fd",
 	    0, { 8 });
+
+static void event_read_raw_v1_layout(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct timespec ts = { 1, 0 };
+	struct gpioevent_data evdata;
+	struct gpiod_line *line;
+	ssize_t rd;
+	int rv, fd;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_rising_edge_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 2, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_event_wait(line, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	/* Single-line requests keep the v1 layout even on v2 kernels. */
+	fd = gpiod_line_event_get_fd(line);
+	rd = read(fd, &evdata, sizeof(evdata));
+	TEST_ASSERT_EQ(rd, sizeof(evdata));
+	TEST_ASSERT_EQ(evdata.id, GPIOEVENT_EVENT_RISING_EDGE);
+}
+TEST_DEFINE(event_read_raw_v1_layout,
+	    "events - raw read() from the event fd of a single line",
+	    0, { 8 });
+
+static void event_waiter_wait_multiple(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_waiter)
+			struct gpiod_event_waiter *waiter = NULL;
+	struct gpiod_line_bulk bulk, event_bulk;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_event ev;
+	struct gpiod_line *line;
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	gpiod_line_bulk_init(&bulk);
+
+	for (i = 0; i < 8; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_both_edges_events(&bulk, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	waiter = gpiod_event_waiter_new();
+	TEST_ASSERT_NOT_NULL(waiter);
+
+	rv = gpiod_event_waiter_add_bulk(waiter, &bulk);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 4, TEST_EVENT_RISING, 100);
+
+	/* Wait more than once to verify the waiter can be reused. */
+	for (i = 0; i < 2; i++) {
+		rv = gpiod_event_waiter_wait(waiter, &ts, &event_bulk);
+		TEST_ASSERT_EQ(rv, 1);
+
+		TEST_ASSERT_EQ(gpiod_line_bulk_num_lines(&event_bulk), 1);
+		line = gpiod_line_bulk_get_line(&event_bulk, 0);
+		TEST_ASSERT_EQ(gpiod_line_offset(line), 4);
+
+		rv = gpiod_line_event_read(line, &ev);
+		TEST_ASSERT_RET_OK(rv);
+		TEST_ASSERT_EQ(ev.event_type, GPIOD_LINE_EVENT_RISING_EDGE);
+	}
+}
+TEST_DEFINE(event_waiter_wait_multiple,
+	    "events - wait for events on multiple lines using an event waiter",
+	    0, { 8 });
+
+static void event_waiter_timeout(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_waiter)
+			struct gpiod_event_waiter *waiter = NULL;
+	struct timespec ts = { 0, 100000 };
+	struct pollfd pfd;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 6);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	waiter = gpiod_event_waiter_new();
+	TEST_ASSERT_NOT_NULL(waiter);
+
+	rv = gpiod_event_waiter_wait(waiter, &ts, NULL);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+
+	rv = gpiod_event_waiter_add_line(waiter, line);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_waiter_wait(waiter, &ts, NULL);
+	TEST_ASSERT_EQ(rv, 0);
+
+	pfd.fd = gpiod_event_waiter_get_fd(waiter);
+	pfd.events = POLLIN;
+	rv = poll(&pfd, 1, 0);
+	TEST_ASSERT_EQ(rv, 0);
+}
+TEST_DEFINE(event_waiter_timeout,
+	    "events - event waiter timeout",
+	    0, { 8 });
+
+static void event_waiter_add_line_when_values_requested(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_waiter)
+			struct gpiod_event_waiter *waiter = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_input(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	waiter = gpiod_event_waiter_new();
+	TEST_ASSERT_NOT_NULL(waiter);
+
+	rv = gpiod_event_waiter_add_line(waiter, line);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+}
+TEST_DEFINE(event_waiter_add_line_when_values_requested,
+	    "events - gpiod_event_waiter_add_line(): line requested for values",
+	    0, { 8 });
+
+static void event_waiter_shared_fd(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_waiter)
+			struct gpiod_event_waiter *waiter = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line_bulk event_bulk;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line *line2, *line5;
+	struct gpiod_line_event ev;
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	if (gpiod_chip_uapi_version(chip) < 2)
+		return;
+
+	line2 = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line2);
+	line5 = gpiod_chip_get_line(chip, 5);
+	TEST_ASSERT_NOT_NULL(line5);
+
+	gpiod_line_bulk_add(&bulk, line2);
+	gpiod_line_bulk_add(&bulk, line5);
+
+	rv = gpiod_line_request_bulk_rising_edge_events_flags(&bulk,
+				TEST_CONSUMER,
+				GPIOD_LINE_REQUEST_FLAG_SHARED_EVENT_FD);
+	TEST_ASSERT_RET_OK(rv);
+
+	waiter = gpiod_event_waiter_new();
+	TEST_ASSERT_NOT_NULL(waiter);
+
+	rv = gpiod_event_waiter_add_bulk(waiter, &bulk);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_waiter_add_line(waiter, line5);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EEXIST);
+
+	test_set_event(0, 5, TEST_EVENT_RISING, 100);
+
+	/* The event stays pending until it's read. */
+	for (i = 0; i < 2; i++) {
+		rv = gpiod_event_waiter_wait(waiter, &ts, &event_bulk);
+		TEST_ASSERT_EQ(rv, 1);
+
+		TEST_ASSERT_EQ(gpiod_line_bulk_num_lines(&event_bulk), 1);
+		TEST_ASSERT_EQ(gpiod_line_bulk_get_line(&event_bulk, 0),
+			       line5);
+	}
+
+	rv = gpiod_line_event_read(line5, &ev);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(ev.event_type, GPIOD_LINE_EVENT_RISING_EDGE);
+	TEST_ASSERT_EQ(ev.offset, 5);
+
+	ts.tv_sec = 0;
+	ts.tv_nsec = 100000;
+	rv = gpiod_event_waiter_wait(waiter, &ts, &event_bulk);
+	TEST_ASSERT_EQ(rv, 0);
+
+	rv = gpiod_event_waiter_remove_line(waiter, line2);
+	TEST_ASSERT_RET_OK(rv);
+	rv = gpiod_event_waiter_remove_line(waiter, line2);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(event_waiter_shared_fd,
+	    "events - event waiter with lines sharing a single event fd",
+	    0, { 8 });
+
+static void event_line_array_wait(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_line_array)
+			struct gpiod_line_array *array = NULL;
+	TEST_CLEANUP(test_free_line_array)
+			struct gpiod_line_array *ev_array = NULL;
+	struct gpiod_line_request_config config;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_event ev;
+	struct gpiod_line *line;
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	array = gpiod_line_array_new();
+	TEST_ASSERT_NOT_NULL(array);
+
+	ev_array = gpiod_line_array_new();
+	TEST_ASSERT_NOT_NULL(ev_array);
+
+	for (i = 0; i < 100; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+
+		rv = gpiod_line_array_add(array, line);
+		TEST_ASSERT_RET_OK(rv);
+	}
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_EVENT_RISING_EDGE;
+
+	rv = gpiod_line_array_request(array, &config, NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 90, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_array_event_wait(array, &ts, ev_array);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(gpiod_line_array_num_lines(ev_array), 1);
+
+	line = gpiod_line_array_get_line(ev_array, 0);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 90);
+
+	rv = gpiod_line_event_read(line, &ev);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(ev.event_type, GPIOD_LINE_EVENT_RISING_EDGE);
+
+	/* The cached poll set must follow the new request. */
+	gpiod_line_array_release(array);
+
+	rv = gpiod_line_array_request(array, &config, NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 10, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_array_event_wait(array, &ts, ev_array);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(gpiod_line_array_num_lines(ev_array), 1);
+
+	line = gpiod_line_array_get_line(ev_array, 0);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 10);
+
+	rv = gpiod_line_event_read(line, &ev);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* ...and lines released and requested bypassing the array. */
+	gpiod_line_release(line);
+
+	rv = gpiod_line_array_event_wait(array, &ts, ev_array);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+
+	rv = gpiod_line_request_rising_edge_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 10, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_array_event_wait(array, &ts, ev_array);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(gpiod_line_array_num_lines(ev_array), 1);
+
+	line = gpiod_line_array_get_line(ev_array, 0);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 10);
+}
+TEST_DEFINE(event_line_array_wait,
+	    "events - wait for events on more than 64 lines",
+	    0, { 128 });
+
+static void event_line_group_wait(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipA = NULL;
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipB = NULL;
+	TEST_CLEANUP(test_free_line_group)
+			struct gpiod_line_group *group = NULL;
+	struct gpiod_line_request_config config;
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line_event ev;
+	unsigned int indices[8];
+	struct gpiod_line *line;
+	int rv, i;
+
+	chipA = gpiod_chip_open(test_chip_path(0));
+	chipB = gpiod_chip_open(test_chip_path(1));
+	TEST_ASSERT_NOT_NULL(chipA);
+	TEST_ASSERT_NOT_NULL(chipB);
+
+	group = gpiod_line_group_new();
+	TEST_ASSERT_NOT_NULL(group);
+
+	for (i = 0; i < 4; i++) {
+		line = gpiod_chip_get_line(chipA, i);
+		TEST_ASSERT_NOT_NULL(line);
+		rv = gpiod_line_group_add(group, line);
+		TEST_ASSERT_RET_OK(rv);
+
+		line = gpiod_chip_get_line(chipB, i);
+		TEST_ASSERT_NOT_NULL(line);
+		rv = gpiod_line_group_add(group, line);
+		TEST_ASSERT_RET_OK(rv);
+	}
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+
+	rv = gpiod_line_group_request(group, &config, NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(1, 2, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_group_event_wait(group, &ts, indices);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(indices[0], 5);
+
+	line = gpiod_line_group_get_line(group, indices[0]);
+	TEST_ASSERT(gpiod_line_get_chip(line) == chipB);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 2);
+
+	rv = gpiod_line_event_read(line, &ev);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* The cached poll set must follow lines requested again directly. */
+	gpiod_line_release(line);
+
+	rv = gpiod_line_group_event_wait(group, &ts, indices);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(1, 2, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_line_group_event_wait(group, &ts, indices);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(indices[0], 5);
+}
+TEST_DEFINE(event_line_group_wait,
+	    "events - wait for events on lines from multiple chips",
+	    0, { 8, 8 });
+
+static void event_drain_pop(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_drain)
+			struct gpiod_event_drain *drain = NULL;
+	struct gpiod_line *line, *lines[8];
+	struct gpiod_line_event events[8];
+	struct timespec ts = { 1, 0 };
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	drain = gpiod_event_drain_new(1000);
+	TEST_ASSERT_NOT_NULL(drain);
+
+	rv = gpiod_event_drain_start(drain);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+
+	rv = gpiod_event_drain_add_line(drain, line);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_start(drain);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_pop(drain, events, lines, 8);
+	TEST_ASSERT_EQ(rv, 0);
+
+	test_set_event(0, 3, TEST_EVENT_ALTERNATING, 100);
+
+	rv = gpiod_event_drain_wait(drain, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	/* Let a couple more events pile up in the ring. */
+	usleep(350000);
+
+	rv = gpiod_event_drain_pop(drain, events, lines, 8);
+	TEST_ASSERT(rv > 1);
+
+	for (i = 0; i < rv; i++) {
+		TEST_ASSERT_EQ(lines[i], line);
+		TEST_ASSERT_EQ(events[i].offset, 3);
+		if (i > 0)
+			TEST_ASSERT_NOTEQ(events[i].event_type,
+					  events[i - 1].event_type);
+	}
+
+	TEST_ASSERT_EQ(gpiod_event_drain_overruns(drain), 0);
+}
+TEST_DEFINE(event_drain_pop,
+	    "events - drain events into the userspace ring",
+	    0, { 8 });
+
+static void event_drain_mlock(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_drain)
+			struct gpiod_event_drain *drain = NULL;
+	struct gpiod_line_event events[8];
+	struct timespec ts = { 1, 0 };
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_rising_edge_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	drain = gpiod_event_drain_new(64);
+	TEST_ASSERT_NOT_NULL(drain);
+
+	rv = gpiod_event_drain_add_line(drain, line);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_set_mlock(drain, true);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_set_cpu(drain, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_start(drain);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_drain_set_mlock(drain, false);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EBUSY);
+
+	test_set_event(0, 2, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_event_drain_wait(drain, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_event_drain_pop(drain, events, NULL, 8);
+	TEST_ASSERT(rv > 0);
+	TEST_ASSERT_EQ(events[0].event_type, GPIOD_LINE_EVENT_RISING_EDGE);
+	TEST_ASSERT_EQ(events[0].offset, 2);
+
+	/* The drain can be restarted after its memory was unlocked. */
+	gpiod_event_drain_stop(drain);
+
+	rv = gpiod_event_drain_start(drain);
+	TEST_ASSERT_RET_OK(rv);
+}
+TEST_DEFINE(event_drain_mlock,
+	    "events - drain events with the drain memory locked",
+	    0, { 8 });
+
+static void event_drain_add_bulk_rollback(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_drain)
+			struct gpiod_event_drain *drain = NULL;
+	struct gpiod_line *line1, *line4;
+	struct gpiod_line_event events[8];
+	struct gpiod_line_bulk bulk;
+	struct timespec ts = { 1, 0 };
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line1 = gpiod_chip_get_line(chip, 1);
+	line4 = gpiod_chip_get_line(chip, 4);
+	TEST_ASSERT_NOT_NULL(line1);
+	TEST_ASSERT_NOT_NULL(line4);
+
+	rv = gpiod_line_request_rising_edge_events(line1, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_request_input(line4, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	drain = gpiod_event_drain_new(64);
+	TEST_ASSERT_NOT_NULL(drain);
+
+	rv = gpiod_event_drain_add_line(drain, line1);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* Adding line 4 fails, line 1 must stay in the drain. */
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line1);
+	gpiod_line_bulk_add(&bulk, line4);
+
+	rv = gpiod_event_drain_add_bulk(drain, &bulk);
+	TEST_ASSERT_EQ(rv, -1);
+
+	rv = gpiod_event_drain_start(drain);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 1, TEST_EVENT_RISING, 100);
+
+	rv = gpiod_event_drain_wait(drain, &ts);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_event_drain_pop(drain, events, NULL, 8);
+	TEST_ASSERT(rv > 0);
+	TEST_ASSERT_EQ(events[0].offset, 1);
+}
+TEST_DEFINE(event_drain_add_bulk_rollback,
+	    "events - failed drain bulk add keeps lines added before",
+	    0, { 8 });
+
+static void event_uring_read(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_uring)
+			struct gpiod_event_uring *uring = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line *line, *lines[8];
+	struct gpiod_line_event events[8];
+	struct timespec ts = { 1, 0 };
+	int rv, i, count = 0;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 4; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_both_edges_events(&bulk, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	uring = gpiod_event_uring_new(4);
+	if (!uring && errno == ENOTSUP)
+		return;
+	TEST_ASSERT_NOT_NULL(uring);
+
+	rv = gpiod_event_uring_add_bulk(uring, &bulk);
+	TEST_ASSERT_RET_OK(rv);
+
+	ts.tv_sec = 0;
+	rv = gpiod_event_uring_read(uring, &ts, events, lines, 8);
+	TEST_ASSERT_EQ(rv, 0);
+
+	test_set_event(0, 2, TEST_EVENT_ALTERNATING, 100);
+
+	/* Events which don't fit are returned by the following calls. */
+	ts.tv_sec = 1;
+	while (count < 3) {
+		rv = gpiod_event_uring_read(uring, &ts, events, lines, 1);
+		TEST_ASSERT_EQ(rv, 1);
+		TEST_ASSERT_EQ(lines[0], gpiod_line_bulk_get_line(&bulk, 2));
+		TEST_ASSERT_EQ(events[0].offset, 2);
+		count++;
+	}
+}
+TEST_DEFINE(event_uring_read,
+	    "events - read events through io_uring",
+	    0, { 8 });
+
+static void event_source_count_cb(struct gpiod_line *line,
+				  const struct gpiod_line_event *event,
+				  void *data)
+{
+	unsigned int *counts = data;
+
+	if (gpiod_line_offset(line) == event->offset)
+		counts[event->offset]++;
+}
+
+static void event_source_dispatch(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipA = NULL;
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipB = NULL;
+	TEST_CLEANUP(test_free_event_source)
+			struct gpiod_event_source *source = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	unsigned int countsA[8] = { 0 }, countsB[8] = { 0 };
+	struct epoll_event event;
+	struct gpiod_line *line;
+	int rv, i, epfd;
+
+	chipA = gpiod_chip_open(test_chip_path(0));
+	chipB = gpiod_chip_open(test_chip_path(1));
+	TEST_ASSERT_NOT_NULL(chipA);
+	TEST_ASSERT_NOT_NULL(chipB);
+
+	for (i = 0; i < 4; i++) {
+		line = gpiod_chip_get_line(chipA, i);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_both_edges_events(&bulk, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_chip_get_line(chipB, 5);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	source = gpiod_event_source_new();
+	TEST_ASSERT_NOT_NULL(source);
+
+	rv = gpiod_event_source_add_bulk(source, &bulk,
+					 event_source_count_cb, countsA);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_source_add_line(source, line,
+					 event_source_count_cb, countsB);
+	TEST_ASSERT_RET_OK(rv);
+
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	TEST_ASSERT(epfd >= 0);
+
+	rv = gpiod_event_source_attach_epoll(source, epfd, source);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 1, TEST_EVENT_RISING, 100);
+	test_set_event(1, 5, TEST_EVENT_FALLING, 100);
+
+	while (!countsA[1] || !countsB[5]) {
+		rv = epoll_wait(epfd, &event, 1, 1000);
+		TEST_ASSERT_EQ(rv, 1);
+		TEST_ASSERT(event.data.ptr == source);
+
+		rv = gpiod_event_source_dispatch(source);
+		TEST_ASSERT(rv >= 0);
+	}
+
+	close(epfd);
+
+	TEST_ASSERT_EQ(countsA[1], 1);
+	TEST_ASSERT_EQ(countsB[5], 1);
+	TEST_ASSERT_EQ(countsA[0] + countsA[2] + countsA[3], 0);
+
+	rv = gpiod_event_source_remove_line(source, line);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_source_remove_line(source, line);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(event_source_dispatch,
+	    "events - dispatch events from multiple chips",
+	    0, { 8, 8 });
+
+static void event_source_add_bulk_rollback(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_source)
+			struct gpiod_event_source *source = NULL;
+	unsigned int countsA[8] = { 0 }, countsB[8] = { 0 };
+	struct gpiod_line *line1, *line2, *line4;
+	struct gpiod_line_bulk bulk;
+	struct pollfd pfd;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line1 = gpiod_chip_get_line(chip, 1);
+	line2 = gpiod_chip_get_line(chip, 2);
+	line4 = gpiod_chip_get_line(chip, 4);
+	TEST_ASSERT_NOT_NULL(line1);
+	TEST_ASSERT_NOT_NULL(line2);
+	TEST_ASSERT_NOT_NULL(line4);
+
+	rv = gpiod_line_request_rising_edge_events(line1, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_request_rising_edge_events(line2, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_request_input(line4, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	source = gpiod_event_source_new();
+	TEST_ASSERT_NOT_NULL(source);
+
+	rv = gpiod_event_source_add_line(source, line1,
+					 event_source_count_cb, countsA);
+	TEST_ASSERT_RET_OK(rv);
+
+	/*
+	 * Adding line 4 fails: line 2 must be removed again and line 1 must
+	 * keep its previous handler.
+	 */
+	gpiod_line_bulk_init(&bulk);
+	gpiod_line_bulk_add(&bulk, line1);
+	gpiod_line_bulk_add(&bulk, line2);
+	gpiod_line_bulk_add(&bulk, line4);
+
+	rv = gpiod_event_source_add_bulk(source, &bulk,
+					 event_source_count_cb, countsB);
+	TEST_ASSERT_EQ(rv, -1);
+
+	rv = gpiod_event_source_remove_line(source, line2);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+
+	test_set_event(0, 1, TEST_EVENT_RISING, 100);
+
+	pfd.fd = gpiod_event_source_get_fd(source);
+	pfd.events = POLLIN;
+
+	rv = poll(&pfd, 1, 1000);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_event_source_dispatch(source);
+	TEST_ASSERT(rv > 0);
+	TEST_ASSERT_EQ(countsA[1], 1);
+	TEST_ASSERT_EQ(countsB[1], 0);
+}
+TEST_DEFINE(event_source_add_bulk_rollback,
+	    "events - failed source bulk add keeps lines added before",
+	    0, { 8 });
+
+static void event_source_readd_rerequested_line(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_event_source)
+			struct gpiod_event_source *source = NULL;
+	unsigned int counts[8] = { 0 };
+	struct gpiod_line *line;
+	struct pollfd pfd;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_rising_edge_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	source = gpiod_event_source_new();
+	TEST_ASSERT_NOT_NULL(source);
+
+	rv = gpiod_event_source_add_line(source, line,
+					 event_source_count_cb, counts);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* Most likely gets the same descriptor number. */
+	gpiod_line_release(line);
+	rv = gpiod_line_request_rising_edge_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_event_source_add_line(source, line,
+					 event_source_count_cb, counts);
+	TEST_ASSERT_RET_OK(rv);
+
+	test_set_event(0, 3, TEST_EVENT_RISING, 100);
+
+	pfd.fd = gpiod_event_source_get_fd(source);
+	pfd.events = POLLIN;
+
+	rv = poll(&pfd, 1, 1000);
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_event_source_dispatch(source);
+	TEST_ASSERT(rv > 0);
+	TEST_ASSERT_EQ(counts[3], 1);
+
+	rv = gpiod_event_source_remove_line(source, line);
+	TEST_ASSERT_RET_OK(rv);
+}
+TEST_DEFINE(event_source_readd_rerequested_line,
+	    "events - re-add a line re-requested while in a source",
+	    0, { 8 });
@@ -8,6 +8,7 @@
 /* Test cases for the gpiofind program. */
 
 #include <stdio.h>
+#include <unistd.h>
 
 #include "gpiod-test.h"
 
@@ -41,6 +42,44 @@ TEST_DEFINE(gpiofind_not_found,
 	    "tools: gpiofind - not found",
 	    TEST_FLAG_NAMED_LINES, { 4, 8 });
 
+static void gpiofind_cache(void)
+{
+	char path[64];
+	int i;
+
+	snprintf(path, sizeof(path), "/tmp/gpiod-test-line-cache.%d",
+		 getpid());
+	unlink(path);
+
+	/* Run twice: once creating the cache and once using it. */
+	for (i = 0; i < 2; i++) {
+		test_tool_run("gpiofind", "--cache", path,
+			      "gpio-mockup-B-7", (char *)NULL);
+		test_tool_wait();
+
+		TEST_ASSERT(test_tool_exited());
+		TEST_ASSERT_RET_OK(test_tool_exit_status());
+		TEST_ASSERT_NOT_NULL(test_tool_stdout());
+		TEST_ASSERT_STR_EQ(test_tool_stdout(),
+				   test_build_str("%s 7\n", test_chip_name(1)));
+		TEST_ASSERT_NULL(test_tool_stderr());
+	}
+
+	test_tool_run("gpiofind", "--cache", path,
+		      "nonexistent", (char *)NULL);
+	test_tool_wait();
+
+	unlink(path);
+
+	TEST_ASSERT(test_tool_exited());
+	TEST_ASSERT_EQ(test_tool_exit_status(), 1);
+	TEST_ASSERT_NULL(test_tool_stdout());
+	TEST_ASSERT_NULL(test_tool_stderr());
+}
+TEST_DEFINE(gpiofind_cache,
+	    "tools: gpiofind - line name cache",
+	    TEST_FLAG_NAMED_LINES, { 4, 8 });
+
 static void gpiofind_invalid_args(void)
 {
 	test_tool_run("gpiofind", (char *)NULL);
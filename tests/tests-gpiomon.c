@@ -64,6 +64,81 @@ TEST_DEFINE(gpiomon_single_rising_edge_event_silent,
 	    "tools: gpiomon - single rising edge event (silent mode)",
 	    0, { 8, 8 });
 
+static void gpiomon_single_rising_edge_event_pinned(void)
+{
+	test_tool_run("gpiomon", "--rising-edge", "--num-events=1",
+		      "--cpu=0", test_chip_name(1), "4", (char *)NULL);
+	test_set_event(1, 4, TEST_EVENT_RISING, 200);
+	test_tool_wait();
+
+	TEST_ASSERT(test_tool_exited());
+	TEST_ASSERT_RET_OK(test_tool_exit_status());
+	TEST_ASSERT_NOT_NULL(test_tool_stdout());
+	TEST_ASSERT_NULL(test_tool_stderr());
+	TEST_ASSERT_REGEX_MATCH(test_tool_stdout(),
+				"event\\:\\s+RISING\\s+EDGE\\s+offset\\:\\s+4\\s+timestamp:\\s+\\[[0-9]+\\.[0-9]+\\]");
+}
+TEST_DEFINE(gpiomon_single_rising_edge_event_pinned,
+	    "tools: gpiomon - single rising edge event (pinned event thread)",
+	    0, { 8, 8 });
+
+static void gpiomon_single_rising_edge_event_rt(void)
+{
+	test_tool_run("gpiomon", "--rising-edge", "--num-events=1",
+		      "--rt-priority=1", test_chip_name(1), "4", (char *)NULL);
+	test_set_event(1, 4, TEST_EVENT_RISING, 200);
+	test_tool_wait();
+
+	TEST_ASSERT(test_tool_exited());
+
+	/*
+	 * Even root may be denied SCHED_FIFO, e.g. if the realtime runtime of
+	 * its cgroup is zero.
+	 */
+	if (test_tool_exit_status() != 0) {
+		TEST_ASSERT_NULL(test_tool_stdout());
+		TEST_ASSERT_NOT_NULL(test_tool_stderr());
+		TEST_ASSERT_STR_CONTAINS(test_tool_stderr(),
+					 "Operation not permitted");
+		return;
+	}
+
+	TEST_ASSERT_NOT_NULL(test_tool_stdout());
+	TEST_ASSERT_NULL(test_tool_stderr());
+	TEST_ASSERT_REGEX_MATCH(test_tool_stdout(),
+				"event\\:\\s+RISING\\s+EDGE\\s+offset\\:\\s+4\\s+timestamp:\\s+\\[[0-9]+\\.[0-9]+\\]");
+}
+TEST_DEFINE(gpiomon_single_rising_edge_event_rt,
+	    "tools: gpiomon - single rising edge event (realtime event thread)",
+	    0, { 8, 8 });
+
+static void gpiomon_single_rising_edge_event_mlock(void)
+{
+	test_tool_run("gpiomon", "--rising-edge", "--num-events=1",
+		      "--mlock", test_chip_name(1), "4", (char *)NULL);
+	test_set_event(1, 4, TEST_EVENT_RISING, 200);
+	test_tool_wait();
+
+	TEST_ASSERT(test_tool_exited());
+
+	/* Locking memory may exceed RLIMIT_MEMLOCK. */
+	if (test_tool_exit_status() != 0) {
+		TEST_ASSERT_NULL(test_tool_stdout());
+		TEST_ASSERT_NOT_NULL(test_tool_stderr());
+		TEST_ASSERT_REGEX_MATCH(test_tool_stderr(),
+				"Operation not permitted|Cannot allocate memory");
+		return;
+	}
+
+	TEST_ASSERT_NOT_NULL(test_tool_stdout());
+	TEST_ASSERT_NULL(test_tool_stderr());
+	TEST_ASSERT_REGEX_MATCH(test_tool_stdout(),
+				"event\\:\\s+RISING\\s+EDGE\\s+offset\\:\\s+4\\s+timestamp:\\s+\\[[0-9]+\\.[0-9]+\\]");
+}
+TEST_DEFINE(gpiomon_single_rising_edge_event_mlock,
+	    "tools: gpiomon - single rising edge event (locked event thread)",
+	    0, { 8, 8 });
+
 static void gpiomon_four_alternating_events(void)
 {
 	test_tool_run("gpiomon", "--num-events=4",
@@ -238,6 +313,23 @@ TEST_DEFINE(gpiomon_line_out_of_range,
 	    "tools: gpiomon - line out of range",
 	    0, { 4 });
 
+static void gpiomon_invalid_rt_priority(void)
+{
+	test_tool_run("gpiomon", "--rt-priority=0",
+		      test_chip_name(0), "3", (char *)NULL);
+	test_tool_wait();
+
+	TEST_ASSERT(test_tool_exited());
+	TEST_ASSERT_EQ(test_tool_exit_status(), 1);
+	TEST_ASSERT_NULL(test_tool_stdout());
+	TEST_ASSERT_NOT_NULL(test_tool_stderr());
+	TEST_ASSERT_STR_CONTAINS(test_tool_stderr(),
+				 "invalid realtime priority");
+}
+TEST_DEFINE(gpiomon_invalid_rt_priority,
+	    "tools: gpiomon - invalid realtime priority",
+	    0, { 4 });
+
 static void gpiomon_custom_format_event_and_offset(void)
 {
 	test_tool_run("gpiomon", "--num-events=1", "--format=%e %o",
@@ -373,3 +465,22 @@ static void gpiomon_custom_format_unknown_specifier(void)
 TEST_DEFINE(gpiomon_custom_format_unknown_specifier,
 	    "tools: gpiomon - custom output format: unknown specifier",
 	    0, { 8, 8 });
+
+static void gpiomon_stats(void)
+{
+	test_tool_run("gpiomon", "--num-events=1", "--silent", "--stats",
+		      test_chip_name(0), "3", "4", (char *)NULL);
+	test_set_event(0, 4, TEST_EVENT_RISING, 100);
+	test_tool_wait();
+
+	TEST_ASSERT(test_tool_exited());
+	TEST_ASSERT_RET_OK(test_tool_exit_status());
+	TEST_ASSERT_NOT_NULL(test_tool_stdout());
+	TEST_ASSERT_NULL(test_tool_stderr());
+	TEST_ASSERT_STR_EQ(test_tool_stdout(),
+			   "line 3: received 0 events, dropped 0 events\n"
+			   "line 4: received 1 events, dropped 0 events\n");
+}
+TEST_DEFINE(gpiomon_stats,
+	    "tools: gpiomon - print event statistics",
+	    0, { 8, 8 });
@@ -37,6 +37,34 @@ TEST_DEFINE(chip_iter,
 	    "gpiod_chip_iter - simple loop",
 	    0, { 8, 8, 8 });
 
+static void chip_iter_eager(void)
+{
+	TEST_CLEANUP(test_free_chip_iter) struct gpiod_chip_iter *iter = NULL;
+	struct gpiod_chip *chip;
+	bool A, B, C;
+
+	A = B = C = false;
+
+	iter = gpiod_chip_iter_new_flags(GPIOD_CHIP_ITER_FLAG_EAGER);
+	TEST_ASSERT_NOT_NULL(iter);
+
+	gpiod_foreach_chip(iter, chip) {
+		if (strcmp(gpiod_chip_label(chip), "gpio-mockup-A") == 0)
+			A = true;
+		else if (strcmp(gpiod_chip_label(chip), "gpio-mockup-B") == 0)
+			B = true;
+		else if (strcmp(gpiod_chip_label(chip), "gpio-mockup-C") == 0)
+			C = true;
+	}
+
+	TEST_ASSERT(A);
+	TEST_ASSERT(B);
+	TEST_ASSERT(C);
+}
+TEST_DEFINE(chip_iter_eager,
+	    "gpiod_chip_iter - simple loop, eager variant",
+	    0, { 8, 8, 8 });
+
 static void chip_iter_noclose(void)
 {
 	TEST_CLEANUP(test_free_chip_iter_noclose)
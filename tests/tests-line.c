@@ -8,6 +8,10 @@
 /* GPIO line test cases. */
 
 #include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "gpiod-test.h"
 
@@ -85,6 +89,85 @@ TEST_DEFINE(line_consumer,
 	    "gpiod_line_consumer() - good",
 	    0, { 8 });
 
+static void line_info_after_bulk_request(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk;
+	struct gpiod_line *line;
+	unsigned int i;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	rv = gpiod_chip_get_all_lines(chip, &bulk);
+	TEST_ASSERT_RET_OK(rv);
+
+	gpiod_line_bulk_foreach_line_off(&bulk, line, i) {
+		TEST_ASSERT_NULL(gpiod_line_consumer(line));
+		TEST_ASSERT_EQ(gpiod_line_direction(line),
+			       GPIOD_LINE_DIRECTION_INPUT);
+	}
+
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* The line info is refreshed when it's first accessed. */
+	gpiod_line_bulk_foreach_line_off(&bulk, line, i) {
+		TEST_ASSERT(!gpiod_line_needs_update(line));
+		TEST_ASSERT_STR_EQ(gpiod_line_consumer(line), TEST_CONSUMER);
+		TEST_ASSERT_EQ(gpiod_line_direction(line),
+			       GPIOD_LINE_DIRECTION_OUTPUT);
+		TEST_ASSERT(gpiod_line_is_used(line));
+	}
+}
+TEST_DEFINE(line_info_after_bulk_request,
+	    "gpiod_line_request_bulk() - line info is up to date",
+	    0, { 16 });
+
+static void line_request_bulk_output_uapi_v1(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	int vals[4] = { 1, 0, 1, 1 };
+	struct gpiod_line *line;
+	uint64_t mask;
+	unsigned int i;
+	int rv;
+
+	chip = gpiod_chip_open_flags(test_chip_path(0),
+				     GPIOD_CHIP_OPEN_FLAG_UAPI_V1);
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 4; i++) {
+		line = gpiod_chip_get_line(chip, i * 2);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &mask);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(mask, 0xd);
+
+	rv = gpiod_line_set_value_bulk_masked(&bulk, 0x3, 0x2);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &mask);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(mask, 0xe);
+
+	line = gpiod_line_bulk_get_line(&bulk, 1);
+	TEST_ASSERT_STR_EQ(gpiod_line_consumer(line), TEST_CONSUMER);
+	TEST_ASSERT_EQ(gpiod_line_direction(line),
+		       GPIOD_LINE_DIRECTION_OUTPUT);
+}
+TEST_DEFINE(line_request_bulk_output_uapi_v1,
+	    "gpiod_line_request_bulk_output() - v1 uAPI",
+	    0, { 8 });
+
 static void line_consumer_long_string(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
@@ -305,6 +388,118 @@ TEST_DEFINE(line_set_value,
 	    "gpiod_line_set_value() - good",
 	    0, { 8 });
 
+#define LINE_CONCURRENT_THREADS		8
+#define LINE_CONCURRENT_ITERATIONS	1000
+
+struct line_concurrent_data {
+	struct gpiod_chip *chip;
+	unsigned int offset;
+	pthread_t thread;
+	int rv;
+};
+
+static void *line_concurrent_func(void *data)
+{
+	struct line_concurrent_data *tdata = data;
+	struct gpiod_line *line;
+	int rv, i;
+
+	tdata->rv = -1;
+
+	line = gpiod_chip_get_line(tdata->chip, tdata->offset);
+	if (!line)
+		return NULL;
+
+	rv = gpiod_line_request_output(line, TEST_CONSUMER, 0);
+	if (rv)
+		return NULL;
+
+	for (i = 0; i < LINE_CONCURRENT_ITERATIONS; i++) {
+		rv = gpiod_line_set_value(line, i % 2);
+		if (rv || gpiod_line_get_value(line) != i % 2)
+			goto out;
+	}
+
+	tdata->rv = 0;
+
+out:
+	gpiod_line_release(line);
+	return NULL;
+}
+
+static void line_set_value_concurrent(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct line_concurrent_data data[LINE_CONCURRENT_THREADS];
+	unsigned int i, num_threads;
+	int rv = 0;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (num_threads = 0; num_threads < LINE_CONCURRENT_THREADS;
+	     num_threads++) {
+		data[num_threads].chip = chip;
+		data[num_threads].offset = num_threads;
+		data[num_threads].rv = -1;
+
+		rv = pthread_create(&data[num_threads].thread, NULL,
+				    line_concurrent_func, &data[num_threads]);
+		if (rv)
+			break;
+	}
+
+	/* Join whatever was started before the chip goes away. */
+	for (i = 0; i < num_threads; i++)
+		pthread_join(data[i].thread, NULL);
+
+	TEST_ASSERT_EQ(rv, 0);
+	for (i = 0; i < LINE_CONCURRENT_THREADS; i++)
+		TEST_ASSERT_RET_OK(data[i].rv);
+}
+TEST_DEFINE(line_set_value_concurrent,
+	    "gpiod_line_set_value() - distinct lines from multiple threads",
+	    0, { 8 });
+
+static void line_set_get_value_bulk_mask(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line *line;
+	uint64_t vals;
+	int rv, i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 12; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	/* Bits beyond the number of lines must be ignored. */
+	rv = gpiod_line_set_value_bulk_mask(&bulk, 0xf0a5a5);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &vals);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals, 0x5a5);
+
+	rv = gpiod_line_set_value_bulk_masked(&bulk, 0x00f, 0xffa);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &vals);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals, 0x5aa);
+}
+TEST_DEFINE(line_set_get_value_bulk_mask,
+	    "gpiod_line_set/get_value_bulk_mask() - good",
+	    0, { 16 });
+
 static void line_get_value_different_chips(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chipA = NULL;
@@ -360,166 +555,706 @@ TEST_DEFINE(line_get_value_different_chips,
 	    "gpiod_line_get_value_bulk() - different chips",
 	    0, { 8, 8 });
 
-static void line_get_good(void)
+static void line_prepared_set_get_values(void)
 {
-	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
-
-	line = gpiod_line_get(test_chip_name(2), 18);
-	TEST_ASSERT_NOT_NULL(line);
-	TEST_ASSERT_EQ(gpiod_line_offset(line), 18);
-}
-TEST_DEFINE(line_get_good,
-	    "gpiod_line_get() - good",
-	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_line_prepared)
+			struct gpiod_line_prepared *prepared = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	int rv, vals[3], i;
+	struct gpiod_line *line;
 
-static void line_get_invalid_offset(void)
-{
-	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
 
-	line = gpiod_line_get(test_chip_name(3), 18);
-	TEST_ASSERT_NULL(line);
-	TEST_ASSERT_ERRNO_IS(EINVAL);
-}
-TEST_DEFINE(line_get_invalid_offset,
-	    "gpiod_line_get() - invalid offset",
-	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+	for (i = 0; i < 3; i++) {
+		line = gpiod_chip_get_line(chip, i + 2);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
 
-static void line_find_good(void)
-{
-	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+	vals[0] = vals[1] = vals[2] = 0;
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, vals);
+	TEST_ASSERT_RET_OK(rv);
 
-	line = gpiod_line_find("gpio-mockup-C-12");
-	TEST_ASSERT_NOT_NULL(line);
+	prepared = gpiod_line_prepared_new(&bulk);
+	TEST_ASSERT_NOT_NULL(prepared);
+	TEST_ASSERT_EQ(gpiod_line_prepared_num_lines(prepared), 3);
 
-	TEST_ASSERT_EQ(gpiod_line_offset(line), 12);
-}
-TEST_DEFINE(line_find_good,
-	    "gpiod_line_find() - good",
-	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+	vals[0] = 1;
+	vals[1] = 0;
+	vals[2] = 1;
+	rv = gpiod_line_prepared_set_values(prepared, vals);
+	TEST_ASSERT_RET_OK(rv);
 
-static void line_find_not_found(void)
-{
-	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_prepared_get_values(prepared, vals);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals[0], 1);
+	TEST_ASSERT_EQ(vals[1], 0);
+	TEST_ASSERT_EQ(vals[2], 1);
 
-	line = gpiod_line_find("nonexistent");
-	TEST_ASSERT_NULL(line);
-	TEST_ASSERT_ERRNO_IS(ENOENT);
-}
-TEST_DEFINE(line_find_not_found,
-	    "gpiod_line_find() - not found",
-	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+	/* The prepared request keeps the line handle alive. */
+	gpiod_line_release_bulk(&bulk);
 
-static void line_find_unnamed_lines(void)
-{
-	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+	vals[0] = 0;
+	vals[1] = 1;
+	vals[2] = 0;
+	rv = gpiod_line_prepared_set_values(prepared, vals);
+	TEST_ASSERT_RET_OK(rv);
 
-	line = gpiod_line_find("gpio-mockup-C-12");
-	TEST_ASSERT_NULL(line);
-	TEST_ASSERT_ERRNO_IS(ENOENT);
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_prepared_get_values(prepared, vals);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals[0], 0);
+	TEST_ASSERT_EQ(vals[1], 1);
+	TEST_ASSERT_EQ(vals[2], 0);
 }
-TEST_DEFINE(line_find_unnamed_lines,
-	    "gpiod_line_find() - unnamed lines",
-	    0, { 16, 16, 32, 16 });
+TEST_DEFINE(line_prepared_set_get_values,
+	    "gpiod_line_prepared_set/get_values() - good",
+	    0, { 8 });
 
-static void line_direction(void)
+static void line_prepared_holds_request(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_line_prepared)
+			struct gpiod_line_prepared *prepared = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
 	struct gpiod_line *line;
-	int rv;
+	int rv, i;
 
 	chip = gpiod_chip_open(test_chip_path(0));
 	TEST_ASSERT_NOT_NULL(chip);
 
-	line = gpiod_chip_get_line(chip, 5);
-	TEST_ASSERT_NOT_NULL(line);
+	for (i = 0; i < 2; i++) {
+		line = gpiod_chip_get_line(chip, i + 2);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
 
-	rv = gpiod_line_request_output(line, TEST_CONSUMER, 0);
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, NULL);
 	TEST_ASSERT_RET_OK(rv);
 
-	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_OUTPUT);
+	prepared = gpiod_line_prepared_new(&bulk);
+	TEST_ASSERT_NOT_NULL(prepared);
 
-	gpiod_line_release(line);
+	/* The lines stay claimed until the prepared request is freed... */
+	gpiod_line_release_bulk(&bulk);
+	TEST_ASSERT(gpiod_line_is_free(line));
 
-	rv = gpiod_line_request_input(line, TEST_CONSUMER);
-	TEST_ASSERT_RET_OK(rv);
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, NULL);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EBUSY);
 
-	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+	/* ...after which they can be requested again. */
+	gpiod_line_prepared_free(prepared);
+	prepared = NULL;
+
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, NULL);
+	TEST_ASSERT_RET_OK(rv);
 }
-TEST_DEFINE(line_direction,
-	    "gpiod_line_direction() - set & get",
+TEST_DEFINE(line_prepared_holds_request,
+	    "gpiod_line_prepared_new() - lines claimed until freed",
 	    0, { 8 });
 
-static void line_active_state(void)
+static void line_prepared_not_requested_together(void)
 {
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
-	struct gpiod_line *line;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line_prepared *prepared;
+	struct gpiod_line *line1, *line2;
 	int rv;
 
 	chip = gpiod_chip_open(test_chip_path(0));
 	TEST_ASSERT_NOT_NULL(chip);
 
-	line = gpiod_chip_get_line(chip, 5);
-	TEST_ASSERT_NOT_NULL(line);
+	line1 = gpiod_chip_get_line(chip, 2);
+	line2 = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line1);
+	TEST_ASSERT_NOT_NULL(line2);
 
-	rv = gpiod_line_request_input(line, TEST_CONSUMER);
-	TEST_ASSERT_RET_OK(rv);
+	gpiod_line_bulk_add(&bulk, line1);
+	gpiod_line_bulk_add(&bulk, line2);
 
-	TEST_ASSERT_EQ(gpiod_line_active_state(line),
-		       GPIOD_LINE_ACTIVE_STATE_HIGH);
+	rv = gpiod_line_request_output(line1, TEST_CONSUMER, 0);
+	TEST_ASSERT_RET_OK(rv);
 
-	gpiod_line_release(line);
+	prepared = gpiod_line_prepared_new(&bulk);
+	TEST_ASSERT_NULL(prepared);
+	TEST_ASSERT_ERRNO_IS(EPERM);
 
-	rv = gpiod_line_request_input_flags(line, TEST_CONSUMER,
-					GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW);
+	rv = gpiod_line_request_output(line2, TEST_CONSUMER, 0);
 	TEST_ASSERT_RET_OK(rv);
 
-	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+	prepared = gpiod_line_prepared_new(&bulk);
+	TEST_ASSERT_NULL(prepared);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
 }
-TEST_DEFINE(line_active_state,
-	    "gpiod_line_active_state() - set & get",
+TEST_DEFINE(line_prepared_not_requested_together,
+	    "gpiod_line_prepared_new() - lines not requested together",
 	    0, { 8 });
 
-static void line_misc_flags(void)
+static void line_waveform_play(void)
 {
+	static const struct gpiod_waveform_step steps[] = {
+		{ .time = 0, .values = 0x5 },
+		{ .time = 10000000, .values = 0x2 },
+		{ .time = 20000000, .values = 0x7 },
+	};
+
 	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
-	struct gpiod_line_request_config config;
+	TEST_CLEANUP(test_free_waveform) struct gpiod_waveform *waveform = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_waveform_step unsorted[2];
+	struct gpiod_waveform_stats stats;
+	struct timespec ts = { 1, 0 };
 	struct gpiod_line *line;
-	int rv;
+	int rv, vals[3], i;
 
 	chip = gpiod_chip_open(test_chip_path(0));
 	TEST_ASSERT_NOT_NULL(chip);
 
-	line = gpiod_chip_get_line(chip, 2);
-	TEST_ASSERT_NOT_NULL(line);
+	for (i = 0; i < 3; i++) {
+		line = gpiod_chip_get_line(chip, i + 2);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
 
-	TEST_ASSERT_FALSE(gpiod_line_is_used(line));
-	TEST_ASSERT_FALSE(gpiod_line_is_open_drain(line));
-	TEST_ASSERT_FALSE(gpiod_line_is_open_source(line));
+	vals[0] = vals[1] = vals[2] = 0;
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, vals);
+	TEST_ASSERT_RET_OK(rv);
 
-	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
-	config.consumer = TEST_CONSUMER;
-	config.flags = GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN;
+	unsorted[0] = steps[1];
+	unsorted[1] = steps[0];
+	waveform = gpiod_waveform_new(&bulk, unsorted, 2);
+	TEST_ASSERT_NULL(waveform);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
 
-	rv = gpiod_line_request(line, &config, 0);
+	waveform = gpiod_waveform_new(&bulk, steps, 3);
+	TEST_ASSERT_NOT_NULL(waveform);
+
+	rv = gpiod_waveform_set_spin(waveform, 50000);
 	TEST_ASSERT_RET_OK(rv);
 
-	TEST_ASSERT(gpiod_line_is_used(line));
-	TEST_ASSERT(gpiod_line_is_open_drain(line));
-	TEST_ASSERT_FALSE(gpiod_line_is_open_source(line));
+	rv = gpiod_waveform_start(waveform, NULL);
+	TEST_ASSERT_RET_OK(rv);
 
-	gpiod_line_release(line);
+	rv = gpiod_waveform_get_stats(waveform, &stats);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EBUSY);
 
-	config.flags = GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE;
+	rv = gpiod_waveform_wait(waveform, &ts);
+	TEST_ASSERT_EQ(rv, 1);
 
-	rv = gpiod_line_request(line, &config, 0);
+	rv = gpiod_line_get_value_bulk(&bulk, vals);
 	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals[0], 1);
+	TEST_ASSERT_EQ(vals[1], 1);
+	TEST_ASSERT_EQ(vals[2], 1);
 
-	TEST_ASSERT(gpiod_line_is_used(line));
-	TEST_ASSERT_FALSE(gpiod_line_is_open_drain(line));
-	TEST_ASSERT(gpiod_line_is_open_source(line));
+	rv = gpiod_waveform_get_stats(waveform, &stats);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(stats.steps, 3);
+	TEST_ASSERT(stats.min_latency <= stats.max_latency);
+	TEST_ASSERT(stats.total_latency >= stats.max_latency);
 }
-TEST_DEFINE(line_misc_flags,
-	    "gpiod_line - misc flags",
+TEST_DEFINE(line_waveform_play,
+	    "gpiod_waveform - play a waveform on a set of lines",
+	    0, { 8 });
+
+static void line_pwm_generate(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_pwm) struct gpiod_pwm *pwm = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_pwm_stats stats;
+	struct gpiod_line *line;
+	int rv, vals[3], i;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 3; i++) {
+		line = gpiod_chip_get_line(chip, i + 2);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	vals[0] = vals[1] = vals[2] = 0;
+	rv = gpiod_line_request_bulk_output(&bulk, TEST_CONSUMER, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	pwm = gpiod_pwm_new(&bulk, 10000000);
+	TEST_ASSERT_NOT_NULL(pwm);
+
+	rv = gpiod_pwm_set_channel(pwm, 3, 10000000, 5000000);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+
+	rv = gpiod_pwm_set_channel(pwm, 0, 10000000, 20000000);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+
+	rv = gpiod_pwm_set_channel(pwm, 0, 10000000, 5000000);
+	TEST_ASSERT_RET_OK(rv);
+	rv = gpiod_pwm_set_channel(pwm, 1, 5000000, 1000000);
+	TEST_ASSERT_RET_OK(rv);
+	/* Channel 2 is always on. */
+	rv = gpiod_pwm_set_channel(pwm, 2, 10000000, 10000000);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_pwm_start(pwm);
+	TEST_ASSERT_RET_OK(rv);
+
+	usleep(100000);
+
+	/* Channels can be updated while running. */
+	rv = gpiod_pwm_set_channel(pwm, 1, 5000000, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	usleep(50000);
+
+	rv = gpiod_line_get_value(gpiod_line_bulk_get_line(&bulk, 2));
+	TEST_ASSERT_EQ(rv, 1);
+
+	rv = gpiod_pwm_get_stats(pwm, &stats);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT(stats.edges > 10);
+	TEST_ASSERT(stats.min_latency <= stats.max_latency);
+
+	gpiod_pwm_stop(pwm);
+
+	rv = gpiod_line_get_value_bulk(&bulk, vals);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(vals[0], 0);
+	TEST_ASSERT_EQ(vals[1], 0);
+	TEST_ASSERT_EQ(vals[2], 0);
+}
+TEST_DEFINE(line_pwm_generate,
+	    "gpiod_pwm - generate pulses on a set of lines",
+	    0, { 8 });
+
+static void line_array_set_get_values(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	TEST_CLEANUP(test_free_line_array)
+			struct gpiod_line_array *array = NULL;
+	struct gpiod_line_request_config config;
+	int rv, vals[200], i;
+	struct gpiod_line *line;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	array = gpiod_line_array_new();
+	TEST_ASSERT_NOT_NULL(array);
+
+	for (i = 0; i < 200; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+
+		rv = gpiod_line_array_add(array, line);
+		TEST_ASSERT_RET_OK(rv);
+
+		vals[i] = i % 2;
+	}
+
+	TEST_ASSERT_EQ(gpiod_line_array_num_lines(array), 200);
+	TEST_ASSERT(gpiod_line_array_get_line(array, 150) ==
+		    gpiod_chip_get_line(chip, 150));
+	TEST_ASSERT_NULL(gpiod_line_array_get_line(array, 200));
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+
+	rv = gpiod_line_array_request(array, &config, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_array_get_values(array, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	for (i = 0; i < 200; i++)
+		TEST_ASSERT_EQ(vals[i], i % 2);
+
+	for (i = 0; i < 200; i++)
+		vals[i] = !(i % 2);
+
+	rv = gpiod_line_array_set_values(array, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_array_get_values(array, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	for (i = 0; i < 200; i++)
+		TEST_ASSERT_EQ(vals[i], !(i % 2));
+
+	gpiod_line_array_release(array);
+
+	line = gpiod_line_array_get_line(array, 199);
+	TEST_ASSERT(gpiod_line_is_free(line));
+}
+TEST_DEFINE(line_array_set_get_values,
+	    "gpiod_line_array - set/get values of more than 64 lines",
+	    0, { 256 });
+
+static void line_array_different_chips(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipA = NULL;
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipB = NULL;
+	TEST_CLEANUP(test_free_line_array)
+			struct gpiod_line_array *array = NULL;
+	struct gpiod_line *lineA, *lineB;
+	int rv;
+
+	chipA = gpiod_chip_open(test_chip_path(0));
+	chipB = gpiod_chip_open(test_chip_path(1));
+	TEST_ASSERT_NOT_NULL(chipA);
+	TEST_ASSERT_NOT_NULL(chipB);
+
+	lineA = gpiod_chip_get_line(chipA, 0);
+	lineB = gpiod_chip_get_line(chipB, 0);
+	TEST_ASSERT_NOT_NULL(lineA);
+	TEST_ASSERT_NOT_NULL(lineB);
+
+	array = gpiod_line_array_new();
+	TEST_ASSERT_NOT_NULL(array);
+
+	rv = gpiod_line_array_add(array, lineA);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_array_add(array, lineB);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+	TEST_ASSERT_EQ(gpiod_line_array_num_lines(array), 1);
+}
+TEST_DEFINE(line_array_different_chips,
+	    "gpiod_line_array_add() - different chips",
+	    0, { 8, 8 });
+
+static void line_group_set_get_values(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipA = NULL;
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipB = NULL;
+	TEST_CLEANUP_CHIP struct gpiod_chip *chipC = NULL;
+	TEST_CLEANUP(test_free_line_group)
+			struct gpiod_line_group *group = NULL;
+	struct gpiod_line_request_config config;
+	struct gpiod_chip *chips[3];
+	struct gpiod_line *line;
+	int rv, vals[12], i;
+
+	chipA = gpiod_chip_open(test_chip_path(0));
+	chipB = gpiod_chip_open(test_chip_path(1));
+	chipC = gpiod_chip_open(test_chip_path(2));
+	TEST_ASSERT_NOT_NULL(chipA);
+	TEST_ASSERT_NOT_NULL(chipB);
+	TEST_ASSERT_NOT_NULL(chipC);
+
+	chips[0] = chipA;
+	chips[1] = chipB;
+	chips[2] = chipC;
+
+	group = gpiod_line_group_new();
+	TEST_ASSERT_NOT_NULL(group);
+
+	/* Interleave the chips to verify the ordering of values. */
+	for (i = 0; i < 12; i++) {
+		line = gpiod_chip_get_line(chips[i % 3], i / 3);
+		TEST_ASSERT_NOT_NULL(line);
+
+		rv = gpiod_line_group_add(group, line);
+		TEST_ASSERT_RET_OK(rv);
+
+		vals[i] = i % 2;
+	}
+
+	TEST_ASSERT_EQ(gpiod_line_group_num_lines(group), 12);
+	TEST_ASSERT_EQ(gpiod_line_group_num_chips(group), 3);
+	TEST_ASSERT(gpiod_line_group_get_line(group, 4) ==
+		    gpiod_chip_get_line(chipB, 1));
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+
+	rv = gpiod_line_group_request(group, &config, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_group_get_values(group, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	for (i = 0; i < 12; i++)
+		TEST_ASSERT_EQ(vals[i], i % 2);
+
+	for (i = 0; i < 12; i++)
+		vals[i] = i < 6;
+
+	rv = gpiod_line_group_set_values(group, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	memset(vals, 0, sizeof(vals));
+	rv = gpiod_line_group_get_values(group, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	for (i = 0; i < 12; i++)
+		TEST_ASSERT_EQ(vals[i], i < 6);
+}
+TEST_DEFINE(line_group_set_get_values,
+	    "gpiod_line_group - set/get values on lines from multiple chips",
+	    0, { 8, 8, 8 });
+
+static void line_get_good(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+
+	line = gpiod_line_get(test_chip_name(2), 18);
+	TEST_ASSERT_NOT_NULL(line);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 18);
+}
+TEST_DEFINE(line_get_good,
+	    "gpiod_line_get() - good",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_get_invalid_offset(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+
+	line = gpiod_line_get(test_chip_name(3), 18);
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+}
+TEST_DEFINE(line_get_invalid_offset,
+	    "gpiod_line_get() - invalid offset",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_find_good(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+
+	line = gpiod_line_find("gpio-mockup-C-12");
+	TEST_ASSERT_NOT_NULL(line);
+
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 12);
+}
+TEST_DEFINE(line_find_good,
+	    "gpiod_line_find() - good",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_find_not_found(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+
+	line = gpiod_line_find("nonexistent");
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(line_find_not_found,
+	    "gpiod_line_find() - not found",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_find_unnamed_lines(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+
+	line = gpiod_line_find("gpio-mockup-C-12");
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(line_find_unnamed_lines,
+	    "gpiod_line_find() - unnamed lines",
+	    0, { 16, 16, 32, 16 });
+
+static void line_cache_find(void)
+{
+	unsigned int offset;
+	char path[64], chip[32];
+	int rv;
+
+	snprintf(path, sizeof(path), "/tmp/gpiod-test-line-cache.%d",
+		 getpid());
+	unlink(path);
+
+	/* The first lookup creates the cache, the second one uses it. */
+	rv = gpiod_line_cache_find(path, "gpio-mockup-C-12", chip,
+				   sizeof(chip), &offset);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(offset, 12);
+	TEST_ASSERT_STR_EQ(chip, test_chip_name(2));
+	TEST_ASSERT_RET_OK(access(path, R_OK));
+
+	rv = gpiod_line_cache_find(path, "gpio-mockup-B-3", chip,
+				   sizeof(chip), &offset);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(offset, 3);
+	TEST_ASSERT_STR_EQ(chip, test_chip_name(1));
+
+	rv = gpiod_line_cache_find(path, "nonexistent", chip,
+				   sizeof(chip), &offset);
+	TEST_ASSERT_EQ(rv, 0);
+
+	unlink(path);
+}
+TEST_DEFINE(line_cache_find,
+	    "gpiod_line_cache_find() - good",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_cache_find_stale(void)
+{
+	static const char garbage[] = "definitely not a line cache";
+
+	unsigned int offset;
+	char path[64], chip[32];
+	FILE *fp;
+	int rv;
+
+	snprintf(path, sizeof(path), "/tmp/gpiod-test-line-cache.%d",
+		 getpid());
+
+	fp = fopen(path, "w");
+	TEST_ASSERT_NOT_NULL(fp);
+	fwrite(garbage, sizeof(garbage), 1, fp);
+	fclose(fp);
+
+	rv = gpiod_line_cache_find(path, "gpio-mockup-C-12", chip,
+				   sizeof(chip), &offset);
+	unlink(path);
+	TEST_ASSERT_EQ(rv, 1);
+	TEST_ASSERT_EQ(offset, 12);
+	TEST_ASSERT_STR_EQ(chip, test_chip_name(2));
+}
+TEST_DEFINE(line_cache_find_stale,
+	    "gpiod_line_cache_find() - invalid cache is rebuilt",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_find_cached(void)
+{
+	TEST_CLEANUP(test_line_close_chip) struct gpiod_line *line = NULL;
+	char path[64];
+
+	snprintf(path, sizeof(path), "/tmp/gpiod-test-line-cache.%d",
+		 getpid());
+	unlink(path);
+	setenv("GPIOD_LINE_CACHE", path, 1);
+
+	line = gpiod_line_find("gpio-mockup-C-12");
+	TEST_ASSERT_NOT_NULL(line);
+	TEST_ASSERT_EQ(gpiod_line_offset(line), 12);
+	gpiod_line_close_chip(line);
+
+	/* A cache miss falls back to scanning the chips. */
+	line = gpiod_line_find("nonexistent");
+	unsetenv("GPIOD_LINE_CACHE");
+	unlink(path);
+	TEST_ASSERT_NULL(line);
+	TEST_ASSERT_ERRNO_IS(ENOENT);
+}
+TEST_DEFINE(line_find_cached,
+	    "gpiod_line_find() - line name cache",
+	    TEST_FLAG_NAMED_LINES, { 16, 16, 32, 16 });
+
+static void line_direction(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 5);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_output(line, TEST_CONSUMER, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_OUTPUT);
+
+	gpiod_line_release(line);
+
+	rv = gpiod_line_request_input(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+}
+TEST_DEFINE(line_direction,
+	    "gpiod_line_direction() - set & get",
+	    0, { 8 });
+
+static void line_active_state(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 5);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_input(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(gpiod_line_active_state(line),
+		       GPIOD_LINE_ACTIVE_STATE_HIGH);
+
+	gpiod_line_release(line);
+
+	rv = gpiod_line_request_input_flags(line, TEST_CONSUMER,
+					GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+}
+TEST_DEFINE(line_active_state,
+	    "gpiod_line_active_state() - set & get",
+	    0, { 8 });
+
+static void line_misc_flags(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_request_config config;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line);
+
+	TEST_ASSERT_FALSE(gpiod_line_is_used(line));
+	TEST_ASSERT_FALSE(gpiod_line_is_open_drain(line));
+	TEST_ASSERT_FALSE(gpiod_line_is_open_source(line));
+
+	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+	config.consumer = TEST_CONSUMER;
+	config.flags = GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN;
+
+	rv = gpiod_line_request(line, &config, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT(gpiod_line_is_used(line));
+	TEST_ASSERT(gpiod_line_is_open_drain(line));
+	TEST_ASSERT_FALSE(gpiod_line_is_open_source(line));
+
+	gpiod_line_release(line);
+
+	config.flags = GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE;
+
+	rv = gpiod_line_request(line, &config, 0);
+	TEST_ASSERT_RET_OK(rv);
+
+	TEST_ASSERT(gpiod_line_is_used(line));
+	TEST_ASSERT_FALSE(gpiod_line_is_open_drain(line));
+	TEST_ASSERT(gpiod_line_is_open_source(line));
+}
+TEST_DEFINE(line_misc_flags,
+	    "gpiod_line - misc flags",
 	    0, { 8 });
 
 static void line_open_source_open_drain_input_invalid(void)
@@ -570,6 +1305,230 @@ TEST_DEFINE(line_open_source_open_drain_simultaneously,
 	    "gpiod_line - open-source & open-drain flags simultaneously",
 	    0, { 8 });
 
+static void line_bias_flags_simultaneously(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 2);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_request_input_flags(line, TEST_CONSUMER,
+				GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_UP |
+				GPIOD_LINE_REQUEST_FLAG_BIAS_PULL_DOWN);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+}
+TEST_DEFINE(line_bias_flags_simultaneously,
+	    "gpiod_line - pull-up & pull-down flags simultaneously",
+	    0, { 8 });
+
+static void line_request_per_line_config(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line_request_config config;
+	struct gpiod_line_config line_configs[2];
+	int vals[4] = { 0, 0, 1, 0 };
+	struct gpiod_line *line;
+	unsigned int i;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 4; i++) {
+		line = gpiod_chip_get_line(chip, i);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	memset(line_configs, 0, sizeof(line_configs));
+	line_configs[0].offset = 1;
+	line_configs[0].flags = GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW;
+	line_configs[1].offset = 2;
+	line_configs[1].request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+	config.flags = GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+	config.line_configs = line_configs;
+	config.num_line_configs = 2;
+
+	rv = gpiod_line_request_bulk(&bulk, &config, vals);
+	if (gpiod_chip_uapi_version(chip) == 1) {
+		TEST_ASSERT_EQ(rv, -1);
+		TEST_ASSERT_ERRNO_IS(ENOTSUP);
+		return;
+	}
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_line_bulk_get_line(&bulk, 0);
+	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+	TEST_ASSERT_EQ(gpiod_line_active_state(line),
+		       GPIOD_LINE_ACTIVE_STATE_HIGH);
+
+	line = gpiod_line_bulk_get_line(&bulk, 1);
+	TEST_ASSERT_EQ(gpiod_line_active_state(line),
+		       GPIOD_LINE_ACTIVE_STATE_LOW);
+
+	line = gpiod_line_bulk_get_line(&bulk, 2);
+	TEST_ASSERT_EQ(gpiod_line_direction(line),
+		       GPIOD_LINE_DIRECTION_OUTPUT);
+	TEST_ASSERT_EQ(gpiod_line_get_value(line), 1);
+}
+TEST_DEFINE(line_request_per_line_config,
+	    "gpiod_line_request_bulk() - per-line config",
+	    0, { 8 });
+
+static void line_request_per_line_config_mixed_types(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	struct gpiod_line_request_config config;
+	struct gpiod_line_config line_config;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 3);
+	TEST_ASSERT_NOT_NULL(line);
+	gpiod_line_bulk_add(&bulk, line);
+
+	memset(&line_config, 0, sizeof(line_config));
+	line_config.offset = 3;
+	line_config.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+	config.flags = GPIOD_LINE_REQUEST_FLAG_PER_LINE_CONFIG;
+	config.line_configs = &line_config;
+	config.num_line_configs = 1;
+
+	rv = gpiod_line_request_bulk(&bulk, &config, NULL);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EINVAL);
+}
+TEST_DEFINE(line_request_per_line_config_mixed_types,
+	    "gpiod_line_request_bulk() - per-line config mixing values and events (invalid)",
+	    0, { 8 });
+
+static void line_request_debounce_uapi_v1(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_request_config config;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open_flags(test_chip_path(0),
+				     GPIOD_CHIP_OPEN_FLAG_UAPI_V1);
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 4);
+	TEST_ASSERT_NOT_NULL(line);
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = TEST_CONSUMER;
+	config.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+	config.flags = GPIOD_LINE_REQUEST_FLAG_DEBOUNCE;
+	config.debounce_period_us = 1000;
+
+	rv = gpiod_line_request(line, &config, 0);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(ENOTSUP);
+}
+TEST_DEFINE(line_request_debounce_uapi_v1,
+	    "gpiod_line_request() - debounce with the v1 uAPI (unsupported)",
+	    0, { 8 });
+
+static void line_set_config_bulk_direction(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line_bulk bulk = GPIOD_LINE_BULK_INITIALIZER;
+	int vals[3] = { 1, 0, 1 };
+	struct gpiod_line *line;
+	unsigned int i;
+	uint64_t mask;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	for (i = 0; i < 3; i++) {
+		line = gpiod_chip_get_line(chip, i + 1);
+		TEST_ASSERT_NOT_NULL(line);
+		gpiod_line_bulk_add(&bulk, line);
+	}
+
+	rv = gpiod_line_request_bulk_input(&bulk, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_set_config_bulk(&bulk,
+					GPIOD_LINE_REQUEST_DIRECTION_OUTPUT,
+					0, vals);
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_line_bulk_get_line(&bulk, 0);
+	TEST_ASSERT(gpiod_line_is_requested(line));
+	TEST_ASSERT_EQ(gpiod_line_direction(line),
+		       GPIOD_LINE_DIRECTION_OUTPUT);
+
+	rv = gpiod_line_get_value_bulk_mask(&bulk, &mask);
+	TEST_ASSERT_RET_OK(rv);
+	TEST_ASSERT_EQ(mask, 0x5);
+
+	rv = gpiod_line_set_config_bulk(&bulk,
+					GPIOD_LINE_REQUEST_DIRECTION_INPUT,
+					GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW,
+					NULL);
+	TEST_ASSERT_RET_OK(rv);
+
+	line = gpiod_line_bulk_get_line(&bulk, 2);
+	TEST_ASSERT_EQ(gpiod_line_direction(line), GPIOD_LINE_DIRECTION_INPUT);
+	TEST_ASSERT_EQ(gpiod_line_active_state(line),
+		       GPIOD_LINE_ACTIVE_STATE_LOW);
+}
+TEST_DEFINE(line_set_config_bulk_direction,
+	    "gpiod_line_set_config_bulk() - change direction in place",
+	    0, { 8 });
+
+static void line_set_config_not_requested_for_values(void)
+{
+	TEST_CLEANUP_CHIP struct gpiod_chip *chip = NULL;
+	struct gpiod_line *line;
+	int rv;
+
+	chip = gpiod_chip_open(test_chip_path(0));
+	TEST_ASSERT_NOT_NULL(chip);
+
+	line = gpiod_chip_get_line(chip, 5);
+	TEST_ASSERT_NOT_NULL(line);
+
+	rv = gpiod_line_set_config(line, GPIOD_LINE_REQUEST_DIRECTION_OUTPUT,
+				   0, 1);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+
+	rv = gpiod_line_request_both_edges_events(line, TEST_CONSUMER);
+	TEST_ASSERT_RET_OK(rv);
+
+	rv = gpiod_line_set_config(line, GPIOD_LINE_REQUEST_DIRECTION_OUTPUT,
+				   0, 1);
+	TEST_ASSERT_EQ(rv, -1);
+	TEST_ASSERT_ERRNO_IS(EPERM);
+}
+TEST_DEFINE(line_set_config_not_requested_for_values,
+	    "gpiod_line_set_config() - line not requested for values",
+	    0, { 8 });
+
 /* Verify that the reference counting of the line fd handle works correctly. */
 static void line_release_one_use_another(void)
 {
@@ -61,7 +61,7 @@ int main(int argc, char **argv)
 	if (argc > 0)
 		die("unrecognized argument: %s", argv[0]);
 
-	iter = gpiod_chip_iter_new();
+	iter = gpiod_chip_iter_new_flags(GPIOD_CHIP_ITER_FLAG_EAGER);
 	if (!iter)
 		die_perror("unable to access GPIO chips");
 
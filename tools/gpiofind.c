@@ -13,12 +13,13 @@
 #include "tools-common.h"
 
 static const struct option longopts[] = {
-	{ "help",	no_argument,	NULL,	'h' },
-	{ "version",	no_argument,	NULL,	'v' },
+	{ "help",	no_argument,		NULL,	'h' },
+	{ "version",	no_argument,		NULL,	'v' },
+	{ "cache",	required_argument,	NULL,	'c' },
 	{ GETOPT_NULL_LONGOPT },
 };
 
-static const char *const shortopts = "+hv";
+static const char *const shortopts = "+hvc:";
 
 static void print_help(void)
 {
@@ -28,10 +29,12 @@ static void print_help(void)
 	printf("Options:\n");
 	printf("  -h, --help:\t\tdisplay this message and exit\n");
 	printf("  -v, --version:\tdisplay the version and exit\n");
+	printf("  -c, --cache=PATH:\tuse (and create if needed) the line name cache stored at PATH\n");
 }
 
 int main(int argc, char **argv)
 {
+	const char *cache = NULL;
 	unsigned int offset;
 	int optc, opti, rv;
 	char chip[32];
@@ -48,6 +51,9 @@ int main(int argc, char **argv)
 		case 'v':
 			print_version();
 			return EXIT_SUCCESS;
+		case 'c':
+			cache = optarg;
+			break;
 		case '?':
 			die("try %s --help", get_progname());
 		default:
@@ -61,7 +67,12 @@ int main(int argc, char **argv)
 	if (argc != 1)
 		die("exactly one GPIO line name must be specified");
 
-	rv = gpiod_ctxless_find_line(argv[0], chip, sizeof(chip), &offset);
+	if (cache)
+		rv = gpiod_line_cache_find(cache, argv[0], chip,
+					   sizeof(chip), &offset);
+	else
+		rv = gpiod_ctxless_find_line(argv[0], chip,
+					     sizeof(chip), &offset);
 	if (rv < 0)
 		die_perror("error performing the line lookup");
 	else if (rv == 0)
@@ -179,7 +179,8 @@ int main(int argc, char **argv)
 	argv += optind;
 
 	if (argc == 0) {
-		chip_iter = gpiod_chip_iter_new();
+		chip_iter = gpiod_chip_iter_new_flags(
+					GPIOD_CHIP_ITER_FLAG_EAGER);
 		if (!chip_iter)
 			die_perror("error accessing GPIO chips");
 
@@ -10,9 +10,11 @@
 #include <gpiod.h>
 #include <limits.h>
 #include <poll.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/signalfd.h>
 #include <unistd.h>
 
@@ -28,10 +30,14 @@ static const struct option longopts[] = {
 	{ "falling-edge",	no_argument,		NULL,	'f' },
 	{ "line-buffered",	no_argument,		NULL,	'b' },
 	{ "format",		required_argument,	NULL,	'F' },
+	{ "stats",		no_argument,		NULL,	'S' },
+	{ "rt-priority",	required_argument,	NULL,	'R' },
+	{ "cpu",		required_argument,	NULL,	'C' },
+	{ "mlock",		no_argument,		NULL,	'm' },
 	{ GETOPT_NULL_LONGOPT },
 };
 
-static const char *const shortopts = "+hvln:srfbF:";
+static const char *const shortopts = "+hvln:srfbF:SR:C:m";
 
 static void print_help(void)
 {
@@ -49,6 +55,16 @@ static void print_help(void)
 	printf("  -f, --falling-edge:\tonly process falling edge events\n");
 	printf("  -b, --line-buffered:\tset standard output as line buffered\n");
 	printf("  -F, --format=FMT\tspecify custom output format\n");
+	printf("  -S, --stats:\t\tprint the number of received and dropped events\n");
+	printf("\t\t\tof every line on exit\n");
+	printf("  -R, --rt-priority=PRIO\tread the events in a realtime thread running\n");
+	printf("\t\t\twith the SCHED_FIFO policy and given priority\n");
+	printf("  -C, --cpu=CPU\t\tread the events in a thread pinned to given CPU\n");
+	printf("  -m, --mlock:\t\tread the events in a thread with its memory locked\n");
+	printf("\n");
+	printf("With --rt-priority, --cpu or --mlock the events are read by a dedicated\n");
+	printf("thread and handed over to the main thread for printing. Locking memory\n");
+	printf("requires a large enough RLIMIT_MEMLOCK or the CAP_IPC_LOCK capability.\n");
 	printf("\n");
 	printf("Format specifiers:\n");
 	printf("  %%o:  GPIO line offset\n");
@@ -66,8 +82,44 @@ struct mon_ctx {
 	char *fmt;
 
 	int sigfd;
+
+	bool stats;
+	const unsigned int *offsets;
+	unsigned int num_lines;
+	unsigned long long received[GPIOD_LINE_BULK_MAX_LINES];
+	unsigned long long dropped[GPIOD_LINE_BULK_MAX_LINES];
+	unsigned long long overruns;
+
+	int rt_priority;
+	int cpu;
+	bool mlock;
 };
 
+static unsigned int line_index(struct mon_ctx *ctx, unsigned int offset)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->num_lines; i++) {
+		if (ctx->offsets[i] == offset)
+			break;
+	}
+
+	return i;
+}
+
+static void print_stats(struct mon_ctx *ctx)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->num_lines; i++)
+		printf("line %u: received %llu events, dropped %llu events\n",
+		       ctx->offsets[i], ctx->received[i], ctx->dropped[i]);
+
+	if (ctx->overruns)
+		printf("dropped %llu events not consumed in time\n",
+		       ctx->overruns);
+}
+
 static void event_print_custom(unsigned int offset,
 			       const struct timespec *ts,
 			       int event_type,
@@ -184,6 +236,14 @@ static void handle_event(struct mon_ctx *ctx, int event_type,
 			 unsigned int line_offset,
 			 const struct timespec *timestamp)
 {
+	unsigned int index;
+
+	if (ctx->stats) {
+		index = line_index(ctx, line_offset);
+		if (index < ctx->num_lines)
+			ctx->received[index]++;
+	}
+
 	if (!ctx->silent) {
 		if (ctx->fmt)
 			event_print_custom(line_offset, timestamp,
@@ -200,12 +260,18 @@ static int event_callback(int event_type, unsigned int line_offset,
 			  const struct timespec *timestamp, void *data)
 {
 	struct mon_ctx *ctx = data;
+	unsigned int index;
 
 	switch (event_type) {
 	case GPIOD_CTXLESS_EVENT_CB_RISING_EDGE:
 	case GPIOD_CTXLESS_EVENT_CB_FALLING_EDGE:
 		handle_event(ctx, event_type, line_offset, timestamp);
 		break;
+	case GPIOD_CTXLESS_EVENT_CB_DROPPED_EVENT:
+		index = line_index(ctx, line_offset);
+		if (index < ctx->num_lines)
+			ctx->dropped[index]++;
+		return GPIOD_CTXLESS_EVENT_CB_RET_OK;
 	default:
 		/*
 		 * REVISIT: This happening would indicate a problem in the
@@ -240,16 +306,167 @@ static int make_signalfd(void)
 	return sigfd;
 }
 
+#define RT_RING_SIZE		4096
+#define RT_MAX_EVENTS		64
+#define RT_MAX_PRIORITY		sched_get_priority_max(SCHED_FIFO)
+
+static int rt_event_type(const struct gpiod_line_event *event)
+{
+	if (event->event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+		return GPIOD_CTXLESS_EVENT_CB_RISING_EDGE;
+
+	return GPIOD_CTXLESS_EVENT_CB_FALLING_EDGE;
+}
+
+static int rt_handle_events(struct gpiod_event_drain *drain,
+			    struct mon_ctx *ctx)
+{
+	struct gpiod_line_event events[RT_MAX_EVENTS];
+	struct timespec no_wait = { 0, 0 };
+	int num_events, i, rv;
+
+	for (;;) {
+		num_events = gpiod_event_drain_pop(drain, events,
+						   NULL, RT_MAX_EVENTS);
+		if (num_events == 0) {
+			/* The ring is empty - check for read errors. */
+			rv = gpiod_event_drain_wait(drain, &no_wait);
+			if (rv < 0)
+				return GPIOD_CTXLESS_EVENT_CB_RET_ERR;
+			else if (rv == 0)
+				return GPIOD_CTXLESS_EVENT_CB_RET_OK;
+
+			continue;
+		}
+
+		for (i = 0; i < num_events; i++) {
+			rv = event_callback(rt_event_type(&events[i]),
+					    events[i].offset,
+					    &events[i].ts, ctx);
+			if (rv == GPIOD_CTXLESS_EVENT_CB_RET_STOP)
+				return rv;
+		}
+	}
+}
+
+/*
+ * Read the events in a library-managed thread with the requested scheduling,
+ * CPU affinity and memory locking. The main thread only prints what the drain
+ * thread collected so that slow output doesn't delay reading.
+ */
+static int monitor_rt(const char *device, int event_type,
+		      unsigned int *offsets, unsigned int num_lines,
+		      bool active_low, struct mon_ctx *ctx)
+{
+	struct gpiod_line_request_config config;
+	struct gpiod_line_event_stats stats;
+	struct gpiod_event_drain *drain;
+	struct gpiod_line_bulk bulk;
+	struct gpiod_chip *chip;
+	struct pollfd pfds[2];
+	eventfd_t count;
+	unsigned int i;
+	int rv;
+
+	chip = gpiod_chip_open_lookup(device);
+	if (!chip)
+		return -1;
+
+	rv = gpiod_chip_get_lines(chip, offsets, num_lines, &bulk);
+	if (rv)
+		goto out_close_chip;
+
+	memset(&config, 0, sizeof(config));
+	config.consumer = "gpiomon";
+	config.flags = active_low ? GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW : 0;
+
+	if (event_type == GPIOD_CTXLESS_EVENT_RISING_EDGE)
+		config.request_type = GPIOD_LINE_REQUEST_EVENT_RISING_EDGE;
+	else if (event_type == GPIOD_CTXLESS_EVENT_FALLING_EDGE)
+		config.request_type = GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE;
+	else
+		config.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
+
+	rv = gpiod_line_request_bulk(&bulk, &config, NULL);
+	if (rv)
+		goto out_close_chip;
+
+	rv = -1;
+	drain = gpiod_event_drain_new(RT_RING_SIZE);
+	if (!drain)
+		goto out_close_chip;
+
+	if (ctx->rt_priority > 0 &&
+	    gpiod_event_drain_set_sched(drain, SCHED_FIFO, ctx->rt_priority))
+		goto out_free_drain;
+
+	if (gpiod_event_drain_set_cpu(drain, ctx->cpu) ||
+	    gpiod_event_drain_set_mlock(drain, ctx->mlock) ||
+	    gpiod_event_drain_add_bulk(drain, &bulk) ||
+	    gpiod_event_drain_start(drain))
+		goto out_free_drain;
+
+	memset(pfds, 0, sizeof(pfds));
+	pfds[0].fd = gpiod_event_drain_get_fd(drain);
+	pfds[0].events = POLLIN;
+	pfds[1].fd = ctx->sigfd;
+	pfds[1].events = POLLIN;
+
+	for (;;) {
+		rv = poll(pfds, 2, -1);
+		if (rv < 0) {
+			if (errno == EINTR)
+				continue;
+
+			goto out_free_drain;
+		}
+
+		if (pfds[0].revents) {
+			eventfd_read(pfds[0].fd, &count);
+			rv = rt_handle_events(drain, ctx);
+			if (rv == GPIOD_CTXLESS_EVENT_CB_RET_ERR)
+				goto out_free_drain;
+			else if (rv == GPIOD_CTXLESS_EVENT_CB_RET_STOP)
+				break;
+		}
+
+		/* No need to read the signal, we know we should quit now. */
+		if (pfds[1].revents)
+			break;
+	}
+
+	gpiod_event_drain_stop(drain);
+	rv = 0;
+
+	if (ctx->stats) {
+		for (i = 0; i < num_lines; i++) {
+			gpiod_line_event_get_stats(
+				gpiod_line_bulk_get_line(&bulk, i), &stats);
+			ctx->dropped[i] = stats.dropped;
+		}
+
+		ctx->overruns = gpiod_event_drain_overruns(drain);
+	}
+
+out_free_drain:
+	gpiod_event_drain_free(drain);
+out_close_chip:
+	gpiod_chip_close(chip);
+
+	return rv;
+}
+
 int main(int argc, char **argv)
 {
 	unsigned int offsets[GPIOD_LINE_BULK_MAX_LINES], num_lines = 0, offset;
 	bool active_low = false, watch_rising = false, watch_falling = false;
 	struct timespec timeout = { 10, 0 };
-	int optc, opti, rv, i, event_type;
+	int optc, opti, rv, i, event_type, flags = 0;
 	struct mon_ctx ctx;
 	char *end;
 
 	memset(&ctx, 0, sizeof(ctx));
+	ctx.cpu = -1;
 
 	for (;;) {
 		optc = getopt_long(argc, argv, shortopts, longopts, &opti);
@@ -286,6 +503,25 @@ int main(int argc, char **argv)
 		case 'F':
 			ctx.fmt = optarg;
 			break;
+		case 'S':
+			ctx.stats = true;
+			flags |= GPIOD_CTXLESS_FLAG_REPORT_DROPPED;
+			break;
+		case 'R':
+			ctx.rt_priority = strtoul(optarg, &end, 10);
+			if (*end != '\0' || ctx.rt_priority < 1 ||
+			    ctx.rt_priority > RT_MAX_PRIORITY)
+				die("invalid realtime priority: %s", optarg);
+			break;
+		case 'C':
+			ctx.cpu = strtoul(optarg, &end, 10);
+			if (*end != '\0' || ctx.cpu < 0 ||
+			    ctx.cpu >= CPU_SETSIZE)
+				die("invalid CPU number: %s", optarg);
+			break;
+		case 'm':
+			ctx.mlock = true;
+			break;
 		case '?':
 			die("try %s --help", get_progname());
 		default:
@@ -319,14 +555,23 @@ int main(int argc, char **argv)
 	}
 
 	ctx.sigfd = make_signalfd();
+	ctx.offsets = offsets;
+	ctx.num_lines = num_lines;
 
-	rv = gpiod_ctxless_event_monitor_multiple(argv[0], event_type,
-						  offsets, num_lines,
-						  active_low, "gpiomon",
-						  &timeout, poll_callback,
-						  event_callback, &ctx);
+	if (ctx.rt_priority || ctx.cpu >= 0 || ctx.mlock)
+		rv = monitor_rt(argv[0], event_type, offsets, num_lines,
+				active_low, &ctx);
+	else
+		rv = gpiod_ctxless_event_monitor_multiple_ext(argv[0],
+						event_type, offsets, num_lines,
+						active_low, "gpiomon",
+						&timeout, poll_callback,
+						event_callback, &ctx, flags);
 	if (rv)
 		die_perror("error waiting for events");
 
+	if (ctx.stats)
+		print_stats(&ctx);
+
 	return EXIT_SUCCESS;
 }